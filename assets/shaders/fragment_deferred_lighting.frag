@@ -0,0 +1,138 @@
+#version 450
+
+layout(location = 0) out vec4 outColor;
+
+struct PointLight {
+  vec4 position; // w is radius
+  vec4 color; // w is intensity
+  float shininess;
+  float range; // distance where the contribution falls under LIGHT_CUTOFF
+  int shadow; // index in shadowMaps, -1 without shadow
+};
+
+// ShaderVariant specialization constants, the defaults are the ones of ShaderVariant
+layout(constant_id = 1) const bool SHADOWS = true;
+layout(constant_id = 2) const uint MAX_LIGHTS = 64; // lights of the cluster shaded at most
+
+// LightClusters DEFAULT_LIGHT_CUTOFF, subtracted so the lights fade out at their range instead of being cut
+const float LIGHT_CUTOFF = 1.0 / 256.0;
+
+layout(set = 0, binding = 0) uniform GlobalUbo {
+  mat4 projection;
+  mat4 view;
+  mat4 invView;
+  vec4 ambientLightColor; // w is intensity
+  vec4 frustumPlanes[6];
+  mat4 prevViewProjection; // HiZ pyramid camera
+  uvec4 clusterGrid; // w is the light count
+  vec4 clusterScale; // xy: clusters per pixel, zw: depth slice scale and bias
+} ubo;
+
+layout(std430, set = 0, binding = 2) readonly buffer Lights {
+  PointLight pointLights[];
+};
+
+// offset and count in lightIndices of the lights of each cluster, written by light_cluster.comp
+layout(std430, set = 0, binding = 3) readonly buffer ClusterRanges {
+  uvec2 clusterRanges[];
+};
+
+layout(std430, set = 0, binding = 4) readonly buffer LightIndices {
+  uint lightIndices[];
+};
+
+struct ShadowMap {
+  mat4 faceViewProjections[6]; // +x, -x, +y, -y, +z, -z, see ShadowCache::getFaceViewProjection
+  vec4 faceRects[6]; // xy: atlas uv of the tile, z: atlas uv size of the tile, w: half texel of the face
+};
+
+// cube shadow maps of the shadow casting lights, see ShadowRenderSystem
+layout(std430, set = 0, binding = 5) readonly buffer ShadowMaps {
+  ShadowMap shadowMaps[];
+};
+
+layout(set = 0, binding = 6) uniform sampler2DShadow shadowAtlas;
+
+// 1 when lit, filtered over the 2x2 texels of the comparison
+float getShadow(int shadow, vec3 lightPosition, vec3 position, vec3 normal) {
+  if (!SHADOWS || shadow < 0) {
+    return 1.0;
+  }
+  // the face whose axis is the major axis of the direction, as ShadowCache renders them
+  vec3 direction = position - lightPosition;
+  vec3 absDirection = abs(direction);
+  uint face = absDirection.x >= absDirection.y && absDirection.x >= absDirection.z ? (direction.x >= 0.0 ? 0u : 1u)
+    : (absDirection.y >= absDirection.z ? (direction.y >= 0.0 ? 2u : 3u) : (direction.z >= 0.0 ? 4u : 5u));
+  vec4 rect = shadowMaps[shadow].faceRects[face];
+  // pushed out along the normal by about two texels (a face texel covers 4 * rect.w of the distance), against acne on grazing surfaces
+  vec3 offsetPosition = position + normal * (max(absDirection.x, max(absDirection.y, absDirection.z)) * 8.0 * rect.w);
+  vec4 clip = shadowMaps[shadow].faceViewProjections[face] * vec4(offsetPosition, 1.0);
+  vec3 ndc = clip.xyz / clip.w;
+  // the filter must not read the neighbouring tiles
+  vec2 uv = clamp(ndc.xy * 0.5 + 0.5, vec2(rect.w), vec2(1.0 - rect.w));
+  return textureLod(shadowAtlas, vec3(rect.xy + uv * rect.z, ndc.z), 0.0);
+}
+
+// written by fragment_gbuffer.frag in the previous subpass
+layout(input_attachment_index = 0, set = 1, binding = 0) uniform subpassInput gBufferAlbedo;
+layout(input_attachment_index = 1, set = 1, binding = 1) uniform subpassInput gBufferNormal;
+layout(input_attachment_index = 2, set = 1, binding = 2) uniform subpassInput gBufferMaterial;
+layout(input_attachment_index = 3, set = 1, binding = 3) uniform subpassInput gBufferDepth;
+
+vec3 decodeNormal(vec2 encoded) {
+  vec3 normal = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+  float fold = max(-normal.z, 0.0);
+  normal.xy += vec2(normal.x >= 0.0 ? -fold : fold, normal.y >= 0.0 ? -fold : fold);
+  return normalize(normal);
+}
+
+void main() {
+  float depth = subpassLoad(gBufferDepth).r;
+  if (depth >= 1.0) {
+    discard; // nothing drawn, the clear color stays
+  }
+
+  // view depth from the projection of Camera (ndc = P22 + P32 / z), the viewport from the cluster scale
+  float viewDepth = ubo.projection[3][2] / (depth - ubo.projection[2][2]);
+  vec2 ndc = gl_FragCoord.xy * ubo.clusterScale.xy / vec2(ubo.clusterGrid.xy) * 2.0 - 1.0;
+  vec3 positionView = vec3(ndc * viewDepth / vec2(ubo.projection[0][0], ubo.projection[1][1]), viewDepth);
+  vec3 fragPosWorld = (ubo.invView * vec4(positionView, 1.0)).xyz;
+
+  vec3 color = subpassLoad(gBufferAlbedo).rgb;
+  vec3 surfaceNormal = decodeNormal(subpassLoad(gBufferNormal).xy);
+  float specularStrength = subpassLoad(gBufferMaterial).x;
+
+  vec3 specularLight = vec3(0.0);
+  vec3 diffuseLight = ubo.ambientLightColor.rgb * ubo.ambientLightColor.a;
+
+  vec3 cameraPosWorld = ubo.invView[3].xyz;
+  vec3 viewDirection = normalize(cameraPosWorld - fragPosWorld);
+
+  // only the lights reaching the cluster of the pixel, see LightClusters::getCluster
+  uvec3 cluster = uvec3(uvec2(gl_FragCoord.xy * ubo.clusterScale.xy), uint(max(log(viewDepth) * ubo.clusterScale.z + ubo.clusterScale.w, 0.0)));
+  cluster = min(cluster, ubo.clusterGrid.xyz - 1u);
+  uvec2 range = clusterRanges[cluster.x + ubo.clusterGrid.x * (cluster.y + ubo.clusterGrid.y * cluster.z)];
+
+  for (uint i = range.x; i < range.x + min(range.y, MAX_LIGHTS); i++) {
+    PointLight light = pointLights[lightIndices[i]];
+    vec3 directionToLight = light.position.xyz - fragPosWorld;
+    float distanceSquared = dot(directionToLight, directionToLight);
+    float attenuation = distanceSquared > 0.001 ? max(light.color.a * (light.position.w + 1.0) / distanceSquared - LIGHT_CUTOFF, 0.0) : 0.0;
+    directionToLight = normalize(directionToLight);
+
+    float cosAngIncidence = max(dot(surfaceNormal, directionToLight), 0);
+
+    if (cosAngIncidence > 0) {
+      vec3 intensity = light.color.rgb * attenuation * getShadow(light.shadow, light.position.xyz, fragPosWorld, surfaceNormal);
+      vec3 halfVector = normalize(directionToLight + viewDirection);
+      float cosAngHalf = max(dot(surfaceNormal, halfVector), 0);
+
+      float specular = pow(cosAngHalf, light.shininess);
+
+      diffuseLight += intensity * cosAngIncidence;
+      specularLight += intensity * specular;
+    }
+  }
+
+  outColor = vec4(diffuseLight * color + specularLight * specularStrength, 1.0);
+}
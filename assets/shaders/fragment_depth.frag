@@ -0,0 +1,15 @@
+#version 450
+
+layout(location = 0) in vec2 fragUv;
+
+layout(set = 1, binding = 1) uniform sampler2D diffuseMap;
+
+// ALPHA_CUTOFF of AlphaMode.hpp
+const float ALPHA_CUTOFF = 0.5;
+
+// depth of the cutout class, the discarded texels leave no depth so the EQUAL lit draw skips them
+void main() {
+  if (texture(diffuseMap, fragUv).a < ALPHA_CUTOFF) {
+    discard;
+  }
+}
@@ -0,0 +1,28 @@
+#version 450
+
+layout(location = 0) in vec3 fragColor;
+layout(location = 1) in vec3 fragPosWorld;
+layout(location = 2) in vec3 fragNormalWorld;
+layout(location = 3) in vec2 fragUv;
+
+// SwapChain GBUFFER_ATTACHMENT order, the position is rebuilt from the depth
+layout(location = 0) out vec4 outAlbedo;
+layout(location = 1) out vec2 outNormal; // octahedral
+layout(location = 2) out vec4 outMaterial; // x: specular strength
+
+layout(set = 1, binding = 1) uniform sampler2D diffuseMap;
+
+// unit vector to the [-1, 1] square: projected on the octahedron, the lower half folded over the upper one
+vec2 encodeNormal(vec3 normal) {
+  normal /= abs(normal.x) + abs(normal.y) + abs(normal.z);
+  vec2 signs = vec2(normal.x >= 0.0 ? 1.0 : -1.0, normal.y >= 0.0 ? 1.0 : -1.0);
+  return normal.z >= 0.0 ? normal.xy : (1.0 - abs(normal.yx)) * signs;
+}
+
+void main() {
+  // no discard, the cutout texels already failed the depth test of the alpha tested depth draw
+  vec4 texColor = texture(diffuseMap, fragUv);
+  outAlbedo = vec4(texColor.rgb, 1.0);
+  outNormal = encodeNormal(normalize(fragNormalWorld));
+  outMaterial = vec4(1.0, 0.0, 0.0, 0.0);
+}
@@ -8,34 +8,87 @@ layout(location = 3) in vec2 fragUv;
 layout(location = 0) out vec4 outColor;
 
 struct PointLight {
-  vec4 position; // ignore w
+  vec4 position; // w is radius
   vec4 color; // w is intensity
   float shininess;
+  float range; // distance where the contribution falls under LIGHT_CUTOFF
+  int shadow; // index in shadowMaps, -1 without shadow
 };
 
+// ShaderVariant specialization constants, the defaults are the ones of ShaderVariant
+layout(constant_id = 0) const uint ALPHA_MODE = 2; // ALPHA_MODE of AlphaMode.hpp, only ALPHA_BLEND (2) reads the texture alpha
+layout(constant_id = 1) const bool SHADOWS = true;
+layout(constant_id = 2) const uint MAX_LIGHTS = 64; // lights of the cluster shaded at most
+
+// LightClusters DEFAULT_LIGHT_CUTOFF, subtracted so the lights fade out at their range instead of being cut
+const float LIGHT_CUTOFF = 1.0 / 256.0;
+
 layout(set = 0, binding = 0) uniform GlobalUbo {
   mat4 projection;
   mat4 view;
   mat4 invView;
   vec4 ambientLightColor; // w is intensity
-  PointLight pointLights[10];
-  int numLights;
+  vec4 frustumPlanes[6];
+  mat4 prevViewProjection; // HiZ pyramid camera
+  uvec4 clusterGrid; // w is the light count
+  vec4 clusterScale; // xy: clusters per pixel, zw: depth slice scale and bias
 } ubo;
 
-layout(set = 1, binding = 1) uniform sampler2D diffuseMap;
+layout(std430, set = 0, binding = 2) readonly buffer Lights {
+  PointLight pointLights[];
+};
+
+// offset and count in lightIndices of the lights of each cluster, written by light_cluster.comp
+layout(std430, set = 0, binding = 3) readonly buffer ClusterRanges {
+  uvec2 clusterRanges[];
+};
+
+layout(std430, set = 0, binding = 4) readonly buffer LightIndices {
+  uint lightIndices[];
+};
+
+struct ShadowMap {
+  mat4 faceViewProjections[6]; // +x, -x, +y, -y, +z, -z, see ShadowCache::getFaceViewProjection
+  vec4 faceRects[6]; // xy: atlas uv of the tile, z: atlas uv size of the tile, w: half texel of the face
+};
+
+// cube shadow maps of the shadow casting lights, see ShadowRenderSystem
+layout(std430, set = 0, binding = 5) readonly buffer ShadowMaps {
+  ShadowMap shadowMaps[];
+};
 
-layout(push_constant) uniform Push {
-  mat4 modelMatrix;
-  mat4 normalMatrix;
-} push;
+layout(set = 0, binding = 6) uniform sampler2DShadow shadowAtlas;
+
+// 1 when lit, filtered over the 2x2 texels of the comparison
+float getShadow(int shadow, vec3 lightPosition, vec3 position, vec3 normal) {
+  if (!SHADOWS || shadow < 0) {
+    return 1.0;
+  }
+  // the face whose axis is the major axis of the direction, as ShadowCache renders them
+  vec3 direction = position - lightPosition;
+  vec3 absDirection = abs(direction);
+  uint face = absDirection.x >= absDirection.y && absDirection.x >= absDirection.z ? (direction.x >= 0.0 ? 0u : 1u)
+    : (absDirection.y >= absDirection.z ? (direction.y >= 0.0 ? 2u : 3u) : (direction.z >= 0.0 ? 4u : 5u));
+  vec4 rect = shadowMaps[shadow].faceRects[face];
+  // pushed out along the normal by about two texels (a face texel covers 4 * rect.w of the distance), against acne on grazing surfaces
+  vec3 offsetPosition = position + normal * (max(absDirection.x, max(absDirection.y, absDirection.z)) * 8.0 * rect.w);
+  vec4 clip = shadowMaps[shadow].faceViewProjections[face] * vec4(offsetPosition, 1.0);
+  vec3 ndc = clip.xyz / clip.w;
+  // the filter must not read the neighbouring tiles
+  vec2 uv = clamp(ndc.xy * 0.5 + 0.5, vec2(rect.w), vec2(1.0 - rect.w));
+  return textureLod(shadowAtlas, vec3(rect.xy + uv * rect.z, ndc.z), 0.0);
+}
+
+layout(set = 1, binding = 1) uniform sampler2D diffuseMap;
 
 void main() {
   vec4 texColor = texture(diffuseMap, fragUv); // Couleur et alpha de la texture
   vec3 color = texColor.rgb;
-  float alpha = texColor.a; // Canal alpha
+  // the opaque and cutout classes are drawn opaque, the cutout holes already failed the depth test
+  float alpha = ALPHA_MODE == 2u ? texColor.a : 1.0; // Canal alpha
 
   // Si le pixel est transparent, on garde la transparence sans éclairage
-  if (alpha < 0.01) {
+  if (ALPHA_MODE == 2u && alpha < 0.01) {
     outColor = vec4(0.0, 0.0, 0.0, 0.0); // Transparent
     return;
   }
@@ -47,17 +100,23 @@ void main() {
   vec3 cameraPosWorld = ubo.invView[3].xyz;
   vec3 viewDirection = normalize(cameraPosWorld - fragPosWorld);
 
-  for (int i = 0; i < ubo.numLights; i++) {
-    PointLight light = ubo.pointLights[i];
+  // only the lights reaching the cluster of the fragment, see LightClusters::getCluster
+  float viewDepth = (ubo.view * vec4(fragPosWorld, 1.0)).z;
+  uvec3 cluster = uvec3(uvec2(gl_FragCoord.xy * ubo.clusterScale.xy), uint(max(log(viewDepth) * ubo.clusterScale.z + ubo.clusterScale.w, 0.0)));
+  cluster = min(cluster, ubo.clusterGrid.xyz - 1u);
+  uvec2 range = clusterRanges[cluster.x + ubo.clusterGrid.x * (cluster.y + ubo.clusterGrid.y * cluster.z)];
+
+  for (uint i = range.x; i < range.x + min(range.y, MAX_LIGHTS); i++) {
+    PointLight light = pointLights[lightIndices[i]];
     vec3 directionToLight = light.position.xyz - fragPosWorld;
     float distanceSquared = dot(directionToLight, directionToLight);
-    float attenuation = distanceSquared > 0.001 ? (light.position.w + 1.0) / distanceSquared : 0.0;
+    float attenuation = distanceSquared > 0.001 ? max(light.color.a * (light.position.w + 1.0) / distanceSquared - LIGHT_CUTOFF, 0.0) : 0.0;
     directionToLight = normalize(directionToLight);
 
     float cosAngIncidence = max(dot(surfaceNormal, directionToLight), 0);
-    vec3 intensity = light.color.rgb * light.color.a * attenuation;
 
     if (cosAngIncidence > 0) {
+      vec3 intensity = light.color.rgb * attenuation * getShadow(light.shadow, light.position.xyz, fragPosWorld, surfaceNormal);
       vec3 halfVector = normalize(directionToLight + viewDirection);
       float cosAngHalf = max(dot(surfaceNormal, halfVector), 0);
 
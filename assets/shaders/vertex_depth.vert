@@ -0,0 +1,32 @@
+#version 450
+
+// DepthVertex stream
+layout(location = 0) in vec3 position;
+layout(location = 1) in vec2 uv;
+
+layout(location = 0) out vec2 fragUv;
+
+// same position as vertex_shader.vert, the lit pass tests it with EQUAL
+invariant gl_Position;
+
+layout(set = 0, binding = 0) uniform GlobalUbo {
+  mat4 projection;
+  mat4 view;
+  mat4 invView;
+  vec4 ambientLightColor; // w is intensity
+  vec4 frustumPlanes[6];
+  mat4 prevViewProjection; // HiZ pyramid camera
+  uvec4 clusterGrid; // w is the light count
+  vec4 clusterScale; // xy: clusters per pixel, zw: depth slice scale and bias
+} ubo;
+
+layout(set = 1, binding = 0) uniform ObjectBufferData {
+  mat4 modelMatrix;
+  mat4 normalMatrix;
+} object;
+
+void main() {
+  vec4 positionWorld = object.modelMatrix * vec4(position, 1.0);
+  gl_Position = ubo.projection * ubo.view * positionWorld;
+  fragUv = uv;
+}
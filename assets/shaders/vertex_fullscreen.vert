@@ -0,0 +1,7 @@
+#version 450
+
+// one triangle covering the screen, counter clockwise: (-1, -1), (-1, 3), (3, -1)
+void main() {
+  vec2 position = vec2((gl_VertexIndex & 2) * 2 - 1, (gl_VertexIndex & 1) * 4 - 1);
+  gl_Position = vec4(position, 0.0, 1.0);
+}
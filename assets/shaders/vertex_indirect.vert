@@ -0,0 +1,50 @@
+#version 450
+
+layout(location = 0) in vec3 position;
+layout(location = 1) in vec3 color;
+layout(location = 2) in vec3 normal;
+layout(location = 3) in vec2 uv;
+
+layout(location = 0) out vec3 fragColor;
+layout(location = 1) out vec3 fragPosWorld;
+layout(location = 2) out vec3 fragNormalWorld;
+layout(location = 3) out vec2 fragUv;
+
+// same position as the depth pre-pass (vertex_depth.vert, vertex_indirect_depth.vert), the lit pass tests it with EQUAL
+invariant gl_Position;
+
+layout(set = 0, binding = 0) uniform GlobalUbo {
+  mat4 projection;
+  mat4 view;
+  mat4 invView;
+  vec4 ambientLightColor; // w is intensity
+  vec4 frustumPlanes[6];
+  mat4 prevViewProjection; // HiZ pyramid camera
+  uvec4 clusterGrid; // w is the light count
+  vec4 clusterScale; // xy: clusters per pixel, zw: depth slice scale and bias
+} ubo;
+
+struct Instance {
+  mat4 modelMatrix;
+  mat4 normalMatrix;
+  vec4 sphere;
+  uint firstIndex;
+  uint indexCount;
+  uint drawOffset;
+  uint bucket;
+};
+
+// firstInstance of each indirect command written by culling.comp is the instance index
+layout(std430, set = 1, binding = 0) readonly buffer Instances {
+  Instance instances[];
+};
+
+void main() {
+  Instance instance = instances[gl_InstanceIndex];
+  vec4 positionWorld = instance.modelMatrix * vec4(position, 1.0);
+  gl_Position = ubo.projection * ubo.view * positionWorld;
+  fragNormalWorld = normalize(mat3(instance.normalMatrix) * normal);
+  fragPosWorld = positionWorld.xyz;
+  fragColor = color;
+  fragUv = uv;
+}
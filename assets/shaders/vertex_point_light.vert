@@ -10,11 +10,14 @@ vec2(1.0, 1.0)
 );
 
 layout(location = 0) out vec2 fragOffset;
+layout(location = 1) out vec4 fragColor;
 
 struct PointLight {
-    vec4 position; // ignore w
+    vec4 position; // w is radius
     vec4 color; // w is intensity
     float shininess;
+    float range;
+    int shadow; // index of the shadow map, -1 without shadow
 };
 
 layout(set = 0, binding = 0) uniform GlobalUbo {
@@ -22,24 +25,31 @@ layout(set = 0, binding = 0) uniform GlobalUbo {
     mat4 view;
     mat4 invView;
     vec4 ambientLightColor; // w is intensity
-    PointLight pointLights[10];
-    int numLights;
+    vec4 frustumPlanes[6];
+    mat4 prevViewProjection; // HiZ pyramid camera
+    uvec4 clusterGrid; // w is the light count
+    vec4 clusterScale; // xy: clusters per pixel, zw: depth slice scale and bias
 } ubo;
 
-layout(push_constant) uniform Push {
-    vec4 position;
-    vec4 color;
-    float radius;
-} push;
+layout(std430, set = 0, binding = 2) readonly buffer Lights {
+    PointLight pointLights[];
+};
+
+// lights in the frustum, farthest first, one instance each
+layout(std430, set = 1, binding = 0) readonly buffer Order {
+    uint lightOrder[];
+};
 
 void main() {
+    PointLight light = pointLights[lightOrder[gl_InstanceIndex]];
     fragOffset = OFFSETS[gl_VertexIndex];
+    fragColor = light.color;
     vec3 cameraRightWorld = vec3(ubo.view[0][0], ubo.view[1][0], ubo.view[2][0]);
     vec3 cameraUpWorld = vec3(ubo.view[0][1], ubo.view[1][1], ubo.view[2][1]);
 
-    vec3 positionWorld = push.position.xyz
-    + push.radius * fragOffset.x * cameraRightWorld
-    + push.radius * fragOffset.y * cameraUpWorld;
+    vec3 positionWorld = light.position.xyz
+    + light.position.w * fragOffset.x * cameraRightWorld
+    + light.position.w * fragOffset.y * cameraUpWorld;
 
     gl_Position = ubo.projection * ubo.view * vec4(positionWorld, 1.0);
 }
@@ -10,19 +10,18 @@ layout(location = 1) out vec3 fragPosWorld;
 layout(location = 2) out vec3 fragNormalWorld;
 layout(location = 3) out vec2 fragUv;
 
-struct PointLight {
-  vec4 position; // ignore w
-  vec4 color; // w is intensity
-  float shininess;
-};
+// same position as the depth pre-pass (vertex_depth.vert, vertex_indirect_depth.vert), the lit pass tests it with EQUAL
+invariant gl_Position;
 
 layout(set = 0, binding = 0) uniform GlobalUbo {
   mat4 projection;
   mat4 view;
   mat4 invView;
   vec4 ambientLightColor; // w is intensity
-  PointLight pointLights[10];
-  int numLights;
+  vec4 frustumPlanes[6];
+  mat4 prevViewProjection; // HiZ pyramid camera
+  uvec4 clusterGrid; // w is the light count
+  vec4 clusterScale; // xy: clusters per pixel, zw: depth slice scale and bias
 } ubo;
 
 layout(set = 1, binding = 0) uniform ObjectBufferData {
@@ -30,11 +29,6 @@ layout(set = 1, binding = 0) uniform ObjectBufferData {
   mat4 normalMatrix;
 } object;
 
-layout(push_constant) uniform Push {
-  mat4 modelMatrix;
-  mat4 normalMatrix;
-} push;
-
 void main() {
   vec4 positionWorld = object.modelMatrix * vec4(position, 1.0);
   gl_Position = ubo.projection * ubo.view * positionWorld;
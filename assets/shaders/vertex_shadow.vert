@@ -0,0 +1,13 @@
+#version 450
+
+// DepthVertex stream, the casters are drawn without alpha test
+layout(location = 0) in vec3 position;
+
+layout(push_constant) uniform Push {
+  mat4 viewProjection; // cube face of the light, see ShadowCache::getFaceViewProjection
+  mat4 modelMatrix;
+} push;
+
+void main() {
+  gl_Position = push.viewProjection * push.modelMatrix * vec4(position, 1.0);
+}
@@ -0,0 +1,9 @@
+SET(BINARY_NAME_BENCHMARKS ${PROJECT_NAME}-benchmarks)
+
+file(GLOB_RECURSE SOURCES_BENCHMARKS ${CMAKE_SOURCE_DIR}/tests/benchmarks/*.cpp)
+
+# not registered with ctest, the timings are only meaningful on an idle machine in a release build
+add_executable(${BINARY_NAME_BENCHMARKS} ${SOURCES_BENCHMARKS} ${SOURCES_CPU})
+
+target_link_libraries(${BINARY_NAME_BENCHMARKS} PRIVATE ${THIRDPARTY_LIBRARIES} gtest gtest_main)
+target_include_directories(${BINARY_NAME_BENCHMARKS} PRIVATE ${gtest_SOURCE_DIR}/googletest/include ${INCLUDE_DIR})
@@ -1,13 +1,19 @@
 file(MAKE_DIRECTORY ${SHADER_BIN_DIR})
 
-file(GLOB SHADERS ${SHADER_SRC_DIR}/*.vert ${SHADER_SRC_DIR}/*.frag)
+file(GLOB SHADERS ${SHADER_SRC_DIR}/*.vert ${SHADER_SRC_DIR}/*.frag ${SHADER_SRC_DIR}/*.comp ${SHADER_SRC_DIR}/*.task ${SHADER_SRC_DIR}/*.mesh)
 
 foreach(SHADER ${SHADERS})
     get_filename_component(FILE_NAME ${SHADER} NAME_WE)
+    get_filename_component(FILE_EXT ${SHADER} EXT)
     set(SPIRV_BINARY ${SHADER_BIN_DIR}/${FILE_NAME}.spv)
+    # VK_EXT_mesh_shader requires SPIR-V 1.4
+    set(SHADER_TARGET_ENV "")
+    if(FILE_EXT STREQUAL ".task" OR FILE_EXT STREQUAL ".mesh")
+        set(SHADER_TARGET_ENV --target-env spirv1.4)
+    endif()
     add_custom_command(
             OUTPUT ${SPIRV_BINARY}
-            COMMAND glslangValidator -V ${SHADER} -o ${SPIRV_BINARY}
+            COMMAND glslangValidator -V ${SHADER_TARGET_ENV} ${SHADER} -o ${SPIRV_BINARY}
             DEPENDS ${SHADER}
             COMMENT "Compiling shader ${FILE_NAME}"
             VERBATIM
@@ -2,6 +2,7 @@
 option(USE_CLANG_TIDY "Use Clang-tidy" OFF)
 option(BUILD_DOC "Build documentation only" OFF)
 option(BUILD_TESTS "Build tests" OFF)
+option(BUILD_BENCHMARKS "Build benchmarks" OFF)
 
 #======================================= Variables ======================================#
 set(CMAKE_CXX_STANDARD 20)
@@ -52,3 +53,45 @@ if(WIN32)
 endif()
 
 file(GLOB_RECURSE SOURCES ${SRC_DIR}/*.cpp)
+
+# engine sources that need neither a window nor a device, built into the tests and the benchmarks
+set(SOURCES_CPU
+	${SRC_DIR}/Scene/camera.cpp
+	${SRC_DIR}/Scene/frustum.cpp
+	${SRC_DIR}/Scene/culler.cpp
+	${SRC_DIR}/Scene/occlusionCuller.cpp
+	${SRC_DIR}/Scene/occlusionCullerAvx2.cpp
+	${SRC_DIR}/Utils/simd.cpp
+	${SRC_DIR}/Utils/threadPool.cpp
+	${SRC_DIR}/Utils/logger.cpp
+	${SRC_DIR}/Scene/pvs.cpp
+	${SRC_DIR}/Scene/sceneGraph.cpp
+	${SRC_DIR}/Scene/Entities/object.cpp
+	${SRC_DIR}/Scene/spatialIndex.cpp
+	${SRC_DIR}/Scene/transformBatch.cpp
+	${SRC_DIR}/Scene/transformBatchSse4.cpp
+	${SRC_DIR}/Scene/transformBatchAvx2.cpp
+	${SRC_DIR}/Scene/sceneFile.cpp
+	${SRC_DIR}/Utils/mappedFile.cpp
+	${SRC_DIR}/Scene/meshSimplifier.cpp
+	${SRC_DIR}/Scene/lodSelector.cpp
+	${SRC_DIR}/Scene/meshlet.cpp
+	${SRC_DIR}/Scene/meshOptimizer.cpp
+	${SRC_DIR}/Scene/lightClusters.cpp
+	${SRC_DIR}/Gfx/alphaMode.cpp
+	${SRC_DIR}/Gfx/shaderVariant.cpp
+	${SRC_DIR}/Gfx/pipelineCacheFile.cpp
+	${SRC_DIR}/Gfx/shaderReflection.cpp
+	${SRC_DIR}/Scene/shadowAtlas.cpp
+	${SRC_DIR}/Scene/shadowCache.cpp
+)
+
+# SIMD kernels get their instruction set per file, the engine picks one at runtime
+if (CMAKE_SYSTEM_PROCESSOR MATCHES "x86_64|AMD64|i.86")
+	if (MSVC)
+		set_source_files_properties(${SRC_DIR}/Scene/transformBatchAvx2.cpp ${SRC_DIR}/Scene/occlusionCullerAvx2.cpp PROPERTIES COMPILE_OPTIONS "/arch:AVX2")
+	else()
+		set_source_files_properties(${SRC_DIR}/Scene/transformBatchSse4.cpp PROPERTIES COMPILE_OPTIONS "-msse4.1")
+		set_source_files_properties(${SRC_DIR}/Scene/transformBatchAvx2.cpp ${SRC_DIR}/Scene/occlusionCullerAvx2.cpp PROPERTIES COMPILE_OPTIONS "-mavx2;-mfma")
+	endif()
+endif()
@@ -6,12 +6,20 @@
 
 #pragma once
 
+#include <memory>
+#include <string_view>
 #include <vector>
 
 #include "VEngine/Core/Window.hpp"
+#include "VEngine/Gfx/PipelineCacheFile.hpp"
+#include "VEngine/Utils/ThreadPool.hpp"
 
 namespace ven {
 
+    class DescriptorLayoutCache;
+
+    static constexpr std::string_view PIPELINE_CACHE_PATH = "build/pipeline_cache.bin";
+
     struct SwapChainSupportDetails {
         VkSurfaceCapabilitiesKHR capabilities;
         std::vector<VkSurfaceFormatKHR> formats;
@@ -60,8 +68,36 @@ namespace ven {
             [[nodiscard]] const VkQueue& getGraphicsQueue() const { return m_graphicsQueue; }
             [[nodiscard]] SwapChainSupportDetails getSwapChainSupport() const { return querySwapChainSupport(m_physicalDevice); }
             [[nodiscard]] QueueFamilyIndices findPhysicalQueueFamilies() const { return findQueueFamilies(m_physicalDevice); }
+            [[nodiscard]] bool hasDrawIndirectCount() const { return m_drawIndirectCount; }
+            [[nodiscard]] bool hasMeshShader() const { return m_meshShader; }
+            [[nodiscard]] bool hasPipelineStatistics() const { return m_pipelineStatistics; }
+            ///
+            /// @brief Pipeline cache shared by every pipeline creation, loaded from PIPELINE_CACHE_PATH and saved back on destruction
+            ///
+            [[nodiscard]] VkPipelineCache getPipelineCache() const { return m_pipelineCache; }
+            ///
+            /// @return Size of the cache data loaded from disk, 0 on a cold start
+            ///
+            [[nodiscard]] std::size_t getPipelineCacheLoadedSize() const { return m_pipelineCacheLoadedSize; }
+            ///
+            /// @brief Workers the pipelines are compiled on, apart from the frame ones so a compilation never delays a parallelFor
+            /// @note vkCreate*Pipelines may run on several threads at once, the pipeline cache is internally synchronized
+            ///
+            [[nodiscard]] ThreadPool& getPipelineThreadPool() const { return *m_pipelineThreadPool; }
+            ///
+            /// @brief Descriptor set layouts and pipeline layouts shared by the render systems, built from the reflection of their shaders
+            ///
+            [[nodiscard]] DescriptorLayoutCache& getLayoutCache() const;
+            ///
+            /// @brief vkCmdDrawMeshTasksEXT, only valid when hasMeshShader is true
+            ///
+            void drawMeshTasks(const VkCommandBuffer commandBuffer, const uint32_t groupCountX) const { m_vkCmdDrawMeshTasks(commandBuffer, groupCountX, 1, 1); }
 
             [[nodiscard]] uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const;
+            ///
+            /// @brief Check for a memory type of typeFilter holding the given properties, VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT is only exposed by tiled GPUs
+            ///
+            [[nodiscard]] bool hasMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const;
             [[nodiscard]] VkFormat findSupportedFormat(const std::vector<VkFormat> &candidates, VkImageTiling tiling, VkFormatFeatureFlags features) const;
 
             void createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer &buffer, VkDeviceMemory &bufferMemory) const;
@@ -69,7 +105,10 @@ namespace ven {
             void endSingleTimeCommands(VkCommandBuffer commandBuffer) const;
             void copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size) const;
             void copyBufferToImage(VkBuffer buffer, VkImage image, uint32_t width, uint32_t height, uint32_t layerCount) const;
-            void createImageWithInfo(const VkImageCreateInfo &imageInfo, VkMemoryPropertyFlags properties, VkImage &image, VkDeviceMemory &imageMemory) const;
+            ///
+            /// @param preferredProperties Added to properties when one of the memory types the image accepts has both, ignored otherwise
+            ///
+            void createImageWithInfo(const VkImageCreateInfo &imageInfo, VkMemoryPropertyFlags properties, VkImage &image, VkDeviceMemory &imageMemory, VkMemoryPropertyFlags preferredProperties = 0) const;
             void transitionImageLayout(VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout, uint32_t mipLevels = 1, uint32_t layerCount = 1) const;
 
         private:
@@ -79,6 +118,9 @@ namespace ven {
             void pickPhysicalDevice();
             void createLogicalDevice();
             void createCommandPool();
+            void createPipelineCache();
+            void savePipelineCache() const;
+            [[nodiscard]] PipelineCacheIdentity getPipelineCacheIdentity() const;
 
             [[nodiscard]] bool isDeviceSuitable(VkPhysicalDevice device) const;
             [[nodiscard]] std::vector<const char *> getRequiredExtensions() const;
@@ -87,6 +129,7 @@ namespace ven {
             static void populateDebugMessengerCreateInfo(VkDebugUtilsMessengerCreateInfoEXT &createInfo);
             void hasGlfwRequiredInstanceExtensions() const;
             bool checkDeviceExtensionSupport(VkPhysicalDevice device) const;
+            [[nodiscard]] static bool hasDeviceExtension(VkPhysicalDevice device, std::string_view extension);
             [[nodiscard]] SwapChainSupportDetails querySwapChainSupport(VkPhysicalDevice device) const;
 
             const Window &m_window;
@@ -99,6 +142,14 @@ namespace ven {
             VkQueue m_graphicsQueue;
             VkQueue m_presentQueue;
             VkPhysicalDeviceProperties m_properties;
+            VkPipelineCache m_pipelineCache{nullptr};
+            std::size_t m_pipelineCacheLoadedSize{0};
+            bool m_drawIndirectCount{false};
+            bool m_meshShader{false};
+            bool m_pipelineStatistics{false};
+            PFN_vkCmdDrawMeshTasksEXT m_vkCmdDrawMeshTasks{nullptr};
+            std::unique_ptr<DescriptorLayoutCache> m_layoutCache;
+            std::unique_ptr<ThreadPool> m_pipelineThreadPool{std::make_unique<ThreadPool>(std::max(1U, std::thread::hardware_concurrency() / 2))};
 
             const std::vector<const char *> m_validationLayers = {"VK_LAYER_KHRONOS_validation"};
             const std::vector<const char *> m_deviceExtensions = {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
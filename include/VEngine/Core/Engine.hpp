@@ -7,7 +7,16 @@
 #pragma once
 
 #include "VEngine/Core/Gui.hpp"
+#include "VEngine/Core/RenderSystem/DeferredLighting.hpp"
+#include "VEngine/Core/RenderSystem/Indirect.hpp"
+#include "VEngine/Core/RenderSystem/LightCluster.hpp"
+#include "VEngine/Core/RenderSystem/Meshlet.hpp"
 #include "VEngine/Core/RenderSystem/Object.hpp"
+#include "VEngine/Core/RenderSystem/PointLight.hpp"
+#include "VEngine/Core/RenderSystem/Shadow.hpp"
+#include "VEngine/Gfx/Descriptors/LayoutCache.hpp"
+#include "VEngine/Gfx/ShaderReflection.hpp"
+#include "VEngine/Utils/Clock.hpp"
 #include "VEngine/Utils/Utils.hpp"
 #include "VEngine/Utils/Config.hpp"
 
@@ -32,23 +41,58 @@ namespace ven {
 
             void run();
 
+            ///
+            /// @brief Bake the potentially visible sets of the models of config.scenePath (the default scene if empty) and save them next to the models
+            /// @note offline, only the meshes are loaded so no window nor device is created
+            ///
+            static void bakePvs(const Config& config);
+
         private:
 
+            static constexpr std::string_view DEFAULT_MODEL_PATH = "assets/models/sponza/sponza.obj";
+
             void loadObjects();
 
             ENGINE_STATE m_state{EXIT};
 
+            Clock m_startupClock; // until the device and the render systems are created, compared between cold and warm pipeline caches
             Window m_window;
             Camera m_camera;
             Gui m_gui;
             Device m_device{m_window};
             SceneManager m_sceneManager{m_device};
             Renderer m_renderer{m_window, m_device};
-            std::unique_ptr<DescriptorPool> m_globalPool;
             std::vector<std::unique_ptr<DescriptorPool>> m_framePools;
+            FrustumCuller m_culler;
+            LodSelector m_lodSelector;
+            LightClusters m_lightClusters;
+            ThreadPool m_threadPool;
+            OcclusionCuller m_occlusionCuller{DEFAULT_OCCLUSION_WIDTH, DEFAULT_OCCLUSION_HEIGHT, &m_threadPool};
+            PipelineStatistics m_pipelineStatistics{m_device};
 
-            std::unique_ptr<DescriptorSetLayout> m_globalSetLayout{DescriptorSetLayout::Builder(m_device).addBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT).addBinding(1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT).build()};
+            // 0: GlobalUbo, 2: lights, 3: cluster ranges, 4: cluster light indices, 5: shadow maps, 6: shadow atlas, rebuilt every frame as the light buffers grow
+            // the bindings and their stages are the ones the shaders the device can run read from set 0
+            std::shared_ptr<DescriptorSetLayout> m_globalSetLayout{m_device.getLayoutCache().getSetLayout(ShaderReflection::fromDirectory(SHADERS_BIN_PATH,
+                VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT | (m_device.hasMeshShader() ? VK_SHADER_STAGE_TASK_BIT_EXT | VK_SHADER_STAGE_MESH_BIT_EXT : 0U)).getSetBindings(0))};
+            LightClusterRenderSystem m_lightClusterRenderSystem{m_device, m_globalSetLayout->getDescriptorSetLayout()};
+            ShadowRenderSystem m_shadowRenderSystem{m_device, m_globalSetLayout->getDescriptorSetLayout()};
             ObjectRenderSystem m_objectRenderSystem{m_device, m_renderer.getSwapChainRenderPass(), m_globalSetLayout->getDescriptorSetLayout()};
+            ObjectRenderSystem m_depthObjectRenderSystem{m_device, m_renderer.getSwapChainRenderPass(), m_globalSetLayout->getDescriptorSetLayout(), GEOMETRY_DEPTH_PREPASS};
+            ObjectRenderSystem m_equalObjectRenderSystem{m_device, m_renderer.getSwapChainRenderPass(), m_globalSetLayout->getDescriptorSetLayout(), GEOMETRY_FORWARD_EQUAL};
+            HiZRenderSystem m_hizRenderSystem{m_device, m_globalSetLayout->getDescriptorSetLayout()};
+            CullingRenderSystem m_cullingRenderSystem{m_device, m_globalSetLayout->getDescriptorSetLayout(), m_sceneManager.getTextureDefault(), m_hizRenderSystem};
+            IndirectRenderSystem m_indirectRenderSystem{m_device, m_renderer.getSwapChainRenderPass(), m_globalSetLayout->getDescriptorSetLayout(), m_cullingRenderSystem};
+            IndirectRenderSystem m_depthIndirectRenderSystem{m_device, m_renderer.getSwapChainRenderPass(), m_globalSetLayout->getDescriptorSetLayout(), m_cullingRenderSystem, GEOMETRY_DEPTH_PREPASS};
+            IndirectRenderSystem m_equalIndirectRenderSystem{m_device, m_renderer.getSwapChainRenderPass(), m_globalSetLayout->getDescriptorSetLayout(), m_cullingRenderSystem, GEOMETRY_FORWARD_EQUAL};
+            MeshletCullingRenderSystem m_meshletCullingRenderSystem{m_device, m_globalSetLayout->getDescriptorSetLayout(), m_sceneManager.getTextureDefault()};
+            MeshletRenderSystem m_meshletRenderSystem{m_device, m_renderer.getSwapChainRenderPass(), m_globalSetLayout->getDescriptorSetLayout(), m_meshletCullingRenderSystem};
+            // deferred path: the same draws into the G-buffer, then the lighting subpass
+            ObjectRenderSystem m_gBufferObjectRenderSystem{m_device, m_renderer.getDeferredRenderPass(), m_globalSetLayout->getDescriptorSetLayout(), GEOMETRY_GBUFFER};
+            IndirectRenderSystem m_gBufferIndirectRenderSystem{m_device, m_renderer.getDeferredRenderPass(), m_globalSetLayout->getDescriptorSetLayout(), m_cullingRenderSystem, GEOMETRY_GBUFFER};
+            ObjectRenderSystem m_blendObjectRenderSystem{m_device, m_renderer.getSwapChainRenderPass(), m_globalSetLayout->getDescriptorSetLayout(), GEOMETRY_FORWARD_BLEND};
+            IndirectRenderSystem m_blendIndirectRenderSystem{m_device, m_renderer.getSwapChainRenderPass(), m_globalSetLayout->getDescriptorSetLayout(), m_cullingRenderSystem, GEOMETRY_FORWARD_BLEND};
+            DeferredLightingRenderSystem m_deferredLightingRenderSystem{m_device, m_renderer.getDeferredRenderPass(), m_globalSetLayout->getDescriptorSetLayout()};
+            PointLightRenderSystem m_pointLightRenderSystem{m_device, m_renderer.getSwapChainRenderPass(), m_globalSetLayout->getDescriptorSetLayout()};
     }; // class Engine
 
 } // namespace ven
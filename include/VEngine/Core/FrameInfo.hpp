@@ -7,6 +7,12 @@
 #pragma once
 
 #include "VEngine/Gfx/Descriptors/Pool.hpp"
+#include "VEngine/Gfx/ShaderVariant.hpp"
+#include "VEngine/Scene/Culler.hpp"
+#include "VEngine/Scene/LightClusters.hpp"
+#include "VEngine/Scene/LodSelector.hpp"
+#include "VEngine/Scene/OcclusionCuller.hpp"
+#include "VEngine/Scene/ShadowCache.hpp"
 #include "VEngine/Scene/Entities/Object.hpp"
 #include "VEngine/Scene/Entities/Light.hpp"
 
@@ -15,12 +21,15 @@ namespace ven {
 static constexpr float DEFAULT_AMBIENT_LIGHT_INTENSITY = .2F;
 static constexpr glm::vec4 DEFAULT_AMBIENT_LIGHT_COLOR = {glm::vec3(1.F), DEFAULT_AMBIENT_LIGHT_INTENSITY};
 
+    // must match the PointLight struct of the shaders (std430)
     struct PointLightData
     {
-        glm::vec4 position{};
-        glm::vec4 color{};
+        glm::vec4 position{}; // w is the radius
+        glm::vec4 color{}; // w is the intensity
         float shininess{32.F};
-        float padding[3]; // Pad to 32 bytes
+        float range{0.F}; // see LightClusters::getRange
+        int32_t shadow{-1}; // index in the buffer of ShadowRenderSystem, see ShadowCache::getLightShadows
+        float padding; // Pad to 48 bytes
     };
 
     struct ObjectBufferData {
@@ -34,8 +43,10 @@ static constexpr glm::vec4 DEFAULT_AMBIENT_LIGHT_COLOR = {glm::vec3(1.F), DEFAUL
         glm::mat4 view{1.F};
         glm::mat4 inverseView{1.F};
         glm::vec4 ambientLightColor{DEFAULT_AMBIENT_LIGHT_COLOR};
-        std::array<PointLightData, MAX_LIGHTS> pointLights;
-        uint8_t numLights;
+        std::array<glm::vec4, PLANE_COUNT> frustumPlanes{};
+        glm::mat4 prevViewProjection{1.F};
+        glm::uvec4 clusterGrid{CLUSTER_GRID_X, CLUSTER_GRID_Y, CLUSTER_GRID_Z, 0}; // w is the light count
+        glm::vec4 clusterScale{0.F}; // see LightClusters::getScale
     };
 
     struct FrameInfo
@@ -44,8 +55,13 @@ static constexpr glm::vec4 DEFAULT_AMBIENT_LIGHT_COLOR = {glm::vec3(1.F), DEFAUL
         VkCommandBuffer commandBuffer;
         VkDescriptorSet globalDescriptorSet;
         DescriptorPool &frameDescriptorPool;
-        Object::Map &objects;
-        Light::Map &lights;
+        ObjectStore &objects;
+        LightStore &lights;
+        FrustumCuller &culler;
+        OcclusionCuller &occlusionCuller;
+        LodSelector &lodSelector;
+        const ShadowCache &shadowCache;
+        ShaderVariant shaderVariant{}; // lighting constants the lit pipelines are bound with
     };
 
 } // namespace ven
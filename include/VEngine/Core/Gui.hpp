@@ -8,8 +8,12 @@
 
 #include <imgui.h>
 
+#include "VEngine/Gfx/PipelineStatistics.hpp"
 #include "VEngine/Gfx/Renderer.hpp"
 #include "VEngine/Scene/Camera.hpp"
+#include "VEngine/Scene/Culler.hpp"
+#include "VEngine/Scene/LodSelector.hpp"
+#include "VEngine/Scene/OcclusionCuller.hpp"
 #include "VEngine/Scene/Manager.hpp"
 
 namespace ven {
@@ -36,7 +40,7 @@ namespace ven {
 
         public:
 
-            Gui() = default;
+            Gui() { DEFAULT_SCENE_PATH.copy(m_scenePath.data(), m_scenePath.size() - 1); }
             ~Gui() = default;
 
             Gui(const Gui&) = delete;
@@ -46,24 +50,42 @@ namespace ven {
 
             void init(GLFWwindow* window, VkInstance instance, const Device* device);
 
-            void render(Renderer *renderer, SceneManager& sceneManager, Camera& camera, VkPhysicalDevice physicalDevice, GlobalUbo& ubo, const ClockData& clockData);
+            void render(Renderer *renderer, SceneManager& sceneManager, Camera& camera, FrustumCuller& culler, OcclusionCuller& occlusionCuller, LodSelector& lodSelector, const PipelineStatistics& pipelineStatistics, VkPhysicalDevice physicalDevice, GlobalUbo& ubo, const ClockData& clockData);
             static void cleanup();
 
             void setState(const GUI_STATE state) { m_state = state; }
             [[nodiscard]] GUI_STATE getState() const { return m_state; }
-            [[nodiscard]] std::vector<unsigned int> &getObjectsToRemove() { return m_objectsToRemove; }
-            [[nodiscard]] std::vector<unsigned int> &getLightsToRemove() { return m_lightsToRemove; }
+            [[nodiscard]] bool useGpuCulling() const { return m_gpuCulling; }
+            [[nodiscard]] bool useOcclusionCulling() const { return m_occlusionCulling; }
+            [[nodiscard]] bool useMeshletRendering() const { return m_meshletRendering; }
+            [[nodiscard]] bool useDeferredShading() const { return m_deferredShading; }
+            [[nodiscard]] bool useDepthPrepass() const { return m_depthPrepass; }
+            [[nodiscard]] uint32_t getMaxFragmentLights() const { return static_cast<uint32_t>(m_maxFragmentLights); }
+            [[nodiscard]] std::vector<Handle> &getObjectsToRemove() { return m_objectsToRemove; }
+            [[nodiscard]] std::vector<Handle> &getLightsToRemove() { return m_lightsToRemove; }
 
         private:
 
             static void initStyle();
             static void renderFrameWindow(const ClockData& clockData);
             static void cameraSection(Camera& camera);
+            void cullingSection(const SceneManager& sceneManager, FrustumCuller& culler, OcclusionCuller& occlusionCuller);
+            static void lodSection(LodSelector& lodSelector);
             static void inputsSection(const ImGuiIO& io);
-            static void rendererSection(Renderer *renderer, GlobalUbo& ubo);
+            void rendererSection(Renderer *renderer, const PipelineStatistics& pipelineStatistics, GlobalUbo& ubo);
             static void devicePropertiesSection(VkPhysicalDeviceProperties deviceProperties);
             void objectsSection(SceneManager& sceneManager);
+            ///
+            /// @brief Select the object under the mouse cursor by casting a ray into the spatial index
+            ///
+            void pickObject(const SceneManager& sceneManager, const Camera& camera);
             void lightsSection(SceneManager& sceneManager);
+            void sceneSection(SceneManager& sceneManager);
+            ///
+            /// @brief Combo listing the objects a node can be attached to
+            /// @return true if another parent was picked
+            ///
+            static bool parentCombo(const std::string& label, const ObjectStore& objects, uint32_t node, uint32_t& parent);
 
             struct funcs { static bool IsLegacyNativeDupe(const ImGuiKey key) { return key >= 0 && key < 512 && ImGui::GetIO().KeyMap[key] != -1; } }; // Hide Native<>ImGuiKey duplicates when both exist
 
@@ -71,9 +93,17 @@ namespace ven {
             GUI_STATE m_state{SHOW_EDITOR};
             float m_intensity{1.0F};
             float m_shininess{DEFAULT_SHININESS};
-
-            std::vector<unsigned int> m_objectsToRemove;
-            std::vector<unsigned int> m_lightsToRemove;
+            bool m_gpuCulling{true};
+            bool m_occlusionCulling{true};
+            bool m_meshletRendering{false};
+            bool m_deferredShading{false};
+            bool m_depthPrepass{false};
+            int m_maxFragmentLights{DEFAULT_MAX_FRAGMENT_LIGHTS};
+
+            std::array<char, 256> m_scenePath{};
+            Handle m_selectedObject;
+            std::vector<Handle> m_objectsToRemove;
+            std::vector<Handle> m_lightsToRemove;
 
     }; // class Gui
 
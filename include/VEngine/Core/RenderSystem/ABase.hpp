@@ -6,12 +6,35 @@
 
 #pragma once
 
+#include <cassert>
+
 #include "VEngine/Core/FrameInfo.hpp"
+#include "VEngine/Gfx/AlphaMode.hpp"
 #include "VEngine/Gfx/Descriptors/SetLayout.hpp"
-#include "VEngine/Gfx/Shaders.hpp"
+#include "VEngine/Gfx/ShaderVariantCache.hpp"
 
 namespace ven {
 
+    ///
+    /// @brief Pipeline variant of the render systems drawing the scene geometry
+    ///
+    enum GEOMETRY_PASS : uint8_t {
+        GEOMETRY_FORWARD = 0, // lit, depth tested and written
+        GEOMETRY_DEPTH_PREPASS = 1, // depth only, from the depth stream of the models, without the blended class
+        GEOMETRY_FORWARD_EQUAL = 2, // lit after a GEOMETRY_DEPTH_PREPASS, only the fragments left in the depth buffer are shaded
+        GEOMETRY_GBUFFER = 3, // first subpass of the deferred render pass, without the blended class
+        GEOMETRY_FORWARD_BLEND = 4 // the blended class alone, drawn forward over the shaded G-buffer
+    };
+
+    ///
+    /// @brief One pipeline of a geometry pass with the alpha classes it draws, the pipelines of a pass are recorded in order
+    ///
+    struct GeometryPipeline {
+        std::unique_ptr<ShaderVariantCache> shaders; // the lit ones follow the lighting constants of FrameInfo::shaderVariant
+        uint8_t alphaModes{0}; // bit per ALPHA_MODE
+        bool depthStream{false}; // reads the DepthVertex stream of the models
+    };
+
     ///
     /// @class ARenderSystemBase
     /// @brief Abstract class for render system base
@@ -22,7 +45,7 @@ namespace ven {
         public:
 
             explicit ARenderSystemBase(const Device& device) : m_device{device} {}
-            virtual ~ARenderSystemBase() { vkDestroyPipelineLayout(m_device.device(), m_pipelineLayout, nullptr); }
+            virtual ~ARenderSystemBase() = default;
 
             ARenderSystemBase(const ARenderSystemBase&) = delete;
             ARenderSystemBase& operator=(const ARenderSystemBase&) = delete;
@@ -33,20 +56,53 @@ namespace ven {
 
         protected:
 
-            void createPipelineLayout(VkDescriptorSetLayout globalSetLayout, uint32_t pushConstantSize);
-            void createPipeline(VkRenderPass renderPass, const std::string &shadersVertPath, const std::string &shadersFragPath, bool isLight);
+            ///
+            /// @brief Create the pipeline layout (set 0 = global, set 1 = renderSystemLayout) from the reflection of the shaders the pipelines of the system are built from
+            /// @note renderSystemLayout and the push constant range hold what these shaders read, both come from the layout cache of the device and are shared with the systems reading the same
+            ///
+            void createPipelineLayout(VkDescriptorSetLayout globalSetLayout, const std::vector<std::string> &shaderPaths);
+            ///
+            /// @param variantConstants Bit per SHADER_CONSTANT the pipeline takes from the variant it is bound with
+            ///
+            void createPipeline(VkRenderPass renderPass, const std::string &shadersVertPath, const std::string &shadersFragPath, bool isLight, uint32_t subpass = 0, uint8_t variantConstants = 0);
+            ///
+            /// @brief Create the pipeline layout and the pipelines of a geometry pass: opaque without blending, cutout as an alpha tested depth draw then an EQUAL lit draw, blended without depth writes
+            /// @param shadersDepthVertPath vertex shader reading the DepthVertex stream, used by the depth only pipelines
+            ///
+            void createGeometryPipelines(VkDescriptorSetLayout globalSetLayout, VkRenderPass renderPass, const std::string &shadersVertPath, const std::string &shadersDepthVertPath, GEOMETRY_PASS pass);
+            ///
+            /// @brief Create a depth only pipeline drawing the DepthVertex stream from both sides with a depth bias, without color attachment
+            ///
+            void createShadowPipeline(VkRenderPass renderPass, const std::string &shadersVertPath);
+            void createMeshPipeline(VkRenderPass renderPass, const std::string &shadersTaskPath, const std::string &shadersMeshPath, const std::string &shadersFragPath, uint8_t variantConstants = 0);
+            void createComputePipeline(const std::string &shadersCompPath);
 
             [[nodiscard]] const Device& getDevice() const { return m_device; }
             [[nodiscard]] const VkPipelineLayout& getPipelineLayout() const { return m_pipelineLayout; }
-            [[nodiscard]] const std::unique_ptr<Shaders>& getShaders() const { return m_shaders; }
-
-            std::unique_ptr<DescriptorSetLayout> renderSystemLayout;
+            [[nodiscard]] const VkPushConstantRange& getPushConstantRange() const { return m_pushConstantRange; }
+            [[nodiscard]] const std::unique_ptr<ShaderVariantCache>& getShaders() const { return m_shaders; }
+            [[nodiscard]] const std::vector<GeometryPipeline>& getGeometryPipelines() const { return m_geometryPipelines; }
+
+            ///
+            /// @brief Push the start of data the shaders read, nothing when none of them reads push constants
+            ///
+            template<typename T>
+            void pushConstants(const VkCommandBuffer commandBuffer, const T &data) const
+            {
+                if (m_pushConstantRange.size == 0) { return; }
+                assert(m_pushConstantRange.size <= sizeof(T) && "Push constant block larger than the pushed data");
+                vkCmdPushConstants(commandBuffer, m_pipelineLayout, m_pushConstantRange.stageFlags, 0, m_pushConstantRange.size, &data);
+            }
+
+            std::shared_ptr<DescriptorSetLayout> renderSystemLayout;
 
         private:
 
             const Device &m_device;
-            VkPipelineLayout m_pipelineLayout{nullptr};
-            std::unique_ptr<Shaders> m_shaders;
+            VkPipelineLayout m_pipelineLayout{nullptr}; // owned by the layout cache of the device
+            VkPushConstantRange m_pushConstantRange{};
+            std::unique_ptr<ShaderVariantCache> m_shaders;
+            std::vector<GeometryPipeline> m_geometryPipelines;
 
     }; // class ARenderSystemBase
 
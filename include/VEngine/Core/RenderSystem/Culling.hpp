@@ -0,0 +1,103 @@
+///
+/// @file Culling.hpp
+/// @brief This file contains the CullingRenderSystem class
+/// @namespace ven
+///
+
+#pragma once
+
+#include "VEngine/Core/RenderSystem/HiZ.hpp"
+#include "VEngine/Gfx/SwapChain.hpp"
+
+namespace ven {
+
+    // must match the Instance struct of culling.comp and vertex_indirect.vert (std430)
+    struct GpuInstanceData {
+        glm::mat4 modelMatrix{1.F};
+        glm::mat4 normalMatrix{1.F};
+        glm::vec4 sphere{0.F};
+        uint32_t firstIndex{0};
+        uint32_t indexCount{0};
+        uint32_t drawOffset{0};
+        uint32_t bucket{0};
+    };
+
+    struct CullingPushConstantData {
+        uint32_t instanceCount{0};
+        uint32_t phase{0};
+        uint32_t hizLevels{0};
+    };
+
+    ///
+    /// @brief Draws sharing a model (vertex/index buffers), a diffuse texture and an alpha class, issued with one vkCmdDrawIndexedIndirectCount
+    /// @note a blended draw has a bucket of its own, the blended buckets are last and back to front
+    ///
+    struct DrawBucket {
+        std::shared_ptr<Model> model;
+        std::shared_ptr<Texture> texture;
+        ALPHA_MODE alphaMode{ALPHA_OPAQUE};
+        uint32_t drawOffset{0};
+        uint32_t capacity{0};
+    };
+
+    ///
+    /// @class CullingRenderSystem
+    /// @brief Compute pass testing every mesh instance against the frustum planes of the GlobalUbo and appending the survivors to per bucket indirect draw lists
+    /// @note with occlusion enabled, instances hidden in the previous frame HiZ pyramid are retested by renderLate against the pyramid of this frame
+    /// @namespace ven
+    ///
+    class CullingRenderSystem final : public ARenderSystemBase {
+
+        public:
+
+            static constexpr uint32_t WORKGROUP_SIZE = 64;
+
+            explicit CullingRenderSystem(const Device& device, VkDescriptorSetLayout globalSetLayout, std::shared_ptr<Texture> defaultTexture, const HiZRenderSystem& hizRenderSystem);
+
+            CullingRenderSystem(const CullingRenderSystem&) = delete;
+            CullingRenderSystem& operator=(const CullingRenderSystem&) = delete;
+            CullingRenderSystem(CullingRenderSystem&&) = delete;
+            CullingRenderSystem& operator=(CullingRenderSystem&&) = delete;
+
+            ///
+            /// @brief Gather the instances and buckets of this frame and upload them
+            ///
+            void prepare(const FrameInfo &frameInfo);
+            ///
+            /// @brief Enable the HiZ tests of the early (previous frame pyramid) and late (this frame pyramid) passes
+            ///
+            void setOcclusion(const bool early, const bool late) { m_earlyOcclusion = early; m_lateOcclusion = late; }
+            ///
+            /// @brief Record the culling dispatch, must be called outside of a render pass
+            ///
+            void render(const FrameInfo &frameInfo) const override;
+            ///
+            /// @brief Record the retest of the instances occluded in render, overwriting the draw lists with the ones that became visible
+            ///
+            void renderLate(const FrameInfo &frameInfo) const;
+
+            [[nodiscard]] const std::vector<DrawBucket>& getBuckets() const { return m_buckets; }
+            [[nodiscard]] uint32_t getInstanceCount() const { return static_cast<uint32_t>(m_instances.size()); }
+            [[nodiscard]] const Buffer& getInstanceBuffer(const unsigned long frameIndex) const { return *m_instanceBuffers.at(frameIndex); }
+            [[nodiscard]] const Buffer& getCommandBuffer(const unsigned long frameIndex) const { return *m_commandBuffers.at(frameIndex); }
+            [[nodiscard]] const Buffer& getCountBuffer(const unsigned long frameIndex) const { return *m_countBuffers.at(frameIndex); }
+
+        private:
+
+            void reserve(unsigned long frameIndex, uint32_t instanceCount, uint32_t bucketCount);
+            void dispatch(const FrameInfo &frameInfo, uint32_t phase, uint32_t hizLevels) const;
+
+            std::shared_ptr<Texture> m_defaultTexture;
+            const HiZRenderSystem& m_hizRenderSystem;
+            bool m_earlyOcclusion{false};
+            bool m_lateOcclusion{false};
+            std::vector<GpuInstanceData> m_instances;
+            std::vector<DrawBucket> m_buckets;
+            std::array<std::unique_ptr<Buffer>, MAX_FRAMES_IN_FLIGHT> m_instanceBuffers;
+            std::array<std::unique_ptr<Buffer>, MAX_FRAMES_IN_FLIGHT> m_commandBuffers;
+            std::array<std::unique_ptr<Buffer>, MAX_FRAMES_IN_FLIGHT> m_countBuffers;
+            std::array<std::unique_ptr<Buffer>, MAX_FRAMES_IN_FLIGHT> m_retestBuffers;
+
+    }; // class CullingRenderSystem
+
+} // namespace ven
@@ -0,0 +1,47 @@
+///
+/// @file DeferredLighting.hpp
+/// @brief This file contains the DeferredLightingRenderSystem class
+/// @namespace ven
+///
+
+#pragma once
+
+#include "VEngine/Core/RenderSystem/ABase.hpp"
+#include "VEngine/Gfx/SwapChain.hpp"
+
+namespace ven {
+
+    ///
+    /// @class DeferredLightingRenderSystem
+    /// @brief Fullscreen pass of the lighting subpass of the deferred render pass, shading the G-buffer read as input attachments
+    /// @note every pixel only evaluates the lights of its cluster (see LightClusterRenderSystem), the background is skipped from the depth
+    /// @namespace ven
+    ///
+    class DeferredLightingRenderSystem final : public ARenderSystemBase {
+
+        public:
+
+            explicit DeferredLightingRenderSystem(const Device& device, VkRenderPass deferredRenderPass, VkDescriptorSetLayout globalSetLayout);
+
+            DeferredLightingRenderSystem(const DeferredLightingRenderSystem&) = delete;
+            DeferredLightingRenderSystem& operator=(const DeferredLightingRenderSystem&) = delete;
+            DeferredLightingRenderSystem(DeferredLightingRenderSystem&&) = delete;
+            DeferredLightingRenderSystem& operator=(DeferredLightingRenderSystem&&) = delete;
+
+            ///
+            /// @brief Set the attachments of the swap chain image drawn this frame, indexed by GBUFFER_ATTACHMENT
+            ///
+            void setAttachments(const std::array<VkImageView, GBUFFER_ATTACHMENT_COUNT>& gBufferImageViews, const VkImageView depthImageView) { m_gBufferImageViews = gBufferImageViews; m_depthImageView = depthImageView; }
+            ///
+            /// @brief Record the lighting, must be called in the lighting subpass of the deferred render pass
+            ///
+            void render(const FrameInfo &frameInfo) const override;
+
+        private:
+
+            std::array<VkImageView, GBUFFER_ATTACHMENT_COUNT> m_gBufferImageViews{};
+            VkImageView m_depthImageView{nullptr};
+
+    }; // class DeferredLightingRenderSystem
+
+} // namespace ven
@@ -0,0 +1,70 @@
+///
+/// @file HiZ.hpp
+/// @brief This file contains the HiZRenderSystem class
+/// @namespace ven
+///
+
+#pragma once
+
+#include "VEngine/Core/RenderSystem/ABase.hpp"
+
+namespace ven {
+
+    struct HiZPushConstantData {
+        glm::ivec2 inputSize{0};
+        glm::ivec2 outputSize{0};
+    };
+
+    ///
+    /// @class HiZRenderSystem
+    /// @brief Compute pass reducing the depth buffer to a max depth pyramid, used by the CullingRenderSystem for occlusion tests
+    /// @namespace ven
+    ///
+    class HiZRenderSystem final : public ARenderSystemBase {
+
+        public:
+
+            static constexpr uint32_t WORKGROUP_SIZE = 8;
+
+            explicit HiZRenderSystem(const Device& device, VkDescriptorSetLayout globalSetLayout);
+            ~HiZRenderSystem() override;
+
+            HiZRenderSystem(const HiZRenderSystem&) = delete;
+            HiZRenderSystem& operator=(const HiZRenderSystem&) = delete;
+            HiZRenderSystem(HiZRenderSystem&&) = delete;
+            HiZRenderSystem& operator=(HiZRenderSystem&&) = delete;
+
+            ///
+            /// @brief Set the depth buffer of this frame, (re)create the pyramid if the extent changed
+            /// @param depthFormat Format of the depth image, its stencil aspect is transitioned along with the depth one
+            /// @return true if the pyramid was recreated, its content is undefined until the next render
+            ///
+            [[nodiscard]] bool prepare(const FrameInfo &frameInfo, VkExtent2D extent, VkImage depthImage, VkImageView depthImageView, VkFormat depthFormat);
+            ///
+            /// @brief Record the pyramid build, must be called outside of a render pass once the depth has been written
+            /// @note leaves the depth image in VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL
+            ///
+            void render(const FrameInfo &frameInfo) const override;
+
+            [[nodiscard]] VkDescriptorImageInfo getImageInfo() const { return { .sampler = m_sampler, .imageView = m_view, .imageLayout = VK_IMAGE_LAYOUT_GENERAL }; }
+            [[nodiscard]] uint32_t getMipLevels() const { return static_cast<uint32_t>(m_levelViews.size()); }
+
+        private:
+
+            void createPyramid(VkExtent2D extent);
+            void destroyPyramid();
+
+            VkExtent2D m_extent{.width = 0, .height = 0};
+            std::vector<VkExtent2D> m_levelExtents;
+            VkImage m_image{nullptr};
+            VkDeviceMemory m_imageMemory{nullptr};
+            VkImageView m_view{nullptr};
+            std::vector<VkImageView> m_levelViews;
+            VkSampler m_sampler{nullptr};
+            VkImage m_depthImage{nullptr};
+            VkImageView m_depthImageView{nullptr};
+            VkImageAspectFlags m_depthAspectMask{VK_IMAGE_ASPECT_DEPTH_BIT};
+
+    }; // class HiZRenderSystem
+
+} // namespace ven
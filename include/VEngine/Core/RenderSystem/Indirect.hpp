@@ -0,0 +1,44 @@
+///
+/// @file Indirect.hpp
+/// @brief This file contains the IndirectRenderSystem class
+/// @namespace ven
+///
+
+#pragma once
+
+#include "VEngine/Core/RenderSystem/Culling.hpp"
+#include "VEngine/Core/RenderSystem/Object.hpp"
+
+namespace ven {
+
+    ///
+    /// @class IndirectRenderSystem
+    /// @brief Class drawing the objects from the indirect draw lists written by the CullingRenderSystem
+    /// @note one instance per GEOMETRY_PASS, they all draw the lists of the last culling dispatch
+    /// @namespace ven
+    ///
+    class IndirectRenderSystem final : public ARenderSystemBase {
+
+        public:
+
+            explicit IndirectRenderSystem(const Device& device, const VkRenderPass renderPass, const VkDescriptorSetLayout globalSetLayout, const CullingRenderSystem& cullingRenderSystem, const GEOMETRY_PASS pass = GEOMETRY_FORWARD) : ARenderSystemBase(device), m_cullingRenderSystem{cullingRenderSystem} {
+                createGeometryPipelines(globalSetLayout, renderPass, std::string(SHADERS_BIN_PATH) + "vertex_indirect.spv", std::string(SHADERS_BIN_PATH) + "vertex_indirect_depth.spv", pass);
+            }
+
+            IndirectRenderSystem(const IndirectRenderSystem&) = delete;
+            IndirectRenderSystem& operator=(const IndirectRenderSystem&) = delete;
+            IndirectRenderSystem(IndirectRenderSystem&&) = delete;
+            IndirectRenderSystem& operator=(IndirectRenderSystem&&) = delete;
+
+            ///
+            /// @brief Record the buckets with every pipeline of the pass
+            ///
+            void render(const FrameInfo &frameInfo) const override;
+
+        private:
+
+            const CullingRenderSystem& m_cullingRenderSystem;
+
+    }; // class IndirectRenderSystem
+
+} // namespace ven
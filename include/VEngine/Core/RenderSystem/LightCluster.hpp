@@ -0,0 +1,66 @@
+///
+/// @file LightCluster.hpp
+/// @brief This file contains the LightClusterRenderSystem class
+/// @namespace ven
+///
+
+#pragma once
+
+#include "VEngine/Core/RenderSystem/ABase.hpp"
+#include "VEngine/Gfx/SwapChain.hpp"
+
+namespace ven {
+
+    static constexpr uint32_t DEFAULT_LIGHTS_PER_CLUSTER = 8;
+
+    struct LightClusterPushConstantData {
+        uint32_t indexCapacity{0};
+    };
+
+    ///
+    /// @class LightClusterRenderSystem
+    /// @brief Compute pass giving every cluster of the view (see LightClusters) the compact list of the lights whose range reaches it
+    /// @note the lists are read by fragment_shader.frag through the global set (binding 3: offset and count per cluster, binding 4: light indices)
+    /// @note the index list grows to the size the previous use of the frame needed, a frame going over it drops the extra lights of the last clusters
+    /// @namespace ven
+    ///
+    class LightClusterRenderSystem final : public ARenderSystemBase {
+
+        public:
+
+            static constexpr uint32_t WORKGROUP_SIZE = 128;
+
+            explicit LightClusterRenderSystem(const Device& device, VkDescriptorSetLayout globalSetLayout);
+
+            LightClusterRenderSystem(const LightClusterRenderSystem&) = delete;
+            LightClusterRenderSystem& operator=(const LightClusterRenderSystem&) = delete;
+            LightClusterRenderSystem(LightClusterRenderSystem&&) = delete;
+            LightClusterRenderSystem& operator=(LightClusterRenderSystem&&) = delete;
+
+            ///
+            /// @brief Grow the light index list to the count written by the previous use of this frame, the frame fence must have been waited on
+            ///
+            void prepare(const FrameInfo &frameInfo);
+            ///
+            /// @brief Record the light assignment dispatch, must be called outside of a render pass and before the draws reading the lists
+            ///
+            void render(const FrameInfo &frameInfo) const override;
+
+            [[nodiscard]] const Buffer& getRangeBuffer(const unsigned long frameIndex) const { return *m_rangeBuffers.at(frameIndex); }
+            [[nodiscard]] const Buffer& getIndexBuffer(const unsigned long frameIndex) const { return *m_indexBuffers.at(frameIndex); }
+            ///
+            /// @return Light indices written by the last completed use of the frame, summed over the clusters
+            ///
+            [[nodiscard]] uint32_t getIndexCount(const unsigned long frameIndex) const { return *static_cast<const uint32_t*>(m_counterBuffers.at(frameIndex)->getMappedMemory()); }
+
+        private:
+
+            void reserve(unsigned long frameIndex, uint32_t indexCount);
+
+            std::array<std::unique_ptr<Buffer>, MAX_FRAMES_IN_FLIGHT> m_rangeBuffers;
+            std::array<std::unique_ptr<Buffer>, MAX_FRAMES_IN_FLIGHT> m_indexBuffers;
+            std::array<std::unique_ptr<Buffer>, MAX_FRAMES_IN_FLIGHT> m_counterBuffers;
+
+    }; // class LightClusterRenderSystem
+
+} // namespace ven
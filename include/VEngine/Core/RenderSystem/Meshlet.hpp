@@ -0,0 +1,44 @@
+///
+/// @file Meshlet.hpp
+/// @brief This file contains the MeshletRenderSystem class
+/// @namespace ven
+///
+
+#pragma once
+
+#include "VEngine/Core/RenderSystem/MeshletCulling.hpp"
+
+namespace ven {
+
+    // one task shader invocation per meshlet, must match meshlet_task.task
+    static constexpr uint32_t MESHLET_TASK_GROUP_SIZE = 32;
+
+    ///
+    /// @class MeshletRenderSystem
+    /// @brief Class drawing the meshlets gathered by the MeshletCullingRenderSystem
+    /// @note with VK_EXT_mesh_shader the task shader culls the meshlets and the mesh shader emits them, otherwise the compacted index buffer of the culling pass is drawn with one indirect command per draw
+    /// @namespace ven
+    ///
+    class MeshletRenderSystem final : public ARenderSystemBase {
+
+        public:
+
+            explicit MeshletRenderSystem(const Device& device, VkRenderPass renderPass, VkDescriptorSetLayout globalSetLayout, const MeshletCullingRenderSystem& meshletCullingRenderSystem);
+
+            MeshletRenderSystem(const MeshletRenderSystem&) = delete;
+            MeshletRenderSystem& operator=(const MeshletRenderSystem&) = delete;
+            MeshletRenderSystem(MeshletRenderSystem&&) = delete;
+            MeshletRenderSystem& operator=(MeshletRenderSystem&&) = delete;
+
+            void render(const FrameInfo &frameInfo) const override;
+
+        private:
+
+            void renderMeshShader(const FrameInfo &frameInfo) const;
+            void renderCompacted(const FrameInfo &frameInfo) const;
+
+            const MeshletCullingRenderSystem& m_meshletCullingRenderSystem;
+
+    }; // class MeshletRenderSystem
+
+} // namespace ven
@@ -0,0 +1,89 @@
+///
+/// @file MeshletCulling.hpp
+/// @brief This file contains the MeshletCullingRenderSystem class
+/// @namespace ven
+///
+
+#pragma once
+
+#include "VEngine/Core/RenderSystem/Culling.hpp"
+
+namespace ven {
+
+    struct MeshletPushConstantData {
+        uint32_t workOffset{0};
+        uint32_t workCount{0};
+    };
+
+    ///
+    /// @brief Meshlet of one draw, must match the Work struct of meshlet_cull.comp and meshlet_task.task
+    ///
+    struct MeshletWork {
+        uint32_t draw{0}; // index in the instance buffer
+        uint32_t meshlet{0}; // index in the model meshlet buffer
+    };
+
+    ///
+    /// @brief Draws sharing a model and a diffuse texture, their meshlets are contiguous in the work list
+    ///
+    struct MeshletBucket {
+        std::shared_ptr<Model> model;
+        std::shared_ptr<Texture> texture;
+        uint32_t drawOffset{0};
+        uint32_t drawCount{0};
+        uint32_t workOffset{0};
+        uint32_t workCount{0};
+    };
+
+    ///
+    /// @class MeshletCullingRenderSystem
+    /// @brief Gather the meshlets of every draw and, without mesh shaders, cull them in a compute pass appending the triangles of the visible ones to a compacted index buffer
+    /// @note meshlets out of the frustum or whose normal cone faces away from the camera are rejected, the full detail level is always used
+    /// @namespace ven
+    ///
+    class MeshletCullingRenderSystem final : public ARenderSystemBase {
+
+        public:
+
+            static constexpr uint32_t WORKGROUP_SIZE = 64;
+
+            explicit MeshletCullingRenderSystem(const Device& device, VkDescriptorSetLayout globalSetLayout, std::shared_ptr<Texture> defaultTexture);
+
+            MeshletCullingRenderSystem(const MeshletCullingRenderSystem&) = delete;
+            MeshletCullingRenderSystem& operator=(const MeshletCullingRenderSystem&) = delete;
+            MeshletCullingRenderSystem(MeshletCullingRenderSystem&&) = delete;
+            MeshletCullingRenderSystem& operator=(MeshletCullingRenderSystem&&) = delete;
+
+            ///
+            /// @brief Gather the draws, buckets and meshlets of this frame and upload them, the indirect commands are reset to 0 indices
+            ///
+            void prepare(const FrameInfo &frameInfo);
+            ///
+            /// @brief Record the compaction dispatches, must be called outside of a render pass, nothing is recorded with mesh shaders
+            ///
+            void render(const FrameInfo &frameInfo) const override;
+
+            [[nodiscard]] const std::vector<MeshletBucket>& getBuckets() const { return m_buckets; }
+            [[nodiscard]] uint32_t getWorkCount() const { return static_cast<uint32_t>(m_work.size()); }
+            [[nodiscard]] const Buffer& getInstanceBuffer(const unsigned long frameIndex) const { return *m_instanceBuffers.at(frameIndex); }
+            [[nodiscard]] const Buffer& getWorkBuffer(const unsigned long frameIndex) const { return *m_workBuffers.at(frameIndex); }
+            [[nodiscard]] const Buffer& getCommandBuffer(const unsigned long frameIndex) const { return *m_commandBuffers.at(frameIndex); }
+            [[nodiscard]] const Buffer& getIndexBuffer(const unsigned long frameIndex) const { return *m_indexBuffers.at(frameIndex); }
+
+        private:
+
+            void reserve(unsigned long frameIndex, uint32_t drawCount, uint32_t workCount, uint32_t indexCount);
+
+            std::shared_ptr<Texture> m_defaultTexture;
+            std::vector<GpuInstanceData> m_instances;
+            std::vector<VkDrawIndexedIndirectCommand> m_commands;
+            std::vector<MeshletWork> m_work;
+            std::vector<MeshletBucket> m_buckets;
+            std::array<std::unique_ptr<Buffer>, MAX_FRAMES_IN_FLIGHT> m_instanceBuffers;
+            std::array<std::unique_ptr<Buffer>, MAX_FRAMES_IN_FLIGHT> m_workBuffers;
+            std::array<std::unique_ptr<Buffer>, MAX_FRAMES_IN_FLIGHT> m_commandBuffers;
+            std::array<std::unique_ptr<Buffer>, MAX_FRAMES_IN_FLIGHT> m_indexBuffers;
+
+    }; // class MeshletCullingRenderSystem
+
+} // namespace ven
@@ -7,26 +7,22 @@
 #pragma once
 
 #include "VEngine/Core/RenderSystem/ABase.hpp"
+#include "VEngine/Gfx/SwapChain.hpp"
 
 namespace ven {
 
-    struct ObjectPushConstantData {
-        glm::mat4 modelMatrix{};
-        glm::mat4 normalMatrix{};
-    };
-
     ///
     /// @class ObjectRenderSystem
     /// @brief Class for object render system
+    /// @note one instance per GEOMETRY_PASS, they all draw what the last prepare kept
     /// @namespace ven
     ///
     class ObjectRenderSystem final : public ARenderSystemBase {
 
         public:
 
-            explicit ObjectRenderSystem(const Device& device, const VkRenderPass renderPass, const VkDescriptorSetLayout globalSetLayout) : ARenderSystemBase(device) {
-                createPipelineLayout(globalSetLayout, sizeof(ObjectPushConstantData));
-                createPipeline(renderPass, std::string(SHADERS_BIN_PATH) + "vertex_shader.spv", std::string(SHADERS_BIN_PATH) + "fragment_shader.spv", false);
+            explicit ObjectRenderSystem(const Device& device, const VkRenderPass renderPass, const VkDescriptorSetLayout globalSetLayout, const GEOMETRY_PASS pass = GEOMETRY_FORWARD) : ARenderSystemBase(device) {
+                createGeometryPipelines(globalSetLayout, renderPass, std::string(SHADERS_BIN_PATH) + "vertex_shader.spv", std::string(SHADERS_BIN_PATH) + "vertex_depth.spv", pass);
             }
 
             ObjectRenderSystem(const ObjectRenderSystem&) = delete;
@@ -34,6 +30,13 @@ namespace ven {
             ObjectRenderSystem(ObjectRenderSystem&&) = delete;
             ObjectRenderSystem& operator=(ObjectRenderSystem&&) = delete;
 
+            ///
+            /// @brief Cull the objects and select their levels of detail, once per frame before the render of any pass
+            ///
+            static void prepare(const FrameInfo &frameInfo);
+            ///
+            /// @brief Record the draws with every pipeline of the pass, the blended ones back to front
+            ///
             void render(const FrameInfo &frameInfo) const override;
 
     }; // class ObjectRenderSystem
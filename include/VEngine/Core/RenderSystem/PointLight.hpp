@@ -7,36 +7,43 @@
 #pragma once
 
 #include "VEngine/Core/RenderSystem/ABase.hpp"
+#include "VEngine/Gfx/SwapChain.hpp"
 
 namespace ven {
 
-    struct LightPushConstantData {
-        glm::vec4 position{};
-        glm::vec4 color{};
-        float radius;
-    };
-
     ///
     /// @class PointLightRenderSystem
     /// @brief Class for point light system
+    /// @note the billboards are drawn with one instanced draw, each instance reads its light from the light buffer of the global set through a back to front ordered list of the lights in the frustum
     /// @namespace ven
     ///
     class PointLightRenderSystem final : public ARenderSystemBase {
 
         public:
 
-            explicit PointLightRenderSystem(const Device& device, const VkRenderPass renderPass, const VkDescriptorSetLayout globalSetLayout) : ARenderSystemBase(device) {
-                createPipelineLayout(globalSetLayout, sizeof(LightPushConstantData));
-                createPipeline(renderPass, std::string(SHADERS_BIN_PATH) + "vertex_point_light.spv", std::string(SHADERS_BIN_PATH) + "fragment_point_light.spv", true);
-            }
+            explicit PointLightRenderSystem(const Device& device, VkRenderPass renderPass, VkDescriptorSetLayout globalSetLayout);
 
             PointLightRenderSystem(const PointLightRenderSystem&) = delete;
             PointLightRenderSystem& operator=(const PointLightRenderSystem&) = delete;
             PointLightRenderSystem(PointLightRenderSystem&&) = delete;
             PointLightRenderSystem& operator=(PointLightRenderSystem&&) = delete;
 
+            ///
+            /// @brief Cull the billboards against the frustum of FrameInfo::culler, sort them back to front and upload their order
+            ///
+            void prepare(const FrameInfo &frameInfo);
             void render(const FrameInfo &frameInfo) const override;
 
+            [[nodiscard]] uint32_t getVisibleCount() const { return static_cast<uint32_t>(m_order.size()); }
+
+        private:
+
+            void reserve(unsigned long frameIndex, uint32_t lightCount);
+
+            std::vector<std::pair<float, uint32_t>> m_sortKeys; // squared camera distance, light index
+            std::vector<uint32_t> m_order;
+            std::array<std::unique_ptr<Buffer>, MAX_FRAMES_IN_FLIGHT> m_orderBuffers;
+
     }; // class PointLightRenderSystem
 
 } // namespace ven
@@ -0,0 +1,92 @@
+///
+/// @file Shadow.hpp
+/// @brief This file contains the ShadowRenderSystem class
+/// @namespace ven
+///
+
+#pragma once
+
+#include "VEngine/Core/RenderSystem/ABase.hpp"
+#include "VEngine/Gfx/SwapChain.hpp"
+
+namespace ven {
+
+    static constexpr uint32_t DEFAULT_SHADOW_MAP_CAPACITY = 16;
+
+    ///
+    /// @brief Layers of the shadow atlas image
+    ///
+    enum SHADOW_LAYER : uint8_t {
+        SHADOW_STATIC_LAYER = 0, // static casters, baked when ShadowMap::bake is set
+        SHADOW_FINAL_LAYER = 1, // copy of the static tiles with the dynamic casters over them, sampled by the lit passes
+        SHADOW_LAYER_COUNT = 2
+    };
+
+    struct ShadowPushConstantData {
+        glm::mat4 viewProjection{1.F};
+        glm::mat4 modelMatrix{1.F};
+    };
+
+    ///
+    /// @brief ShadowMap as read by the fragment shaders (std430)
+    ///
+    struct ShadowBufferData {
+        std::array<glm::mat4, CUBE_FACE_COUNT> faceViewProjections{};
+        std::array<glm::vec4, CUBE_FACE_COUNT> faceRects{}; // xy: atlas uv of the tile, z: atlas uv size of the tile, w: half texel of the face
+    };
+
+    ///
+    /// @class ShadowRenderSystem
+    /// @brief Depth only draws of the shadow casters into the cube face tiles the ShadowCache gave to the lights
+    /// @note the atlas is a two layer depth image, the lit passes sample the final layer through the global set (binding 5: ShadowBufferData, binding 6: comparison sampler)
+    /// @note the casters are whole models at full detail, without alpha test
+    /// @namespace ven
+    ///
+    class ShadowRenderSystem final : public ARenderSystemBase {
+
+        public:
+
+            static constexpr VkFormat DEPTH_FORMAT = VK_FORMAT_D32_SFLOAT;
+
+            explicit ShadowRenderSystem(const Device& device, VkDescriptorSetLayout globalSetLayout, uint32_t atlasSize = SHADOW_ATLAS_SIZE);
+            ~ShadowRenderSystem() override;
+
+            ShadowRenderSystem(const ShadowRenderSystem&) = delete;
+            ShadowRenderSystem& operator=(const ShadowRenderSystem&) = delete;
+            ShadowRenderSystem(ShadowRenderSystem&&) = delete;
+            ShadowRenderSystem& operator=(ShadowRenderSystem&&) = delete;
+
+            ///
+            /// @brief Upload the shadow maps of this frame, the frame fence must have been waited on
+            ///
+            void prepare(const FrameInfo &frameInfo);
+            ///
+            /// @brief Record the bakes and the composites of this frame, must be called outside of a render pass and before the lit draws
+            ///
+            void render(const FrameInfo &frameInfo) const override;
+
+            [[nodiscard]] const Buffer& getBuffer(const unsigned long frameIndex) const { return *m_buffers.at(frameIndex); }
+            [[nodiscard]] VkDescriptorImageInfo getImageInfo() const { return { .sampler = m_sampler, .imageView = m_sampledView, .imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL }; }
+
+        private:
+
+            void createAtlas();
+            void createRenderPass();
+            void reserve(unsigned long frameIndex, uint32_t shadowMapCount);
+            void drawLayer(const FrameInfo &frameInfo, SHADOW_LAYER layer) const;
+
+            uint32_t m_atlasSize;
+            VkImage m_image{nullptr};
+            VkDeviceMemory m_imageMemory{nullptr};
+            VkImageView m_sampledView{nullptr}; // final layer
+            std::array<VkImageView, SHADOW_LAYER_COUNT> m_layerViews{};
+            std::array<VkFramebuffer, SHADOW_LAYER_COUNT> m_framebuffers{};
+            VkRenderPass m_renderPass{nullptr};
+            VkSampler m_sampler{nullptr};
+            bool m_initialized{false}; // the layers left VK_IMAGE_LAYOUT_UNDEFINED
+            std::array<std::unique_ptr<Buffer>, MAX_FRAMES_IN_FLIGHT> m_buffers;
+            std::vector<ShadowBufferData> m_bufferData;
+
+    }; // class ShadowRenderSystem
+
+} // namespace ven
@@ -29,12 +29,8 @@ namespace ven {
             LightFactory(LightFactory&&) = delete;
             LightFactory& operator=(LightFactory&&) = delete;
 
-            static std::unique_ptr<Light> create(const Transform3D &transform = DEFAULT_TRANSFORM, glm::vec4 color = DEFAULT_LIGHT_COLOR);
-            static std::unique_ptr<Light> duplicate(const Light &cpyLight) { return create(cpyLight.transform, cpyLight.color); }
-
-        private:
-
-            static unsigned int m_currentLightId;
+            static Handle create(LightStore& lights, const Transform3D &transform = DEFAULT_TRANSFORM, glm::vec4 color = DEFAULT_LIGHT_COLOR, uint8_t flags = 0);
+            static Handle duplicate(LightStore& lights, Handle cpyLight);
 
     }; // class LightFactory
 
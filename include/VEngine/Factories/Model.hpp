@@ -27,8 +27,18 @@ namespace ven {
             ModelFactory(ModelFactory&&) = delete;
             ModelFactory& operator=(ModelFactory&&) = delete;
 
-            static std::unique_ptr<Model> get(const Device& device, const std::string& filepath);
-            static std::unordered_map<std::string, std::shared_ptr<Model>> getAll(const Device& device, const std::string& folderPath);
+            ///
+            /// @brief Load a model and its potentially visible sets (filepath + PVS_EXTENSION) if they match the model content
+            /// @param threadPool Pool the levels of detail are generated on, serial when null
+            ///
+            static std::unique_ptr<Model> get(const Device& device, const std::string& filepath, ThreadPool* threadPool = nullptr);
+            ///
+            /// @brief Bake and save the potentially visible sets of a model from its geometry alone, without a window nor a device
+            /// @note the geometry goes through the same processing as get, so the baked content hash matches the loaded model
+            /// @param threadPool Pool the levels of detail and the visibility are computed on, serial when null
+            ///
+            static void bakePvs(const std::string& filepath, ThreadPool* threadPool = nullptr);
+            static std::unordered_map<std::string, std::shared_ptr<Model>> getAll(const Device& device, const std::string& folderPath, ThreadPool* threadPool = nullptr);
 
     }; // class ModelFactory
 
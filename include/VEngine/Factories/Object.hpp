@@ -27,12 +27,8 @@ namespace ven {
             ObjectFactory(ObjectFactory&&) = delete;
             ObjectFactory& operator=(ObjectFactory&&) = delete;
 
-            static std::unique_ptr<Object> create(const std::shared_ptr<Texture>& texture, const std::shared_ptr<Model>& model, const std::string &name, const Transform3D &transform);
-            static std::unique_ptr<Object> duplicate(const Object& objSrc) { return create(objSrc.getDiffuseMap(), objSrc.getModel(), objSrc.getName(), objSrc.transform); }
-
-        private:
-
-            static unsigned int m_currentObjId;
+            static Handle create(ObjectStore& objects, const std::shared_ptr<Texture>& texture, const std::shared_ptr<Model>& model, const std::string &name, const Transform3D &transform);
+            static Handle duplicate(ObjectStore& objects, Handle objSrc);
 
     }; // class ObjectFactory
 
@@ -0,0 +1,38 @@
+///
+/// @file AlphaMode.hpp
+/// @brief This file contains the ALPHA_MODE enum and the classification of texture alpha
+/// @namespace ven
+///
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+namespace ven {
+
+    ///
+    /// @brief How the draws of a material treat the alpha of its diffuse texture, also the order in which the classes are drawn
+    ///
+    enum ALPHA_MODE : uint8_t {
+        ALPHA_OPAQUE = 0, // alpha ignored, no blending nor discard, the early depth test stays on
+        ALPHA_CUTOUT = 1, // texels under ALPHA_CUTOFF are discarded from the depth, the others are opaque
+        ALPHA_BLEND = 2 // blended back to front after the other classes, without depth writes
+    };
+
+    static constexpr uint8_t ALPHA_MODE_COUNT = 3;
+    // alpha test of the cutout class, 0.5 in fragment_depth.frag
+    static constexpr uint8_t ALPHA_CUTOFF = 128;
+    // texels from ALPHA_OPAQUE_MIN are opaque, up to ALPHA_TRANSPARENT_MAX they are holes, in between partial coverage
+    static constexpr uint8_t ALPHA_OPAQUE_MIN = 250;
+    static constexpr uint8_t ALPHA_TRANSPARENT_MAX = 5;
+    // the partial coverage of a cutout only comes from the filtered edges of its holes
+    static constexpr float ALPHA_BLEND_MIN_PARTIAL_RATIO = 0.25F;
+
+    ///
+    /// @brief Classify the alpha of RGBA8 texels
+    /// @return ALPHA_OPAQUE when every texel is opaque, ALPHA_BLEND when the partial texels reach ALPHA_BLEND_MIN_PARTIAL_RATIO of the non opaque ones, ALPHA_CUTOUT otherwise
+    ///
+    [[nodiscard]] ALPHA_MODE classifyAlpha(std::span<const uint8_t> rgba);
+
+} // namespace ven
@@ -6,7 +6,9 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cassert>
+#include <memory>
 
 #include "VEngine/Core/Device.hpp"
 
@@ -29,6 +31,18 @@ namespace ven {
             Buffer(Buffer&&) = delete;
             Buffer& operator=(Buffer&&) = delete;
 
+            ///
+            /// @brief Recreate a buffer with room for instanceCount instances when it is missing or too small, host visible memory is mapped
+            /// @note the capacity grows geometrically, see growCapacity
+            /// @note only call it for a frame whose fence has been waited on: the previous buffer is destroyed at once, nothing in flight may still use it
+            /// @return true if the buffer was recreated, its contents and the descriptors pointing at it are gone
+            ///
+            static bool reserve(std::unique_ptr<Buffer>& buffer, const Device& device, VkDeviceSize instanceSize, uint32_t instanceCount, VkBufferUsageFlags usageFlags, VkMemoryPropertyFlags memoryPropertyFlags, VkDeviceSize minOffsetAlignment = 1);
+            ///
+            /// @return Capacity of a buffer holding capacity instances grown to fit required ones, at least doubled so n grows cost O(log n) reallocations
+            ///
+            [[nodiscard]] static uint32_t growCapacity(const uint32_t capacity, const uint32_t required) { return capacity >= required ? capacity : std::max({required, capacity * 2, 1U}); }
+
             ///
             /// @brief Map a memory range of this buffer. If successful, mapped points to the specified buffer range.
             ///
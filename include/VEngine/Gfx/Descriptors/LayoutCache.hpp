@@ -0,0 +1,69 @@
+///
+/// @file LayoutCache.hpp
+/// @brief This file contains the DescriptorLayoutCache class
+/// @namespace ven
+///
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "VEngine/Gfx/Descriptors/SetLayout.hpp"
+
+namespace ven {
+
+    ///
+    /// @class DescriptorLayoutCache
+    /// @brief Descriptor set layouts and pipeline layouts created once per distinct definition, shared by every render system asking for the same one
+    /// @note they live as long as the device, the handles it returns stay valid until its destruction
+    /// @namespace ven
+    ///
+    class DescriptorLayoutCache {
+
+        public:
+
+            explicit DescriptorLayoutCache(const Device& device) : m_device{device} {}
+            ~DescriptorLayoutCache();
+
+            DescriptorLayoutCache(const DescriptorLayoutCache&) = delete;
+            DescriptorLayoutCache& operator=(const DescriptorLayoutCache&) = delete;
+            DescriptorLayoutCache(DescriptorLayoutCache&&) = delete;
+            DescriptorLayoutCache& operator=(DescriptorLayoutCache&&) = delete;
+
+            [[nodiscard]] std::shared_ptr<DescriptorSetLayout> getSetLayout(const std::vector<VkDescriptorSetLayoutBinding>& bindings);
+            ///
+            /// @param pushConstantRange Left out of the layout when its size is 0
+            ///
+            [[nodiscard]] VkPipelineLayout getPipelineLayout(const std::vector<VkDescriptorSetLayout>& setLayouts, const VkPushConstantRange& pushConstantRange);
+
+            [[nodiscard]] std::size_t getSetLayoutCount() const { return m_setLayouts.size(); }
+            [[nodiscard]] std::size_t getPipelineLayoutCount() const { return m_pipelineLayouts.size(); }
+
+        private:
+
+            struct BindingKey {
+                uint32_t binding;
+                VkDescriptorType descriptorType;
+                uint32_t count;
+                VkShaderStageFlags stageFlags;
+
+                auto operator<=>(const BindingKey&) const = default;
+            };
+
+            struct PipelineLayoutKey {
+                std::vector<VkDescriptorSetLayout> setLayouts;
+                VkShaderStageFlags pushConstantStages;
+                uint32_t pushConstantSize;
+
+                auto operator<=>(const PipelineLayoutKey&) const = default;
+            };
+
+            const Device& m_device;
+            std::map<std::vector<BindingKey>, std::shared_ptr<DescriptorSetLayout>> m_setLayouts;
+            std::map<PipelineLayoutKey, VkPipelineLayout> m_pipelineLayouts;
+
+    }; // class DescriptorLayoutCache
+
+} // namespace ven
@@ -14,6 +14,7 @@ namespace ven {
     ///
     /// @class DescriptorWriter
     /// @brief Class for descriptor writer
+    /// @note a binding the layout does not have is skipped, the reflected layouts leave out what the shaders never read
     /// @namespace ven
     ///
     class DescriptorWriter {
@@ -11,6 +11,8 @@
 #include <glm/glm.hpp>
 
 #include "VEngine/Gfx/Texture.hpp"
+#include "VEngine/Scene/Bounds.hpp"
+#include "VEngine/Scene/LodSelector.hpp"
 
 namespace ven {
 
@@ -32,16 +34,34 @@ namespace ven {
         bool operator==(const Vertex& other) const { return position == other.position && color == other.color && normal == other.normal && uv == other.uv; }
     };
 
+    ///
+    /// @brief Depth stream of a model, what the depth pre-pass reads: the position and the uv of the alpha test
+    ///
+    struct DepthVertex {
+        glm::vec3 position{};
+        glm::vec2 uv{};
+
+        static std::vector<VkVertexInputBindingDescription> getBindingDescriptions();
+        static std::vector<VkVertexInputAttributeDescription> getAttributeDescriptions();
+    };
+
     struct Material {
         std::vector<std::shared_ptr<Texture>> diffuseTextures;
         std::vector<std::shared_ptr<Texture>> specularTextures;
         std::vector<std::shared_ptr<Texture>> normalTextures;
+        ALPHA_MODE alphaMode{ALPHA_OPAQUE}; // picks the pipelines and the draw order of the meshes using it
     };
 
     struct Mesh {
-        std::vector<Vertex> vertices;
-        std::vector<uint32_t> indices;
+        uint32_t firstIndex{0};
+        uint32_t indexCount{0};
+        AABB aabb;
+        BoundingSphere sphere;
         Material material;
+        bool occluder{false}; // large enough to hide other meshes, rasterized by the OcclusionCuller
+        std::vector<MeshLod> lods; // level 0 is firstIndex/indexCount, the simplified levels follow in the same index buffer
+        uint32_t firstMeshlet{0}; // clusters of the full detail level in the model meshlet buffer
+        uint32_t meshletCount{0};
     };
 
 } // namespace ven
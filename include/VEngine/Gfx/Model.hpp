@@ -12,10 +12,16 @@
 
 #include "VEngine/Gfx/Buffer.hpp"
 #include "VEngine/Gfx/Mesh.hpp"
+#include "VEngine/Scene/Meshlet.hpp"
+#include "VEngine/Scene/MeshOptimizer.hpp"
+#include "VEngine/Scene/MeshSimplifier.hpp"
+#include "VEngine/Scene/Pvs.hpp"
 
 namespace ven {
 
     static constexpr std::string_view MODEL_PATH = "assets/models/sponza/";
+    // a mesh is an occluder when its two largest dimensions reach this fraction of the model largest dimension
+    static constexpr float OCCLUDER_MIN_EXTENT_RATIO = 0.1F;
 
     ///
     /// @class Model
@@ -33,11 +39,41 @@ namespace ven {
                 std::vector<uint32_t> indices;
                 TextureMap textures;
                 std::vector<Mesh> meshes;
-
-                void loadModel(const Device& device, const std::string &filename);
-                void processNode(const Device& device, const aiNode* node, const aiScene* scene);
+                std::vector<MeshLod> lods; // whole model range of each level of detail, level 0 holds the source meshes
+                MeshletData meshlets;
+
+                void loadModel(const Device& device, const std::string &filename) { load(&device, filename); }
+                ///
+                /// @brief Load the vertices, indices and meshes only, no texture is created so no device is needed (offline tools)
+                ///
+                void loadGeometry(const std::string &filename) { load(nullptr, filename); }
+                ///
+                /// @brief Append the simplified levels of every mesh to the indices, see MeshSimplifier::buildChain
+                ///
+                void generateLods(const LodSettings& settings = {}, ThreadPool* threadPool = nullptr);
+                ///
+                /// @brief Reorder the triangles of every level for the vertex cache and overdraw, then the vertices in fetch order, see MeshOptimizer
+                /// @return Cache efficiency of the full detail meshes before and after
+                ///
+                MeshOptimizationStats optimizeMeshes();
+                ///
+                /// @brief Split the full detail level of every mesh into meshlets, see MeshletBuilder::build
+                ///
+                void generateMeshlets();
+                void load(const Device* device, const std::string &filename);
+                void processNode(const Device* device, const aiNode* node, const aiScene* scene);
                 void processMesh(const aiMesh* mesh);
-                void processMaterial(const Device &device, const aiMesh *mesh, const aiScene *scene);
+                ///
+                /// @param device Textures are skipped when null
+                ///
+                void processMaterial(const Device* device, const aiMesh *mesh, const aiScene *scene);
+
+                [[nodiscard]] std::vector<glm::vec3> getPositions() const;
+                [[nodiscard]] std::vector<PvsMeshRange> getMeshRanges() const;
+                ///
+                /// @brief Indices of the full detail meshes, without the generated levels
+                ///
+                [[nodiscard]] std::span<const uint32_t> getBaseIndices() const { return lods.empty() ? std::span(indices) : std::span(indices).first(lods[0].indexCount); }
             };
 
             Model(const Device &device, const Builder &builder);
@@ -49,20 +85,52 @@ namespace ven {
             Model& operator=(Model&&) = delete;
 
             void bind(VkCommandBuffer commandBuffer) const;
-            void draw(VkCommandBuffer commandBuffer) const;
+            ///
+            /// @brief Bind the depth stream (see DepthVertex) in place of the vertices, for the depth pre-pass
+            ///
+            void bindDepth(VkCommandBuffer commandBuffer) const;
+            void draw(VkCommandBuffer commandBuffer, uint8_t lod = 0) const;
             void bindMesh(VkCommandBuffer commandBuffer, const Mesh& mesh) const;
-            void drawMesh(VkCommandBuffer commandBuffer, const Mesh& mesh) const;
+            void drawMesh(VkCommandBuffer commandBuffer, const Mesh& mesh, uint8_t lod = 0) const;
 
             const TextureMap& getTextures() const { return m_textures; }
             const std::vector<Mesh>& getMeshes() const { return m_meshes; }
+            ///
+            /// @brief Index count of the full detail model
+            ///
+            uint32_t getIndexCount() const { return m_indexCount; }
+            const std::vector<MeshLod>& getLods() const { return m_lods; }
+            uint32_t getMeshletCount() const { return m_meshletCount; }
+            ///
+            /// @brief Storage buffers read by the meshlet culling and mesh shaders, null when the model has no meshlets
+            ///
+            const Buffer* getMeshletBuffer() const { return m_meshletBuffer.get(); }
+            const Buffer* getMeshletVertexBuffer() const { return m_meshletVertexBuffer.get(); }
+            const Buffer* getMeshletTriangleBuffer() const { return m_meshletTriangleBuffer.get(); }
+            const Buffer& getVertexBuffer() const { return *m_vertexBuffer; }
+            const AABB& getAABB() const { return m_aabb; }
+            const BoundingSphere& getSphere() const { return m_sphere; }
+            const std::vector<glm::vec3>& getOccluderTriangles() const { return m_occluderTriangles; }
+            uint64_t getContentHash() const { return m_contentHash; }
+            const Pvs& getPvs() const { return m_pvs; }
+            void setPvs(Pvs pvs) { m_pvs = std::move(pvs); }
+            ///
+            /// @brief File the model was loaded from, empty for generated models
+            ///
+            const std::string& getFilepath() const { return m_filepath; }
+            void setFilepath(std::string filepath) { m_filepath = std::move(filepath); }
 
         private:
 
             void createVertexBuffer(const std::vector<Vertex>& vertices);
+            void createDepthVertexBuffer(const std::vector<Vertex>& vertices);
             void createIndexBuffer(const std::vector<uint32_t>& indices);
+            void createMeshletBuffers(const MeshletData& meshlets);
+            [[nodiscard]] std::unique_ptr<Buffer> createStorageBuffer(const void* data, VkDeviceSize instanceSize, uint32_t instanceCount) const;
 
             const Device& m_device;
             std::unique_ptr<Buffer> m_vertexBuffer;
+            std::unique_ptr<Buffer> m_depthVertexBuffer;
             uint32_t m_vertexCount;
 
             bool m_hasIndexBuffer{false};
@@ -70,6 +138,17 @@ namespace ven {
             uint32_t m_indexCount;
             TextureMap m_textures;
             std::vector<Mesh> m_meshes;
+            std::vector<MeshLod> m_lods;
+            uint32_t m_meshletCount{0};
+            std::unique_ptr<Buffer> m_meshletBuffer;
+            std::unique_ptr<Buffer> m_meshletVertexBuffer;
+            std::unique_ptr<Buffer> m_meshletTriangleBuffer;
+            AABB m_aabb;
+            BoundingSphere m_sphere;
+            std::vector<glm::vec3> m_occluderTriangles;
+            uint64_t m_contentHash{0};
+            Pvs m_pvs;
+            std::string m_filepath;
 
     }; // class Model
 
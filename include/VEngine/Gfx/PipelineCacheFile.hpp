@@ -0,0 +1,65 @@
+///
+/// @file PipelineCacheFile.hpp
+/// @brief This file contains the PipelineCacheFile class, the on disk form of the VkPipelineCache data
+/// @namespace ven
+///
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace ven {
+
+    static constexpr uint32_t PIPELINE_CACHE_UUID_SIZE = 16; // VK_UUID_SIZE
+
+    ///
+    /// @brief Device and driver a pipeline cache was built by, from VkPhysicalDeviceProperties
+    ///
+    struct PipelineCacheIdentity {
+        uint32_t vendorID{0};
+        uint32_t deviceID{0};
+        uint32_t driverVersion{0};
+        std::array<uint8_t, PIPELINE_CACHE_UUID_SIZE> uuid{}; // pipelineCacheUUID
+
+        bool operator==(const PipelineCacheIdentity&) const = default;
+    };
+
+    ///
+    /// @class PipelineCacheFile
+    /// @brief Header naming the device and the driver in front of the vkGetPipelineCacheData blob
+    /// @note the driver version is not in the header Vulkan puts in the blob, a driver update would otherwise feed the new driver an old cache
+    /// @namespace ven
+    ///
+    class PipelineCacheFile {
+
+        public:
+
+            static constexpr uint32_t FILE_MAGIC = 0x43505056; // "VPPC"
+            static constexpr uint32_t FILE_VERSION = 1;
+
+            PipelineCacheFile() = delete;
+
+            ///
+            /// @brief Write the cache through a temporary file renamed over the previous one, a crash never leaves a torn cache
+            ///
+            static void save(const std::string& filepath, const PipelineCacheIdentity& identity, std::span<const uint8_t> data);
+            ///
+            /// @return Cache data, empty when the file is missing, corrupted or written by another device or driver
+            ///
+            [[nodiscard]] static std::vector<uint8_t> load(const std::string& filepath, const PipelineCacheIdentity& identity);
+
+            [[nodiscard]] static std::vector<uint8_t> pack(const PipelineCacheIdentity& identity, std::span<const uint8_t> data);
+            ///
+            /// @brief Check the file header, the checksum and the Vulkan header of the blob against the identity
+            /// @return The blob, std::nullopt when any of them does not match
+            ///
+            [[nodiscard]] static std::optional<std::span<const uint8_t>> unpack(const PipelineCacheIdentity& identity, std::span<const uint8_t> file);
+
+    }; // class PipelineCacheFile
+
+} // namespace ven
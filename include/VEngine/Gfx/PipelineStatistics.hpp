@@ -0,0 +1,67 @@
+///
+/// @file PipelineStatistics.hpp
+/// @brief This file contains the PipelineStatistics class
+/// @namespace ven
+///
+
+#pragma once
+
+#include <array>
+
+#include "VEngine/Gfx/SwapChain.hpp"
+
+namespace ven {
+
+    ///
+    /// @class PipelineStatistics
+    /// @brief Fragment shader invocations of the geometry passes of a frame, read back once the frame fence has been waited on
+    /// @note does nothing when the device lacks pipelineStatisticsQuery
+    /// @namespace ven
+    ///
+    class PipelineStatistics {
+
+        public:
+
+            enum SCOPE : uint8_t {
+                DEPTH_PREPASS = 0,
+                LIT = 1
+            };
+
+            static constexpr uint32_t SCOPE_COUNT = 2;
+
+            explicit PipelineStatistics(const Device& device);
+            ~PipelineStatistics();
+
+            PipelineStatistics(const PipelineStatistics&) = delete;
+            PipelineStatistics& operator=(const PipelineStatistics&) = delete;
+            PipelineStatistics(PipelineStatistics&&) = delete;
+            PipelineStatistics& operator=(PipelineStatistics&&) = delete;
+
+            ///
+            /// @brief Read the counts of the previous use of the frame then reset its queries, must be called outside of a render pass
+            ///
+            void reset(VkCommandBuffer commandBuffer, unsigned long frameIndex);
+            ///
+            /// @brief Count the draws recorded until end, begin and end must be in the same subpass
+            ///
+            void begin(VkCommandBuffer commandBuffer, unsigned long frameIndex, SCOPE scope);
+            void end(VkCommandBuffer commandBuffer, unsigned long frameIndex, SCOPE scope) const;
+
+            [[nodiscard]] bool isSupported() const { return m_queryPool != VK_NULL_HANDLE; }
+            ///
+            /// @return Fragment shader invocations of the scope in the last frame read back, 0 when it was not recorded
+            ///
+            [[nodiscard]] uint64_t getFragmentInvocations(const SCOPE scope) const { return m_fragmentInvocations.at(scope); }
+
+        private:
+
+            [[nodiscard]] static uint32_t getQuery(const unsigned long frameIndex, const SCOPE scope) { return (static_cast<uint32_t>(frameIndex) * SCOPE_COUNT) + scope; }
+
+            const Device& m_device;
+            VkQueryPool m_queryPool{VK_NULL_HANDLE};
+            std::array<uint8_t, MAX_FRAMES_IN_FLIGHT> m_recorded{}; // bit per scope begun since the reset of the frame
+            std::array<uint64_t, SCOPE_COUNT> m_fragmentInvocations{};
+
+    }; // class PipelineStatistics
+
+} // namespace ven
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <cassert>
+#include <span>
 
 #include "VEngine/Gfx/SwapChain.hpp"
 
@@ -33,7 +34,13 @@ namespace ven {
             Renderer& operator=(Renderer &&) = delete;
 
             [[nodiscard]] VkRenderPass getSwapChainRenderPass() const { return m_swapChain->getRenderPass(); }
+            [[nodiscard]] VkRenderPass getDeferredRenderPass() const { return m_swapChain->getDeferredRenderPass(); }
             [[nodiscard]] float getAspectRatio() const { return m_swapChain->extentAspectRatio(); }
+            [[nodiscard]] VkExtent2D getSwapChainExtent() const { return m_swapChain->getSwapChainExtent(); }
+            [[nodiscard]] VkImage getCurrentDepthImage() const { return m_swapChain->getDepthImage(m_currentImageIndex); }
+            [[nodiscard]] VkImageView getCurrentDepthImageView() const { return m_swapChain->getDepthImageView(m_currentImageIndex); }
+            [[nodiscard]] VkFormat getSwapChainDepthFormat() const { return m_swapChain->getSwapChainDepthFormat(); }
+            [[nodiscard]] VkImageView getCurrentGBufferImageView(const GBUFFER_ATTACHMENT attachment) const { return m_swapChain->getGBufferImageView(m_currentImageIndex, attachment); }
             [[nodiscard]] bool isFrameInProgress() const { return m_isFrameStarted; }
             [[nodiscard]] const VkCommandBuffer& getCurrentCommandBuffer() const { assert(isFrameInProgress() && "cannot get command m_buffer when frame not in progress"); return m_commandBuffers[static_cast<unsigned long>(m_currentFrameIndex)]; }
             [[nodiscard]] const Window& getWindow() const { return m_window; }
@@ -50,10 +57,24 @@ namespace ven {
             VkCommandBuffer beginFrame();
             void endFrame();
             void beginSwapChainRenderPass(VkCommandBuffer commandBuffer) const;
+            ///
+            /// @brief Begin the render pass again, keeping the color and depth written so far (depth expected in read only layout)
+            ///
+            void resumeSwapChainRenderPass(VkCommandBuffer commandBuffer) const;
+            ///
+            /// @brief Begin the deferred render pass in its G-buffer subpass, end it with endSwapChainRenderPass
+            ///
+            void beginDeferredRenderPass(VkCommandBuffer commandBuffer) const;
+            ///
+            /// @brief Move the deferred render pass to its lighting subpass
+            ///
+            void nextSubpass(VkCommandBuffer commandBuffer) const;
             void endSwapChainRenderPass(VkCommandBuffer commandBuffer) const;
 
         private:
 
+            void beginRenderPass(VkCommandBuffer commandBuffer, VkRenderPass renderPass, VkFramebuffer framebuffer, std::span<const VkClearValue> clearValues) const;
+
             void createCommandBuffers();
             void freeCommandBuffers();
             void recreateSwapChain();
@@ -0,0 +1,81 @@
+///
+/// @file ShaderReflection.hpp
+/// @brief This file contains the ShaderReflection class, the descriptors and push constants read from SPIR-V modules
+/// @namespace ven
+///
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+namespace ven {
+
+    ///
+    /// @brief Descriptor read by the stages of a module, or of the modules merged into a reflection
+    ///
+    struct ReflectedBinding {
+        uint32_t set{0};
+        uint32_t binding{0};
+        VkDescriptorType descriptorType{VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER};
+        uint32_t count{1};
+        VkShaderStageFlags stageFlags{0};
+
+        bool operator==(const ReflectedBinding&) const = default;
+    };
+
+    ///
+    /// @class ShaderReflection
+    /// @brief Descriptor bindings and push constant range of one or several SPIR-V modules, what the layouts of their pipelines are built from
+    /// @note only the resources the functions of a module access are kept, a binding or a push constant block declared but never read reaches no layout
+    /// @namespace ven
+    ///
+    class ShaderReflection {
+
+        public:
+
+            ShaderReflection() = default;
+            ///
+            /// @param code Words of one SPIR-V module, throws when they are not one
+            ///
+            explicit ShaderReflection(std::span<const uint32_t> code);
+
+            [[nodiscard]] static ShaderReflection fromFile(const std::string& filepath);
+            ///
+            /// @brief Merge of the modules of a pipeline, empty paths are skipped
+            ///
+            [[nodiscard]] static ShaderReflection fromFiles(const std::vector<std::string>& filepaths);
+            ///
+            /// @brief Merge of every .spv module of a directory whose stages are all in stageFlags
+            ///
+            [[nodiscard]] static ShaderReflection fromDirectory(const std::string& path, VkShaderStageFlags stageFlags);
+
+            ///
+            /// @brief Add the descriptors and the push constants of other modules, throws when both sides declare a binding with different types
+            ///
+            void merge(const ShaderReflection& other);
+
+            ///
+            /// @return Bindings of a descriptor set, sorted by binding, in the form DescriptorSetLayout takes them
+            ///
+            [[nodiscard]] std::vector<VkDescriptorSetLayoutBinding> getSetBindings(uint32_t set) const;
+            [[nodiscard]] const std::vector<ReflectedBinding>& getBindings() const { return m_bindings; }
+            ///
+            /// @return Range from 0 to the end of the push constant block, its size is 0 when no stage reads one
+            ///
+            [[nodiscard]] const VkPushConstantRange& getPushConstantRange() const { return m_pushConstantRange; }
+            [[nodiscard]] VkShaderStageFlags getStageFlags() const { return m_stageFlags; }
+
+        private:
+
+            std::vector<ReflectedBinding> m_bindings; // sorted by set then binding
+            VkPushConstantRange m_pushConstantRange{};
+            VkShaderStageFlags m_stageFlags{0};
+
+    }; // class ShaderReflection
+
+} // namespace ven
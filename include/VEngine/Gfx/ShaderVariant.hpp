@@ -0,0 +1,56 @@
+///
+/// @file ShaderVariant.hpp
+/// @brief This file contains the ShaderVariant struct, the specialization constants of the lit shaders
+/// @namespace ven
+///
+
+#pragma once
+
+#include <array>
+
+#include <vulkan/vulkan.h>
+
+#include "VEngine/Gfx/AlphaMode.hpp"
+
+namespace ven {
+
+    static constexpr uint32_t DEFAULT_MAX_FRAGMENT_LIGHTS = 64;
+
+    ///
+    /// @brief Specialization constants of the shaders, the values are their constant_id
+    ///
+    enum SHADER_CONSTANT : uint8_t {
+        SHADER_CONSTANT_ALPHA_MODE = 0, // ALPHA_MODE of the draws, only ALPHA_BLEND reads the texture alpha
+        SHADER_CONSTANT_SHADOWS = 1, // sample the shadow maps of the lights
+        SHADER_CONSTANT_MAX_LIGHTS = 2, // lights of the cluster list shaded per fragment at most
+        SHADER_CONSTANT_COUNT = 3
+    };
+
+    ///
+    /// @brief Values of the specialization constants a pipeline is compiled with, laid out as the specialization data
+    /// @note the defaults are the ones of the shaders, a pipeline built with them behaves as if it was not specialized
+    ///
+    struct ShaderVariant {
+        uint32_t alphaMode{ALPHA_BLEND};
+        VkBool32 shadows{VK_TRUE};
+        uint32_t maxLights{DEFAULT_MAX_FRAGMENT_LIGHTS};
+
+        bool operator==(const ShaderVariant&) const = default;
+
+        ///
+        /// @brief Copy of this variant with the given constants taken from another one
+        /// @param constants Bit per SHADER_CONSTANT
+        ///
+        [[nodiscard]] ShaderVariant select(const ShaderVariant& variant, uint8_t constants) const;
+        [[nodiscard]] uint64_t getKey() const;
+        ///
+        /// @brief Specialization of a shader stage, points to this variant which must outlive the pipeline creation
+        ///
+        [[nodiscard]] VkSpecializationInfo getSpecializationInfo() const;
+
+        [[nodiscard]] static const std::array<VkSpecializationMapEntry, SHADER_CONSTANT_COUNT>& getMapEntries();
+    };
+
+    static constexpr auto SHADER_LIGHTING_CONSTANTS = static_cast<uint8_t>(1U << SHADER_CONSTANT_SHADOWS | 1U << SHADER_CONSTANT_MAX_LIGHTS);
+
+} // namespace ven
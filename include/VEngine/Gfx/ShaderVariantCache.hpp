@@ -0,0 +1,142 @@
+///
+/// @file ShaderVariantCache.hpp
+/// @brief This file contains the ShaderVariantCache class
+/// @namespace ven
+///
+
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+#include "VEngine/Gfx/Shaders.hpp"
+#include "VEngine/Utils/Logger.hpp"
+#include "VEngine/Utils/ThreadPool.hpp"
+
+namespace ven {
+
+    ///
+    /// @class BasicShaderVariantCache
+    /// @brief Pipelines of one render system slot, one per ShaderVariant it was asked for
+    /// @note only the constants the slot depends on come from the requested variant, the others keep the base ones so the requests differing by them share a pipeline
+    /// @note every variant is compiled on the pipeline workers of the Device, the first request of a variant returns the base one until it is ready
+    /// @note the base variant, with the defaults of the shaders, draws the same image as any other one, only slower: it is the fallback and the only variant waited for
+    /// @note templated on the pipeline type so the compile path can be tested without a device, see ShaderVariantCache
+    /// @namespace ven
+    ///
+    template<typename Pipeline>
+    class BasicShaderVariantCache {
+
+        public:
+
+            using Factory = std::function<std::unique_ptr<Pipeline>(const ShaderVariant& variant)>;
+
+            ///
+            /// @param threadPool Workers the variants are compiled on
+            /// @param factory Builds the pipeline of a variant, called once per variant from a worker
+            /// @param base Variant the constants outside of `constants` are taken from, its compilation starts right away
+            /// @param constants Bit per SHADER_CONSTANT read from the requested variants
+            ///
+            BasicShaderVariantCache(ThreadPool& threadPool, Factory factory, const ShaderVariant& base = {}, const uint8_t constants = 0) : m_threadPool{threadPool}, m_factory{std::move(factory)}, m_base{base}, m_constants{constants}
+            {
+                const std::scoped_lock lock(m_mutex);
+                m_variants.try_emplace(m_base.getKey());
+                compile(m_base);
+            }
+            ~BasicShaderVariantCache()
+            {
+                // the workers write into m_variants and call the factory, whose captures may not outlive this
+                std::unique_lock lock(m_mutex);
+                m_condition.wait(lock, [this] { return m_pending == 0; });
+            }
+
+            BasicShaderVariantCache(const BasicShaderVariantCache&) = delete;
+            BasicShaderVariantCache& operator=(const BasicShaderVariantCache&) = delete;
+            BasicShaderVariantCache(BasicShaderVariantCache&&) = delete;
+            BasicShaderVariantCache& operator=(BasicShaderVariantCache&&) = delete;
+
+            ///
+            /// @brief Pipeline of a variant, its compilation is queued on the first request
+            /// @return The variant when it is compiled, the base variant otherwise, waiting for it when it is not compiled yet either
+            ///
+            [[nodiscard]] const Pipeline& get(const ShaderVariant& variant) const
+            {
+                const ShaderVariant selected = m_base.select(variant, m_constants);
+                std::unique_lock lock(m_mutex);
+                auto [it, inserted] = m_variants.try_emplace(selected.getKey());
+                if (inserted) {
+                    compile(selected);
+                }
+                if (it->second.pipeline != nullptr) {
+                    return *it->second.pipeline;
+                }
+                // a failed variant keeps drawing with the base one, it is not queued again
+                if (!it->second.error.empty() && !it->second.reported) {
+                    it->second.reported = true;
+                    Logger::logWarning("Failed to compile a shader variant, keeping the base one: " + it->second.error);
+                }
+
+                const Variant& base = m_variants.at(m_base.getKey());
+                m_condition.wait(lock, [&base] { return base.pipeline != nullptr || !base.error.empty(); });
+                if (base.pipeline == nullptr) {
+                    throw std::runtime_error(base.error);
+                }
+                return *base.pipeline;
+            }
+            void bind(const VkCommandBuffer commandBuffer, const ShaderVariant& variant = {}) const { get(variant).bind(commandBuffer); }
+
+            [[nodiscard]] std::size_t getVariantCount() const
+            {
+                const std::scoped_lock lock(m_mutex);
+                return m_variants.size();
+            }
+
+        private:
+
+            struct Variant {
+                std::unique_ptr<Pipeline> pipeline; // set by the worker once compiled
+                std::string error; // set by the worker when the compilation failed
+                bool reported{false};
+            };
+
+            void compile(const ShaderVariant& variant) const
+            {
+                m_pending++;
+                m_threadPool.submit([this, variant] {
+                    std::unique_ptr<Pipeline> pipeline;
+                    std::string error;
+                    try {
+                        pipeline = m_factory(variant);
+                    } catch (const std::exception& exception) {
+                        error = exception.what();
+                    }
+                    // notified under the lock, the destructor can only see m_pending reach 0 once this task no longer touches the cache
+                    const std::scoped_lock lock(m_mutex);
+                    Variant& entry = m_variants.at(variant.getKey());
+                    entry.pipeline = std::move(pipeline);
+                    entry.error = std::move(error);
+                    m_pending--;
+                    m_condition.notify_all();
+                });
+            }
+
+            ThreadPool& m_threadPool;
+            Factory m_factory;
+            ShaderVariant m_base;
+            uint8_t m_constants;
+            // filled by the const get: a variant is a cached view of the same pipeline slot
+            mutable std::unordered_map<uint64_t, Variant> m_variants;
+            mutable uint32_t m_pending{0};
+            mutable std::mutex m_mutex;
+            mutable std::condition_variable m_condition;
+
+    }; // class BasicShaderVariantCache
+
+    using ShaderVariantCache = BasicShaderVariantCache<Shaders>;
+
+} // namespace ven
@@ -7,6 +7,7 @@
 #pragma once
 
 #include "VEngine/Core/Device.hpp"
+#include "VEngine/Gfx/ShaderVariant.hpp"
 
 namespace ven {
 
@@ -30,6 +31,7 @@ namespace ven {
         VkPipelineLayout pipelineLayout = nullptr;
         VkRenderPass renderPass = nullptr;
         uint32_t subpass = 0;
+        ShaderVariant variant{}; // specialization constants of every stage
     };
 
     ///
@@ -41,7 +43,15 @@ namespace ven {
 
         public:
 
+            ///
+            /// @note an empty fragFilepath creates a pipeline without fragment stage, for depth only draws
+            ///
             Shaders(const Device &device, const std::string& vertFilepath, const std::string& fragFilepath, const PipelineConfigInfo& configInfo) : m_device{device} { createGraphicsPipeline(vertFilepath, fragFilepath, configInfo); };
+            ///
+            /// @brief Task + mesh shader pipeline, the vertex input and input assembly states of the config are ignored
+            ///
+            Shaders(const Device &device, const std::string& taskFilepath, const std::string& meshFilepath, const std::string& fragFilepath, const PipelineConfigInfo& configInfo) : m_device{device} { createMeshPipeline(taskFilepath, meshFilepath, fragFilepath, configInfo); };
+            Shaders(const Device &device, const std::string& compFilepath, const VkPipelineLayout pipelineLayout) : m_device{device}, m_bindPoint{VK_PIPELINE_BIND_POINT_COMPUTE} { createComputePipeline(compFilepath, pipelineLayout); };
             ~Shaders();
 
             Shaders(const Shaders&) = delete;
@@ -50,18 +60,24 @@ namespace ven {
             Shaders& operator=(Shaders&&) = delete;
 
             static void defaultPipelineConfigInfo(PipelineConfigInfo& configInfo);
-            void bind(const VkCommandBuffer commandBuffer) const { vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_graphicsPipeline); }
+            void bind(const VkCommandBuffer commandBuffer) const { vkCmdBindPipeline(commandBuffer, m_bindPoint, m_pipeline); }
 
         private:
 
             static std::vector<char> readFile(const std::string &filename);
             void createGraphicsPipeline(const std::string& vertFilepath, const std::string& fragFilepath, const PipelineConfigInfo& configInfo);
+            void createMeshPipeline(const std::string& taskFilepath, const std::string& meshFilepath, const std::string& fragFilepath, const PipelineConfigInfo& configInfo);
+            void createComputePipeline(const std::string& compFilepath, VkPipelineLayout pipelineLayout);
             void createShaderModule(const std::vector<char>& code, VkShaderModule* shaderModule) const;
 
             const Device& m_device;
-            VkPipeline m_graphicsPipeline{nullptr};
+            VkPipelineBindPoint m_bindPoint{VK_PIPELINE_BIND_POINT_GRAPHICS};
+            VkPipeline m_pipeline{nullptr};
             VkShaderModule m_vertShaderModule{nullptr};
             VkShaderModule m_fragShaderModule{nullptr};
+            VkShaderModule m_compShaderModule{nullptr};
+            VkShaderModule m_taskShaderModule{nullptr};
+            VkShaderModule m_meshShaderModule{nullptr};
 
     }; // class Shaders
 
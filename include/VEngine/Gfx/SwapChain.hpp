@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <array>
 #include <memory>
 
 #include "VEngine/Core/Device.hpp"
@@ -14,6 +15,18 @@ namespace ven {
 
     static constexpr int MAX_FRAMES_IN_FLIGHT = 2;
 
+    ///
+    /// @brief G-buffer attachments written by the first subpass of the deferred render pass, attachment 2 + value of the pass
+    ///
+    enum GBUFFER_ATTACHMENT : uint8_t {
+        GBUFFER_ALBEDO = 0,
+        GBUFFER_NORMAL = 1, // octahedral encoded world normal
+        GBUFFER_MATERIAL = 2 // x: specular strength
+    };
+
+    static constexpr std::array<VkFormat, 3> GBUFFER_FORMATS{VK_FORMAT_R8G8B8A8_UNORM, VK_FORMAT_R16G16_SFLOAT, VK_FORMAT_R8G8B8A8_UNORM};
+    static constexpr uint32_t GBUFFER_ATTACHMENT_COUNT = GBUFFER_FORMATS.size();
+
     ///
     /// @class SwapChain
     /// @brief Class for swap chain
@@ -33,10 +46,24 @@ namespace ven {
             SwapChain& operator=(SwapChain &&) = delete;
 
             [[nodiscard]] const VkFramebuffer& getFrameBuffer(const unsigned long index) const { return m_swapChainFrameBuffers[index]; }
+            ///
+            /// @note the render passes are handed over to the swap chain recreated from this one when the formats match, the pipelines built against them outlive a resize
+            ///
             [[nodiscard]] const VkRenderPass& getRenderPass() const { return m_renderPass; }
+            [[nodiscard]] const VkRenderPass& getLoadRenderPass() const { return m_loadRenderPass; }
+            ///
+            /// @brief Two subpass pass: the G-buffer and depth, then the lighting reading them as input attachments into the swap chain image
+            /// @note compatible with getLoadRenderPass on the swap chain image and depth once it ended, the depth is left in read only layout
+            ///
+            [[nodiscard]] const VkRenderPass& getDeferredRenderPass() const { return m_deferredRenderPass; }
+            [[nodiscard]] const VkFramebuffer& getDeferredFrameBuffer(const unsigned long index) const { return m_deferredFrameBuffers[index]; }
+            [[nodiscard]] const VkImageView& getGBufferImageView(const unsigned long index, const GBUFFER_ATTACHMENT attachment) const { return m_gBufferImageViews[(index * GBUFFER_ATTACHMENT_COUNT) + attachment]; }
+            [[nodiscard]] const VkImage& getDepthImage(const unsigned long index) const { return m_depthImages[index]; }
+            [[nodiscard]] const VkImageView& getDepthImageView(const unsigned long index) const { return m_depthImageViews[index]; }
             [[nodiscard]] const VkImageView& getImageView(const int index) const { return m_swapChainImageViews[static_cast<unsigned long>(index)]; }
             [[nodiscard]] size_t imageCount() const { return m_swapChainImages.size(); }
             [[nodiscard]] const VkFormat& getSwapChainImageFormat() const { return m_swapChainImageFormat; }
+            [[nodiscard]] const VkFormat& getSwapChainDepthFormat() const { return m_swapChainDepthFormat; }
             [[nodiscard]] const VkExtent2D& getSwapChainExtent() const { return m_swapChainExtent; }
             [[nodiscard]] uint32_t width() const { return m_swapChainExtent.width; }
             [[nodiscard]] uint32_t height() const { return m_swapChainExtent.height; }
@@ -53,6 +80,11 @@ namespace ven {
             void createImageViews();
             void createDepthResources();
             void createRenderPass();
+            void createDeferredRenderPass();
+            ///
+            /// @brief Transient G-buffer images, backed by lazily allocated memory when their memory requirements allow it so they can stay in tile memory
+            ///
+            void createGBufferResources();
             void createFrameBuffers();
             void createSyncObjects();
             [[nodiscard]] static VkSurfaceFormatKHR chooseSwapSurfaceFormat(const std::vector<VkSurfaceFormatKHR> &availableFormats);
@@ -67,10 +99,17 @@ namespace ven {
 
             std::vector<VkFramebuffer> m_swapChainFrameBuffers;
             VkRenderPass m_renderPass{};
+            VkRenderPass m_loadRenderPass{};
+            std::vector<VkFramebuffer> m_deferredFrameBuffers;
+            VkRenderPass m_deferredRenderPass{};
 
             std::vector<VkImage> m_depthImages;
             std::vector<VkDeviceMemory> m_depthImageMemory;
             std::vector<VkImageView> m_depthImageViews;
+            // GBUFFER_ATTACHMENT_COUNT per swap chain image
+            std::vector<VkImage> m_gBufferImages;
+            std::vector<VkDeviceMemory> m_gBufferImageMemory;
+            std::vector<VkImageView> m_gBufferImageViews;
             std::vector<VkImage> m_swapChainImages;
             std::vector<VkImageView> m_swapChainImageViews;
 
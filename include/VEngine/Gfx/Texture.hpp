@@ -9,6 +9,7 @@
 #include <memory>
 
 #include "VEngine/Core/Device.hpp"
+#include "VEngine/Gfx/AlphaMode.hpp"
 
 namespace ven {
 
@@ -41,6 +42,14 @@ namespace ven {
             [[nodiscard]] const VkImageLayout& getImageLayout() const { return m_textureLayout; }
             [[nodiscard]] const VkExtent3D& getExtent() const { return m_extent; }
             [[nodiscard]] const VkFormat& getFormat() const { return m_format; }
+            ///
+            /// @brief File the texture was loaded from, empty for attachments
+            ///
+            [[nodiscard]] const std::string& getFilepath() const { return m_filepath; }
+            ///
+            /// @brief Alpha class of the loaded texels, see classifyAlpha, attachments are opaque
+            ///
+            [[nodiscard]] ALPHA_MODE getAlphaMode() const { return m_alphaMode; }
 
         private:
 
@@ -59,6 +68,8 @@ namespace ven {
             uint32_t m_mipLevels{1};
             uint32_t m_layerCount{1};
             VkExtent3D m_extent{};
+            std::string m_filepath;
+            ALPHA_MODE m_alphaMode{ALPHA_OPAQUE};
 
     }; // class Texture
 
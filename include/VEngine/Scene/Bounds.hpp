@@ -0,0 +1,59 @@
+///
+/// @file Bounds.hpp
+/// @brief This file contains the AABB and BoundingSphere structs
+/// @namespace ven
+///
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <glm/glm.hpp>
+
+namespace ven {
+
+    ///
+    /// @struct AABB
+    /// @brief Axis aligned bounding box
+    /// @namespace ven
+    ///
+    struct AABB {
+        glm::vec3 min{std::numeric_limits<float>::max()};
+        glm::vec3 max{std::numeric_limits<float>::lowest()};
+
+        void expand(const glm::vec3& point) { min = glm::min(min, point); max = glm::max(max, point); }
+        void expand(const AABB& other) { min = glm::min(min, other.min); max = glm::max(max, other.max); }
+
+        [[nodiscard]] bool isValid() const { return min.x <= max.x && min.y <= max.y && min.z <= max.z; }
+        [[nodiscard]] glm::vec3 center() const { return (min + max) * 0.5F; }
+        [[nodiscard]] glm::vec3 extent() const { return (max - min) * 0.5F; }
+
+        ///
+        /// @brief Box enclosing the transformed box (center transformed, extent through the absolute rotation/scale)
+        ///
+        [[nodiscard]] AABB transform(const glm::mat4& matrix) const {
+            const glm::vec3 newCenter = glm::vec3(matrix * glm::vec4(center(), 1.F));
+            const glm::vec3 halfExtent = extent();
+            const glm::vec3 newExtent = abs(glm::vec3(matrix[0])) * halfExtent.x + abs(glm::vec3(matrix[1])) * halfExtent.y + abs(glm::vec3(matrix[2])) * halfExtent.z;
+            return { .min = newCenter - newExtent, .max = newCenter + newExtent };
+        }
+    };
+
+    ///
+    /// @struct BoundingSphere
+    /// @brief Bounding sphere, transformed conservatively (largest axis scale)
+    /// @namespace ven
+    ///
+    struct BoundingSphere {
+        glm::vec3 center{0.F};
+        float radius{0.F};
+
+        [[nodiscard]] BoundingSphere transform(const glm::mat4& matrix) const {
+            const float scaleSq = std::max({dot(glm::vec3(matrix[0]), glm::vec3(matrix[0])), dot(glm::vec3(matrix[1]), glm::vec3(matrix[1])), dot(glm::vec3(matrix[2]), glm::vec3(matrix[2]))});
+            return { .center = glm::vec3(matrix * glm::vec4(center, 1.F)), .radius = radius * std::sqrt(scaleSq) };
+        }
+    };
+
+} // namespace ven
@@ -0,0 +1,93 @@
+///
+/// @file Culler.hpp
+/// @brief This file contains the FrustumCuller class
+/// @namespace ven
+///
+
+#pragma once
+
+#include <vector>
+
+#include "VEngine/Scene/Frustum.hpp"
+
+namespace ven {
+
+    static constexpr float DEFAULT_MIN_PIXEL_SIZE = 2.F;
+
+    struct CullingStats {
+        uint32_t tested{0};
+        uint32_t pvsCulled{0};
+        uint32_t frustumCulled{0};
+        uint32_t smallCulled{0};
+        uint32_t submitted{0};
+        float timeMS{0.F};
+    };
+
+    ///
+    /// @class FrustumCuller
+    /// @brief Batch visibility test of world space bounding spheres against the camera frustum and a projected size threshold
+    /// @namespace ven
+    ///
+    class FrustumCuller {
+
+        public:
+
+            FrustumCuller() = default;
+            ~FrustumCuller() = default;
+
+            FrustumCuller(const FrustumCuller&) = delete;
+            FrustumCuller& operator=(const FrustumCuller&) = delete;
+            FrustumCuller(FrustumCuller&&) = delete;
+            FrustumCuller& operator=(FrustumCuller&&) = delete;
+
+            ///
+            /// @brief Clear the batch and setup the frustum for this frame
+            /// @param projection Camera projection matrix
+            /// @param view Camera view matrix
+            /// @param viewportHeight Height of the render target in pixels, used for the small object test
+            ///
+            void begin(const glm::mat4& projection, const glm::mat4& view, float viewportHeight);
+            ///
+            /// @brief Queue a world space sphere
+            /// @return Index to query with isVisible once cull has been called
+            ///
+            uint32_t add(const BoundingSphere& sphere);
+            ///
+            /// @brief Queue an entry already rejected by the potentially visible set, keeps the indices aligned with the draw loop
+            ///
+            uint32_t addHidden();
+            void cull();
+
+            [[nodiscard]] bool isVisible(const uint32_t index) const { return m_visible[index] != 0; }
+            [[nodiscard]] const std::vector<uint8_t>& getVisibility() const { return m_visible; }
+            [[nodiscard]] const CullingStats& getStats() const { return m_stats; }
+            [[nodiscard]] const Frustum& getFrustum() const { return m_frustum; }
+            [[nodiscard]] const glm::vec3& getCameraPosition() const { return m_cameraPosition; }
+            [[nodiscard]] bool isPvsEnabled() const { return m_pvsEnabled; }
+            void setPvsEnabled(const bool enabled) { m_pvsEnabled = enabled; }
+            [[nodiscard]] float getMinPixelSize() const { return m_minPixelSize; }
+            [[nodiscard]] bool isEnabled() const { return m_enabled; }
+            void setMinPixelSize(const float minPixelSize) { m_minPixelSize = minPixelSize; }
+            void setEnabled(const bool enabled) { m_enabled = enabled; }
+
+        private:
+
+            void cullRange(std::size_t first, std::size_t last);
+
+            Frustum m_frustum;
+            glm::vec3 m_cameraPosition{0.F};
+            float m_projectionScale{1.F};
+            float m_minPixelSize{DEFAULT_MIN_PIXEL_SIZE};
+            bool m_enabled{true};
+            bool m_pvsEnabled{true};
+
+            std::vector<float> m_centerX;
+            std::vector<float> m_centerY;
+            std::vector<float> m_centerZ;
+            std::vector<float> m_radius;
+            std::vector<uint8_t> m_visible;
+            CullingStats m_stats;
+
+    }; // class FrustumCuller
+
+} // namespace ven
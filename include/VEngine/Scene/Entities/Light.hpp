@@ -1,12 +1,16 @@
 ///
 /// @file Light.hpp
-/// @brief This file contains the Light class
+/// @brief This file contains the LightStore class
 /// @namespace ven
 ///
 
 #pragma once
 
-#include "VEngine/Scene/Transform3D.hpp"
+#include <span>
+#include <string>
+
+#include "VEngine/Scene/SceneGraph.hpp"
+#include "VEngine/Utils/SparseSet.hpp"
 
 namespace ven {
 
@@ -15,44 +19,90 @@ namespace ven {
     static constexpr float DEFAULT_SHININESS = 32.F;
     static constexpr glm::vec4 DEFAULT_LIGHT_COLOR = {glm::vec3(1.F), DEFAULT_LIGHT_INTENSITY};
 
-    static constexpr uint8_t MAX_LIGHTS = 10;
+    enum LIGHT_FLAG : uint8_t {
+        LIGHT_ANIMATED = 1U << 0, // orbits around the world y axis, see SceneManager::updateBuffer
+        LIGHT_SHADOW = 1U << 1 // casts cube shadows from the shadow atlas, see ShadowCache
+    };
 
     ///
-    /// @class Light
-    /// @brief Class for light
+    /// @class LightStore
+    /// @brief Point lights of the scene, one dense column per component
+    /// @note each light owns a SceneGraph node holding its local transform, so it can follow an object
+    /// @note the storage is private, lights only come and go through create, erase and clear so their node follows them
     /// @namespace ven
     ///
-    class Light {
+    class LightStore : SparseSet<Transform3D, uint32_t, glm::vec3, glm::vec4, float, uint8_t, std::string> {
 
         public:
 
-            using Map = std::unordered_map<unsigned int, Light>;
-
-            explicit Light(const unsigned int objId) : m_lightId{objId} {}
-
-            ~Light() = default;
-
-            Light(const Light&) = delete;
-            Light& operator=(const Light&) = delete;
-            Light(Light&&) = default;
-            Light& operator=(Light&&) = default;
-
-            [[nodiscard]] unsigned int getId() const { return m_lightId; }
-            [[nodiscard]] const std::string& getName() const { return m_name; }
-            [[nodiscard]] float getShininess() const { return m_shininess; }
-
-            void setName(const std::string &name) { m_name = name; }
-            void setShininess(const float shininess) { m_shininess = shininess; }
-
-            glm::vec4 color{DEFAULT_LIGHT_COLOR};
-            Transform3D transform{};
+            enum Column : uint8_t { TRANSFORM, NODE, POSITION, COLOR, SHININESS, FLAGS, NAME };
+
+            explicit LightStore(SceneGraph& sceneGraph) : m_sceneGraph{sceneGraph} {}
+
+            Handle create(const Transform3D& transform, const glm::vec4& color, const float shininess = DEFAULT_SHININESS, const std::string& name = "point light", const uint32_t parentNode = SceneGraph::NONE, const uint8_t flags = 0) {
+                return insert(transform, m_sceneGraph.add(transform, parentNode), transform.translation, color, shininess, flags, name);
+            }
+            bool erase(const Handle handle) {
+                if (!contains(handle)) { return false; }
+                m_sceneGraph.remove(nodes()[indexOf(handle)]);
+                return SparseSet::erase(handle);
+            }
+            void clear() {
+                for (const uint32_t node : nodes()) {
+                    m_sceneGraph.remove(node);
+                }
+                SparseSet::clear();
+            }
+
+            using SparseSet::contains;
+            using SparseSet::empty;
+            using SparseSet::handles;
+            using SparseSet::indexOf;
+            using SparseSet::reserve;
+            using SparseSet::size;
+
+            void setTransform(const uint32_t index, const Transform3D& transform) {
+                column<TRANSFORM>()[index] = transform;
+                m_sceneGraph.setLocal(column<NODE>()[index], transform);
+            }
+            ///
+            /// @brief Attach a light to a node of the scene graph (NONE to detach it), its transform becomes relative to that node
+            ///
+            void setParent(const uint32_t index, const uint32_t parentNode) { m_sceneGraph.setParent(column<NODE>()[index], parentNode); }
+            ///
+            /// @brief Copy the world positions from the scene graph, which must be up to date
+            ///
+            void updateWorld() {
+                for (uint32_t i = 0; i < size(); i++) {
+                    column<POSITION>()[i] = glm::vec3(m_sceneGraph.getWorld(column<NODE>()[i])[3]);
+                }
+            }
+
+            ///
+            /// @brief Local transforms, relative to the parent node, scale.x is the radius
+            ///
+            [[nodiscard]] std::span<const Transform3D> transforms() const { return column<TRANSFORM>(); }
+            [[nodiscard]] std::span<const uint32_t> nodes() const { return column<NODE>(); }
+            [[nodiscard]] uint32_t getParent(const uint32_t index) const { return m_sceneGraph.getParent(column<NODE>()[index]); }
+            ///
+            /// @brief World positions, refreshed by updateWorld
+            ///
+            [[nodiscard]] std::span<const glm::vec3> positions() const { return column<POSITION>(); }
+            [[nodiscard]] std::span<glm::vec4> colors() { return column<COLOR>(); }
+            [[nodiscard]] std::span<const glm::vec4> colors() const { return column<COLOR>(); }
+            [[nodiscard]] std::span<float> shininess() { return column<SHININESS>(); }
+            [[nodiscard]] std::span<const float> shininess() const { return column<SHININESS>(); }
+            ///
+            /// @brief LIGHT_FLAG bits
+            ///
+            [[nodiscard]] std::span<uint8_t> flags() { return column<FLAGS>(); }
+            [[nodiscard]] std::span<const uint8_t> flags() const { return column<FLAGS>(); }
+            [[nodiscard]] std::span<const std::string> names() const { return column<NAME>(); }
 
         private:
 
-            unsigned int m_lightId;
-            std::string m_name{"point light"};
-            float m_shininess{DEFAULT_SHININESS};
+            SceneGraph& m_sceneGraph;
 
-    }; // class Light
+    }; // class LightStore
 
 } // namespace ven
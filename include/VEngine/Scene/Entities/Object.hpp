@@ -1,58 +1,129 @@
 ///
 /// @file Object.hpp
-/// @brief This file contains the Object class
+/// @brief This file contains the ObjectStore class
 /// @namespace ven
 ///
 
 #pragma once
 
+#include <span>
+
 #include "VEngine/Gfx/Model.hpp"
-#include "VEngine/Scene/Transform3D.hpp"
+#include "VEngine/Gfx/SwapChain.hpp"
+#include "VEngine/Scene/SceneGraph.hpp"
+#include "VEngine/Scene/SpatialIndex.hpp"
+#include "VEngine/Scene/TransformBatch.hpp"
+#include "VEngine/Utils/SparseSet.hpp"
 
 namespace ven {
 
-    static constexpr uint16_t MAX_OBJECTS = 1000;
+    using ObjectBufferInfos = std::array<VkDescriptorBufferInfo, MAX_FRAMES_IN_FLIGHT>;
+
+    struct WorldMatrices {
+        glm::mat4 model{1.F};
+        glm::mat4 normal{1.F};
+    };
 
     ///
-    /// @class Object
-    /// @brief Class for object
+    /// @class ObjectStore
+    /// @brief Objects of the scene, one dense column per component, the dense index is also the slot of the object in the per frame uniform buffer
+    /// @note each object owns a SceneGraph node holding its local transform, the cached world matrices are refreshed from the graph by updateWorld
+    /// @note each object with a model owns a SpatialIndex proxy, refitted by updateWorld
+    /// @note the storage is private, entities only come and go through create, erase and clear so their node and proxy follow them
     /// @namespace ven
     ///
-    class Object {
+    class ObjectStore : SparseSet<Transform3D, uint32_t, WorldMatrices, AABB, std::shared_ptr<Model>, std::shared_ptr<Texture>, uint8_t, ObjectBufferInfos, uint64_t, uint32_t, std::vector<uint8_t>, std::string> {
 
         public:
 
-            using Map = std::unordered_map<unsigned int, Object>;
-
-            explicit Object(const unsigned int objId) : m_objId{objId} {}
-
-            ~Object() = default;
-
-            Object(const Object &) = delete;
-            Object &operator=(const Object &) = delete;
-            Object(Object &&) = default;
-            Object &operator=(Object &&) = default;
-
-            [[nodiscard]] unsigned int getId() const { return m_objId; }
-            [[nodiscard]] const std::string& getName() const { return m_name; }
-            [[nodiscard]] std::shared_ptr<Model> getModel() const { return m_model; }
-            [[nodiscard]] std::shared_ptr<Texture> getDiffuseMap() const { return m_diffuseMap; }
-            [[nodiscard]] VkDescriptorBufferInfo getBufferInfo(const int frameIndex) const { return m_bufferInfo.at(frameIndex); }
-            void setModel(const std::shared_ptr<Model> &model) { m_model = model; }
-            void setDiffuseMap(const std::shared_ptr<Texture> &diffuseMap) { m_diffuseMap = diffuseMap; }
-            void setName(const std::string &name) { m_name = name; }
-            void setBufferInfo(const int frameIndex, const VkDescriptorBufferInfo& info) { m_bufferInfo[frameIndex] = info; }
-
-            Transform3D transform{};
+            enum Column : uint8_t { TRANSFORM, NODE, WORLD, BOUNDS, MODEL, DIFFUSE_MAP, OCCLUDER, BUFFER_INFO, VERSION, PROXY, LOD, NAME };
+
+            ObjectStore(SceneGraph& sceneGraph, SpatialIndex& spatialIndex) : m_sceneGraph{sceneGraph}, m_spatialIndex{spatialIndex} {}
+
+            Handle create(const std::shared_ptr<Model>& model, const std::shared_ptr<Texture>& diffuseMap, const std::string& name, const Transform3D& transform, const bool occluder = false, const uint32_t parentNode = SceneGraph::NONE) {
+                return insert(transform, m_sceneGraph.add(transform, parentNode), {}, {}, model, diffuseMap, static_cast<uint8_t>(occluder), {}, 0, SpatialIndex::NONE, {}, name);
+            }
+            bool erase(const Handle handle) {
+                if (!contains(handle)) { return false; }
+                release(indexOf(handle));
+                return SparseSet::erase(handle);
+            }
+            void clear() {
+                for (uint32_t i = 0; i < size(); i++) {
+                    release(i);
+                }
+                SparseSet::clear();
+            }
+
+            using SparseSet::contains;
+            using SparseSet::empty;
+            using SparseSet::handles;
+            using SparseSet::indexOf;
+            using SparseSet::reserve;
+            using SparseSet::size;
+
+            void setTransform(const uint32_t index, const Transform3D& transform) {
+                column<TRANSFORM>()[index] = transform;
+                m_sceneGraph.setLocal(column<NODE>()[index], transform);
+            }
+            ///
+            /// @brief Attach an object to a node of the scene graph (NONE to detach it), its transform becomes relative to that node
+            ///
+            void setParent(const uint32_t index, const uint32_t parentNode) { m_sceneGraph.setParent(column<NODE>()[index], parentNode); }
+            ///
+            /// @brief Copy the world matrices of the objects whose node changed since the last call, recompute their bounds and refit their spatial index proxy, the scene graph must be up to date
+            /// @note objects without a parent get their matrices from the SIMD TransformBatch kernel, children from the graph with a general inverse for the normal matrix
+            /// @return Number of objects updated
+            ///
+            uint32_t updateWorld();
+
+            ///
+            /// @brief Local transforms, relative to the parent node
+            ///
+            [[nodiscard]] std::span<const Transform3D> transforms() const { return column<TRANSFORM>(); }
+            [[nodiscard]] std::span<const uint32_t> nodes() const { return column<NODE>(); }
+            [[nodiscard]] uint32_t getParent(const uint32_t index) const { return m_sceneGraph.getParent(column<NODE>()[index]); }
+            ///
+            /// @brief Cached model and normal matrices, refreshed by updateWorld
+            ///
+            [[nodiscard]] std::span<const WorldMatrices> worlds() const { return column<WORLD>(); }
+            ///
+            /// @brief World space bounds, refreshed by updateWorld
+            ///
+            [[nodiscard]] std::span<const AABB> bounds() const { return column<BOUNDS>(); }
+            ///
+            /// @brief Scene graph version of the cached world matrices, unique across objects and updates
+            ///
+            [[nodiscard]] std::span<const uint64_t> versions() const { return column<VERSION>(); }
+            [[nodiscard]] std::span<const std::shared_ptr<Model>> models() const { return column<MODEL>(); }
+            [[nodiscard]] std::span<const std::shared_ptr<Texture>> diffuseMaps() const { return column<DIFFUSE_MAP>(); }
+            [[nodiscard]] std::span<uint8_t> occluders() { return column<OCCLUDER>(); }
+            [[nodiscard]] std::span<const uint8_t> occluders() const { return column<OCCLUDER>(); }
+            [[nodiscard]] std::span<ObjectBufferInfos> bufferInfos() { return column<BUFFER_INFO>(); }
+            [[nodiscard]] std::span<const ObjectBufferInfos> bufferInfos() const { return column<BUFFER_INFO>(); }
+            ///
+            /// @brief Level of detail drawn in the previous frame, one per mesh (or one for the whole model), kept for the LodSelector hysteresis
+            ///
+            [[nodiscard]] std::span<std::vector<uint8_t>> lods() { return column<LOD>(); }
+            [[nodiscard]] std::span<const std::vector<uint8_t>> lods() const { return column<LOD>(); }
+            [[nodiscard]] std::span<const std::string> names() const { return column<NAME>(); }
 
         private:
 
-            unsigned int m_objId;
-            std::string m_name;
-            std::shared_ptr<Model> m_model = nullptr;
-            std::shared_ptr<Texture> m_diffuseMap = nullptr;
-            std::unordered_map<int, VkDescriptorBufferInfo> m_bufferInfo;
-
-    }; // class Object
+            void release(const uint32_t index) {
+                m_sceneGraph.remove(column<NODE>()[index]);
+                if (column<PROXY>()[index] != SpatialIndex::NONE) { m_spatialIndex.remove(column<PROXY>()[index]); }
+            }
+
+            SceneGraph& m_sceneGraph;
+            SpatialIndex& m_spatialIndex;
+            // scratch of updateWorld, kept to avoid allocations every frame
+            TransformBatch m_batch;
+            std::vector<uint32_t> m_batchIndices;
+            std::vector<uint32_t> m_changed;
+            std::vector<glm::mat4> m_batchModels;
+            std::vector<glm::mat4> m_batchNormals;
+
+    }; // class ObjectStore
 
 } // namespace ven
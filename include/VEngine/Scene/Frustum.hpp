@@ -0,0 +1,50 @@
+///
+/// @file Frustum.hpp
+/// @brief This file contains the Frustum class
+/// @namespace ven
+///
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "VEngine/Scene/Bounds.hpp"
+
+namespace ven {
+
+    enum FRUSTUM_PLANE : uint8_t {
+        PLANE_LEFT = 0,
+        PLANE_RIGHT = 1,
+        PLANE_BOTTOM = 2,
+        PLANE_TOP = 3,
+        PLANE_NEAR = 4,
+        PLANE_FAR = 5,
+        PLANE_COUNT = 6
+    };
+
+    ///
+    /// @class Frustum
+    /// @brief Six normalized world space planes (xyz = inward normal, w = distance) extracted from a view-projection matrix
+    /// @namespace ven
+    ///
+    class Frustum {
+
+        public:
+
+            Frustum() = default;
+            explicit Frustum(const glm::mat4& viewProjection) { update(viewProjection); }
+
+            void update(const glm::mat4& viewProjection);
+
+            [[nodiscard]] bool intersects(const BoundingSphere& sphere) const;
+            [[nodiscard]] bool intersects(const AABB& box) const;
+            [[nodiscard]] const std::array<glm::vec4, PLANE_COUNT>& getPlanes() const { return m_planes; }
+
+        private:
+
+            std::array<glm::vec4, PLANE_COUNT> m_planes{};
+
+    }; // class Frustum
+
+} // namespace ven
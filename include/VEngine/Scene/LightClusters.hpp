@@ -0,0 +1,82 @@
+///
+/// @file LightClusters.hpp
+/// @brief This file contains the LightClusters class
+/// @namespace ven
+///
+
+#pragma once
+
+#include <cstdint>
+
+#include "VEngine/Scene/Bounds.hpp"
+
+namespace ven {
+
+    // clusters of the view frustum, screen tiles along x and y, exponential depth slices along z, must match light_cluster.comp
+    static constexpr uint32_t CLUSTER_GRID_X = 16;
+    static constexpr uint32_t CLUSTER_GRID_Y = 9;
+    static constexpr uint32_t CLUSTER_GRID_Z = 24;
+    static constexpr uint32_t CLUSTER_COUNT = CLUSTER_GRID_X * CLUSTER_GRID_Y * CLUSTER_GRID_Z;
+    // lit contribution (intensity * attenuation) under which a light no longer reaches a surface
+    static constexpr float DEFAULT_LIGHT_CUTOFF = 1.F / 256.F;
+
+    ///
+    /// @class LightClusters
+    /// @brief Cluster grid of the clustered forward lighting: maps view space positions to clusters and gives the view space bounds of each cluster
+    /// @note the same mapping is done on the GPU by light_cluster.comp (light lists) and fragment_shader.frag (lookup), this class is its reference
+    /// @namespace ven
+    ///
+    class LightClusters {
+
+        public:
+
+            LightClusters() = default;
+            ~LightClusters() = default;
+
+            LightClusters(const LightClusters&) = delete;
+            LightClusters& operator=(const LightClusters&) = delete;
+            LightClusters(LightClusters&&) = delete;
+            LightClusters& operator=(LightClusters&&) = delete;
+
+            ///
+            /// @brief Setup the grid of this frame
+            /// @param projection Perspective projection of the camera (Camera::setPerspectiveProjection)
+            /// @param near Near plane distance
+            /// @param far Far plane distance
+            /// @param viewport Size of the render target in pixels
+            ///
+            void begin(const glm::mat4& projection, float near, float far, const glm::vec2& viewport);
+            ///
+            /// @return xy: clusters per pixel, z and w: scale and bias turning log(view depth) into a depth slice, stored in GlobalUbo::clusterScale
+            ///
+            [[nodiscard]] const glm::vec4& getScale() const { return m_scale; }
+            ///
+            /// @return Cluster holding a fragment, clamped to the grid
+            /// @param pixel Window coordinates of the fragment
+            /// @param depth View space depth of the fragment
+            ///
+            [[nodiscard]] glm::uvec3 getCluster(const glm::vec2& pixel, float depth) const;
+            [[nodiscard]] static uint32_t getClusterIndex(const glm::uvec3& cluster) { return cluster.x + (CLUSTER_GRID_X * (cluster.y + (CLUSTER_GRID_Y * cluster.z))); }
+            ///
+            /// @return View space box enclosing the part of the frustum covered by a cluster
+            ///
+            [[nodiscard]] AABB getBounds(const glm::uvec3& cluster) const;
+            ///
+            /// @return Whether a light sphere (view space center, range) touches a cluster box
+            ///
+            [[nodiscard]] static bool intersects(const AABB& bounds, const glm::vec3& center, float range);
+            ///
+            /// @return Distance at which the contribution of a light falls under the cutoff, see the attenuation of fragment_shader.frag
+            /// @param intensity Light intensity (color alpha)
+            /// @param radius Light radius (transform scale x)
+            ///
+            [[nodiscard]] static float getRange(float intensity, float radius, float cutoff = DEFAULT_LIGHT_CUTOFF);
+
+        private:
+
+            glm::vec2 m_projectionScale{1.F}; // projection[0][0] and projection[1][1], view space x / depth -> NDC
+            glm::vec4 m_scale{0.F};
+
+    }; // class LightClusters
+
+} // namespace ven
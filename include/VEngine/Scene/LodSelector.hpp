@@ -0,0 +1,93 @@
+///
+/// @file LodSelector.hpp
+/// @brief This file contains the LodSelector class
+/// @namespace ven
+///
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+
+#include "VEngine/Scene/Bounds.hpp"
+
+namespace ven {
+
+    static constexpr std::size_t MAX_LOD_COUNT = 4;
+    static constexpr float DEFAULT_LOD_PIXEL_ERROR = 1.F;
+    static constexpr float DEFAULT_LOD_HYSTERESIS = 0.25F;
+
+    ///
+    /// @brief Index range of one level of detail in the model index buffer
+    ///
+    struct MeshLod {
+        uint32_t firstIndex{0};
+        uint32_t indexCount{0};
+        float error{0.F}; // model space distance to the full detail surface, 0 for the full detail level
+    };
+
+    struct LodStats {
+        std::array<uint32_t, MAX_LOD_COUNT> selected{}; // draws per level
+        uint64_t indexCount{0}; // indices of the selected levels
+        uint64_t baseIndexCount{0}; // indices the same draws would have at full detail
+    };
+
+    ///
+    /// @class LodSelector
+    /// @brief Pick the coarsest level of detail whose error projected on screen stays under a pixel threshold
+    /// @note a level is only left for a coarser one below threshold * (1 - hysteresis) and for a finer one above threshold * (1 + hysteresis), so objects moving around the threshold don't pop every frame
+    /// @namespace ven
+    ///
+    class LodSelector {
+
+        public:
+
+            LodSelector() = default;
+            ~LodSelector() = default;
+
+            LodSelector(const LodSelector&) = delete;
+            LodSelector& operator=(const LodSelector&) = delete;
+            LodSelector(LodSelector&&) = delete;
+            LodSelector& operator=(LodSelector&&) = delete;
+
+            ///
+            /// @brief Setup the projection of this frame and reset the stats
+            /// @param cameraPosition World space position of the camera
+            /// @param fov Vertical field of view in radians (Camera::getFov)
+            /// @param viewportHeight Height of the render target in pixels
+            ///
+            void begin(const glm::vec3& cameraPosition, float fov, float viewportHeight);
+            ///
+            /// @return Size in pixels of a world space error at the distance of the sphere, the closest point of the sphere is used
+            ///
+            [[nodiscard]] float getScreenError(float error, const BoundingSphere& sphere) const;
+            ///
+            /// @brief Select the level to draw and count it in the stats
+            /// @param lods Levels of the mesh, finest first
+            /// @param sphere Model space bounds of the mesh
+            /// @param model Model matrix, its largest axis scale converts the level errors to world space
+            /// @param current Level drawn in the previous frame
+            ///
+            uint8_t select(std::span<const MeshLod> lods, const BoundingSphere& sphere, const glm::mat4& model, uint8_t current);
+
+            [[nodiscard]] const LodStats& getStats() const { return m_stats; }
+            [[nodiscard]] float getPixelError() const { return m_pixelError; }
+            [[nodiscard]] float getHysteresis() const { return m_hysteresis; }
+            [[nodiscard]] bool isEnabled() const { return m_enabled; }
+            void setPixelError(const float pixelError) { m_pixelError = pixelError; }
+            void setHysteresis(const float hysteresis) { m_hysteresis = hysteresis; }
+            void setEnabled(const bool enabled) { m_enabled = enabled; }
+
+        private:
+
+            glm::vec3 m_cameraPosition{0.F};
+            float m_projectionScale{1.F};
+            float m_pixelError{DEFAULT_LOD_PIXEL_ERROR};
+            float m_hysteresis{DEFAULT_LOD_HYSTERESIS};
+            bool m_enabled{true};
+            LodStats m_stats;
+
+    }; // class LodSelector
+
+} // namespace ven
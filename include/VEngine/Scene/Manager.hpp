@@ -8,9 +8,14 @@
 
 #include "VEngine/Core/FrameInfo.hpp"
 #include "VEngine/Gfx/SwapChain.hpp"
+#include "VEngine/Scene/SceneFile.hpp"
+#include "VEngine/Scene/ShadowCache.hpp"
 
 namespace ven {
 
+    static constexpr uint32_t DEFAULT_OBJECT_CAPACITY = 64;
+    static constexpr uint32_t DEFAULT_LIGHT_CAPACITY = 64;
+
     ///
     /// @class SceneManager
     /// @brief Class for object manager
@@ -27,33 +32,73 @@ namespace ven {
             SceneManager(SceneManager &&) = delete;
             SceneManager &operator=(SceneManager &&) = delete;
 
-            void addObject(const std::unique_ptr<Object> &object) { m_objects.insert({object->getId(), std::move(*object)}); }
-            void addLight(const std::unique_ptr<Light> &light) { m_lights.insert({light->getId(), std::move(*light)}); }
-
-            void destroyObject(const unsigned int objectId) { m_objects.erase(objectId); }
-            void destroyLight(const unsigned int lightId) { m_lights.erase(lightId); }
-            void destroyEntity(std::vector<unsigned int>& objectsIds, std::vector<unsigned int>& lightsIds);
+            void destroyObject(const Handle object) { m_objects.erase(object); }
+            void destroyLight(const Handle light) { m_lights.erase(light); }
+            void destroyEntity(std::vector<Handle>& objects, std::vector<Handle>& lights);
 
+            ///
+            /// @brief Animate the LIGHT_ANIMATED lights, update the world transforms, the shadow cache and upload the objects and lights of a frame
+            /// @note ShadowCache::begin must have been called for this frame
+            ///
             void updateBuffer(GlobalUbo &ubo, unsigned long frameIndex, float frameTime);
 
-            [[nodiscard]] VkDescriptorBufferInfo getBufferInfoForObject(const int frameIndex, const unsigned int objectId) const { return m_uboBuffers.at(static_cast<long unsigned int>(frameIndex))->descriptorInfoForIndex(objectId); }
-            [[nodiscard]] Object::Map& getObjects() { return m_objects; }
-            [[nodiscard]] Light::Map& getLights() { return m_lights; }
+            ///
+            /// @brief Save the objects and lights (text if the path ends with SCENE_TEXT_EXTENSION), assets are referenced by path and content hash
+            /// @param threadPool Hashes the asset files in parallel when set
+            ///
+            void save(const std::string& filepath, ThreadPool* threadPool = nullptr) const;
+            ///
+            /// @brief Replace the scene by a saved one, throws std::runtime_error if the file is unreadable, the GPU must be idle
+            /// @param threadPool Checks the asset content hashes in parallel when set
+            ///
+            void load(const std::string& filepath, ThreadPool* threadPool = nullptr);
+
+            [[nodiscard]] SceneGraph& getSceneGraph() { return m_sceneGraph; }
+            [[nodiscard]] const SpatialIndex& getSpatialIndex() const { return m_spatialIndex; }
+            [[nodiscard]] ObjectStore& getObjects() { return m_objects; }
+            [[nodiscard]] LightStore& getLights() { return m_lights; }
+            [[nodiscard]] ShadowCache& getShadowCache() { return m_shadowCache; }
             [[nodiscard]] const std::vector<std::unique_ptr<Buffer>> &getUboBuffers() const { return m_uboBuffers; }
+            ///
+            /// @brief Storage buffer of the PointLightData of a frame, refreshed by updateBuffer which may reallocate it
+            ///
+            [[nodiscard]] const Buffer& getLightBuffer(const unsigned long frameIndex) const { return *m_lightBuffers.at(frameIndex); }
             [[nodiscard]] const std::shared_ptr<Texture>& getTextureDefault() const { return m_textureDefault; }
             [[nodiscard]] bool getDestroyState() const { return m_destroyState; }
 
             void setDestroyState(const bool state) { m_destroyState = state; }
+            ///
+            /// @brief Scene to load once the frame is over, empty if none
+            ///
+            [[nodiscard]] const std::string& getPendingLoad() const { return m_pendingLoad; }
+            void setPendingLoad(std::string filepath) { m_pendingLoad = std::move(filepath); }
 
         private:
 
-            unsigned int m_currentObjId{0};
-            unsigned int m_currentLightId{0};
+            ///
+            /// @brief Grow the object uniform buffer of a frame geometrically so it holds objectCount slots
+            ///
+            void reserve(unsigned long frameIndex, uint32_t objectCount);
+            ///
+            /// @brief Grow the light storage buffer of a frame geometrically so it holds lightCount lights
+            ///
+            void reserveLights(unsigned long frameIndex, uint32_t lightCount);
+
+            const Device& m_device;
+            VkDeviceSize m_uboAlignment;
             std::shared_ptr<Texture> m_textureDefault;
-            Object::Map m_objects;
-            Light::Map m_lights;
-            std::vector<std::unique_ptr<Buffer>> m_uboBuffers{MAX_FRAMES_IN_FLIGHT};
+            SceneGraph m_sceneGraph;
+            SpatialIndex m_spatialIndex;
+            ObjectStore m_objects{m_sceneGraph, m_spatialIndex};
+            LightStore m_lights{m_sceneGraph};
+            std::vector<std::unique_ptr<Buffer>> m_uboBuffers{MAX_FRAMES_IN_FLIGHT}; // grown by reserve, one slot per object
+            std::array<std::vector<uint64_t>, MAX_FRAMES_IN_FLIGHT> m_uploadedVersions; // version of the object held by each slot of m_uboBuffers
+            std::array<std::unique_ptr<Buffer>, MAX_FRAMES_IN_FLIGHT> m_lightBuffers; // grown by reserveLights, rewritten every frame
+            std::vector<PointLightData> m_lightData;
+            ShadowCache m_shadowCache;
+            std::vector<ShadowLight> m_shadowLights; // LIGHT_SHADOW lights of this frame, in dense order
             bool m_destroyState{false};
+            std::string m_pendingLoad;
 
     }; // class SceneManager
 
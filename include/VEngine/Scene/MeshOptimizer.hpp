@@ -0,0 +1,66 @@
+///
+/// @file MeshOptimizer.hpp
+/// @brief This file contains the MeshOptimizer class
+/// @namespace ven
+///
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace ven {
+
+    // FIFO size used to report the cache efficiency, close to the post-transform caches of current hardware
+    static constexpr uint32_t DEFAULT_VERTEX_CACHE_SIZE = 16;
+    // overdraw sorting may cost this much ACMR relative to the vertex cache order
+    static constexpr float DEFAULT_OVERDRAW_THRESHOLD = 1.05F;
+
+    struct VertexCacheStats {
+        float acmr{0.F}; // average cache miss ratio: transformed vertices per triangle, 0.5 at best on a regular grid, 3 at worst
+        float atvr{0.F}; // average transform to vertex ratio: transformed vertices per referenced vertex, 1 at best
+    };
+
+    struct MeshOptimizationStats {
+        VertexCacheStats before;
+        VertexCacheStats after;
+    };
+
+    ///
+    /// @class MeshOptimizer
+    /// @brief Index and vertex reordering run once at import: vertex cache order (Forsyth), overdraw aware cluster order (Tipsify like) and vertex fetch order
+    /// @note the reorderings keep the triangles and their winding, only their order and the vertex numbering change
+    /// @namespace ven
+    ///
+    class MeshOptimizer {
+
+        public:
+
+            MeshOptimizer() = delete;
+
+            ///
+            /// @brief Simulate a FIFO post-transform cache over a triangle list
+            ///
+            [[nodiscard]] static VertexCacheStats analyzeVertexCache(std::span<const uint32_t> indices, uint32_t cacheSize = DEFAULT_VERTEX_CACHE_SIZE);
+            ///
+            /// @brief Reorder the triangles so consecutive ones share vertices (Forsyth, linear speed vertex cache optimisation)
+            ///
+            static void optimizeVertexCache(std::span<uint32_t> indices);
+            ///
+            /// @brief Reorder clusters of a vertex cache optimized triangle list so the ones facing outwards are drawn first and hide the others
+            /// @param positions Positions of the whole vertex buffer
+            /// @param threshold Largest ACMR increase allowed by the cluster splits
+            ///
+            static void optimizeOverdraw(std::span<uint32_t> indices, std::span<const glm::vec3> positions, float threshold = DEFAULT_OVERDRAW_THRESHOLD);
+            ///
+            /// @brief Renumber the vertices in the order the indices first reference them, so the vertex fetches walk the buffer forwards
+            /// @return New index of each vertex, unreferenced vertices are moved to the end
+            ///
+            [[nodiscard]] static std::vector<uint32_t> optimizeVertexFetch(std::span<uint32_t> indices, std::size_t vertexCount);
+
+    }; // class MeshOptimizer
+
+} // namespace ven
@@ -0,0 +1,65 @@
+///
+/// @file MeshSimplifier.hpp
+/// @brief This file contains the MeshSimplifier class
+/// @namespace ven
+///
+
+#pragma once
+
+#include <limits>
+#include <span>
+#include <vector>
+
+#include "VEngine/Scene/LodSelector.hpp"
+#include "VEngine/Scene/Pvs.hpp"
+
+namespace ven {
+
+    struct LodSettings {
+        uint32_t levelCount{MAX_LOD_COUNT}; // including the full detail level
+        float reduction{0.5F}; // index count of a level relative to the previous one
+        float maxRelativeError{0.05F}; // error budget of a collapse, relative to the mesh bounds half diagonal
+        float minLevelReduction{0.9F}; // the chain stops at the first level keeping more than this fraction of the previous one
+    };
+
+    struct SimplifiedMesh {
+        std::vector<uint32_t> indices;
+        float error{0.F}; // largest error of the collapses, a distance in the unit of the positions
+    };
+
+    ///
+    /// @brief Levels of detail of a model
+    ///
+    struct LodChain {
+        std::vector<MeshLod> levels; // whole model range of each level, the ranges of the meshes of a level are contiguous
+        std::vector<std::vector<MeshLod>> meshes; // per mesh, level 0 is the source range
+    };
+
+    ///
+    /// @class MeshSimplifier
+    /// @brief Quadric error metric edge collapse (Garland and Heckbert), each collapse moves a vertex onto a neighbour so the attributes of the remaining vertices are untouched
+    /// @note open edges are locked: attribute seams (UV or normal discontinuities, the vertices are split there) and the borders of a mesh with its neighbours of other materials keep their shape
+    /// @namespace ven
+    ///
+    class MeshSimplifier {
+
+        public:
+
+            MeshSimplifier() = delete;
+
+            ///
+            /// @brief Collapse edges by increasing error until the index count is reached or the next collapse exceeds maxError
+            /// @param positions Positions of the whole vertex buffer
+            /// @param indices Triangle list to simplify
+            /// @return Triangle list referencing the same vertices
+            ///
+            static SimplifiedMesh simplify(std::span<const glm::vec3> positions, std::span<const uint32_t> indices, std::size_t targetIndexCount, float maxError = std::numeric_limits<float>::max());
+            ///
+            /// @brief Simplify each mesh level after level and append the levels to the index buffer, level after level
+            /// @param indices Index buffer holding the meshes, the levels are appended
+            ///
+            static LodChain buildChain(std::span<const glm::vec3> positions, std::vector<uint32_t>& indices, std::span<const PvsMeshRange> meshes, const LodSettings& settings = {}, ThreadPool* threadPool = nullptr);
+
+    }; // class MeshSimplifier
+
+} // namespace ven
@@ -0,0 +1,68 @@
+///
+/// @file Meshlet.hpp
+/// @brief This file contains the MeshletBuilder class
+/// @namespace ven
+///
+
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include "VEngine/Scene/Frustum.hpp"
+
+namespace ven {
+
+    // mesh shader friendly limits: 64 vertices, 124 triangles (126 at most on common hardware, kept a multiple of 4)
+    static constexpr uint32_t MESHLET_MAX_VERTICES = 64;
+    static constexpr uint32_t MESHLET_MAX_TRIANGLES = 124;
+
+    ///
+    /// @brief Cluster of triangles sharing at most MESHLET_MAX_VERTICES vertices, culled as a whole
+    /// @note must match the Meshlet struct of meshlet_cull.comp, meshlet_task.task and meshlet_mesh.mesh (std430)
+    ///
+    struct Meshlet {
+        glm::vec4 sphere{0.F}; // model space center, w is radius
+        glm::vec4 cone{0.F, 0.F, 1.F, 1.F}; // model space normal cone axis, w is the sine of its half angle, 1 disables the backface test
+        uint32_t vertexOffset{0}; // first entry in MeshletData::vertices
+        uint32_t triangleOffset{0}; // first entry in MeshletData::triangles
+        uint32_t vertexCount{0};
+        uint32_t triangleCount{0};
+    };
+
+    struct MeshletData {
+        std::vector<Meshlet> meshlets;
+        std::vector<uint32_t> vertices; // vertex buffer index of each meshlet vertex
+        std::vector<uint32_t> triangles; // three 8 bits meshlet vertex indices per triangle, first corner in the low bits
+    };
+
+    ///
+    /// @class MeshletBuilder
+    /// @brief Greedy clustering of a triangle list: a meshlet grows through the triangles adjacent to it, adding the one needing the fewest new vertices (lowest index on ties) so the result only depends on the input
+    /// @namespace ven
+    ///
+    class MeshletBuilder {
+
+        public:
+
+            MeshletBuilder() = delete;
+
+            ///
+            /// @brief Cluster a triangle list and append the meshlets, with their bounds and normal cones
+            /// @param positions Positions of the whole vertex buffer
+            /// @return Number of meshlets appended
+            ///
+            static uint32_t build(std::span<const glm::vec3> positions, std::span<const uint32_t> indices, MeshletData& data);
+
+            ///
+            /// @return true if every triangle of the meshlet faces away from the camera, all in model space
+            ///
+            static bool isBackfacing(const Meshlet& meshlet, const glm::vec3& cameraPosition);
+            ///
+            /// @return true if the bounding sphere of the meshlet, transformed to world space, is out of the frustum
+            ///
+            static bool isOutside(const Meshlet& meshlet, const Frustum& frustum, const glm::mat4& model);
+
+    }; // class MeshletBuilder
+
+} // namespace ven
@@ -0,0 +1,119 @@
+///
+/// @file OcclusionCuller.hpp
+/// @brief This file contains the OcclusionCuller class
+/// @namespace ven
+///
+
+#pragma once
+
+#include <array>
+#include <span>
+#include <vector>
+
+#include "VEngine/Scene/Bounds.hpp"
+#include "VEngine/Utils/Simd.hpp"
+#include "VEngine/Utils/ThreadPool.hpp"
+
+namespace ven {
+
+    static constexpr uint32_t DEFAULT_OCCLUSION_WIDTH = 256;
+    static constexpr uint32_t DEFAULT_OCCLUSION_HEIGHT = 144;
+
+    struct OcclusionStats {
+        uint32_t occluderTriangles{0};
+        uint32_t tested{0};
+        uint32_t occluded{0};
+        float rasterMS{0.F};
+        float testMS{0.F};
+    };
+
+    ///
+    /// @class OcclusionCuller
+    /// @brief Software occlusion culling: designated occluders are rasterized in a low resolution depth buffer with per tile max depth, bounding boxes are then tested against it
+    /// @namespace ven
+    ///
+    class OcclusionCuller {
+
+        public:
+
+            static constexpr uint32_t TILE_WIDTH = 8;
+            static constexpr uint32_t TILE_HEIGHT = 8;
+
+            ///
+            /// @param width Depth buffer width, rounded up to a multiple of TILE_WIDTH
+            /// @param height Depth buffer height, rounded up to a multiple of TILE_HEIGHT
+            /// @param threadPool Pool used for the raster bands and the tests, work runs on the calling thread when null
+            ///
+            explicit OcclusionCuller(uint32_t width = DEFAULT_OCCLUSION_WIDTH, uint32_t height = DEFAULT_OCCLUSION_HEIGHT, ThreadPool* threadPool = nullptr);
+            ~OcclusionCuller() = default;
+
+            OcclusionCuller(const OcclusionCuller&) = delete;
+            OcclusionCuller& operator=(const OcclusionCuller&) = delete;
+            OcclusionCuller(OcclusionCuller&&) = delete;
+            OcclusionCuller& operator=(OcclusionCuller&&) = delete;
+
+            ///
+            /// @brief Clear the occluders and the queued boxes for this frame
+            ///
+            void begin(const glm::mat4& viewProjection);
+            ///
+            /// @brief Queue an occluder
+            /// @param triangles Triangle list (3 vertices per triangle) in model space
+            ///
+            void addOccluder(std::span<const glm::vec3> triangles, const glm::mat4& modelMatrix);
+            ///
+            /// @brief Queue a world space box, an empty AABB{} is always visible
+            /// @return Index to query with isVisible once cull has been called
+            ///
+            uint32_t add(const AABB& aabb);
+            ///
+            /// @brief Rasterize the queued occluders and test the queued boxes
+            /// @param candidates Optional per box flags (from the frustum culler), boxes flagged 0 are reported not visible without being tested
+            ///
+            void cull(const std::vector<uint8_t>* candidates = nullptr);
+
+            [[nodiscard]] bool isOccluded(const AABB& aabb) const;
+            [[nodiscard]] bool isVisible(const uint32_t index) const { return m_visible[index] != 0; }
+            [[nodiscard]] float getDepth(const uint32_t x, const uint32_t y) const { return m_depth[y * m_width + x]; }
+            [[nodiscard]] uint32_t getWidth() const { return m_width; }
+            [[nodiscard]] uint32_t getHeight() const { return m_height; }
+            [[nodiscard]] const OcclusionStats& getStats() const { return m_stats; }
+            [[nodiscard]] bool isEnabled() const { return m_enabled; }
+            void setEnabled(const bool enabled) { m_enabled = enabled; }
+            ///
+            /// @brief Rasterize the occluders with the AVX2 kernel at SimdLevel::AVX2, with SSE2 (when built for it) or scalar code below, clamped to the supported level
+            ///
+            void setLevel(SimdLevel level);
+            [[nodiscard]] SimdLevel getLevel() const { return m_level; }
+
+        private:
+
+            struct ScreenTriangle {
+                std::array<glm::vec3, 3> vertices; // pixels, depth
+                float minY;
+                float maxY;
+            };
+
+            void addClipTriangle(const std::array<glm::vec4, 3>& clip);
+            void rasterizeBand(uint32_t tileRow);
+            void rasterizeTriangle(const ScreenTriangle& triangle, uint32_t firstRow, uint32_t lastRow);
+
+            uint32_t m_width;
+            uint32_t m_height;
+            uint32_t m_tilesX;
+            uint32_t m_tilesY;
+            ThreadPool* m_threadPool;
+            bool m_enabled{true};
+            SimdLevel m_level{getSupportedSimdLevel()};
+
+            glm::mat4 m_viewProjection{1.F};
+            std::vector<ScreenTriangle> m_triangles;
+            std::vector<float> m_depth;
+            std::vector<float> m_tileMax;
+            std::vector<AABB> m_boxes;
+            std::vector<uint8_t> m_visible;
+            OcclusionStats m_stats;
+
+    }; // class OcclusionCuller
+
+} // namespace ven
@@ -0,0 +1,33 @@
+///
+/// @file OcclusionKernel.hpp
+/// @brief This file contains the occluder rasterization kernel of the AVX2 path of the OcclusionCuller
+/// @namespace ven
+///
+
+#pragma once
+
+#include <cstdint>
+
+namespace ven {
+
+    ///
+    /// @struct OcclusionRaster
+    /// @brief Setup of one occluder triangle clipped to a band of the depth buffer
+    /// @namespace ven
+    ///
+    struct OcclusionRaster {
+        float edges[3][3]; // a, b, c of the edge functions a * x + b * y + c, positive inside
+        float depthPlane[3]; // depth = a * x + b * y + c
+        uint32_t xBegin;
+        uint32_t xEnd; // inclusive
+        uint32_t yBegin;
+        uint32_t yEnd; // inclusive
+    };
+
+    ///
+    /// @brief Keep the nearest of the triangle and the depth buffer in the covered pixels, the width must be a multiple of 8
+    /// @note this header is compiled with AVX2 in the kernel translation unit, it must not pull in glm or any other inline code shared with the rest of the engine
+    ///
+    void rasterizeOccluderAvx2(const OcclusionRaster& raster, float* depth, uint32_t width);
+
+} // namespace ven
@@ -0,0 +1,106 @@
+///
+/// @file Pvs.hpp
+/// @brief This file contains the Pvs class
+/// @namespace ven
+///
+
+#pragma once
+
+#include <span>
+#include <string>
+#include <vector>
+
+#include "VEngine/Scene/Bounds.hpp"
+#include "VEngine/Utils/ThreadPool.hpp"
+
+namespace ven {
+
+    static constexpr std::string_view PVS_EXTENSION = ".pvs";
+
+    struct PvsSettings {
+        uint32_t cellsPerAxis{16}; // along the largest dimension of the model, cells are cubes
+        uint32_t samplesPerCell{8}; // random eye positions inside each cell
+        uint32_t raysPerTarget{2}; // rays from each eye towards random points of each mesh bounds
+        uint32_t randomRays{64}; // rays from each eye in uniform random directions
+    };
+
+    ///
+    /// @brief Index range of a mesh in the model index buffer
+    ///
+    struct PvsMeshRange {
+        uint32_t firstIndex{0};
+        uint32_t indexCount{0};
+    };
+
+    ///
+    /// @class Pvs
+    /// @brief Potentially visible sets of a static model: a grid of cells over the model bounds (model space), each holding a run length encoded bitset of the meshes visible from it
+    /// @namespace ven
+    ///
+    class Pvs {
+
+        public:
+
+            static constexpr uint32_t FILE_MAGIC = 0x53565056; // "VPVS"
+            static constexpr uint32_t FILE_VERSION = 1;
+            static constexpr uint32_t OUTSIDE = UINT32_MAX;
+
+            Pvs() = default;
+            ~Pvs() = default;
+
+            Pvs(const Pvs&) = delete;
+            Pvs& operator=(const Pvs&) = delete;
+            Pvs(Pvs&&) = default;
+            Pvs& operator=(Pvs&&) = default;
+
+            ///
+            /// @brief Sample the visibility of every mesh from every cell with ray casts
+            /// @param contentHash Hash of the model content, stored to detect stale files
+            ///
+            static Pvs bake(std::span<const glm::vec3> positions, std::span<const uint32_t> indices, std::span<const PvsMeshRange> meshes, uint64_t contentHash, const PvsSettings& settings = {}, ThreadPool* threadPool = nullptr);
+            ///
+            /// @brief Hash of the geometry a Pvs depends on
+            ///
+            static uint64_t hashContent(std::span<const glm::vec3> positions, std::span<const uint32_t> indices, std::span<const PvsMeshRange> meshes);
+
+            ///
+            /// @brief Load a baked file
+            /// @return false if the file is missing, corrupted or was baked for another content hash
+            ///
+            bool load(const std::string& filepath, uint64_t expectedContentHash);
+            ///
+            /// @brief Write to a temporary file then rename it, throws on failure
+            ///
+            void save(const std::string& filepath) const;
+
+            ///
+            /// @return Cell containing the model space position, OUTSIDE if it is out of the grid
+            ///
+            [[nodiscard]] uint32_t findCell(const glm::vec3& position) const;
+            ///
+            /// @brief Decode the bitset of a cell, one byte per mesh
+            ///
+            void decodeCell(uint32_t cell, std::vector<uint8_t>& visible) const;
+
+            [[nodiscard]] bool isValid() const { return m_meshCount > 0; }
+            [[nodiscard]] uint32_t getCellCount() const { return m_cellCounts.x * m_cellCounts.y * m_cellCounts.z; }
+            [[nodiscard]] uint32_t getMeshCount() const { return m_meshCount; }
+            [[nodiscard]] uint64_t getContentHash() const { return m_contentHash; }
+            [[nodiscard]] std::size_t getCompressedSize() const { return m_data.size(); }
+            [[nodiscard]] AABB getCellBounds(uint32_t cell) const;
+
+        private:
+
+            static void encode(const std::vector<uint8_t>& visible, std::vector<uint8_t>& out);
+
+            AABB m_bounds;
+            glm::uvec3 m_cellCounts{0};
+            float m_cellSize{0.F};
+            uint32_t m_meshCount{0};
+            uint64_t m_contentHash{0};
+            std::vector<uint32_t> m_cellOffsets; // cell count + 1 offsets in m_data
+            std::vector<uint8_t> m_data;
+
+    }; // class Pvs
+
+} // namespace ven
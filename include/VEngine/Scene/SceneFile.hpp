@@ -0,0 +1,113 @@
+///
+/// @file SceneFile.hpp
+/// @brief This file contains the SceneFile class
+/// @namespace ven
+///
+
+#pragma once
+
+#include <span>
+#include <string>
+#include <vector>
+
+#include "VEngine/Scene/Transform3D.hpp"
+
+namespace ven {
+
+    static constexpr std::string_view SCENE_EXTENSION = ".vscene";
+    static constexpr std::string_view SCENE_TEXT_EXTENSION = ".txt";
+    static constexpr std::string_view DEFAULT_SCENE_PATH = "assets/scenes/default.vscene";
+
+    enum class AssetKind : uint8_t {
+        MODEL = 0,
+        TEXTURE = 1
+    };
+
+    ///
+    /// @brief Asset referenced by path, the content hash (FNV-1a of the file) detects files changed since the scene was saved
+    ///
+    struct SceneAsset {
+        AssetKind kind{AssetKind::MODEL};
+        uint64_t contentHash{0};
+        std::string path;
+    };
+
+    ///
+    /// @brief Object entry, parent is the index of another object, model and diffuseMap index the assets
+    ///
+    struct SceneObject {
+        Transform3D transform{};
+        uint32_t parent{UINT32_MAX};
+        uint32_t model{UINT32_MAX};
+        uint32_t diffuseMap{UINT32_MAX};
+        bool occluder{false};
+        std::string name;
+    };
+
+    ///
+    /// @brief Light entry, parent is the index of an object
+    ///
+    struct SceneLight {
+        Transform3D transform{};
+        glm::vec4 color{1.F};
+        float shininess{0.F};
+        uint32_t parent{UINT32_MAX};
+        uint8_t flags{0}; // LIGHT_FLAG bits of LightStore
+        std::string name;
+    };
+
+    ///
+    /// @class SceneFile
+    /// @brief Serialized scene: an asset table, objects and lights, saved as a compact binary file read through mmap or as text for diffing
+    /// @note the binary layout is native endian, fixed size records followed by one string table
+    /// @namespace ven
+    ///
+    class SceneFile {
+
+        public:
+
+            static constexpr uint32_t FILE_MAGIC = 0x4E435356; // "VSCN"
+            static constexpr uint32_t FILE_VERSION = 2;
+            static constexpr uint32_t FILE_VERSION_V1 = 1; // lights without flags, still read, they are upgraded to animated lights without shadows
+            static constexpr uint32_t NONE = UINT32_MAX;
+
+            SceneFile() = default;
+            ~SceneFile() = default;
+
+            SceneFile(const SceneFile&) = delete;
+            SceneFile& operator=(const SceneFile&) = delete;
+            SceneFile(SceneFile&&) = default;
+            SceneFile& operator=(SceneFile&&) = default;
+
+            ///
+            /// @brief Index of an asset, added if no asset has this kind and path yet
+            ///
+            uint32_t addAsset(AssetKind kind, const std::string& path, uint64_t contentHash);
+
+            ///
+            /// @brief Save as text if the path ends with SCENE_TEXT_EXTENSION, binary otherwise, throws on failure
+            ///
+            void save(const std::string& filepath) const;
+            ///
+            /// @brief Load a binary or text scene (detected from the file magic), throws std::runtime_error if it is missing or corrupted
+            /// @note version 1 files are upgraded on load, they are saved back as FILE_VERSION
+            ///
+            void load(const std::string& filepath);
+
+            void saveBinary(const std::string& filepath) const;
+            void saveText(const std::string& filepath) const;
+            void loadBinary(std::span<const uint8_t> data);
+            void loadText(std::string_view text);
+
+            ///
+            /// @return FNV-1a of the file content, 0 if it can't be read
+            ///
+            static uint64_t hashFile(const std::string& filepath);
+
+            std::vector<SceneAsset> assets;
+            std::vector<SceneObject> objects;
+            std::vector<SceneLight> lights;
+
+    }; // class SceneFile
+
+} // namespace ven
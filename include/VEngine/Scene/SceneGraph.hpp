@@ -0,0 +1,111 @@
+///
+/// @file SceneGraph.hpp
+/// @brief This file contains the SceneGraph class
+/// @namespace ven
+///
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "VEngine/Scene/Transform3D.hpp"
+#include "VEngine/Utils/ThreadPool.hpp"
+
+namespace ven {
+
+    ///
+    /// @class SceneGraph
+    /// @brief Transform hierarchy stored as arrays sorted by depth, every parent comes before its children
+    /// @note node ids are stable, the dense order is rebuilt lazily by update after structural changes
+    /// @namespace ven
+    ///
+    class SceneGraph {
+
+        public:
+
+            static constexpr uint32_t NONE = UINT32_MAX;
+            static constexpr std::size_t PARALLEL_GRAIN = 1024; // nodes per parallelFor chunk, smaller levels run on the calling thread
+
+            explicit SceneGraph(ThreadPool* threadPool = nullptr) : m_threadPool{threadPool} {}
+            ~SceneGraph() = default;
+
+            SceneGraph(const SceneGraph&) = delete;
+            SceneGraph& operator=(const SceneGraph&) = delete;
+            SceneGraph(SceneGraph&&) = default;
+            SceneGraph& operator=(SceneGraph&&) = default;
+
+            ///
+            /// @return Id of the new node, its world matrix is valid after the next update
+            ///
+            uint32_t add(const glm::mat4& local, uint32_t parent = NONE);
+            uint32_t add(const Transform3D& local, const uint32_t parent = NONE) { return add(local.transformMatrix(), parent); }
+            ///
+            /// @brief Remove a node, its children are attached to its parent and keep their local transform
+            /// @note costs the number of children of the node, not the size of the graph
+            ///
+            void remove(uint32_t node);
+            ///
+            /// @brief Attach a node to another one (NONE for a root), throws std::invalid_argument if it would create a cycle
+            ///
+            void setParent(uint32_t node, uint32_t parent);
+            void setLocal(uint32_t node, const glm::mat4& local);
+            void setLocal(const uint32_t node, const Transform3D& local) { setLocal(node, local.transformMatrix()); }
+
+            ///
+            /// @brief Propagate the world matrices level by level, visiting only the touched nodes and the subtrees below them
+            /// @return Number of nodes whose world matrix changed
+            ///
+            uint32_t update();
+
+            [[nodiscard]] const glm::mat4& getWorld(const uint32_t node) const { return m_worlds[m_dense.at(node)]; }
+            [[nodiscard]] const glm::mat4& getLocal(const uint32_t node) const { return m_locals[m_dense.at(node)]; }
+            [[nodiscard]] uint32_t getParent(const uint32_t node) const { return m_parents.at(node); }
+            ///
+            /// @brief Unique stamp of the last world change of a node, (update count << 32) | node
+            ///
+            [[nodiscard]] uint64_t getVersion(const uint32_t node) const { return m_versions[m_dense.at(node)]; }
+            [[nodiscard]] bool contains(const uint32_t node) const { return node < m_dense.size() && m_dense[node] != NONE; }
+            [[nodiscard]] uint32_t size() const { return static_cast<uint32_t>(m_ids.size() - m_pendingRemovals); }
+            [[nodiscard]] uint32_t getLevelCount() const { return m_levelOffsets.empty() ? 0 : static_cast<uint32_t>(m_levelOffsets.size() - 1); }
+            void setThreadPool(ThreadPool* threadPool) { m_threadPool = threadPool; }
+
+        private:
+
+            void link(uint32_t node, uint32_t parent);
+            void unlink(uint32_t node);
+            void rebuild();
+            void markDirty(uint32_t dense);
+            ///
+            /// @brief Recompute the worlds of dirty dense nodes of one level and append the dense indices of their children
+            ///
+            void updateNodes(std::span<const uint32_t> nodes, std::vector<uint32_t>& children);
+
+            ThreadPool* m_threadPool{nullptr};
+
+            // per node id
+            std::vector<uint32_t> m_parents;
+            std::vector<uint32_t> m_firstChildren; // children of a node are a doubly linked list through the sibling links
+            std::vector<uint32_t> m_nextSiblings;
+            std::vector<uint32_t> m_prevSiblings;
+            std::vector<uint32_t> m_dense; // NONE once removed
+            std::vector<uint32_t> m_freeIds;
+
+            // dense, sorted by level once rebuilt
+            std::vector<uint32_t> m_ids;
+            std::vector<uint32_t> m_denseParents;
+            std::vector<glm::mat4> m_locals;
+            std::vector<glm::mat4> m_worlds;
+            std::vector<uint64_t> m_versions;
+            std::vector<uint8_t> m_dirty;
+            std::vector<uint8_t> m_removed;
+            std::vector<uint32_t> m_levelOffsets; // level count + 1 offsets in the dense arrays
+            std::vector<std::vector<uint32_t>> m_levelDirty; // dense indices of the dirty nodes per level
+            bool m_structureDirty{false};
+            uint32_t m_pendingRemovals{0};
+            uint64_t m_updateCount{0};
+
+    }; // class SceneGraph
+
+} // namespace ven
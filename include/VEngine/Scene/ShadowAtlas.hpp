@@ -0,0 +1,75 @@
+///
+/// @file ShadowAtlas.hpp
+/// @brief This file contains the ShadowAtlas class
+/// @namespace ven
+///
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace ven {
+
+    static constexpr uint32_t SHADOW_ATLAS_SIZE = 4096;
+    static constexpr uint32_t SHADOW_MIN_TILE_SIZE = 128;
+
+    ///
+    /// @brief Square region of the atlas, in texels
+    ///
+    struct ShadowTile {
+        uint32_t x{0};
+        uint32_t y{0};
+        uint32_t size{0};
+
+        bool operator==(const ShadowTile&) const = default;
+    };
+
+    ///
+    /// @class ShadowAtlas
+    /// @brief Quadtree buddy allocator of the square power of two tiles of a shadow atlas
+    /// @note a tile is split in four to serve a smaller request, four free siblings are merged back when one of them is freed
+    /// @namespace ven
+    ///
+    class ShadowAtlas {
+
+        public:
+
+            explicit ShadowAtlas(uint32_t size = SHADOW_ATLAS_SIZE, uint32_t minTileSize = SHADOW_MIN_TILE_SIZE);
+            ~ShadowAtlas() = default;
+
+            ShadowAtlas(const ShadowAtlas&) = delete;
+            ShadowAtlas& operator=(const ShadowAtlas&) = delete;
+            ShadowAtlas(ShadowAtlas&&) = default;
+            ShadowAtlas& operator=(ShadowAtlas&&) = default;
+
+            ///
+            /// @param size Power of two between the minimum tile size and the atlas size
+            /// @return The tile, or nothing if no free region of that size is left
+            ///
+            [[nodiscard]] std::optional<ShadowTile> allocate(uint32_t size);
+            ///
+            /// @brief Give back a tile returned by allocate
+            ///
+            void free(const ShadowTile& tile);
+            void clear();
+
+            [[nodiscard]] uint32_t getSize() const { return m_size; }
+            [[nodiscard]] uint32_t getMinTileSize() const { return m_minTileSize; }
+            ///
+            /// @return Free texels, summed over the free tiles
+            ///
+            [[nodiscard]] uint64_t getFreeArea() const;
+
+        private:
+
+            [[nodiscard]] uint32_t getLevel(uint32_t size) const;
+
+            uint32_t m_size;
+            uint32_t m_minTileSize;
+            std::vector<std::vector<ShadowTile>> m_freeTiles; // per level, level 0 is the whole atlas
+
+    }; // class ShadowAtlas
+
+} // namespace ven
@@ -0,0 +1,153 @@
+///
+/// @file ShadowCache.hpp
+/// @brief This file contains the ShadowCache class
+/// @namespace ven
+///
+
+#pragma once
+
+#include <array>
+#include <span>
+#include <vector>
+
+#include "VEngine/Scene/Bounds.hpp"
+#include "VEngine/Scene/ShadowAtlas.hpp"
+#include "VEngine/Utils/SparseSet.hpp"
+
+namespace ven {
+
+    static constexpr uint32_t CUBE_FACE_COUNT = 6;
+    static constexpr uint32_t SHADOW_MAX_FACE_SIZE = 1024;
+    static constexpr uint32_t SHADOW_SETTLE_FRAMES = 8; // frames an object must keep its version to join the static layer
+    static constexpr float SHADOW_NEAR = 0.05F;
+
+    ///
+    /// @brief Shadow casting point light given to ShadowCache::update
+    ///
+    struct ShadowLight {
+        Handle handle;
+        glm::vec3 position{0.F};
+        float range{0.F};
+    };
+
+    ///
+    /// @brief Cube shadow map of a light for this frame, one atlas tile per face
+    /// @note the caster lists are dense object indices, the static ones are only filled when the map is baked
+    ///
+    struct ShadowMap {
+        uint32_t light{0}; // index in the lights given to update
+        std::array<glm::mat4, CUBE_FACE_COUNT> faceViewProjections{};
+        std::array<ShadowTile, CUBE_FACE_COUNT> tiles{};
+        bool bake{false}; // the static casters must be rendered again in the cache layer
+        bool composite{false}; // the final layer must be refreshed: static tiles copied, then the dynamic casters drawn over them
+        std::array<std::vector<uint32_t>, CUBE_FACE_COUNT> staticCasters;
+        std::array<std::vector<uint32_t>, CUBE_FACE_COUNT> dynamicCasters;
+    };
+
+    struct ShadowStats {
+        uint32_t shadowMaps{0};
+        uint32_t baked{0};
+        uint32_t composited{0};
+        uint32_t dynamicObjects{0};
+    };
+
+    ///
+    /// @class ShadowCache
+    /// @brief Decide which cube shadow maps of the point lights must be rendered again, and where they live in the shadow atlas
+    /// @note an object is static once its version stayed the same for SHADOW_SETTLE_FRAMES frames, the static casters are rendered once in a cache layer
+    /// @note a map is baked again when its light moves, its range or tile size changes, or an object joins or leaves the static set in its range
+    /// @note a map is composited when it was baked or a dynamic caster is (or was in the previous frame) in its range
+    /// @note the face size follows the screen size of the light range, the most important lights are served first and may evict the least important ones
+    /// @namespace ven
+    ///
+    class ShadowCache {
+
+        public:
+
+            explicit ShadowCache(const uint32_t atlasSize = SHADOW_ATLAS_SIZE, const uint32_t minFaceSize = SHADOW_MIN_TILE_SIZE) : m_atlas{atlasSize, minFaceSize} {}
+            ~ShadowCache() = default;
+
+            ShadowCache(const ShadowCache&) = delete;
+            ShadowCache& operator=(const ShadowCache&) = delete;
+            ShadowCache(ShadowCache&&) = delete;
+            ShadowCache& operator=(ShadowCache&&) = delete;
+
+            ///
+            /// @brief Setup the projection used to rate the lights of this frame
+            /// @param cameraPosition World space position of the camera
+            /// @param fov Vertical field of view in radians (Camera::getFov)
+            /// @param viewportHeight Height of the render target in pixels
+            ///
+            void begin(const glm::vec3& cameraPosition, float fov, float viewportHeight);
+            ///
+            /// @brief Track the objects, assign the atlas tiles and build the shadow maps of this frame
+            /// @param objects Handles of the objects, bounds and versions share their dense index
+            /// @param bounds World space bounds of the objects
+            /// @param versions Versions of the objects, changed whenever they move
+            ///
+            void update(std::span<const Handle> objects, std::span<const AABB> bounds, std::span<const uint64_t> versions, std::span<const ShadowLight> lights);
+            ///
+            /// @brief Forget everything, every map is baked again by the next update
+            ///
+            void clear();
+
+            [[nodiscard]] const std::vector<ShadowMap>& getShadowMaps() const { return m_shadowMaps; }
+            ///
+            /// @return Shadow map index of each light given to the last update, -1 for the lights left without shadow
+            ///
+            [[nodiscard]] std::span<const int32_t> getLightShadows() const { return m_lightShadows; }
+            [[nodiscard]] bool isStatic(Handle object) const;
+            [[nodiscard]] const ShadowStats& getStats() const { return m_stats; }
+            [[nodiscard]] uint32_t getAtlasSize() const { return m_atlas.getSize(); }
+            ///
+            /// @return Face size in texels the light would get from its screen size, before the atlas runs out of room
+            ///
+            [[nodiscard]] uint32_t getFaceSize(const ShadowLight& light) const;
+
+            ///
+            /// @brief View-projection of a cube face, looking from the light down the axis of the face (+x, -x, +y, -y, +z, -z)
+            /// @note depth from 0 at SHADOW_NEAR to 1 at range, must match the face selection of fragment_shader.frag
+            ///
+            [[nodiscard]] static glm::mat4 getFaceViewProjection(const glm::vec3& position, float range, uint32_t face);
+
+        private:
+
+            struct ObjectState {
+                uint32_t generation{0};
+                uint64_t version{0};
+                uint64_t frame{0}; // last update seeing the object, 0 for a free slot
+                uint32_t stillFrames{0};
+                AABB bounds; // bounds the object had when it joined the static set
+            };
+
+            struct LightState {
+                uint32_t generation{0};
+                uint64_t frame{0};
+                glm::vec3 position{0.F};
+                float range{0.F};
+                uint32_t faceSize{0}; // 0 without tiles
+                std::array<ShadowTile, CUBE_FACE_COUNT> tiles{};
+                bool hadDynamic{false};
+            };
+
+            [[nodiscard]] std::optional<std::array<ShadowTile, CUBE_FACE_COUNT>> allocateFaces(uint32_t faceSize);
+            void freeFaces(LightState& state);
+            void updateObjects(std::span<const Handle> objects, std::span<const AABB> bounds, std::span<const uint64_t> versions);
+            void assignTiles(std::span<const ShadowLight> lights);
+
+            ShadowAtlas m_atlas;
+            glm::vec3 m_cameraPosition{0.F};
+            float m_projectionScale{1.F};
+            uint64_t m_frame{0};
+            std::vector<ObjectState> m_objectStates; // by handle index
+            std::vector<LightState> m_lightStates; // by handle index
+            std::vector<uint32_t> m_dynamicObjects; // dense indices, this frame
+            std::vector<AABB> m_invalidBounds; // regions of the static layer that changed this frame
+            std::vector<uint8_t> m_moved; // per light of this update, its tiles were (re)assigned
+            std::vector<ShadowMap> m_shadowMaps;
+            std::vector<int32_t> m_lightShadows;
+            ShadowStats m_stats;
+
+    }; // class ShadowCache
+
+} // namespace ven
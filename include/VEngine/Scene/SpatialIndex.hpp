@@ -0,0 +1,111 @@
+///
+/// @file SpatialIndex.hpp
+/// @brief This file contains the SpatialIndex class
+/// @namespace ven
+///
+
+#pragma once
+
+#include <limits>
+#include <span>
+#include <vector>
+
+#include "VEngine/Scene/Frustum.hpp"
+#include "VEngine/Utils/SparseSet.hpp"
+
+namespace ven {
+
+    static constexpr float DEFAULT_FAT_MARGIN = 0.1F;
+
+    struct Ray {
+        glm::vec3 origin{0.F};
+        glm::vec3 direction{0.F, 0.F, 1.F};
+        float maxDistance{std::numeric_limits<float>::max()};
+    };
+
+    struct RayHit {
+        Handle handle{};
+        float distance{std::numeric_limits<float>::max()}; // entry distance into the bounds, in units of the ray direction
+    };
+
+    ///
+    /// @class SpatialIndex
+    /// @brief Dynamic AABB tree: leaves hold fat bounds so small moves don't touch the tree, the tree is kept balanced with rotations on insertion
+    /// @namespace ven
+    ///
+    class SpatialIndex {
+
+        public:
+
+            static constexpr uint32_t NONE = UINT32_MAX;
+
+            explicit SpatialIndex(const float fatMargin = DEFAULT_FAT_MARGIN) : m_fatMargin{fatMargin} {}
+            ~SpatialIndex() = default;
+
+            SpatialIndex(const SpatialIndex&) = delete;
+            SpatialIndex& operator=(const SpatialIndex&) = delete;
+            SpatialIndex(SpatialIndex&&) = default;
+            SpatialIndex& operator=(SpatialIndex&&) = default;
+
+            ///
+            /// @return Proxy id of the new leaf
+            ///
+            uint32_t insert(const AABB& bounds, Handle handle);
+            void remove(uint32_t proxy);
+            ///
+            /// @brief Move a proxy, the tree is only modified if the bounds left the fat bounds of the leaf
+            /// @return true if the leaf was reinserted
+            ///
+            bool update(uint32_t proxy, const AABB& bounds);
+
+            ///
+            /// @brief Append the handles whose fat bounds intersect the volume
+            ///
+            void query(const Frustum& frustum, std::vector<Handle>& results) const;
+            void query(const BoundingSphere& sphere, std::vector<Handle>& results) const;
+            void query(const AABB& box, std::vector<Handle>& results) const;
+            ///
+            /// @brief Closest fat bounds hit by each ray, hits[i].handle stays null when rays[i] hits nothing
+            ///
+            void raycast(std::span<const Ray> rays, std::span<RayHit> hits) const;
+
+            [[nodiscard]] Handle getHandle(const uint32_t proxy) const { return m_nodes.at(proxy).handle; }
+            [[nodiscard]] const AABB& getFatBounds(const uint32_t proxy) const { return m_nodes.at(proxy).bounds; }
+            [[nodiscard]] uint32_t getProxyCount() const { return m_proxyCount; }
+            [[nodiscard]] uint32_t getHeight() const { return m_root == NONE ? 0 : static_cast<uint32_t>(m_nodes[m_root].height); }
+            ///
+            /// @brief Sum of the internal node surface areas over the root one, lower is a better tree
+            ///
+            [[nodiscard]] float getAreaRatio() const;
+
+        private:
+
+            struct Node {
+                AABB bounds;
+                Handle handle{};
+                uint32_t parent{NONE}; // next free node while on the free list
+                uint32_t child1{NONE};
+                uint32_t child2{NONE};
+                int32_t height{-1}; // 0 for leaves, -1 for free nodes
+
+                [[nodiscard]] bool isLeaf() const { return child1 == NONE; }
+            };
+
+            uint32_t allocateNode();
+            void freeNode(uint32_t node);
+            void insertLeaf(uint32_t leaf);
+            void removeLeaf(uint32_t leaf);
+            uint32_t balance(uint32_t node);
+            template<typename Overlaps>
+            void collect(const Overlaps& overlaps, std::vector<Handle>& results) const;
+            void collectSubtree(uint32_t node, std::vector<Handle>& results) const;
+
+            std::vector<Node> m_nodes;
+            uint32_t m_root{NONE};
+            uint32_t m_freeList{NONE};
+            uint32_t m_proxyCount{0};
+            float m_fatMargin{DEFAULT_FAT_MARGIN};
+
+    }; // class SpatialIndex
+
+} // namespace ven
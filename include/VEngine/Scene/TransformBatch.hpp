@@ -0,0 +1,67 @@
+///
+/// @file TransformBatch.hpp
+/// @brief This file contains the TransformBatch class
+/// @namespace ven
+///
+
+#pragma once
+
+#include <array>
+#include <span>
+#include <vector>
+
+#include "VEngine/Scene/Transform3D.hpp"
+#include "VEngine/Utils/Simd.hpp"
+
+namespace ven {
+
+    ///
+    /// @class TransformBatch
+    /// @brief Translation, rotation and scale of many objects stored as structure of arrays, turned into model and normal matrices by a SIMD kernel
+    /// @note the normal matrix uses the closed form inverse transpose of a TRS matrix, the kernel is picked at runtime from the CPU features
+    /// @namespace ven
+    ///
+    class TransformBatch {
+
+        public:
+
+            TransformBatch() = default;
+            ~TransformBatch() = default;
+
+            TransformBatch(const TransformBatch&) = delete;
+            TransformBatch& operator=(const TransformBatch&) = delete;
+            TransformBatch(TransformBatch&&) = default;
+            TransformBatch& operator=(TransformBatch&&) = default;
+
+            void clear();
+            void push(const Transform3D& transform);
+            void set(std::size_t index, const Transform3D& transform);
+            void resize(std::size_t count);
+            [[nodiscard]] std::size_t size() const { return m_size; }
+
+            ///
+            /// @brief Write the model and normal matrices of every transform, the spans must hold size() matrices
+            ///
+            void compute(std::span<glm::mat4> models, std::span<glm::mat4> normals) const;
+
+            ///
+            /// @brief Best kernel supported by the CPU and the build
+            ///
+            [[nodiscard]] static SimdLevel getSupportedLevel();
+            [[nodiscard]] SimdLevel getLevel() const { return m_level; }
+            ///
+            /// @brief Force a kernel, clamped to the supported level
+            ///
+            void setLevel(SimdLevel level);
+
+        private:
+
+            std::array<std::vector<float>, 3> m_translation;
+            std::array<std::vector<float>, 3> m_rotation;
+            std::array<std::vector<float>, 3> m_scale;
+            std::size_t m_size{0};
+            SimdLevel m_level{getSupportedLevel()};
+
+    }; // class TransformBatch
+
+} // namespace ven
@@ -0,0 +1,124 @@
+///
+/// @file TransformKernel.hpp
+/// @brief This file contains the batched TRS kernel shared by the scalar, SSE4 and AVX2 paths
+/// @namespace ven
+///
+
+#pragma once
+
+#include <cstddef>
+
+namespace ven {
+
+    ///
+    /// @struct TrsStreams
+    /// @brief Structure of arrays input of the transform kernels, rotations are XYZ Euler angles in radians
+    /// @namespace ven
+    ///
+    struct TrsStreams {
+        const float* translation[3];
+        const float* rotation[3];
+        const float* scale[3];
+    };
+
+    ///
+    /// @brief Write the model and normal matrices (column major, 16 floats per object) of objects [begin, end), the range size must be a multiple of the width
+    /// @note this header is compiled with a different instruction set in each kernel translation unit, it must not pull in glm or any other inline code shared with the rest of the engine
+    ///
+    using TrsKernel = void (*)(const TrsStreams& in, std::size_t begin, std::size_t end, float* models, float* normals);
+
+    void computeTrsSse4(const TrsStreams& in, std::size_t begin, std::size_t end, float* models, float* normals);
+    void computeTrsAvx2(const TrsStreams& in, std::size_t begin, std::size_t end, float* models, float* normals);
+
+    ///
+    /// @brief Closed form TRS kernel over a vector type V (V::WIDTH lanes, one object per lane)
+    /// @details model = T * Rx * Ry * Rz * S, the normal matrix is the inverse transpose of R * S which is R * S^-1 for a rotation R
+    ///
+    template<typename V>
+    void computeTrs(const TrsStreams& in, const std::size_t begin, const std::size_t end, float* models, float* normals)
+    {
+        using T = typename V::Type;
+        const T zero = V::set1(0.F);
+        const T one = V::set1(1.F);
+        for (std::size_t i = begin; i < end; i += V::WIDTH) {
+            T sinX;
+            T cosX;
+            T sinY;
+            T cosY;
+            T sinZ;
+            T cosZ;
+            V::sincos(V::load(in.rotation[0] + i), sinX, cosX);
+            V::sincos(V::load(in.rotation[1] + i), sinY, cosY);
+            V::sincos(V::load(in.rotation[2] + i), sinZ, cosZ);
+            const T sxsy = V::mul(sinX, sinY);
+            const T cxsy = V::mul(cosX, sinY);
+
+            // columns of Rx * Ry * Rz
+            const T r00 = V::mul(cosY, cosZ);
+            const T r01 = V::fmadd(sxsy, cosZ, V::mul(cosX, sinZ));
+            const T r02 = V::fnmadd(cxsy, cosZ, V::mul(sinX, sinZ));
+            const T r10 = V::sub(zero, V::mul(cosY, sinZ));
+            const T r11 = V::fnmadd(sxsy, sinZ, V::mul(cosX, cosZ));
+            const T r12 = V::fmadd(cxsy, sinZ, V::mul(sinX, cosZ));
+            const T r20 = sinY;
+            const T r21 = V::sub(zero, V::mul(sinX, cosY));
+            const T r22 = V::mul(cosX, cosY);
+
+            const T scaleX = V::load(in.scale[0] + i);
+            const T scaleY = V::load(in.scale[1] + i);
+            const T scaleZ = V::load(in.scale[2] + i);
+            float* model = models + (i * 16);
+            V::storeColumn(model, 0, V::mul(r00, scaleX), V::mul(r01, scaleX), V::mul(r02, scaleX), zero);
+            V::storeColumn(model, 1, V::mul(r10, scaleY), V::mul(r11, scaleY), V::mul(r12, scaleY), zero);
+            V::storeColumn(model, 2, V::mul(r20, scaleZ), V::mul(r21, scaleZ), V::mul(r22, scaleZ), zero);
+            V::storeColumn(model, 3, V::load(in.translation[0] + i), V::load(in.translation[1] + i), V::load(in.translation[2] + i), one);
+
+            const T inverseX = V::div(one, scaleX);
+            const T inverseY = V::div(one, scaleY);
+            const T inverseZ = V::div(one, scaleZ);
+            float* normal = normals + (i * 16);
+            V::storeColumn(normal, 0, V::mul(r00, inverseX), V::mul(r01, inverseX), V::mul(r02, inverseX), zero);
+            V::storeColumn(normal, 1, V::mul(r10, inverseY), V::mul(r11, inverseY), V::mul(r12, inverseY), zero);
+            V::storeColumn(normal, 2, V::mul(r20, inverseZ), V::mul(r21, inverseZ), V::mul(r22, inverseZ), zero);
+            V::storeColumn(normal, 3, zero, zero, zero, one);
+        }
+    }
+
+    ///
+    /// @brief sin and cos from the vector primitives of V: reduction to [-pi/4, pi/4] by quadrant and the Cephes minimax polynomials
+    ///
+    template<typename V>
+    void polynomialSincos(const typename V::Type x, typename V::Type& sine, typename V::Type& cosine)
+    {
+        using T = typename V::Type;
+        // pi / 2 split in three parts so that quadrant * part is exact (Cody-Waite)
+        constexpr float PI_2_HI = 1.5703125F;
+        constexpr float PI_2_MID = 4.837512969970703125E-4F;
+        constexpr float PI_2_LO = 7.54978995489188216E-8F;
+        constexpr float TWO_OVER_PI = 0.636619772367581343F;
+
+        const T quadrant = V::floor(V::fmadd(x, V::set1(TWO_OVER_PI), V::set1(0.5F)));
+        T r = V::fnmadd(quadrant, V::set1(PI_2_HI), x);
+        r = V::fnmadd(quadrant, V::set1(PI_2_MID), r);
+        r = V::fnmadd(quadrant, V::set1(PI_2_LO), r);
+        const T z = V::mul(r, r);
+
+        T s = V::fmadd(V::set1(-1.9515295891E-4F), z, V::set1(8.3321608736E-3F));
+        s = V::fmadd(s, z, V::set1(-1.6666654611E-1F));
+        s = V::fmadd(V::mul(s, z), r, r);
+        T c = V::fmadd(V::set1(2.443315711809948E-5F), z, V::set1(-1.388731625493765E-3F));
+        c = V::fmadd(c, z, V::set1(4.166664568298827E-2F));
+        c = V::fmadd(V::mul(c, z), z, V::fnmadd(V::set1(0.5F), z, V::set1(1.F)));
+
+        // quadrant modulo 4: odd ones swap sin and cos, 2 and 3 negate the sine, 1 and 2 negate the cosine
+        const T q = V::fnmadd(V::floor(V::mul(quadrant, V::set1(0.25F))), V::set1(4.F), quadrant);
+        const auto odd = V::equal(V::sub(q, V::mul(V::floor(V::mul(q, V::set1(0.5F))), V::set1(2.F))), V::set1(1.F));
+        const T swappedSine = V::select(odd, c, s);
+        const T swappedCosine = V::select(odd, s, c);
+        const T zero = V::set1(0.F);
+        sine = V::select(V::greater(q, V::set1(1.5F)), V::sub(zero, swappedSine), swappedSine);
+        const auto cosinePositive = V::greater(V::mul(V::sub(q, V::set1(0.5F)), V::sub(q, V::set1(2.5F))), zero);
+        cosine = V::select(cosinePositive, swappedCosine, V::sub(zero, swappedCosine));
+    }
+
+} // namespace ven
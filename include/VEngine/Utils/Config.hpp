@@ -11,6 +11,8 @@
     #undef far
 #endif
 
+#include <string>
+
 #include "VEngine/Core/Window.hpp"
 #include "VEngine/Scene/Camera.hpp"
 
@@ -37,6 +39,8 @@ namespace ven {
         WindowConf window;
         CameraConf camera;
         bool vsync = false; // TODO: Implement vsync
+        bool bakePvs = false;
+        std::string scenePath; // scene file to load instead of the default scene
     };
 
 } // namespace ven
@@ -6,12 +6,30 @@
 
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
 namespace ven {
 
+    static constexpr uint64_t FNV1A_OFFSET_BASIS = 0xcbf29ce484222325ULL;
+    static constexpr uint64_t FNV1A_PRIME = 0x100000001b3ULL;
+
     template<typename T, typename... Rest>
     void hashCombine(std::size_t& seed, const T& v, const Rest&... rest) {
         seed ^= std::hash<T>{}(v) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
         (hashCombine(seed, rest), ...);
     }
 
+    ///
+    /// @brief 64 bits FNV-1a of a byte range, chain calls by passing the previous result as hash
+    ///
+    inline uint64_t fnv1a(const void* data, const std::size_t size, uint64_t hash = FNV1A_OFFSET_BASIS) {
+        const auto* bytes = static_cast<const uint8_t*>(data);
+        for (std::size_t i = 0; i < size; i++) {
+            hash = (hash ^ bytes[i]) * FNV1A_PRIME;
+        }
+        return hash;
+    }
+
 } // namespace ven
@@ -6,8 +6,10 @@
 
 #pragma once
 
+#include <array>
 #include <iostream>
 #include <iomanip>
+#include <string>
 
 #ifdef _WIN32
     #include <windows.h>
@@ -40,6 +42,7 @@ namespace ven {
                 std::cout << getColorForDuration(duration) << formatLogMessage(LogLevel::INFO, message + " took " + std::to_string(duration) + " ms") << LOG_LEVEL_COLOR.at(3);
             }
 
+            static void logInfo(const std::string& message) { std::cout << formatLogMessage(LogLevel::INFO, message) << LOG_LEVEL_COLOR.at(3); }
             static void logWarning(const std::string& message) { std::cout << LOG_LEVEL_COLOR.at(2) << formatLogMessage(LogLevel::WARNING, message) << LOG_LEVEL_COLOR.at(3); }
 
         private:
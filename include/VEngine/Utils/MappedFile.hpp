@@ -0,0 +1,51 @@
+///
+/// @file MappedFile.hpp
+/// @brief This file contains the MappedFile class
+/// @namespace ven
+///
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+
+namespace ven {
+
+    ///
+    /// @class MappedFile
+    /// @brief Read only memory mapping of a whole file, unmapped on destruction
+    /// @namespace ven
+    ///
+    class MappedFile {
+
+        public:
+
+            ///
+            /// @brief Map a file, throws std::runtime_error if it can't be opened or mapped
+            ///
+            explicit MappedFile(const std::string& filepath);
+            ~MappedFile();
+
+            MappedFile(const MappedFile&) = delete;
+            MappedFile& operator=(const MappedFile&) = delete;
+            MappedFile(MappedFile&& other) noexcept;
+            MappedFile& operator=(MappedFile&& other) noexcept;
+
+            [[nodiscard]] std::span<const uint8_t> getData() const { return { m_data, m_size }; }
+            [[nodiscard]] std::size_t getSize() const { return m_size; }
+
+        private:
+
+            void unmap();
+
+            const uint8_t* m_data{nullptr};
+            std::size_t m_size{0};
+#ifdef _WIN32
+            void* m_file{nullptr};
+            void* m_mapping{nullptr};
+#endif
+
+    }; // class MappedFile
+
+} // namespace ven
@@ -24,6 +24,8 @@ namespace ven {
           "  --version, -v        Show version information and exit\n"
           "  --fullscreen, -f     Enable fullscreen mode\n"
           "  --vsync, -V          Enable vertical sync\n"
+          "  --bake-pvs           Bake the potentially visible sets of the scene models and exit\n"
+          "  --scene <path>       Load a scene file (.vscene, or .txt for the text format)\n"
           "  --width <value>      Set the width of the window (e.g., 800)\n"
           "  --height <value>     Set the height of the window (e.g., 600)\n"
           "  --fov <value>        Set the field of view (1.0 to 300.0)\n"
@@ -60,6 +60,14 @@ namespace ven {
         } },
         { "fullscreen", [](Config& conf, std::string_view arg) { conf.window.fullscreen = true; } },
         { "vsync", [](Config& conf, std::string_view arg) { conf.vsync = true; } },
+        { "bake-pvs", [](Config& conf, std::string_view arg) { conf.bakePvs = true; } },
+        { "scene", [](Config& conf, const std::string_view arg)
+        {
+            if (arg.empty()) {
+                throw std::invalid_argument("Missing value for scene");
+            }
+            conf.scenePath = std::string(arg);
+        } },
         { "fov", [](Config& conf, const std::string_view arg)
         {
             if (!isNumeric(arg)) {
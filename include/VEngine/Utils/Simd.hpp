@@ -0,0 +1,25 @@
+///
+/// @file Simd.hpp
+/// @brief This file contains the runtime detection of the SIMD instruction sets
+/// @namespace ven
+///
+
+#pragma once
+
+#include <cstdint>
+
+namespace ven {
+
+    enum class SimdLevel : uint8_t {
+        SCALAR = 0,
+        SSE4 = 1,
+        AVX2 = 2 // with FMA
+    };
+
+    ///
+    /// @brief Best instruction set supported by the CPU (and the OS for the AVX state), detected once
+    /// @note the kernels of a level live in their own translation units compiled for it, see PathsAndOptions.cmake
+    ///
+    [[nodiscard]] SimdLevel getSupportedSimdLevel();
+
+} // namespace ven
@@ -0,0 +1,147 @@
+///
+/// @file SparseSet.hpp
+/// @brief This file contains the Handle struct and the SparseSet class
+/// @namespace ven
+///
+
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace ven {
+
+    ///
+    /// @struct Handle
+    /// @brief Generational handle, stays invalid once its entity is erased even if the slot is reused
+    /// @namespace ven
+    ///
+    struct Handle {
+        static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+
+        uint32_t index{INVALID_INDEX};
+        uint32_t generation{0};
+
+        [[nodiscard]] bool isNull() const { return index == INVALID_INDEX; }
+        bool operator==(const Handle&) const = default;
+    };
+
+    ///
+    /// @class SparseSet
+    /// @brief Dense structure of arrays storage indexed by generational handles
+    /// @note erase swaps the last entity into the hole, dense indices are only stable until the next erase and column references until the next insert
+    /// @namespace ven
+    ///
+    template<typename... Columns>
+    class SparseSet {
+
+        public:
+
+            SparseSet() = default;
+            ~SparseSet() = default;
+
+            SparseSet(const SparseSet&) = delete;
+            SparseSet& operator=(const SparseSet&) = delete;
+            SparseSet(SparseSet&&) = default;
+            SparseSet& operator=(SparseSet&&) = default;
+
+            Handle insert(Columns... values) {
+                const auto dense = static_cast<uint32_t>(m_handles.size());
+                Handle handle{};
+                if (m_freeSlots.empty()) {
+                    handle.index = static_cast<uint32_t>(m_slots.size());
+                    m_slots.push_back({ .dense = dense, .generation = 0 });
+                } else {
+                    handle.index = m_freeSlots.back();
+                    m_freeSlots.pop_back();
+                    m_slots[handle.index].dense = dense;
+                }
+                handle.generation = m_slots[handle.index].generation;
+                m_handles.push_back(handle);
+                pushBack(std::index_sequence_for<Columns...>{}, std::move(values)...);
+                return handle;
+            }
+
+            ///
+            /// @return false if the handle was already stale
+            ///
+            bool erase(const Handle handle) {
+                if (!contains(handle)) { return false; }
+                Slot& slot = m_slots[handle.index];
+                const uint32_t last = size() - 1;
+                if (slot.dense != last) {
+                    swapDense(std::index_sequence_for<Columns...>{}, slot.dense, last);
+                    m_handles[slot.dense] = m_handles[last];
+                    m_slots[m_handles[slot.dense].index].dense = slot.dense;
+                }
+                popBack(std::index_sequence_for<Columns...>{});
+                m_handles.pop_back();
+                slot.dense = Handle::INVALID_INDEX;
+                slot.generation++;
+                m_freeSlots.push_back(handle.index);
+                return true;
+            }
+
+            void clear() {
+                for (const Handle& handle : m_handles) {
+                    m_slots[handle.index].dense = Handle::INVALID_INDEX;
+                    m_slots[handle.index].generation++;
+                    m_freeSlots.push_back(handle.index);
+                }
+                m_handles.clear();
+                std::apply([](auto&... column) { (column.clear(), ...); }, m_columns);
+            }
+
+            void reserve(const std::size_t capacity) {
+                m_handles.reserve(capacity);
+                std::apply([capacity](auto&... column) { (column.reserve(capacity), ...); }, m_columns);
+            }
+
+            [[nodiscard]] bool contains(const Handle handle) const {
+                return handle.index < m_slots.size() && m_slots[handle.index].generation == handle.generation && m_slots[handle.index].dense != Handle::INVALID_INDEX;
+            }
+            ///
+            /// @brief Dense index of a live handle, throws std::out_of_range for a stale one
+            ///
+            [[nodiscard]] uint32_t indexOf(const Handle handle) const {
+                if (!contains(handle)) { throw std::out_of_range("SparseSet: stale handle"); }
+                return m_slots[handle.index].dense;
+            }
+
+            [[nodiscard]] uint32_t size() const { return static_cast<uint32_t>(m_handles.size()); }
+            [[nodiscard]] bool empty() const { return m_handles.empty(); }
+            [[nodiscard]] const std::vector<Handle>& handles() const { return m_handles; }
+
+            template<std::size_t I>
+            [[nodiscard]] auto& column() { return std::get<I>(m_columns); }
+            template<std::size_t I>
+            [[nodiscard]] const auto& column() const { return std::get<I>(m_columns); }
+
+        private:
+
+            struct Slot {
+                uint32_t dense{Handle::INVALID_INDEX};
+                uint32_t generation{0};
+            };
+
+            template<std::size_t... I>
+            void pushBack(std::index_sequence<I...> /*unused*/, Columns&&... values) { (std::get<I>(m_columns).push_back(std::move(values)), ...); }
+            template<std::size_t... I>
+            void popBack(std::index_sequence<I...> /*unused*/) { (std::get<I>(m_columns).pop_back(), ...); }
+            template<std::size_t... I>
+            void swapDense(std::index_sequence<I...> /*unused*/, const uint32_t lhs, const uint32_t rhs) {
+                using std::swap;
+                (swap(std::get<I>(m_columns)[lhs], std::get<I>(m_columns)[rhs]), ...);
+            }
+
+            std::tuple<std::vector<Columns>...> m_columns;
+            std::vector<Handle> m_handles; // dense index -> handle
+            std::vector<Slot> m_slots; // handle index -> dense index
+            std::vector<uint32_t> m_freeSlots;
+
+    }; // class SparseSet
+
+} // namespace ven
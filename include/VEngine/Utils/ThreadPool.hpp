@@ -0,0 +1,62 @@
+///
+/// @file ThreadPool.hpp
+/// @brief This file contains the ThreadPool class
+/// @namespace ven
+///
+
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace ven {
+
+    ///
+    /// @class ThreadPool
+    /// @brief Fixed set of worker threads running queued tasks, the calling thread takes part in parallelFor
+    /// @namespace ven
+    ///
+    class ThreadPool {
+
+        public:
+
+            explicit ThreadPool(unsigned int workerCount = std::max(1U, std::thread::hardware_concurrency()) - 1);
+            ~ThreadPool();
+
+            ThreadPool(const ThreadPool&) = delete;
+            ThreadPool& operator=(const ThreadPool&) = delete;
+            ThreadPool(ThreadPool&&) = delete;
+            ThreadPool& operator=(ThreadPool&&) = delete;
+
+            void submit(std::function<void()> task);
+            ///
+            /// @brief Split [0, count) in chunks of at least grainSize and run task(begin, end) on them, returns once every chunk is done
+            ///
+            void parallelFor(std::size_t count, const std::function<void(std::size_t begin, std::size_t end)>& task, std::size_t grainSize = 1);
+            ///
+            /// @brief Block until the queue is empty and no worker is running a task
+            ///
+            void waitIdle();
+
+            [[nodiscard]] unsigned int getWorkerCount() const { return static_cast<unsigned int>(m_workers.size()); }
+
+        private:
+
+            void workerLoop();
+
+            std::vector<std::thread> m_workers;
+            std::queue<std::function<void()>> m_tasks;
+            std::mutex m_mutex;
+            std::condition_variable m_condition;
+            std::condition_variable m_idleCondition;
+            unsigned int m_runningTasks{0};
+            bool m_stop{false};
+
+    }; // class ThreadPool
+
+} // namespace ven
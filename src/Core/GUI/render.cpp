@@ -1,3 +1,6 @@
+#include <algorithm>
+#include <stdexcept>
+
 #include <imgui_impl_glfw.h>
 #include <imgui_impl_vulkan.h>
 
@@ -7,6 +10,7 @@
 #include "VEngine/Factories/Light.hpp"
 #include "VEngine/Factories/Object.hpp"
 #include "VEngine/Utils/Colors.hpp"
+#include "VEngine/Utils/Logger.hpp"
 
 void ven::Gui::cleanup()
 {
@@ -15,7 +19,7 @@ void ven::Gui::cleanup()
     ImGui::DestroyContext();
 }
 
-void ven::Gui::render(Renderer* renderer, SceneManager& sceneManager, Camera& camera, const VkPhysicalDevice physicalDevice, GlobalUbo& ubo, const ClockData& clockData)
+void ven::Gui::render(Renderer* renderer, SceneManager& sceneManager, Camera& camera, FrustumCuller& culler, OcclusionCuller& occlusionCuller, LodSelector& lodSelector, const PipelineStatistics& pipelineStatistics, const VkPhysicalDevice physicalDevice, GlobalUbo& ubo, const ClockData& clockData)
 {
     VkPhysicalDeviceProperties deviceProperties;
     vkGetPhysicalDeviceProperties(physicalDevice, &deviceProperties);
@@ -23,11 +27,17 @@ void ven::Gui::render(Renderer* renderer, SceneManager& sceneManager, Camera& ca
     ImGui_ImplGlfw_NewFrame();
     ImGui::NewFrame();
     renderFrameWindow(clockData);
+    if (m_state == SHOW_EDITOR) {
+        pickObject(sceneManager, camera);
+    }
 
-    rendererSection(renderer, ubo);
+    rendererSection(renderer, pipelineStatistics, ubo);
     cameraSection(camera);
+    cullingSection(sceneManager, culler, occlusionCuller);
+    lodSection(lodSelector);
     lightsSection(sceneManager);
     objectsSection(sceneManager);
+    sceneSection(sceneManager);
     inputsSection(*m_io);
     devicePropertiesSection(deviceProperties);
 
@@ -45,12 +55,21 @@ void ven::Gui::renderFrameWindow(const ClockData& clockData)
     ImGui::End();
 }
 
-void ven::Gui::rendererSection(Renderer *renderer, GlobalUbo& ubo)
+void ven::Gui::rendererSection(Renderer *renderer, const PipelineStatistics& pipelineStatistics, GlobalUbo& ubo)
 {
     ImGui::SetNextWindowPos(ImVec2(0.0F, 45.0F), ImGuiCond_Always, ImVec2(0.0F, 0.0F));
     ImGui::Begin("Editor tools");
     if (ImGui::CollapsingHeader("Renderer")) {
         ImGui::Text("Aspect Ratio: %.2f", renderer->getAspectRatio());
+        ImGui::Checkbox("Deferred shading (G-buffer + lighting subpass)", &m_deferredShading);
+        ImGui::Checkbox("Depth pre-pass (lit pass with EQUAL depth test)", &m_depthPrepass);
+        // a specialization constant of the lit shaders, each new value builds their pipelines once
+        ImGui::SliderInt("Max lights per pixel", &m_maxFragmentLights, 1, static_cast<int>(DEFAULT_MAX_FRAGMENT_LIGHTS));
+        if (pipelineStatistics.isSupported()) {
+            ImGui::Text("Fragment invocations: %llu lit, %llu pre-pass",
+                        static_cast<unsigned long long>(pipelineStatistics.getFragmentInvocations(PipelineStatistics::LIT)),
+                        static_cast<unsigned long long>(pipelineStatistics.getFragmentInvocations(PipelineStatistics::DEPTH_PREPASS)));
+        }
 
         if (ImGui::BeginTable("ClearColorTable", 2)) {
             ImGui::TableNextColumn();
@@ -155,33 +174,148 @@ void ven::Gui::cameraSection(Camera &camera)
     }
 }
 
+void ven::Gui::cullingSection(const SceneManager& sceneManager, FrustumCuller& culler, OcclusionCuller& occlusionCuller)
+{
+    if (ImGui::CollapsingHeader("Culling")) {
+        const CullingStats& stats = culler.getStats();
+        const OcclusionStats& occlusionStats = occlusionCuller.getStats();
+        bool enabled = culler.isEnabled();
+        bool occlusionEnabled = occlusionCuller.isEnabled();
+        float minPixelSize = culler.getMinPixelSize();
+
+        ImGui::Checkbox("GPU culling (compute + indirect count)", &m_gpuCulling);
+        ImGui::Checkbox("HiZ occlusion culling (GPU)", &m_occlusionCulling);
+        ImGui::Checkbox("Meshlet rendering (GPU, frustum + cone culling)", &m_meshletRendering);
+        bool pvsEnabled = culler.isPvsEnabled();
+        if (ImGui::Checkbox("Enabled##culling", &enabled)) { culler.setEnabled(enabled); }
+        if (ImGui::Checkbox("Potentially visible sets", &pvsEnabled)) { culler.setPvsEnabled(pvsEnabled); }
+        if (ImGui::SliderFloat("Min pixel size", &minPixelSize, 0.0F, 32.0F)) { culler.setMinPixelSize(minPixelSize); }
+        ImGui::SameLine();
+        if (ImGui::Button("Reset##minPixelSize")) { culler.setMinPixelSize(DEFAULT_MIN_PIXEL_SIZE); }
+        ImGui::Text("Tested: %u", stats.tested);
+        ImGui::Text("PVS culled: %u", stats.pvsCulled);
+        ImGui::Text("Frustum culled: %u", stats.frustumCulled);
+        ImGui::Text("Small culled: %u", stats.smallCulled);
+        ImGui::Text("Submitted: %u", stats.submitted);
+        ImGui::Text("Culling time: %.3fms", stats.timeMS);
+        ImGui::Separator();
+        if (ImGui::Checkbox("CPU occlusion culling", &occlusionEnabled)) { occlusionCuller.setEnabled(occlusionEnabled); }
+        ImGui::Text("Occluder triangles: %u", occlusionStats.occluderTriangles);
+        ImGui::Text("Occluded: %u", occlusionStats.occluded);
+        ImGui::Text("Raster time: %.3fms", occlusionStats.rasterMS);
+        ImGui::Text("Occlusion test time: %.3fms", occlusionStats.testMS);
+        ImGui::Separator();
+        const SpatialIndex& spatialIndex = sceneManager.getSpatialIndex();
+        std::vector<Handle> visible;
+        spatialIndex.query(culler.getFrustum(), visible);
+        ImGui::Text("Spatial index proxies: %u", spatialIndex.getProxyCount());
+        ImGui::Text("Spatial index height: %u", spatialIndex.getHeight());
+        ImGui::Text("Spatial index area ratio: %.2f", static_cast<double>(spatialIndex.getAreaRatio()));
+        ImGui::Text("In frustum (spatial index): %zu", visible.size());
+    }
+}
+
+void ven::Gui::lodSection(LodSelector& lodSelector)
+{
+    if (ImGui::CollapsingHeader("Level of detail")) {
+        const LodStats& stats = lodSelector.getStats();
+        bool enabled = lodSelector.isEnabled();
+        float pixelError = lodSelector.getPixelError();
+        float hysteresis = lodSelector.getHysteresis();
+
+        if (ImGui::Checkbox("Enabled##lod", &enabled)) { lodSelector.setEnabled(enabled); }
+        if (ImGui::SliderFloat("Max pixel error", &pixelError, 0.1F, 16.0F)) { lodSelector.setPixelError(pixelError); }
+        ImGui::SameLine();
+        if (ImGui::Button("Reset##pixelError")) { lodSelector.setPixelError(DEFAULT_LOD_PIXEL_ERROR); }
+        if (ImGui::SliderFloat("Hysteresis", &hysteresis, 0.0F, 0.9F)) { lodSelector.setHysteresis(hysteresis); }
+        ImGui::SameLine();
+        if (ImGui::Button("Reset##hysteresis")) { lodSelector.setHysteresis(DEFAULT_LOD_HYSTERESIS); }
+        for (std::size_t lod = 0; lod < stats.selected.size(); lod++) {
+            ImGui::Text("LOD %zu: %u draws", lod, stats.selected[lod]);
+        }
+        const double ratio = stats.baseIndexCount > 0 ? static_cast<double>(stats.indexCount) / static_cast<double>(stats.baseIndexCount) : 1.0;
+        ImGui::Text("Triangles: %llu (%.1f%% of full detail)", static_cast<unsigned long long>(stats.indexCount / 3), ratio * 100.0);
+    }
+}
+
+void ven::Gui::pickObject(const SceneManager& sceneManager, const Camera& camera)
+{
+    if (m_io->WantCaptureMouse || !ImGui::IsMouseClicked(ImGuiMouseButton_Left) || m_io->DisplaySize.x <= 0.0F || m_io->DisplaySize.y <= 0.0F) {
+        return;
+    }
+    // unproject the cursor on the near (depth 0) and far (depth 1) planes
+    const glm::vec2 ndc{ 2.0F * m_io->MousePos.x / m_io->DisplaySize.x - 1.0F, 2.0F * m_io->MousePos.y / m_io->DisplaySize.y - 1.0F };
+    const glm::mat4 inverseViewProjection = inverse(camera.getProjection() * camera.getView());
+    const glm::vec4 nearPoint = inverseViewProjection * glm::vec4(ndc, 0.0F, 1.0F);
+    const glm::vec4 farPoint = inverseViewProjection * glm::vec4(ndc, 1.0F, 1.0F);
+    const glm::vec3 origin = glm::vec3(nearPoint) / nearPoint.w;
+    const Ray ray{ .origin = origin, .direction = glm::vec3(farPoint) / farPoint.w - origin, .maxDistance = 1.0F };
+    RayHit hit;
+    sceneManager.getSpatialIndex().raycast(std::span(&ray, 1), std::span(&hit, 1));
+    m_selectedObject = hit.handle;
+}
+
 void ven::Gui::objectsSection(SceneManager& sceneManager)
 {
     if (ImGui::CollapsingHeader("Objects")) {
         bool open = false;
-        for (Object::Map& objects = sceneManager.getObjects(); auto& [id, object] : objects) {
+        ObjectStore& objects = sceneManager.getObjects();
+        for (uint32_t i = 0; i < objects.size(); i++) {
+            const Handle handle = objects.handles()[i];
+            const std::string name = objects.names()[i];
             ImGui::PushStyleColor(ImGuiCol_Text, { Colors::GRAY_4.r, Colors::GRAY_4.g, Colors::GRAY_4.b, 1.0F });
-            open = ImGui::TreeNode(std::string(object.getName() + " [" + std::to_string(object.getId()) + "]").c_str());
+            if (handle == m_selectedObject) {
+                ImGui::SetNextItemOpen(true);
+                ImGui::SetScrollHereY();
+                m_selectedObject = {};
+            }
+            open = ImGui::TreeNode(std::string(name + " [" + std::to_string(handle.index) + "]").c_str());
             ImGui::PopStyleColor(1);
             if (open) {
-                if (ImGui::Button(("Delete##" + object.getName()).c_str())) {
-                    m_objectsToRemove.push_back(id);
+                if (ImGui::Button(("Delete##" + name).c_str())) {
+                    m_objectsToRemove.push_back(handle);
                     sceneManager.setDestroyState(true);
                 }
                 ImGui::SameLine();
-                if (ImGui::Button(("Duplicate##" + object.getName()).c_str())) {
-                    ObjectFactory::duplicate(object);
+                if (ImGui::Button(("Duplicate##" + name).c_str())) {
+                    ObjectFactory::duplicate(objects, handle);
+                }
+                Transform3D transform = objects.transforms()[i];
+                bool occluder = objects.occluders()[i] != 0;
+                ImGui::Text("Generation: %u", handle.generation);
+                if (ImGui::Checkbox(("Occluder##" + name).c_str(), &occluder)) { objects.occluders()[i] = static_cast<uint8_t>(occluder); }
+                bool moved = ImGui::DragFloat3(("Position##" + name).c_str(), glm::value_ptr(transform.translation), 0.1F);
+                moved |= ImGui::DragFloat3(("Rotation##" + name).c_str(), glm::value_ptr(transform.rotation), 0.1F);
+                moved |= ImGui::DragFloat3(("Scale##" + name).c_str(), glm::value_ptr(transform.scale), 0.1F);
+                if (moved) { objects.setTransform(i, transform); }
+                if (uint32_t parent = sceneManager.getSceneGraph().getParent(objects.nodes()[i]); parentCombo("Parent##" + name, objects, objects.nodes()[i], parent)) {
+                    try { objects.setParent(i, parent); } catch (const std::invalid_argument&) { /* would create a cycle, keep the current parent */ }
                 }
-                ImGui::Text("Address: %p", static_cast<void*>(&object));
-                ImGui::DragFloat3(("Position##" + object.getName()).c_str(), glm::value_ptr(object.transform.translation), 0.1F);
-                ImGui::DragFloat3(("Rotation##" + object.getName()).c_str(), glm::value_ptr(object.transform.rotation), 0.1F);
-                ImGui::DragFloat3(("Scale##" + object.getName()).c_str(), glm::value_ptr(object.transform.scale), 0.1F);
                 ImGui::TreePop();
             }
         }
     }
 }
 
+void ven::Gui::sceneSection(SceneManager& sceneManager)
+{
+    if (ImGui::CollapsingHeader("Scene")) {
+        ImGui::InputText("Path##scene", m_scenePath.data(), m_scenePath.size());
+        const std::string path(m_scenePath.data());
+        if (ImGui::Button("Save##scene")) {
+            try {
+                sceneManager.save(path);
+            } catch (const std::exception& error) {
+                Logger::logWarning("Failed to save scene " + path + ": " + error.what());
+            }
+        }
+        ImGui::SameLine();
+        // replacing the scene frees resources the current frame still uses, the engine loads it after the frame
+        if (ImGui::Button("Load##scene")) { sceneManager.setPendingLoad(path); }
+        ImGui::Text("Binary %s, text if the path ends with %s", SCENE_EXTENSION.data(), SCENE_TEXT_EXTENSION.data());
+    }
+}
+
 void ven::Gui::lightsSection(SceneManager& sceneManager)
 {
 
@@ -189,65 +323,82 @@ void ven::Gui::lightsSection(SceneManager& sceneManager)
         bool open = false;
         float tempIntensity = m_intensity;
         float tempShininess = m_shininess;
-        Light::Map& lights = sceneManager.getLights();
+        LightStore& lights = sceneManager.getLights();
 
         if (ImGui::BeginTable("LightTable", 2)) {
             ImGui::TableNextColumn();
             if (ImGui::SliderFloat("Global Intensity", &tempIntensity, 0.0F, 5.F)) {
                 m_intensity = tempIntensity;
-                for (auto&[fst, snd] : lights) {
-                    snd.color.a = m_intensity;
+                for (glm::vec4& color : lights.colors()) {
+                    color.a = m_intensity;
                 }
             }
             ImGui::TableNextColumn();
             if (ImGui::Button("Reset")) {
                 m_intensity = DEFAULT_LIGHT_INTENSITY;
                 tempIntensity = m_intensity;
-                for (auto&[fst, snd] : lights) {
-                    snd.color.a = m_intensity;
+                for (glm::vec4& color : lights.colors()) {
+                    color.a = m_intensity;
                 }
             }
 
             ImGui::TableNextColumn();
             if (ImGui::SliderFloat("Global Shininess", &tempShininess, 0.0F, 512.F)) {
                 m_shininess = tempShininess;
-                for (auto&[fst, snd] : lights) {
-                    snd.setShininess(m_shininess);
-                }
+                std::ranges::fill(lights.shininess(), m_shininess);
             }
 
             ImGui::TableNextColumn();
             if (ImGui::Button("Reset")) {
                 m_shininess = DEFAULT_SHININESS;
                 tempShininess = m_shininess;
-                for (auto&[fst, snd] : lights) {
-                    snd.setShininess(m_shininess);
-                }
+                std::ranges::fill(lights.shininess(), m_shininess);
             }
 
             ImGui::EndTable();
         }
 
-        for (auto& [id, light] : lights) {
-            ImGui::PushStyleColor(ImGuiCol_Text, {light.color.r, light.color.g, light.color.b, 1.0F});
-            open = ImGui::TreeNode(std::string(light.getName() + " [" + std::to_string(light.getId()) + "]").c_str());
+        const ShadowStats& shadowStats = sceneManager.getShadowCache().getStats();
+        ImGui::Text("Shadow maps: %u (%u baked, %u composited)", shadowStats.shadowMaps, shadowStats.baked, shadowStats.composited);
+        ImGui::Text("Dynamic shadow casters: %u", shadowStats.dynamicObjects);
+
+        for (uint32_t i = 0; i < lights.size(); i++) {
+            const Handle handle = lights.handles()[i];
+            const std::string name = lights.names()[i];
+            const std::string id = std::to_string(handle.index);
+            ImGui::PushStyleColor(ImGuiCol_Text, {lights.colors()[i].r, lights.colors()[i].g, lights.colors()[i].b, 1.0F});
+            open = ImGui::TreeNode(std::string(name + " [" + id + "]").c_str());
             ImGui::PopStyleColor(1);
             if (open) {
-                if (ImGui::Button(("Delete##" + light.getName()).c_str())) {
-                    m_lightsToRemove.push_back(id);
+                if (ImGui::Button(("Delete##" + id).c_str())) {
+                    m_lightsToRemove.push_back(handle);
                     sceneManager.setDestroyState(true);
                 }
                 ImGui::SameLine();
-                if (ImGui::Button(("Duplicate##" + light.getName()).c_str())) {
-                    LightFactory::duplicate(light);
+                if (ImGui::Button(("Duplicate##" + id).c_str())) {
+                    LightFactory::duplicate(lights, handle);
+                }
+                // fetched after the duplicate, inserting may reallocate the columns
+                Transform3D transform = lights.transforms()[i];
+                glm::vec4& color = lights.colors()[i];
+                float& shininess = lights.shininess()[i];
+                ImGui::Text("Generation: %u", handle.generation);
+                bool moved = ImGui::DragFloat3(("Position##" + id).c_str(), glm::value_ptr(transform.translation), 0.1F);
+                moved |= ImGui::DragFloat3(("Rotation##" + id).c_str(), glm::value_ptr(transform.rotation), 0.1F);
+                moved |= ImGui::DragFloat3(("Scale##" + id).c_str(), glm::value_ptr(transform.scale), 0.1F);
+                if (moved) { lights.setTransform(i, transform); }
+                if (uint32_t parent = sceneManager.getSceneGraph().getParent(lights.nodes()[i]); parentCombo("Parent##" + id, sceneManager.getObjects(), lights.nodes()[i], parent)) {
+                    lights.setParent(i, parent);
                 }
-                ImGui::Text("Address: %p", static_cast<void*>(&light));
-                ImGui::DragFloat3(("Position##" + std::to_string(light.getId())).c_str(), glm::value_ptr(light.transform.translation), 0.1F);
-                ImGui::DragFloat3(("Rotation##" + std::to_string(light.getId())).c_str(), glm::value_ptr(light.transform.rotation), 0.1F);
-                ImGui::DragFloat3(("Scale##" + std::to_string(light.getId())).c_str(), glm::value_ptr(light.transform.scale), 0.1F);
+                uint8_t& flags = lights.flags()[i];
+                bool animated = (flags & LIGHT_ANIMATED) != 0;
+                bool shadow = (flags & LIGHT_SHADOW) != 0;
+                if (ImGui::Checkbox(("Animated##" + id).c_str(), &animated)) { flags = static_cast<uint8_t>(animated ? flags | LIGHT_ANIMATED : flags & ~LIGHT_ANIMATED); }
+                ImGui::SameLine();
+                if (ImGui::Checkbox(("Casts shadows##" + id).c_str(), &shadow)) { flags = static_cast<uint8_t>(shadow ? flags | LIGHT_SHADOW : flags & ~LIGHT_SHADOW); }
                 if (ImGui::BeginTable("ColorTable", 2)) {
                     ImGui::TableNextColumn();
-                    ImGui::ColorEdit4(("Color##" + std::to_string(light.getId())).c_str(), glm::value_ptr(light.color));
+                    ImGui::ColorEdit4(("Color##" + id).c_str(), glm::value_ptr(color));
                     ImGui::TableNextColumn();
                     static int item_current = 0;
                     if (ImGui::Combo("Color Presets",
@@ -259,19 +410,16 @@ void ven::Gui::lightsSection(SceneManager& sceneManager)
                                      },
                                      nullptr,
                                      std::size(Colors::COLOR_PRESETS_3))) {
-                        light.color = {Colors::COLOR_PRESETS_3.at(static_cast<unsigned long>(item_current)).second, light.color.a};
+                        color = {Colors::COLOR_PRESETS_3.at(static_cast<unsigned long>(item_current)).second, color.a};
                     }
                     ImGui::EndTable();
 
-                    ImGui::SliderFloat(("Intensity##" + std::to_string(light.getId())).c_str(), &light.color.a, 0.0F, 5.F);
+                    ImGui::SliderFloat(("Intensity##" + id).c_str(), &color.a, 0.0F, 5.F);
                     ImGui::SameLine();
-                    if (ImGui::Button(("Reset##" + std::to_string(light.getId())).c_str())) { light.color.a = DEFAULT_LIGHT_INTENSITY; }
-                    float shininess = light.getShininess();
-                    if (ImGui::SliderFloat("Shininess", &shininess, 0.0F, 512.F)) {
-                        light.setShininess(shininess);
-                    }
+                    if (ImGui::Button(("Reset##" + id).c_str())) { color.a = DEFAULT_LIGHT_INTENSITY; }
+                    ImGui::SliderFloat("Shininess", &shininess, 0.0F, 512.F);
                     ImGui::SameLine();
-                    if (ImGui::Button("Reset##shininess")) { light.setShininess(DEFAULT_SHININESS); }
+                    if (ImGui::Button("Reset##shininess")) { shininess = DEFAULT_SHININESS; }
                 }
                 ImGui::TreePop();
             }
@@ -279,6 +427,30 @@ void ven::Gui::lightsSection(SceneManager& sceneManager)
     }
 }
 
+bool ven::Gui::parentCombo(const std::string& label, const ObjectStore& objects, const uint32_t node, uint32_t& parent)
+{
+    bool changed = false;
+    const std::span<const uint32_t> nodes = objects.nodes();
+    const auto current = std::ranges::find(nodes, parent);
+    const std::string preview = current == nodes.end() ? "none" : objects.names()[static_cast<std::size_t>(current - nodes.begin())];
+
+    if (ImGui::BeginCombo(label.c_str(), preview.c_str())) {
+        if (ImGui::Selectable("none", parent == SceneGraph::NONE)) {
+            parent = SceneGraph::NONE;
+            changed = true;
+        }
+        for (uint32_t i = 0; i < objects.size(); i++) {
+            if (nodes[i] == node) { continue; }
+            if (ImGui::Selectable((objects.names()[i] + "##parent" + std::to_string(nodes[i])).c_str(), nodes[i] == parent)) {
+                parent = nodes[i];
+                changed = true;
+            }
+        }
+        ImGui::EndCombo();
+    }
+    return changed;
+}
+
 void ven::Gui::inputsSection(const ImGuiIO& io)
 {
     if (ImGui::CollapsingHeader("Input")) {
@@ -1,48 +1,165 @@
 #include "VEngine/Core/RenderSystem/ABase.hpp"
+#include "VEngine/Gfx/Descriptors/LayoutCache.hpp"
+#include "VEngine/Gfx/ShaderReflection.hpp"
 
-void ven::ARenderSystemBase::createPipelineLayout(const VkDescriptorSetLayout globalSetLayout, const uint32_t pushConstantSize)
+void ven::ARenderSystemBase::createPipelineLayout(const VkDescriptorSetLayout globalSetLayout, const std::vector<std::string> &shaderPaths)
 {
-    VkPushConstantRange pushConstantRange{};
-    pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
-    pushConstantRange.offset = 0;
-    pushConstantRange.size = pushConstantSize;
-
-    renderSystemLayout =
-    DescriptorSetLayout::Builder(m_device)
-        .addBinding(
-            0,
-            VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
-            VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT)
-        .addBinding(1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT)
-        .build();
-
-    const std::vector<VkDescriptorSetLayout> descriptorSetLayouts{
-        globalSetLayout,
-        renderSystemLayout->getDescriptorSetLayout()
+    // set 0 is the global set shared by every system, only set 1 and the push constants follow the shaders of this one
+    const ShaderReflection reflection = ShaderReflection::fromFiles(shaderPaths);
+    DescriptorLayoutCache& layoutCache = m_device.getLayoutCache();
+    renderSystemLayout = layoutCache.getSetLayout(reflection.getSetBindings(1));
+    m_pushConstantRange = reflection.getPushConstantRange();
+    m_pipelineLayout = layoutCache.getPipelineLayout({ globalSetLayout, renderSystemLayout->getDescriptorSetLayout() }, m_pushConstantRange);
+}
+
+void ven::ARenderSystemBase::createPipeline(const VkRenderPass renderPass, const std::string &shadersVertPath, const std::string &shadersFragPath, const bool isLight, const uint32_t subpass, const uint8_t variantConstants)
+{
+    assert(m_pipelineLayout && "Cannot create pipeline before pipeline layout");
+    m_shaders = std::make_unique<ShaderVariantCache>(m_device.getPipelineThreadPool(), [&device = m_device, pipelineLayout = m_pipelineLayout, renderPass, shadersVertPath, shadersFragPath, isLight, subpass](const ShaderVariant& variant) {
+        PipelineConfigInfo pipelineConfig{};
+        Shaders::defaultPipelineConfigInfo(pipelineConfig);
+        if (isLight) {
+            pipelineConfig.attributeDescriptions.clear();
+            pipelineConfig.bindingDescriptions.clear();
+        }
+        // billboards and the unclassified meshlet draws, both rely on the alpha
+        pipelineConfig.colorBlendAttachment.blendEnable = VK_TRUE;
+        pipelineConfig.renderPass = renderPass;
+        pipelineConfig.subpass = subpass;
+        pipelineConfig.pipelineLayout = pipelineLayout;
+        pipelineConfig.variant = variant;
+        return std::make_unique<Shaders>(device, shadersVertPath, shadersFragPath, pipelineConfig);
+    }, ShaderVariant{}, variantConstants);
+}
+
+void ven::ARenderSystemBase::createGeometryPipelines(const VkDescriptorSetLayout globalSetLayout, const VkRenderPass renderPass, const std::string &shadersVertPath, const std::string &shadersDepthVertPath, const GEOMETRY_PASS pass)
+{
+    struct PipelineDescription {
+        uint8_t alphaModes;
+        bool depthStream;
+        VkCompareOp depthCompareOp;
+        bool blend;
+        std::string fragPath;
     };
+    const std::string litFragPath = std::string(SHADERS_BIN_PATH) + (pass == GEOMETRY_GBUFFER ? "fragment_gbuffer.spv" : "fragment_shader.spv");
+    const std::string cutoutFragPath = std::string(SHADERS_BIN_PATH) + "fragment_depth.spv";
+    const uint32_t colorAttachmentCount = pass == GEOMETRY_GBUFFER ? GBUFFER_ATTACHMENT_COUNT : 1;
+    constexpr auto OPAQUE = static_cast<uint8_t>(1U << ALPHA_OPAQUE);
+    constexpr auto CUTOUT = static_cast<uint8_t>(1U << ALPHA_CUTOUT);
+    constexpr auto BLEND = static_cast<uint8_t>(1U << ALPHA_BLEND);
+
+    // the cutout draws lay their alpha tested depth first, their lit draw then runs without discard behind the EQUAL test
+    std::vector<PipelineDescription> descriptions;
+    switch (pass) {
+        case GEOMETRY_FORWARD:
+        case GEOMETRY_GBUFFER:
+            descriptions.push_back({ OPAQUE, false, VK_COMPARE_OP_LESS, false, litFragPath });
+            descriptions.push_back({ CUTOUT, true, VK_COMPARE_OP_LESS, false, cutoutFragPath });
+            descriptions.push_back({ CUTOUT, false, VK_COMPARE_OP_EQUAL, false, litFragPath });
+            if (pass == GEOMETRY_FORWARD) {
+                descriptions.push_back({ BLEND, false, VK_COMPARE_OP_LESS, true, litFragPath });
+            }
+            break;
+        case GEOMETRY_DEPTH_PREPASS:
+            // no fragment stage at all for the opaque depth
+            descriptions.push_back({ OPAQUE, true, VK_COMPARE_OP_LESS, false, "" });
+            descriptions.push_back({ CUTOUT, true, VK_COMPARE_OP_LESS, false, cutoutFragPath });
+            break;
+        case GEOMETRY_FORWARD_EQUAL:
+            descriptions.push_back({ OPAQUE | CUTOUT, false, VK_COMPARE_OP_EQUAL, false, litFragPath });
+            descriptions.push_back({ BLEND, false, VK_COMPARE_OP_LESS, true, litFragPath });
+            break;
+        case GEOMETRY_FORWARD_BLEND:
+            descriptions.push_back({ BLEND, false, VK_COMPARE_OP_LESS, true, litFragPath });
+            break;
+    }
+
+    // one layout for all the pipelines of the pass, they draw with the same descriptor sets
+    std::vector<std::string> shaderPaths;
+    for (const PipelineDescription& description : descriptions) {
+        shaderPaths.push_back(description.depthStream ? shadersDepthVertPath : shadersVertPath);
+        shaderPaths.push_back(description.fragPath);
+    }
+    createPipelineLayout(globalSetLayout, shaderPaths);
 
-    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
-    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-    pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(descriptorSetLayouts.size());
-    pipelineLayoutInfo.pSetLayouts = descriptorSetLayouts.data();
-    pipelineLayoutInfo.pushConstantRangeCount = 1;
-    pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
-    if (vkCreatePipelineLayout(m_device.device(), &pipelineLayoutInfo, nullptr, &m_pipelineLayout) != VK_SUCCESS)
-    {
-        throw std::runtime_error("Failed to create pipeline layout");
+    for (const PipelineDescription& description : descriptions) {
+        const std::string& vertPath = description.depthStream ? shadersDepthVertPath : shadersVertPath;
+        const std::string& fragPath = description.fragPath;
+        const bool depthStream = description.depthStream;
+        const VkCompareOp depthCompareOp = description.depthCompareOp;
+        const bool blend = description.blend;
+        // the cutout texels already failed the EQUAL test of their lit draw, only the blended class reads the texture alpha
+        const ShaderVariant base{ .alphaMode = blend ? ALPHA_BLEND : ALPHA_OPAQUE };
+        const uint8_t variantConstants = fragPath == litFragPath && pass != GEOMETRY_GBUFFER ? SHADER_LIGHTING_CONSTANTS : 0;
+        m_geometryPipelines.push_back({
+            .shaders = std::make_unique<ShaderVariantCache>(m_device.getPipelineThreadPool(), [&device = m_device, pipelineLayout = m_pipelineLayout, renderPass, vertPath, fragPath, colorAttachmentCount, depthStream, depthCompareOp, blend](const ShaderVariant& variant) {
+                PipelineConfigInfo pipelineConfig{};
+                Shaders::defaultPipelineConfigInfo(pipelineConfig);
+                if (depthStream) {
+                    pipelineConfig.bindingDescriptions = DepthVertex::getBindingDescriptions();
+                    pipelineConfig.attributeDescriptions = DepthVertex::getAttributeDescriptions();
+                    pipelineConfig.colorBlendAttachment.colorWriteMask = 0;
+                }
+                // an EQUAL test keeps the depth laid before, a blended surface must not hide what is drawn behind it later
+                pipelineConfig.depthStencilInfo.depthCompareOp = depthCompareOp;
+                pipelineConfig.depthStencilInfo.depthWriteEnable = depthCompareOp == VK_COMPARE_OP_LESS && !blend ? VK_TRUE : VK_FALSE;
+                pipelineConfig.colorBlendAttachment.blendEnable = blend ? VK_TRUE : VK_FALSE;
+                const std::vector colorBlendAttachments(colorAttachmentCount, pipelineConfig.colorBlendAttachment);
+                pipelineConfig.colorBlendInfo.attachmentCount = colorAttachmentCount;
+                pipelineConfig.colorBlendInfo.pAttachments = colorBlendAttachments.data();
+                pipelineConfig.renderPass = renderPass;
+                pipelineConfig.pipelineLayout = pipelineLayout;
+                pipelineConfig.variant = variant;
+                return std::make_unique<Shaders>(device, vertPath, fragPath, pipelineConfig);
+            }, base, variantConstants),
+            .alphaModes = description.alphaModes,
+            .depthStream = depthStream
+        });
     }
 }
 
-void ven::ARenderSystemBase::createPipeline(const VkRenderPass renderPass, const std::string &shadersVertPath, const std::string &shadersFragPath, const bool isLight)
+void ven::ARenderSystemBase::createShadowPipeline(const VkRenderPass renderPass, const std::string &shadersVertPath)
 {
     assert(m_pipelineLayout && "Cannot create pipeline before pipeline layout");
-    PipelineConfigInfo pipelineConfig{};
-    Shaders::defaultPipelineConfigInfo(pipelineConfig);
-    if (isLight) {
-        pipelineConfig.attributeDescriptions.clear();
-    	pipelineConfig.bindingDescriptions.clear();
-    }
-    pipelineConfig.renderPass = renderPass;
-    pipelineConfig.pipelineLayout = m_pipelineLayout;
-    m_shaders = std::make_unique<Shaders>(m_device, shadersVertPath, shadersFragPath, pipelineConfig);
+    m_shaders = std::make_unique<ShaderVariantCache>(m_device.getPipelineThreadPool(), [&device = m_device, pipelineLayout = m_pipelineLayout, renderPass, shadersVertPath](const ShaderVariant& variant) {
+        PipelineConfigInfo pipelineConfig{};
+        Shaders::defaultPipelineConfigInfo(pipelineConfig);
+        pipelineConfig.bindingDescriptions = DepthVertex::getBindingDescriptions();
+        pipelineConfig.attributeDescriptions = DepthVertex::getAttributeDescriptions();
+        // the casters are not closed meshes, culling a side would let the light leak through their thin walls
+        pipelineConfig.rasterizationInfo.cullMode = VK_CULL_MODE_NONE;
+        // against the acne of the lit surfaces, the lookups of the lit passes are also pushed along the normal for the grazing ones
+        pipelineConfig.rasterizationInfo.depthBiasEnable = VK_TRUE;
+        pipelineConfig.rasterizationInfo.depthBiasConstantFactor = 1.25F;
+        pipelineConfig.rasterizationInfo.depthBiasSlopeFactor = 1.75F;
+        pipelineConfig.colorBlendInfo.attachmentCount = 0;
+        pipelineConfig.colorBlendInfo.pAttachments = nullptr;
+        pipelineConfig.renderPass = renderPass;
+        pipelineConfig.pipelineLayout = pipelineLayout;
+        pipelineConfig.variant = variant;
+        return std::make_unique<Shaders>(device, shadersVertPath, "", pipelineConfig);
+    });
+}
+
+void ven::ARenderSystemBase::createMeshPipeline(const VkRenderPass renderPass, const std::string &shadersTaskPath, const std::string &shadersMeshPath, const std::string &shadersFragPath, const uint8_t variantConstants)
+{
+    assert(m_pipelineLayout && "Cannot create pipeline before pipeline layout");
+    m_shaders = std::make_unique<ShaderVariantCache>(m_device.getPipelineThreadPool(), [&device = m_device, pipelineLayout = m_pipelineLayout, renderPass, shadersTaskPath, shadersMeshPath, shadersFragPath](const ShaderVariant& variant) {
+        PipelineConfigInfo pipelineConfig{};
+        Shaders::defaultPipelineConfigInfo(pipelineConfig);
+        // the meshlets are not split by alpha class, they keep the blending the lit shader expects for its transparent texels
+        pipelineConfig.colorBlendAttachment.blendEnable = VK_TRUE;
+        pipelineConfig.renderPass = renderPass;
+        pipelineConfig.pipelineLayout = pipelineLayout;
+        pipelineConfig.variant = variant;
+        return std::make_unique<Shaders>(device, shadersTaskPath, shadersMeshPath, shadersFragPath, pipelineConfig);
+    }, ShaderVariant{}, variantConstants);
+}
+
+void ven::ARenderSystemBase::createComputePipeline(const std::string &shadersCompPath)
+{
+    assert(m_pipelineLayout && "Cannot create pipeline before pipeline layout");
+    m_shaders = std::make_unique<ShaderVariantCache>(m_device.getPipelineThreadPool(), [&device = m_device, pipelineLayout = m_pipelineLayout, shadersCompPath](const ShaderVariant&) {
+        return std::make_unique<Shaders>(device, shadersCompPath, pipelineLayout);
+    });
 }
@@ -0,0 +1,172 @@
+#include <algorithm>
+#include <map>
+
+#include "VEngine/Core/RenderSystem/Culling.hpp"
+#include "VEngine/Gfx/Descriptors/Writer.hpp"
+
+ven::CullingRenderSystem::CullingRenderSystem(const Device& device, const VkDescriptorSetLayout globalSetLayout, std::shared_ptr<Texture> defaultTexture, const HiZRenderSystem& hizRenderSystem) : ARenderSystemBase(device), m_defaultTexture{std::move(defaultTexture)}, m_hizRenderSystem{hizRenderSystem}
+{
+    const std::string compPath = std::string(SHADERS_BIN_PATH) + "culling.spv";
+    createPipelineLayout(globalSetLayout, { compPath });
+    createComputePipeline(compPath);
+    for (unsigned long i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+        reserve(i, 1, 1);
+    }
+}
+
+void ven::CullingRenderSystem::reserve(const unsigned long frameIndex, const uint32_t instanceCount, const uint32_t bucketCount)
+{
+    // one command and one retest flag per instance, the three buffers grow together
+    Buffer::reserve(m_instanceBuffers.at(frameIndex), getDevice(), sizeof(GpuInstanceData), instanceCount, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    Buffer::reserve(m_commandBuffers.at(frameIndex), getDevice(), sizeof(VkDrawIndexedIndirectCommand), instanceCount, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    Buffer::reserve(m_retestBuffers.at(frameIndex), getDevice(), sizeof(uint32_t), instanceCount, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    Buffer::reserve(m_countBuffers.at(frameIndex), getDevice(), sizeof(uint32_t), bucketCount, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+}
+
+void ven::CullingRenderSystem::prepare(const FrameInfo &frameInfo)
+{
+    struct BlendedInstance {
+        float distance;
+        DrawBucket bucket;
+        GpuInstanceData instance;
+    };
+    std::map<std::tuple<const Model*, const Texture*, ALPHA_MODE>, uint32_t> bucketIndices;
+    std::vector<BlendedInstance> blendedInstances;
+    const auto addInstance = [&](const std::shared_ptr<Model>& model, const std::shared_ptr<Texture>& texture, const ALPHA_MODE alphaMode, const GpuInstanceData& instance) {
+        if (alphaMode == ALPHA_BLEND) {
+            // a bucket each, ordered once they are all known
+            const glm::vec3 center{instance.modelMatrix * glm::vec4(glm::vec3(instance.sphere), 1.F)};
+            blendedInstances.push_back({ .distance = glm::length(center - frameInfo.culler.getCameraPosition()), .bucket = { .model = model, .texture = texture, .alphaMode = alphaMode }, .instance = instance });
+            return;
+        }
+        const auto [it, inserted] = bucketIndices.try_emplace({model.get(), texture.get(), alphaMode}, static_cast<uint32_t>(m_buckets.size()));
+        if (inserted) {
+            m_buckets.push_back({ .model = model, .texture = texture, .alphaMode = alphaMode });
+        }
+        m_instances.push_back(instance);
+        m_instances.back().bucket = it->second;
+        m_buckets[it->second].capacity++;
+    };
+
+    m_instances.clear();
+    m_buckets.clear();
+    std::vector<uint8_t> pvsVisible;
+    const std::span<const WorldMatrices> worlds = frameInfo.objects.worlds();
+    const std::span<const std::shared_ptr<Model>> models = frameInfo.objects.models();
+    const std::span<const std::shared_ptr<Texture>> diffuseMaps = frameInfo.objects.diffuseMaps();
+    for (uint32_t i = 0; i < frameInfo.objects.size(); i++) {
+        const std::shared_ptr<Model>& model = models[i];
+        if (model == nullptr || model->getIndexCount() == 0) { continue; }
+        GpuInstanceData instance{
+            .modelMatrix = worlds[i].model,
+            .normalMatrix = worlds[i].normal
+        };
+        if (diffuseMaps[i] == nullptr && !model->getTextures().empty()) {
+            const Pvs& pvs = model->getPvs();
+            const uint32_t cell = frameInfo.culler.isPvsEnabled() && pvs.isValid() ? pvs.findCell(glm::vec3(glm::inverse(instance.modelMatrix) * glm::vec4(frameInfo.culler.getCameraPosition(), 1.F))) : Pvs::OUTSIDE;
+            pvsVisible.assign(model->getMeshes().size(), 1);
+            if (cell != Pvs::OUTSIDE) {
+                pvs.decodeCell(cell, pvsVisible);
+            }
+            std::vector<uint8_t>& lods = frameInfo.objects.lods()[i];
+            lods.resize(model->getMeshes().size());
+            for (std::size_t meshIndex = 0; meshIndex < model->getMeshes().size(); meshIndex++) {
+                const Mesh& mesh = model->getMeshes()[meshIndex];
+                if (mesh.material.diffuseTextures.empty() || pvsVisible[meshIndex] == 0) { continue; }
+                // selected before the GPU culling, hidden instances keep the level updated here
+                lods[meshIndex] = frameInfo.lodSelector.select(mesh.lods, mesh.sphere, instance.modelMatrix, lods[meshIndex]);
+                const bool simplified = lods[meshIndex] > 0 && lods[meshIndex] < mesh.lods.size();
+                instance.sphere = glm::vec4(mesh.sphere.center, mesh.sphere.radius);
+                instance.firstIndex = simplified ? mesh.lods[lods[meshIndex]].firstIndex : mesh.firstIndex;
+                instance.indexCount = simplified ? mesh.lods[lods[meshIndex]].indexCount : mesh.indexCount;
+                addInstance(model, mesh.material.diffuseTextures[0], mesh.material.alphaMode, instance);
+            }
+        } else {
+            std::vector<uint8_t>& lods = frameInfo.objects.lods()[i];
+            lods.resize(1);
+            lods[0] = frameInfo.lodSelector.select(model->getLods(), model->getSphere(), instance.modelMatrix, lods[0]);
+            const bool simplified = lods[0] > 0 && lods[0] < model->getLods().size();
+            instance.sphere = glm::vec4(model->getSphere().center, model->getSphere().radius);
+            instance.firstIndex = simplified ? model->getLods()[lods[0]].firstIndex : 0;
+            instance.indexCount = simplified ? model->getLods()[lods[0]].indexCount : model->getIndexCount();
+            const std::shared_ptr<Texture>& texture = diffuseMaps[i] != nullptr ? diffuseMaps[i] : m_defaultTexture;
+            addInstance(model, texture, texture->getAlphaMode(), instance);
+        }
+    }
+    // the blended buckets come last, back to front, the indirect draws keep the bucket order
+    std::ranges::sort(blendedInstances, std::ranges::greater{}, &BlendedInstance::distance);
+    for (BlendedInstance& blended : blendedInstances) {
+        blended.instance.bucket = static_cast<uint32_t>(m_buckets.size());
+        blended.bucket.capacity = 1;
+        m_buckets.push_back(std::move(blended.bucket));
+        m_instances.push_back(blended.instance);
+    }
+
+    uint32_t drawOffset = 0;
+    for (DrawBucket& bucket : m_buckets) {
+        bucket.drawOffset = drawOffset;
+        drawOffset += bucket.capacity;
+    }
+    for (GpuInstanceData& instance : m_instances) {
+        instance.drawOffset = m_buckets[instance.bucket].drawOffset;
+    }
+
+    reserve(frameInfo.frameIndex, getInstanceCount(), static_cast<uint32_t>(m_buckets.size()));
+    if (!m_instances.empty()) {
+        m_instanceBuffers.at(frameInfo.frameIndex)->writeToBuffer(m_instances.data(), m_instances.size() * sizeof(GpuInstanceData));
+    }
+}
+
+void ven::CullingRenderSystem::render(const FrameInfo &frameInfo) const
+{
+    dispatch(frameInfo, 0, m_earlyOcclusion ? m_hizRenderSystem.getMipLevels() : 0);
+}
+
+void ven::CullingRenderSystem::renderLate(const FrameInfo &frameInfo) const
+{
+    dispatch(frameInfo, 1, m_lateOcclusion ? m_hizRenderSystem.getMipLevels() : 0);
+}
+
+void ven::CullingRenderSystem::dispatch(const FrameInfo &frameInfo, const uint32_t phase, const uint32_t hizLevels) const
+{
+    const Buffer& countBuffer = getCountBuffer(frameInfo.frameIndex);
+    const CullingPushConstantData push{ .instanceCount = getInstanceCount(), .phase = phase, .hizLevels = hizLevels };
+    VkDescriptorSet cullingDescriptorSet = nullptr;
+    auto instanceInfo = getInstanceBuffer(frameInfo.frameIndex).descriptorInfo();
+    auto commandInfo = getCommandBuffer(frameInfo.frameIndex).descriptorInfo();
+    auto countInfo = countBuffer.descriptorInfo();
+    auto retestInfo = m_retestBuffers.at(frameInfo.frameIndex)->descriptorInfo();
+    const VkDescriptorImageInfo hizInfo = m_hizRenderSystem.getImageInfo();
+
+    // the draw lists may still be consumed by the indirect draws of the previous phase
+    vkCmdPipelineBarrier(frameInfo.commandBuffer, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 0, nullptr);
+    vkCmdFillBuffer(frameInfo.commandBuffer, countBuffer.getBuffer(), 0, VK_WHOLE_SIZE, 0);
+
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    vkCmdPipelineBarrier(frameInfo.commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+    if (push.instanceCount > 0) {
+        DescriptorWriter(*renderSystemLayout, frameInfo.frameDescriptorPool)
+            .writeBuffer(0, &instanceInfo)
+            .writeBuffer(1, &commandInfo)
+            .writeBuffer(2, &countInfo)
+            .writeImage(3, &hizInfo)
+            .writeBuffer(4, &retestInfo)
+            .build(cullingDescriptorSet);
+
+        getShaders()->bind(frameInfo.commandBuffer);
+        const std::array descriptorSets{frameInfo.globalDescriptorSet, cullingDescriptorSet};
+        vkCmdBindDescriptorSets(frameInfo.commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, getPipelineLayout(), 0, static_cast<uint32_t>(descriptorSets.size()), descriptorSets.data(), 0, nullptr);
+        pushConstants(frameInfo.commandBuffer, push);
+        vkCmdDispatch(frameInfo.commandBuffer, (push.instanceCount + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, 1, 1);
+    }
+
+    VkMemoryBarrier memoryBarrier{};
+    memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    memoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    memoryBarrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+    vkCmdPipelineBarrier(frameInfo.commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, 0, 1, &memoryBarrier, 0, nullptr, 0, nullptr);
+}
@@ -0,0 +1,32 @@
+#include "VEngine/Core/RenderSystem/DeferredLighting.hpp"
+#include "VEngine/Gfx/Descriptors/Writer.hpp"
+
+ven::DeferredLightingRenderSystem::DeferredLightingRenderSystem(const Device& device, const VkRenderPass deferredRenderPass, const VkDescriptorSetLayout globalSetLayout) : ARenderSystemBase(device)
+{
+    // set 1 holds the G-buffer in GBUFFER_ATTACHMENT order, then the depth
+    const std::string vertPath = std::string(SHADERS_BIN_PATH) + "vertex_fullscreen.spv";
+    const std::string fragPath = std::string(SHADERS_BIN_PATH) + "fragment_deferred_lighting.spv";
+    createPipelineLayout(globalSetLayout, { vertPath, fragPath });
+    createPipeline(deferredRenderPass, vertPath, fragPath, true, 1, SHADER_LIGHTING_CONSTANTS);
+}
+
+void ven::DeferredLightingRenderSystem::render(const FrameInfo &frameInfo) const
+{
+    std::array<VkDescriptorImageInfo, GBUFFER_ATTACHMENT_COUNT + 1> imageInfos{};
+    for (uint32_t i = 0; i < GBUFFER_ATTACHMENT_COUNT; i++) {
+        imageInfos.at(i) = {.sampler = VK_NULL_HANDLE, .imageView = m_gBufferImageViews.at(i), .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+    }
+    imageInfos.back() = {.sampler = VK_NULL_HANDLE, .imageView = m_depthImageView, .imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL};
+    VkDescriptorSet inputDescriptorSet = nullptr;
+    DescriptorWriter writer(*renderSystemLayout, frameInfo.frameDescriptorPool);
+    for (uint32_t i = 0; i < imageInfos.size(); i++) {
+        writer.writeImage(i, &imageInfos.at(i));
+    }
+    writer.build(inputDescriptorSet);
+
+    getShaders()->bind(frameInfo.commandBuffer, frameInfo.shaderVariant);
+    const std::array descriptorSets{frameInfo.globalDescriptorSet, inputDescriptorSet};
+    vkCmdBindDescriptorSets(frameInfo.commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, getPipelineLayout(), 0, static_cast<uint32_t>(descriptorSets.size()), descriptorSets.data(), 0, nullptr);
+    // one triangle covering the screen, see vertex_fullscreen.vert
+    vkCmdDraw(frameInfo.commandBuffer, 3, 1, 0, 0);
+}
@@ -0,0 +1,179 @@
+#include <algorithm>
+
+#include "VEngine/Core/RenderSystem/HiZ.hpp"
+#include "VEngine/Gfx/Descriptors/Writer.hpp"
+
+ven::HiZRenderSystem::HiZRenderSystem(const Device& device, const VkDescriptorSetLayout globalSetLayout) : ARenderSystemBase(device)
+{
+    const std::string compPath = std::string(SHADERS_BIN_PATH) + "hiz.spv";
+    createPipelineLayout(globalSetLayout, { compPath });
+    createComputePipeline(compPath);
+
+    VkSamplerCreateInfo samplerInfo{};
+    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.magFilter = VK_FILTER_NEAREST;
+    samplerInfo.minFilter = VK_FILTER_NEAREST;
+    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.maxAnisotropy = 1.0F;
+    samplerInfo.minLod = 0.0F;
+    samplerInfo.maxLod = VK_LOD_CLAMP_NONE;
+    if (vkCreateSampler(device.device(), &samplerInfo, nullptr, &m_sampler) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create HiZ sampler!");
+    }
+}
+
+ven::HiZRenderSystem::~HiZRenderSystem()
+{
+    destroyPyramid();
+    vkDestroySampler(getDevice().device(), m_sampler, nullptr);
+}
+
+void ven::HiZRenderSystem::createPyramid(const VkExtent2D extent)
+{
+    // level 0 is half the depth resolution, each level halves (rounding up) down to 1x1
+    m_extent = extent;
+    m_levelExtents.clear();
+    VkExtent2D levelExtent{ .width = std::max(1U, (extent.width + 1) / 2), .height = std::max(1U, (extent.height + 1) / 2) };
+    while (true) {
+        m_levelExtents.push_back(levelExtent);
+        if (levelExtent.width == 1 && levelExtent.height == 1) { break; }
+        levelExtent = { .width = std::max(1U, (levelExtent.width + 1) / 2), .height = std::max(1U, (levelExtent.height + 1) / 2) };
+    }
+
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.format = VK_FORMAT_R32_SFLOAT;
+    imageInfo.extent = { .width = m_levelExtents[0].width, .height = m_levelExtents[0].height, .depth = 1 };
+    imageInfo.mipLevels = static_cast<uint32_t>(m_levelExtents.size());
+    imageInfo.arrayLayers = 1;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    getDevice().createImageWithInfo(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_image, m_imageMemory);
+
+    VkImageViewCreateInfo viewInfo{};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = m_image;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = VK_FORMAT_R32_SFLOAT;
+    viewInfo.subresourceRange = { .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT, .baseMipLevel = 0, .levelCount = imageInfo.mipLevels, .baseArrayLayer = 0, .layerCount = 1 };
+    if (vkCreateImageView(getDevice().device(), &viewInfo, nullptr, &m_view) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create HiZ image view!");
+    }
+    m_levelViews.resize(m_levelExtents.size());
+    for (uint32_t i = 0; i < m_levelViews.size(); i++) {
+        viewInfo.subresourceRange.baseMipLevel = i;
+        viewInfo.subresourceRange.levelCount = 1;
+        if (vkCreateImageView(getDevice().device(), &viewInfo, nullptr, &m_levelViews[i]) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create HiZ image view!");
+        }
+    }
+}
+
+void ven::HiZRenderSystem::destroyPyramid()
+{
+    for (const VkImageView view : m_levelViews) {
+        vkDestroyImageView(getDevice().device(), view, nullptr);
+    }
+    m_levelViews.clear();
+    vkDestroyImageView(getDevice().device(), m_view, nullptr);
+    vkDestroyImage(getDevice().device(), m_image, nullptr);
+    vkFreeMemory(getDevice().device(), m_imageMemory, nullptr);
+    m_view = nullptr;
+    m_image = nullptr;
+    m_imageMemory = nullptr;
+}
+
+bool ven::HiZRenderSystem::prepare(const FrameInfo &frameInfo, const VkExtent2D extent, const VkImage depthImage, const VkImageView depthImageView, const VkFormat depthFormat)
+{
+    m_depthImage = depthImage;
+    m_depthImageView = depthImageView;
+    // a layout transition of a combined depth stencil image must cover both aspects, the view only samples the depth
+    m_depthAspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+    if (depthFormat == VK_FORMAT_D32_SFLOAT_S8_UINT || depthFormat == VK_FORMAT_D24_UNORM_S8_UINT) {
+        m_depthAspectMask |= VK_IMAGE_ASPECT_STENCIL_BIT;
+    }
+    if (m_image != nullptr && extent.width == m_extent.width && extent.height == m_extent.height) {
+        return false;
+    }
+
+    // the previous pyramid may still be read by a frame in flight
+    vkDeviceWaitIdle(getDevice().device());
+    destroyPyramid();
+    createPyramid(extent);
+
+    // the pyramid stays in GENERAL: written as storage image, sampled by the next level and the culling pass
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = m_image;
+    barrier.subresourceRange = { .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT, .baseMipLevel = 0, .levelCount = getMipLevels(), .baseArrayLayer = 0, .layerCount = 1 };
+    vkCmdPipelineBarrier(frameInfo.commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+    return true;
+}
+
+void ven::HiZRenderSystem::render(const FrameInfo &frameInfo) const
+{
+    VkImageMemoryBarrier depthBarrier{};
+    depthBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    depthBarrier.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    depthBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    depthBarrier.oldLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    depthBarrier.newLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+    depthBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    depthBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    depthBarrier.image = m_depthImage;
+    depthBarrier.subresourceRange = { .aspectMask = m_depthAspectMask, .baseMipLevel = 0, .levelCount = 1, .baseArrayLayer = 0, .layerCount = 1 };
+    // the compute stage also orders the writes of this frame after the reads of the previous culling passes
+    vkCmdPipelineBarrier(frameInfo.commandBuffer, VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &depthBarrier);
+
+    getShaders()->bind(frameInfo.commandBuffer);
+    vkCmdBindDescriptorSets(frameInfo.commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, getPipelineLayout(), 0, 1, &frameInfo.globalDescriptorSet, 0, nullptr);
+
+    VkImageMemoryBarrier levelBarrier{};
+    levelBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    levelBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    levelBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    levelBarrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+    levelBarrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+    levelBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    levelBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    levelBarrier.image = m_image;
+
+    VkExtent2D inputExtent = m_extent;
+    for (uint32_t level = 0; level < getMipLevels(); level++) {
+        const VkExtent2D outputExtent = m_levelExtents[level];
+        VkDescriptorSet levelDescriptorSet = nullptr;
+        const VkDescriptorImageInfo inputInfo = level == 0
+            ? VkDescriptorImageInfo{ .sampler = m_sampler, .imageView = m_depthImageView, .imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL }
+            : VkDescriptorImageInfo{ .sampler = m_sampler, .imageView = m_levelViews[level - 1], .imageLayout = VK_IMAGE_LAYOUT_GENERAL };
+        const VkDescriptorImageInfo outputInfo{ .sampler = nullptr, .imageView = m_levelViews[level], .imageLayout = VK_IMAGE_LAYOUT_GENERAL };
+        DescriptorWriter(*renderSystemLayout, frameInfo.frameDescriptorPool)
+            .writeImage(0, &inputInfo)
+            .writeImage(1, &outputInfo)
+            .build(levelDescriptorSet);
+
+        const HiZPushConstantData push{
+            .inputSize = { static_cast<int>(inputExtent.width), static_cast<int>(inputExtent.height) },
+            .outputSize = { static_cast<int>(outputExtent.width), static_cast<int>(outputExtent.height) }
+        };
+        vkCmdBindDescriptorSets(frameInfo.commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, getPipelineLayout(), 1, 1, &levelDescriptorSet, 0, nullptr);
+        pushConstants(frameInfo.commandBuffer, push);
+        vkCmdDispatch(frameInfo.commandBuffer, (outputExtent.width + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, (outputExtent.height + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, 1);
+
+        levelBarrier.subresourceRange = { .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT, .baseMipLevel = level, .levelCount = 1, .baseArrayLayer = 0, .layerCount = 1 };
+        vkCmdPipelineBarrier(frameInfo.commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &levelBarrier);
+        inputExtent = outputExtent;
+    }
+}
@@ -0,0 +1,43 @@
+#include "VEngine/Core/RenderSystem/Indirect.hpp"
+#include "VEngine/Gfx/Descriptors/Writer.hpp"
+
+void ven::IndirectRenderSystem::render(const FrameInfo &frameInfo) const
+{
+    const std::vector<DrawBucket>& buckets = m_cullingRenderSystem.getBuckets();
+    const VkBuffer commandBuffer = m_cullingRenderSystem.getCommandBuffer(frameInfo.frameIndex).getBuffer();
+    const VkBuffer countBuffer = m_cullingRenderSystem.getCountBuffer(frameInfo.frameIndex).getBuffer();
+    auto instanceInfo = m_cullingRenderSystem.getInstanceBuffer(frameInfo.frameIndex).descriptorInfo();
+
+    std::vector<VkDescriptorSet> bucketDescriptorSets(buckets.size(), nullptr);
+    for (uint32_t i = 0; i < buckets.size(); i++) {
+        auto imageInfo = buckets[i].texture->getImageInfo();
+        DescriptorWriter(*renderSystemLayout, frameInfo.frameDescriptorPool)
+            .writeBuffer(0, &instanceInfo)
+            .writeImage(1, &imageInfo)
+            .build(bucketDescriptorSets[i]);
+    }
+
+    // the buckets of each pipeline in the culling order, which puts the blended ones back to front
+    for (const GeometryPipeline& pipeline : getGeometryPipelines()) {
+        pipeline.shaders->bind(frameInfo.commandBuffer, frameInfo.shaderVariant);
+        vkCmdBindDescriptorSets(frameInfo.commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, getPipelineLayout(), 0, 1, &frameInfo.globalDescriptorSet, 0, nullptr);
+        for (uint32_t i = 0; i < buckets.size(); i++) {
+            const DrawBucket& bucket = buckets[i];
+            if ((pipeline.alphaModes & (1U << bucket.alphaMode)) == 0) { continue; }
+            vkCmdBindDescriptorSets(frameInfo.commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, getPipelineLayout(), 1, 1, &bucketDescriptorSets[i], 0, nullptr);
+            if (pipeline.depthStream) {
+                bucket.model->bindDepth(frameInfo.commandBuffer);
+            } else {
+                bucket.model->bind(frameInfo.commandBuffer);
+            }
+            vkCmdDrawIndexedIndirectCount(
+                frameInfo.commandBuffer,
+                commandBuffer,
+                bucket.drawOffset * sizeof(VkDrawIndexedIndirectCommand),
+                countBuffer,
+                i * sizeof(uint32_t),
+                bucket.capacity,
+                sizeof(VkDrawIndexedIndirectCommand));
+        }
+    }
+}
@@ -0,0 +1,60 @@
+#include "VEngine/Core/RenderSystem/LightCluster.hpp"
+#include "VEngine/Gfx/Descriptors/Writer.hpp"
+
+ven::LightClusterRenderSystem::LightClusterRenderSystem(const Device& device, const VkDescriptorSetLayout globalSetLayout) : ARenderSystemBase(device)
+{
+    const std::string compPath = std::string(SHADERS_BIN_PATH) + "light_cluster.spv";
+    createPipelineLayout(globalSetLayout, { compPath });
+    createComputePipeline(compPath);
+    constexpr uint32_t zero = 0;
+    for (unsigned long i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+        m_rangeBuffers.at(i) = std::make_unique<Buffer>(device, sizeof(glm::uvec2), CLUSTER_COUNT, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        // read back by prepare once the frame fence is signaled
+        m_counterBuffers.at(i) = std::make_unique<Buffer>(device, sizeof(uint32_t), 1, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+        m_counterBuffers.at(i)->map();
+        m_counterBuffers.at(i)->writeToBuffer(&zero, sizeof(zero));
+        reserve(i, CLUSTER_COUNT * DEFAULT_LIGHTS_PER_CLUSTER);
+    }
+}
+
+void ven::LightClusterRenderSystem::reserve(const unsigned long frameIndex, const uint32_t indexCount)
+{
+    Buffer::reserve(m_indexBuffers.at(frameIndex), getDevice(), sizeof(uint32_t), indexCount, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+}
+
+void ven::LightClusterRenderSystem::prepare(const FrameInfo &frameInfo)
+{
+    // the counter holds what the lists needed, even the part that did not fit
+    reserve(frameInfo.frameIndex, getIndexCount(frameInfo.frameIndex));
+}
+
+void ven::LightClusterRenderSystem::render(const FrameInfo &frameInfo) const
+{
+    const Buffer& counterBuffer = *m_counterBuffers.at(frameInfo.frameIndex);
+    const LightClusterPushConstantData push{ .indexCapacity = getIndexBuffer(frameInfo.frameIndex).getInstanceCount() };
+    VkDescriptorSet clusterDescriptorSet = nullptr;
+    auto counterInfo = counterBuffer.descriptorInfo();
+    DescriptorWriter(*renderSystemLayout, frameInfo.frameDescriptorPool)
+        .writeBuffer(0, &counterInfo)
+        .build(clusterDescriptorSet);
+
+    vkCmdFillBuffer(frameInfo.commandBuffer, counterBuffer.getBuffer(), 0, VK_WHOLE_SIZE, 0);
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    vkCmdPipelineBarrier(frameInfo.commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+    getShaders()->bind(frameInfo.commandBuffer);
+    const std::array descriptorSets{frameInfo.globalDescriptorSet, clusterDescriptorSet};
+    vkCmdBindDescriptorSets(frameInfo.commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, getPipelineLayout(), 0, static_cast<uint32_t>(descriptorSets.size()), descriptorSets.data(), 0, nullptr);
+    pushConstants(frameInfo.commandBuffer, push);
+    vkCmdDispatch(frameInfo.commandBuffer, (CLUSTER_COUNT + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, 1, 1);
+
+    // the lists are read by the fragment shaders of the draws, the counter by prepare on the host
+    VkMemoryBarrier memoryBarrier{};
+    memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    memoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    memoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_HOST_READ_BIT;
+    vkCmdPipelineBarrier(frameInfo.commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &memoryBarrier, 0, nullptr, 0, nullptr);
+}
@@ -0,0 +1,83 @@
+#include "VEngine/Core/RenderSystem/Meshlet.hpp"
+#include "VEngine/Core/RenderSystem/Object.hpp"
+#include "VEngine/Gfx/Descriptors/Writer.hpp"
+
+ven::MeshletRenderSystem::MeshletRenderSystem(const Device& device, const VkRenderPass renderPass, const VkDescriptorSetLayout globalSetLayout, const MeshletCullingRenderSystem& meshletCullingRenderSystem) : ARenderSystemBase(device), m_meshletCullingRenderSystem{meshletCullingRenderSystem}
+{
+    const std::string fragPath = std::string(SHADERS_BIN_PATH) + "fragment_shader.spv";
+    if (device.hasMeshShader()) {
+        const std::string taskPath = std::string(SHADERS_BIN_PATH) + "meshlet_task.spv";
+        const std::string meshPath = std::string(SHADERS_BIN_PATH) + "meshlet_mesh.spv";
+        createPipelineLayout(globalSetLayout, { taskPath, meshPath, fragPath });
+        createMeshPipeline(renderPass, taskPath, meshPath, fragPath, SHADER_LIGHTING_CONSTANTS);
+    } else {
+        const std::string vertPath = std::string(SHADERS_BIN_PATH) + "vertex_indirect.spv";
+        createPipelineLayout(globalSetLayout, { vertPath, fragPath });
+        createPipeline(renderPass, vertPath, fragPath, false, 0, SHADER_LIGHTING_CONSTANTS);
+    }
+}
+
+void ven::MeshletRenderSystem::render(const FrameInfo &frameInfo) const
+{
+    if (m_meshletCullingRenderSystem.getBuckets().empty()) {
+        return;
+    }
+    getShaders()->bind(frameInfo.commandBuffer, frameInfo.shaderVariant);
+    vkCmdBindDescriptorSets(frameInfo.commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, getPipelineLayout(), 0, 1, &frameInfo.globalDescriptorSet, 0, nullptr);
+    if (getDevice().hasMeshShader()) {
+        renderMeshShader(frameInfo);
+    } else {
+        renderCompacted(frameInfo);
+    }
+}
+
+void ven::MeshletRenderSystem::renderMeshShader(const FrameInfo &frameInfo) const
+{
+    auto instanceInfo = m_meshletCullingRenderSystem.getInstanceBuffer(frameInfo.frameIndex).descriptorInfo();
+    auto workInfo = m_meshletCullingRenderSystem.getWorkBuffer(frameInfo.frameIndex).descriptorInfo();
+
+    for (const MeshletBucket& bucket : m_meshletCullingRenderSystem.getBuckets()) {
+        VkDescriptorSet bucketDescriptorSet = nullptr;
+        auto imageInfo = bucket.texture->getImageInfo();
+        auto meshletInfo = bucket.model->getMeshletBuffer()->descriptorInfo();
+        auto meshletVertexInfo = bucket.model->getMeshletVertexBuffer()->descriptorInfo();
+        auto meshletTriangleInfo = bucket.model->getMeshletTriangleBuffer()->descriptorInfo();
+        auto vertexInfo = bucket.model->getVertexBuffer().descriptorInfo();
+        DescriptorWriter(*renderSystemLayout, frameInfo.frameDescriptorPool)
+            .writeBuffer(0, &instanceInfo)
+            .writeImage(1, &imageInfo)
+            .writeBuffer(2, &workInfo)
+            .writeBuffer(3, &meshletInfo)
+            .writeBuffer(4, &meshletVertexInfo)
+            .writeBuffer(5, &meshletTriangleInfo)
+            .writeBuffer(6, &vertexInfo)
+            .build(bucketDescriptorSet);
+
+        const MeshletPushConstantData push{ .workOffset = bucket.workOffset, .workCount = bucket.workCount };
+        vkCmdBindDescriptorSets(frameInfo.commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, getPipelineLayout(), 1, 1, &bucketDescriptorSet, 0, nullptr);
+        pushConstants(frameInfo.commandBuffer, push);
+        getDevice().drawMeshTasks(frameInfo.commandBuffer, (push.workCount + MESHLET_TASK_GROUP_SIZE - 1) / MESHLET_TASK_GROUP_SIZE);
+    }
+}
+
+void ven::MeshletRenderSystem::renderCompacted(const FrameInfo &frameInfo) const
+{
+    const VkBuffer commandBuffer = m_meshletCullingRenderSystem.getCommandBuffer(frameInfo.frameIndex).getBuffer();
+    const VkBuffer indexBuffer = m_meshletCullingRenderSystem.getIndexBuffer(frameInfo.frameIndex).getBuffer();
+    auto instanceInfo = m_meshletCullingRenderSystem.getInstanceBuffer(frameInfo.frameIndex).descriptorInfo();
+
+    for (const MeshletBucket& bucket : m_meshletCullingRenderSystem.getBuckets()) {
+        VkDescriptorSet bucketDescriptorSet = nullptr;
+        auto imageInfo = bucket.texture->getImageInfo();
+        DescriptorWriter(*renderSystemLayout, frameInfo.frameDescriptorPool)
+            .writeBuffer(0, &instanceInfo)
+            .writeImage(1, &imageInfo)
+            .build(bucketDescriptorSet);
+
+        vkCmdBindDescriptorSets(frameInfo.commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, getPipelineLayout(), 1, 1, &bucketDescriptorSet, 0, nullptr);
+        // vertices of the model, triangles of the visible meshlets
+        bucket.model->bind(frameInfo.commandBuffer);
+        vkCmdBindIndexBuffer(frameInfo.commandBuffer, indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+        vkCmdDrawIndexedIndirect(frameInfo.commandBuffer, commandBuffer, bucket.drawOffset * sizeof(VkDrawIndexedIndirectCommand), bucket.drawCount, sizeof(VkDrawIndexedIndirectCommand));
+    }
+}
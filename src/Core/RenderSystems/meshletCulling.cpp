@@ -0,0 +1,158 @@
+#include <algorithm>
+#include <map>
+
+#include "VEngine/Core/RenderSystem/MeshletCulling.hpp"
+#include "VEngine/Gfx/Descriptors/Writer.hpp"
+
+ven::MeshletCullingRenderSystem::MeshletCullingRenderSystem(const Device& device, const VkDescriptorSetLayout globalSetLayout, std::shared_ptr<Texture> defaultTexture) : ARenderSystemBase(device), m_defaultTexture{std::move(defaultTexture)}
+{
+    const std::string compPath = std::string(SHADERS_BIN_PATH) + "meshlet_cull.spv";
+    createPipelineLayout(globalSetLayout, { compPath });
+    createComputePipeline(compPath);
+    for (unsigned long i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+        reserve(i, 1, 1, 3);
+    }
+}
+
+void ven::MeshletCullingRenderSystem::reserve(const unsigned long frameIndex, const uint32_t drawCount, const uint32_t workCount, const uint32_t indexCount)
+{
+    Buffer::reserve(m_instanceBuffers.at(frameIndex), getDevice(), sizeof(GpuInstanceData), drawCount, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    Buffer::reserve(m_commandBuffers.at(frameIndex), getDevice(), sizeof(VkDrawIndexedIndirectCommand), drawCount, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    Buffer::reserve(m_workBuffers.at(frameIndex), getDevice(), sizeof(MeshletWork), workCount, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    Buffer::reserve(m_indexBuffers.at(frameIndex), getDevice(), sizeof(uint32_t), indexCount, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+}
+
+void ven::MeshletCullingRenderSystem::prepare(const FrameInfo &frameInfo)
+{
+    struct PendingDraw {
+        uint32_t bucket;
+        GpuInstanceData instance;
+        uint32_t firstMeshlet;
+        uint32_t meshletCount;
+    };
+    std::vector<PendingDraw> draws;
+    std::map<std::pair<const Model*, const Texture*>, uint32_t> bucketIndices;
+    const auto addDraw = [&](const std::shared_ptr<Model>& model, const std::shared_ptr<Texture>& texture, const PendingDraw& draw) {
+        const auto [it, inserted] = bucketIndices.try_emplace({model.get(), texture.get()}, static_cast<uint32_t>(m_buckets.size()));
+        if (inserted) {
+            m_buckets.push_back({ .model = model, .texture = texture });
+        }
+        draws.push_back(draw);
+        draws.back().bucket = it->second;
+        m_buckets[it->second].drawCount++;
+        m_buckets[it->second].workCount += draw.meshletCount;
+    };
+
+    m_buckets.clear();
+    std::vector<uint8_t> pvsVisible;
+    const std::span<const WorldMatrices> worlds = frameInfo.objects.worlds();
+    const std::span<const std::shared_ptr<Model>> models = frameInfo.objects.models();
+    const std::span<const std::shared_ptr<Texture>> diffuseMaps = frameInfo.objects.diffuseMaps();
+    for (uint32_t i = 0; i < frameInfo.objects.size(); i++) {
+        const std::shared_ptr<Model>& model = models[i];
+        if (model == nullptr || model->getMeshletCount() == 0) { continue; }
+        const GpuInstanceData instance{
+            .modelMatrix = worlds[i].model,
+            .normalMatrix = worlds[i].normal
+        };
+        if (diffuseMaps[i] == nullptr && !model->getTextures().empty()) {
+            const Pvs& pvs = model->getPvs();
+            const uint32_t cell = frameInfo.culler.isPvsEnabled() && pvs.isValid() ? pvs.findCell(glm::vec3(glm::inverse(instance.modelMatrix) * glm::vec4(frameInfo.culler.getCameraPosition(), 1.F))) : Pvs::OUTSIDE;
+            pvsVisible.assign(model->getMeshes().size(), 1);
+            if (cell != Pvs::OUTSIDE) {
+                pvs.decodeCell(cell, pvsVisible);
+            }
+            for (std::size_t meshIndex = 0; meshIndex < model->getMeshes().size(); meshIndex++) {
+                const Mesh& mesh = model->getMeshes()[meshIndex];
+                if (mesh.material.diffuseTextures.empty() || pvsVisible[meshIndex] == 0 || mesh.meshletCount == 0) { continue; }
+                PendingDraw draw{ .bucket = 0, .instance = instance, .firstMeshlet = mesh.firstMeshlet, .meshletCount = mesh.meshletCount };
+                draw.instance.sphere = glm::vec4(mesh.sphere.center, mesh.sphere.radius);
+                draw.instance.indexCount = mesh.indexCount;
+                addDraw(model, mesh.material.diffuseTextures[0], draw);
+            }
+        } else {
+            PendingDraw draw{ .bucket = 0, .instance = instance, .firstMeshlet = 0, .meshletCount = model->getMeshletCount() };
+            draw.instance.sphere = glm::vec4(model->getSphere().center, model->getSphere().radius);
+            draw.instance.indexCount = model->getIndexCount();
+            addDraw(model, diffuseMaps[i] != nullptr ? diffuseMaps[i] : m_defaultTexture, draw);
+        }
+    }
+
+    // draws and meshlets of a bucket are contiguous, each draw owns the worst case range of the compacted index buffer
+    uint32_t drawOffset = 0;
+    uint32_t workOffset = 0;
+    for (MeshletBucket& bucket : m_buckets) {
+        bucket.drawOffset = drawOffset;
+        bucket.workOffset = workOffset;
+        drawOffset += bucket.drawCount;
+        workOffset += bucket.workCount;
+    }
+    m_instances.resize(draws.size());
+    m_commands.resize(draws.size());
+    m_work.resize(workOffset);
+    std::vector<uint32_t> drawFill(m_buckets.size(), 0);
+    std::vector<uint32_t> workFill(m_buckets.size(), 0);
+    uint32_t indexOffset = 0;
+    for (const PendingDraw& draw : draws) {
+        const MeshletBucket& bucket = m_buckets[draw.bucket];
+        const uint32_t drawIndex = bucket.drawOffset + drawFill[draw.bucket]++;
+        GpuInstanceData& instance = m_instances[drawIndex];
+        instance = draw.instance;
+        instance.firstIndex = indexOffset;
+        instance.drawOffset = bucket.drawOffset;
+        instance.bucket = draw.bucket;
+        m_commands[drawIndex] = { .indexCount = 0, .instanceCount = 1, .firstIndex = indexOffset, .vertexOffset = 0, .firstInstance = drawIndex };
+        indexOffset += instance.indexCount;
+        for (uint32_t meshlet = 0; meshlet < draw.meshletCount; meshlet++) {
+            m_work[bucket.workOffset + workFill[draw.bucket]++] = { .draw = drawIndex, .meshlet = draw.firstMeshlet + meshlet };
+        }
+    }
+
+    reserve(frameInfo.frameIndex, static_cast<uint32_t>(m_instances.size()), getWorkCount(), indexOffset);
+    if (!m_instances.empty()) {
+        m_instanceBuffers.at(frameInfo.frameIndex)->writeToBuffer(m_instances.data(), m_instances.size() * sizeof(GpuInstanceData));
+        m_commandBuffers.at(frameInfo.frameIndex)->writeToBuffer(m_commands.data(), m_commands.size() * sizeof(VkDrawIndexedIndirectCommand));
+        m_workBuffers.at(frameInfo.frameIndex)->writeToBuffer(m_work.data(), m_work.size() * sizeof(MeshletWork));
+    }
+}
+
+void ven::MeshletCullingRenderSystem::render(const FrameInfo &frameInfo) const
+{
+    // the task shader culls the meshlets itself
+    if (getDevice().hasMeshShader() || m_buckets.empty()) {
+        return;
+    }
+    auto instanceInfo = getInstanceBuffer(frameInfo.frameIndex).descriptorInfo();
+    auto commandInfo = getCommandBuffer(frameInfo.frameIndex).descriptorInfo();
+    auto workInfo = getWorkBuffer(frameInfo.frameIndex).descriptorInfo();
+    auto indexInfo = getIndexBuffer(frameInfo.frameIndex).descriptorInfo();
+
+    getShaders()->bind(frameInfo.commandBuffer);
+    vkCmdBindDescriptorSets(frameInfo.commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, getPipelineLayout(), 0, 1, &frameInfo.globalDescriptorSet, 0, nullptr);
+    for (const MeshletBucket& bucket : m_buckets) {
+        VkDescriptorSet bucketDescriptorSet = nullptr;
+        auto meshletInfo = bucket.model->getMeshletBuffer()->descriptorInfo();
+        auto meshletVertexInfo = bucket.model->getMeshletVertexBuffer()->descriptorInfo();
+        auto meshletTriangleInfo = bucket.model->getMeshletTriangleBuffer()->descriptorInfo();
+        DescriptorWriter(*renderSystemLayout, frameInfo.frameDescriptorPool)
+            .writeBuffer(0, &instanceInfo)
+            .writeBuffer(1, &commandInfo)
+            .writeBuffer(2, &workInfo)
+            .writeBuffer(3, &meshletInfo)
+            .writeBuffer(4, &meshletVertexInfo)
+            .writeBuffer(5, &meshletTriangleInfo)
+            .writeBuffer(6, &indexInfo)
+            .build(bucketDescriptorSet);
+
+        const MeshletPushConstantData push{ .workOffset = bucket.workOffset, .workCount = bucket.workCount };
+        vkCmdBindDescriptorSets(frameInfo.commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, getPipelineLayout(), 1, 1, &bucketDescriptorSet, 0, nullptr);
+        pushConstants(frameInfo.commandBuffer, push);
+        vkCmdDispatch(frameInfo.commandBuffer, (push.workCount + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, 1, 1);
+    }
+
+    VkMemoryBarrier memoryBarrier{};
+    memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    memoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    memoryBarrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_INDEX_READ_BIT;
+    vkCmdPipelineBarrier(frameInfo.commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, 0, 1, &memoryBarrier, 0, nullptr, 0, nullptr);
+}
@@ -1,73 +1,172 @@
-#include <ranges>
+#include <algorithm>
 
 #include "VEngine/Core/RenderSystem/Object.hpp"
 #include "VEngine/Gfx/Descriptors/Writer.hpp"
 
-void ven::ObjectRenderSystem::render(const FrameInfo &frameInfo) const
-{
-    getShaders()->bind(frameInfo.commandBuffer);
+namespace {
 
-    vkCmdBindDescriptorSets(frameInfo.commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, getPipelineLayout(), 0, 1, &frameInfo.globalDescriptorSet, 0, nullptr);
-    for (Object& object : frameInfo.objects | std::views::values) {
-        if (object.getModel() == nullptr) { continue; }
-        auto bufferInfo = object.getBufferInfo(static_cast<int>(frameInfo.frameIndex));
-        VkDescriptorSet objectDescriptorSet = nullptr;
-        if (object.getDiffuseMap() != nullptr) {
-            auto imageInfo = object.getDiffuseMap()->getImageInfo();
-            DescriptorWriter(*renderSystemLayout, frameInfo.frameDescriptorPool)
-                .writeBuffer(0, &bufferInfo)
-                .writeImage(1, &imageInfo)
-                .build(objectDescriptorSet);
-        } else if (!object.getModel()->getTextures().empty()) {
-            for (const auto& mesh : object.getModel()->getMeshes()) {
-                if (!mesh.material.diffuseTextures.empty()) {
-                    auto imageInfo = mesh.material.diffuseTextures[0]->getImageInfo();
-                    DescriptorWriter(*renderSystemLayout, frameInfo.frameDescriptorPool)
-                        .writeBuffer(0, &bufferInfo)
-                        .writeImage(1, &imageInfo)
-                        .build(objectDescriptorSet);
+    // a visible object, or one of its meshes, and the set written for it
+    struct ObjectDraw {
+        uint32_t object{0};
+        const ven::Mesh* mesh{nullptr}; // the whole model when null
+        uint8_t lod{0};
+        ven::ALPHA_MODE alphaMode{ven::ALPHA_OPAQUE};
+        float distance{0.F}; // to the camera, orders the blended draws
+        VkDescriptorSet descriptorSet{nullptr};
+    };
 
-                    vkCmdBindDescriptorSets(
-                        frameInfo.commandBuffer,
-                        VK_PIPELINE_BIND_POINT_GRAPHICS,
-                        getPipelineLayout(),
-                        1,  // starting set (0 is the globalDescriptorSet, 1 is the set specific to this system)
-                        1,  // set count
-                        &objectDescriptorSet,
-                        0,
-                        nullptr);
-                    const ObjectPushConstantData push{
-                        .modelMatrix = object.transform.transformMatrix(),
-                        .normalMatrix = object.transform.normalMatrix()
-                    };
-                    vkCmdPushConstants(frameInfo.commandBuffer, getPipelineLayout(), VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(ObjectPushConstantData), &push);
-                    object.getModel()->bindMesh(frameInfo.commandBuffer, mesh);
-                    object.getModel()->drawMesh(frameInfo.commandBuffer, mesh);
+} // namespace
+
+void ven::ObjectRenderSystem::prepare(const FrameInfo &frameInfo)
+{
+    FrustumCuller& culler = frameInfo.culler;
+    OcclusionCuller& occlusionCuller = frameInfo.occlusionCuller;
+    const ObjectStore& objects = frameInfo.objects;
+    const std::span<const WorldMatrices> worlds = objects.worlds();
+    const std::span<const std::shared_ptr<Model>> models = objects.models();
+    const std::span<const std::shared_ptr<Texture>> diffuseMaps = objects.diffuseMaps();
+    const std::span<const uint8_t> occluders = objects.occluders();
+    std::vector<uint8_t> pvsVisible;
+
+    // queue bounds in the same order as the draw loop below, the running index maps back to the culling result
+    // occluders are not tested against the depth they wrote themselves
+    for (uint32_t i = 0; i < objects.size(); i++) {
+        const Model* model = models[i].get();
+        if (model == nullptr) { continue; }
+        const glm::mat4& modelMatrix = worlds[i].model;
+        if (occluders[i] != 0) {
+            occlusionCuller.addOccluder(model->getOccluderTriangles(), modelMatrix);
+        }
+        if (diffuseMaps[i] == nullptr && !model->getTextures().empty()) {
+            // the baked sets are in model space, an eye outside of the grid sees everything
+            const Pvs& pvs = model->getPvs();
+            const uint32_t cell = culler.isPvsEnabled() && pvs.isValid() ? pvs.findCell(glm::vec3(glm::inverse(modelMatrix) * glm::vec4(culler.getCameraPosition(), 1.F))) : Pvs::OUTSIDE;
+            pvsVisible.assign(model->getMeshes().size(), 1);
+            if (cell != Pvs::OUTSIDE) {
+                pvs.decodeCell(cell, pvsVisible);
+            }
+            const std::vector<Mesh>& meshes = model->getMeshes();
+            for (std::size_t meshIndex = 0; meshIndex < meshes.size(); meshIndex++) {
+                const Mesh& mesh = meshes[meshIndex];
+                if (mesh.material.diffuseTextures.empty()) { continue; }
+                if (pvsVisible[meshIndex] == 0) {
+                    culler.addHidden();
+                    occlusionCuller.add(AABB{});
+                    continue;
                 }
+                culler.add(mesh.sphere.transform(modelMatrix));
+                occlusionCuller.add(occluders[i] != 0 && mesh.occluder ? AABB{} : mesh.aabb.transform(modelMatrix));
             }
-            return;
-    } else {
-            DescriptorWriter(*renderSystemLayout, frameInfo.frameDescriptorPool)
-                .writeBuffer(0, &bufferInfo)
-                .build(objectDescriptorSet);
+        } else {
+            culler.add(model->getSphere().transform(modelMatrix));
+            occlusionCuller.add(occluders[i] != 0 ? AABB{} : objects.bounds()[i]);
         }
+    }
+    culler.cull();
+    // only the frustum survivors are tested, the occlusion result holds the combined visibility
+    occlusionCuller.cull(&culler.getVisibility());
+
+    // selected once for every pass, a depth pre-pass and its EQUAL pass must rasterize the same triangles
+    uint32_t cullIndex = 0;
+    for (uint32_t i = 0; i < objects.size(); i++) {
+        const Model* model = models[i].get();
+        if (model == nullptr) { continue; }
+        std::vector<uint8_t>& lods = frameInfo.objects.lods()[i];
+        if (diffuseMaps[i] == nullptr && !model->getTextures().empty()) {
+            lods.resize(model->getMeshes().size());
+            for (std::size_t meshIndex = 0; meshIndex < model->getMeshes().size(); meshIndex++) {
+                const Mesh& mesh = model->getMeshes()[meshIndex];
+                if (mesh.material.diffuseTextures.empty() || !occlusionCuller.isVisible(cullIndex++)) { continue; }
+                lods[meshIndex] = frameInfo.lodSelector.select(mesh.lods, mesh.sphere, worlds[i].model, lods[meshIndex]);
+            }
+        } else {
+            if (!occlusionCuller.isVisible(cullIndex++)) { continue; }
+            lods.resize(1);
+            lods[0] = frameInfo.lodSelector.select(model->getLods(), model->getSphere(), worlds[i].model, lods[0]);
+        }
+    }
+}
 
-        vkCmdBindDescriptorSets(
-            frameInfo.commandBuffer,
-            VK_PIPELINE_BIND_POINT_GRAPHICS,
-            getPipelineLayout(),
-            1,  // starting set (0 is the globalDescriptorSet, 1 is the set specific to this system)
-            1,  // set count
-            &objectDescriptorSet,
-            0,
-            nullptr);
+void ven::ObjectRenderSystem::render(const FrameInfo &frameInfo) const
+{
+    const OcclusionCuller& occlusionCuller = frameInfo.occlusionCuller;
+    const ObjectStore& objects = frameInfo.objects;
+    const std::span<const WorldMatrices> worlds = objects.worlds();
+    const std::span<const std::shared_ptr<Model>> models = objects.models();
+    const std::span<const std::shared_ptr<Texture>> diffuseMaps = objects.diffuseMaps();
+    uint8_t alphaModes = 0;
+    for (const GeometryPipeline& pipeline : getGeometryPipelines()) {
+        alphaModes |= pipeline.alphaModes;
+    }
 
-        const ObjectPushConstantData push{
-            .modelMatrix = object.transform.transformMatrix(),
-            .normalMatrix = object.transform.normalMatrix()
-        };
-        object.getModel()->bind(frameInfo.commandBuffer);
-        object.getModel()->draw(frameInfo.commandBuffer);
-        vkCmdPushConstants(frameInfo.commandBuffer, getPipelineLayout(), VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(ObjectPushConstantData), &push);
+    // the visible draws of the classes this pass handles, their set is written once for all the pipelines drawing them
+    std::vector<ObjectDraw> draws;
+    const auto addDraw = [&](const uint32_t object, const Mesh* mesh, const uint8_t lod, const Texture* texture, const ALPHA_MODE alphaMode, const BoundingSphere& sphere) {
+        if ((alphaModes & (1U << alphaMode)) == 0) { return; }
+        ObjectDraw& draw = draws.emplace_back(ObjectDraw{ .object = object, .mesh = mesh, .lod = lod, .alphaMode = alphaMode });
+        draw.distance = glm::length(glm::vec3(worlds[object].model * glm::vec4(sphere.center, 1.F)) - frameInfo.culler.getCameraPosition());
+        auto bufferInfo = objects.bufferInfos()[object][frameInfo.frameIndex];
+        DescriptorWriter writer(*renderSystemLayout, frameInfo.frameDescriptorPool);
+        writer.writeBuffer(0, &bufferInfo);
+        VkDescriptorImageInfo imageInfo{};
+        if (texture != nullptr) {
+            imageInfo = texture->getImageInfo();
+            writer.writeImage(1, &imageInfo);
+        }
+        writer.build(draw.descriptorSet);
+    };
+    uint32_t cullIndex = 0;
+    for (uint32_t i = 0; i < objects.size(); i++) {
+        const Model* model = models[i].get();
+        if (model == nullptr) { continue; }
+        if (diffuseMaps[i] != nullptr) {
+            if (occlusionCuller.isVisible(cullIndex++)) {
+                addDraw(i, nullptr, objects.lods()[i][0], diffuseMaps[i].get(), diffuseMaps[i]->getAlphaMode(), model->getSphere());
+            }
+        } else if (!model->getTextures().empty()) {
+            const std::vector<uint8_t>& lods = objects.lods()[i];
+            for (std::size_t meshIndex = 0; meshIndex < model->getMeshes().size(); meshIndex++) {
+                const Mesh& mesh = model->getMeshes()[meshIndex];
+                if (mesh.material.diffuseTextures.empty() || !occlusionCuller.isVisible(cullIndex++)) { continue; }
+                addDraw(i, &mesh, lods[meshIndex], mesh.material.diffuseTextures[0].get(), mesh.material.alphaMode, mesh.sphere);
+            }
+        } else if (occlusionCuller.isVisible(cullIndex++)) {
+            addDraw(i, nullptr, objects.lods()[i][0], nullptr, ALPHA_OPAQUE, model->getSphere());
+        }
+    }
+    // the blended surfaces back to front, the other classes keep the scene order
+    const auto blended = std::ranges::stable_partition(draws, [](const ObjectDraw& draw) { return draw.alphaMode != ALPHA_BLEND; });
+    std::ranges::sort(blended, std::ranges::greater{}, &ObjectDraw::distance);
+
+    for (const GeometryPipeline& pipeline : getGeometryPipelines()) {
+        pipeline.shaders->bind(frameInfo.commandBuffer, frameInfo.shaderVariant);
+        vkCmdBindDescriptorSets(frameInfo.commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, getPipelineLayout(), 0, 1, &frameInfo.globalDescriptorSet, 0, nullptr);
+        const Model* boundModel = nullptr;
+        for (const ObjectDraw& draw : draws) {
+            if ((pipeline.alphaModes & (1U << draw.alphaMode)) == 0) { continue; }
+            const Model* model = models[draw.object].get();
+            vkCmdBindDescriptorSets(
+                frameInfo.commandBuffer,
+                VK_PIPELINE_BIND_POINT_GRAPHICS,
+                getPipelineLayout(),
+                1,  // starting set (0 is the globalDescriptorSet, 1 is the set specific to this system)
+                1,  // set count
+                &draw.descriptorSet,
+                0,
+                nullptr);
+            if (model != boundModel) {
+                if (pipeline.depthStream) {
+                    model->bindDepth(frameInfo.commandBuffer);
+                } else {
+                    model->bind(frameInfo.commandBuffer);
+                }
+                boundModel = model;
+            }
+            if (draw.mesh != nullptr) {
+                model->drawMesh(frameInfo.commandBuffer, *draw.mesh, draw.lod);
+            } else {
+                model->draw(frameInfo.commandBuffer, draw.lod);
+            }
+        }
     }
 }
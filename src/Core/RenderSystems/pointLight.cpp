@@ -1,19 +1,63 @@
-#include <ranges>
+#include <algorithm>
+#include <numbers>
 
 #include "VEngine/Core/RenderSystem/PointLight.hpp"
+#include "VEngine/Gfx/Descriptors/Writer.hpp"
+
+ven::PointLightRenderSystem::PointLightRenderSystem(const Device& device, const VkRenderPass renderPass, const VkDescriptorSetLayout globalSetLayout) : ARenderSystemBase(device)
+{
+    const std::string vertPath = std::string(SHADERS_BIN_PATH) + "vertex_point_light.spv";
+    const std::string fragPath = std::string(SHADERS_BIN_PATH) + "fragment_point_light.spv";
+    createPipelineLayout(globalSetLayout, { vertPath, fragPath });
+    createPipeline(renderPass, vertPath, fragPath, true);
+    for (unsigned long i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+        reserve(i, 1);
+    }
+}
+
+void ven::PointLightRenderSystem::reserve(const unsigned long frameIndex, const uint32_t lightCount)
+{
+    Buffer::reserve(m_orderBuffers.at(frameIndex), getDevice(), sizeof(uint32_t), lightCount, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+}
+
+void ven::PointLightRenderSystem::prepare(const FrameInfo &frameInfo)
+{
+    const std::span<const Transform3D> transforms = frameInfo.lights.transforms();
+    const std::span<const glm::vec3> positions = frameInfo.lights.positions();
+    const glm::vec3& cameraPosition = frameInfo.culler.getCameraPosition();
+
+    m_sortKeys.clear();
+    for (uint32_t i = 0; i < frameInfo.lights.size(); i++) {
+        // the camera facing quad spans radius on both axes, its corners are sqrt(2) * radius away
+        const BoundingSphere sphere{ .center = positions[i], .radius = transforms[i].scale.x * std::numbers::sqrt2_v<float> };
+        if (!frameInfo.culler.getFrustum().intersects(sphere)) { continue; }
+        const glm::vec3 offset = positions[i] - cameraPosition;
+        m_sortKeys.emplace_back(dot(offset, offset), i);
+    }
+    // alpha blended, the farthest billboard is drawn first
+    std::ranges::sort(m_sortKeys, std::ranges::greater{});
+    m_order.resize(m_sortKeys.size());
+    std::ranges::transform(m_sortKeys, m_order.begin(), [](const std::pair<float, uint32_t>& key) { return key.second; });
+
+    reserve(frameInfo.frameIndex, getVisibleCount());
+    if (!m_order.empty()) {
+        m_orderBuffers.at(frameInfo.frameIndex)->writeToBuffer(m_order.data(), m_order.size() * sizeof(uint32_t));
+    }
+}
 
 void ven::PointLightRenderSystem::render(const FrameInfo &frameInfo) const
 {
-    getShaders()->bind(frameInfo.commandBuffer);
-    vkCmdBindDescriptorSets(frameInfo.commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, getPipelineLayout(), 0, 1, &frameInfo.globalDescriptorSet, 0, nullptr);
-
-    for (const Light &light : frameInfo.lights | std::views::values) {
-        const LightPushConstantData push{
-            .position = glm::vec4(light.transform.translation, 1.F),
-            .color = light.color,
-            .radius = light.transform.scale.x
-        };
-        vkCmdPushConstants(frameInfo.commandBuffer, getPipelineLayout(), VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(LightPushConstantData), &push);
-        vkCmdDraw(frameInfo.commandBuffer, 6, 1, 0, 0);
+    if (m_order.empty()) {
+        return;
     }
+    VkDescriptorSet orderDescriptorSet = nullptr;
+    auto orderInfo = m_orderBuffers.at(frameInfo.frameIndex)->descriptorInfo();
+    DescriptorWriter(*renderSystemLayout, frameInfo.frameDescriptorPool)
+        .writeBuffer(0, &orderInfo)
+        .build(orderDescriptorSet);
+
+    getShaders()->bind(frameInfo.commandBuffer);
+    const std::array descriptorSets{frameInfo.globalDescriptorSet, orderDescriptorSet};
+    vkCmdBindDescriptorSets(frameInfo.commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, getPipelineLayout(), 0, static_cast<uint32_t>(descriptorSets.size()), descriptorSets.data(), 0, nullptr);
+    vkCmdDraw(frameInfo.commandBuffer, 6, getVisibleCount(), 0, 0);
 }
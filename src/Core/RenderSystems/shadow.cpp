@@ -0,0 +1,290 @@
+#include <algorithm>
+
+#include "VEngine/Core/RenderSystem/Shadow.hpp"
+
+namespace {
+
+    struct LayerTransition {
+        VkImageLayout oldLayout;
+        VkImageLayout newLayout;
+        VkAccessFlags srcAccessMask;
+        VkAccessFlags dstAccessMask;
+        VkPipelineStageFlags srcStageMask;
+        VkPipelineStageFlags dstStageMask;
+    };
+
+    void transitionLayer(const VkCommandBuffer commandBuffer, const VkImage image, const ven::SHADOW_LAYER layer, const LayerTransition& transition)
+    {
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask = transition.srcAccessMask;
+        barrier.dstAccessMask = transition.dstAccessMask;
+        barrier.oldLayout = transition.oldLayout;
+        barrier.newLayout = transition.newLayout;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image;
+        barrier.subresourceRange = { .aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT, .baseMipLevel = 0, .levelCount = 1, .baseArrayLayer = layer, .layerCount = 1 };
+        vkCmdPipelineBarrier(commandBuffer, transition.srcStageMask, transition.dstStageMask, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+    }
+
+    constexpr VkPipelineStageFlags DEPTH_TEST_STAGES = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    constexpr VkAccessFlags DEPTH_ACCESS = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+} // namespace
+
+ven::ShadowRenderSystem::ShadowRenderSystem(const Device& device, const VkDescriptorSetLayout globalSetLayout, const uint32_t atlasSize) : ARenderSystemBase(device), m_atlasSize{atlasSize}
+{
+    createAtlas();
+    createRenderPass();
+    const std::string vertPath = std::string(SHADERS_BIN_PATH) + "vertex_shadow.spv";
+    createPipelineLayout(globalSetLayout, { vertPath });
+    createShadowPipeline(m_renderPass, vertPath);
+
+    for (unsigned long i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+        reserve(i, DEFAULT_SHADOW_MAP_CAPACITY);
+    }
+}
+
+ven::ShadowRenderSystem::~ShadowRenderSystem()
+{
+    const VkDevice device = getDevice().device();
+    vkDestroySampler(device, m_sampler, nullptr);
+    for (const VkFramebuffer framebuffer : m_framebuffers) {
+        vkDestroyFramebuffer(device, framebuffer, nullptr);
+    }
+    vkDestroyRenderPass(device, m_renderPass, nullptr);
+    for (const VkImageView view : m_layerViews) {
+        vkDestroyImageView(device, view, nullptr);
+    }
+    vkDestroyImageView(device, m_sampledView, nullptr);
+    vkDestroyImage(device, m_image, nullptr);
+    vkFreeMemory(device, m_imageMemory, nullptr);
+}
+
+void ven::ShadowRenderSystem::createAtlas()
+{
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.format = DEPTH_FORMAT;
+    imageInfo.extent = { .width = m_atlasSize, .height = m_atlasSize, .depth = 1 };
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = SHADOW_LAYER_COUNT;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    getDevice().createImageWithInfo(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_image, m_imageMemory);
+
+    VkImageViewCreateInfo viewInfo{};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = m_image;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = DEPTH_FORMAT;
+    for (uint32_t layer = 0; layer < SHADOW_LAYER_COUNT; layer++) {
+        viewInfo.subresourceRange = { .aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT, .baseMipLevel = 0, .levelCount = 1, .baseArrayLayer = layer, .layerCount = 1 };
+        if (vkCreateImageView(getDevice().device(), &viewInfo, nullptr, &m_layerViews.at(layer)) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create shadow atlas image view!");
+        }
+    }
+    viewInfo.subresourceRange.baseArrayLayer = SHADOW_FINAL_LAYER;
+    if (vkCreateImageView(getDevice().device(), &viewInfo, nullptr, &m_sampledView) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create shadow atlas image view!");
+    }
+
+    // linear filtering of the comparisons gives a 2x2 percentage closer filter
+    VkSamplerCreateInfo samplerInfo{};
+    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.magFilter = VK_FILTER_LINEAR;
+    samplerInfo.minFilter = VK_FILTER_LINEAR;
+    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.compareEnable = VK_TRUE;
+    samplerInfo.compareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
+    samplerInfo.maxAnisotropy = 1.0F;
+    samplerInfo.minLod = 0.0F;
+    samplerInfo.maxLod = 0.0F;
+    if (vkCreateSampler(getDevice().device(), &samplerInfo, nullptr, &m_sampler) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create shadow atlas sampler!");
+    }
+}
+
+void ven::ShadowRenderSystem::createRenderPass()
+{
+    // the tiles of the other lights are kept, each draw clears or copies its own tiles first
+    VkAttachmentDescription depthAttachment{};
+    depthAttachment.format = DEPTH_FORMAT;
+    depthAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+    depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+    depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depthAttachment.initialLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    depthAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+    VkAttachmentReference depthAttachmentRef{};
+    depthAttachmentRef.attachment = 0;
+    depthAttachmentRef.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+    VkSubpassDescription subpass{};
+    subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpass.colorAttachmentCount = 0;
+    subpass.pDepthStencilAttachment = &depthAttachmentRef;
+
+    VkRenderPassCreateInfo renderPassInfo{};
+    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+    renderPassInfo.attachmentCount = 1;
+    renderPassInfo.pAttachments = &depthAttachment;
+    renderPassInfo.subpassCount = 1;
+    renderPassInfo.pSubpasses = &subpass;
+    if (vkCreateRenderPass(getDevice().device(), &renderPassInfo, nullptr, &m_renderPass) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create shadow render pass!");
+    }
+
+    for (uint32_t layer = 0; layer < SHADOW_LAYER_COUNT; layer++) {
+        VkFramebufferCreateInfo framebufferInfo{};
+        framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+        framebufferInfo.renderPass = m_renderPass;
+        framebufferInfo.attachmentCount = 1;
+        framebufferInfo.pAttachments = &m_layerViews.at(layer);
+        framebufferInfo.width = m_atlasSize;
+        framebufferInfo.height = m_atlasSize;
+        framebufferInfo.layers = 1;
+        if (vkCreateFramebuffer(getDevice().device(), &framebufferInfo, nullptr, &m_framebuffers.at(layer)) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create shadow framebuffer!");
+        }
+    }
+}
+
+void ven::ShadowRenderSystem::reserve(const unsigned long frameIndex, const uint32_t shadowMapCount)
+{
+    Buffer::reserve(m_buffers.at(frameIndex), getDevice(), sizeof(ShadowBufferData), shadowMapCount, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+}
+
+void ven::ShadowRenderSystem::prepare(const FrameInfo &frameInfo)
+{
+    if (!m_initialized) {
+        // each layer rests in the layout of its next reader, render switches them to attachments around its draws
+        transitionLayer(frameInfo.commandBuffer, m_image, SHADOW_STATIC_LAYER, {
+            .oldLayout = VK_IMAGE_LAYOUT_UNDEFINED, .newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            .srcAccessMask = 0, .dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT,
+            .srcStageMask = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, .dstStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT });
+        transitionLayer(frameInfo.commandBuffer, m_image, SHADOW_FINAL_LAYER, {
+            .oldLayout = VK_IMAGE_LAYOUT_UNDEFINED, .newLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL,
+            .srcAccessMask = 0, .dstAccessMask = VK_ACCESS_SHADER_READ_BIT,
+            .srcStageMask = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, .dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT });
+        m_initialized = true;
+    }
+
+    const std::vector<ShadowMap>& shadowMaps = frameInfo.shadowCache.getShadowMaps();
+    const auto atlasSize = static_cast<float>(m_atlasSize);
+    m_bufferData.resize(shadowMaps.size());
+    for (std::size_t i = 0; i < shadowMaps.size(); i++) {
+        m_bufferData[i].faceViewProjections = shadowMaps[i].faceViewProjections;
+        for (uint32_t face = 0; face < CUBE_FACE_COUNT; face++) {
+            const ShadowTile& tile = shadowMaps[i].tiles.at(face);
+            const auto size = static_cast<float>(tile.size);
+            m_bufferData[i].faceRects.at(face) = { static_cast<float>(tile.x) / atlasSize, static_cast<float>(tile.y) / atlasSize, size / atlasSize, 0.5F / size };
+        }
+    }
+    reserve(frameInfo.frameIndex, static_cast<uint32_t>(shadowMaps.size()));
+    if (!m_bufferData.empty()) {
+        m_buffers.at(frameInfo.frameIndex)->writeToBuffer(m_bufferData.data(), m_bufferData.size() * sizeof(ShadowBufferData));
+    }
+}
+
+void ven::ShadowRenderSystem::drawLayer(const FrameInfo &frameInfo, const SHADOW_LAYER layer) const
+{
+    VkRenderPassBeginInfo renderPassInfo{};
+    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+    renderPassInfo.renderPass = m_renderPass;
+    renderPassInfo.framebuffer = m_framebuffers.at(layer);
+    renderPassInfo.renderArea = { .offset = {0, 0}, .extent = { .width = m_atlasSize, .height = m_atlasSize } };
+    vkCmdBeginRenderPass(frameInfo.commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+    getShaders()->bind(frameInfo.commandBuffer);
+
+    const std::span<const WorldMatrices> worlds = frameInfo.objects.worlds();
+    const std::span<const std::shared_ptr<Model>> models = frameInfo.objects.models();
+    for (const ShadowMap& shadowMap : frameInfo.shadowCache.getShadowMaps()) {
+        if (layer == SHADOW_STATIC_LAYER ? !shadowMap.bake : !shadowMap.composite) { continue; }
+        for (uint32_t face = 0; face < CUBE_FACE_COUNT; face++) {
+            const ShadowTile& tile = shadowMap.tiles.at(face);
+            const VkRect2D rect{ .offset = { static_cast<int32_t>(tile.x), static_cast<int32_t>(tile.y) }, .extent = { .width = tile.size, .height = tile.size } };
+            if (layer == SHADOW_STATIC_LAYER) {
+                // the final layer tiles are overwritten by the copy of these ones
+                const VkClearAttachment clear{ .aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT, .colorAttachment = 0, .clearValue = { .depthStencil = { .depth = 1.0F, .stencil = 0 } } };
+                const VkClearRect clearRect{ .rect = rect, .baseArrayLayer = 0, .layerCount = 1 };
+                vkCmdClearAttachments(frameInfo.commandBuffer, 1, &clear, 1, &clearRect);
+            }
+            const std::vector<uint32_t>& casters = layer == SHADOW_STATIC_LAYER ? shadowMap.staticCasters.at(face) : shadowMap.dynamicCasters.at(face);
+            if (casters.empty()) { continue; }
+            const VkViewport viewport{ .x = static_cast<float>(tile.x), .y = static_cast<float>(tile.y), .width = static_cast<float>(tile.size), .height = static_cast<float>(tile.size), .minDepth = 0.0F, .maxDepth = 1.0F };
+            vkCmdSetViewport(frameInfo.commandBuffer, 0, 1, &viewport);
+            vkCmdSetScissor(frameInfo.commandBuffer, 0, 1, &rect);
+            for (const uint32_t object : casters) {
+                const std::shared_ptr<Model>& model = models[object];
+                if (model == nullptr) { continue; }
+                const ShadowPushConstantData push{ .viewProjection = shadowMap.faceViewProjections.at(face), .modelMatrix = worlds[object].model };
+                pushConstants(frameInfo.commandBuffer, push);
+                model->bindDepth(frameInfo.commandBuffer);
+                model->draw(frameInfo.commandBuffer);
+            }
+        }
+    }
+    vkCmdEndRenderPass(frameInfo.commandBuffer);
+}
+
+void ven::ShadowRenderSystem::render(const FrameInfo &frameInfo) const
+{
+    const std::vector<ShadowMap>& shadowMaps = frameInfo.shadowCache.getShadowMaps();
+    const bool bake = std::ranges::any_of(shadowMaps, &ShadowMap::bake);
+    // a bake always composites its map
+    if (!std::ranges::any_of(shadowMaps, &ShadowMap::composite)) { return; }
+    const VkCommandBuffer commandBuffer = frameInfo.commandBuffer;
+
+    if (bake) {
+        transitionLayer(commandBuffer, m_image, SHADOW_STATIC_LAYER, {
+            .oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, .newLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+            .srcAccessMask = 0, .dstAccessMask = DEPTH_ACCESS,
+            .srcStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT, .dstStageMask = DEPTH_TEST_STAGES });
+        drawLayer(frameInfo, SHADOW_STATIC_LAYER);
+        transitionLayer(commandBuffer, m_image, SHADOW_STATIC_LAYER, {
+            .oldLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, .newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            .srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT, .dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT,
+            .srcStageMask = DEPTH_TEST_STAGES, .dstStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT });
+    }
+
+    // the previous frames may still sample the final layer, the barrier waits for their fragment shaders
+    transitionLayer(commandBuffer, m_image, SHADOW_FINAL_LAYER, {
+        .oldLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL, .newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        .srcAccessMask = 0, .dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .srcStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, .dstStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT });
+    std::vector<VkImageCopy> regions;
+    for (const ShadowMap& shadowMap : shadowMaps) {
+        if (!shadowMap.composite) { continue; }
+        for (const ShadowTile& tile : shadowMap.tiles) {
+            const VkOffset3D offset{ .x = static_cast<int32_t>(tile.x), .y = static_cast<int32_t>(tile.y), .z = 0 };
+            regions.push_back({
+                .srcSubresource = { .aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT, .mipLevel = 0, .baseArrayLayer = SHADOW_STATIC_LAYER, .layerCount = 1 },
+                .srcOffset = offset,
+                .dstSubresource = { .aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT, .mipLevel = 0, .baseArrayLayer = SHADOW_FINAL_LAYER, .layerCount = 1 },
+                .dstOffset = offset,
+                .extent = { .width = tile.size, .height = tile.size, .depth = 1 }
+            });
+        }
+    }
+    vkCmdCopyImage(commandBuffer, m_image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, m_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(regions.size()), regions.data());
+    transitionLayer(commandBuffer, m_image, SHADOW_FINAL_LAYER, {
+        .oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, .newLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+        .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT, .dstAccessMask = DEPTH_ACCESS,
+        .srcStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT, .dstStageMask = DEPTH_TEST_STAGES });
+    drawLayer(frameInfo, SHADOW_FINAL_LAYER);
+    transitionLayer(commandBuffer, m_image, SHADOW_FINAL_LAYER, {
+        .oldLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, .newLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL,
+        .srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT, .dstAccessMask = VK_ACCESS_SHADER_READ_BIT,
+        .srcStageMask = DEPTH_TEST_STAGES, .dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT });
+}
@@ -1,9 +1,13 @@
+#include <algorithm>
 #include <cstring>
+#include <filesystem>
 #include <iostream>
 #include <set>
 #include <unordered_set>
 
 #include "VEngine/Core/Device.hpp"
+#include "VEngine/Gfx/Descriptors/LayoutCache.hpp"
+#include "VEngine/Utils/Logger.hpp"
 
 static VKAPI_ATTR VkBool32 VKAPI_CALL debugCallback(const VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity, const VkDebugUtilsMessageTypeFlagsEXT messageType, const VkDebugUtilsMessengerCallbackDataEXT *pCallbackData, void *pUserData)
 {
@@ -37,10 +41,22 @@ ven::Device::Device(const Window& window) : m_window{window}
     pickPhysicalDevice();
     createLogicalDevice();
     createCommandPool();
+    createPipelineCache();
+    m_layoutCache = std::make_unique<DescriptorLayoutCache>(*this);
 }
 
 ven::Device::~Device()
 {
+    // joined before the device goes, a compilation still queued would otherwise create its pipeline on a destroyed one
+    m_pipelineThreadPool.reset();
+    m_layoutCache.reset();
+    // every pipeline has been created by now, a failed save only costs the next start its warm cache
+    try {
+        savePipelineCache();
+    } catch (const std::exception& error) {
+        Logger::logWarning(std::string("Failed to save the pipeline cache: ") + error.what());
+    }
+    vkDestroyPipelineCache(m_device, m_pipelineCache, nullptr);
     vkDestroyCommandPool(m_device, m_commandPool, nullptr);
     vkDestroyDevice(m_device, nullptr);
     if (enableValidationLayers) {
@@ -50,6 +66,11 @@ ven::Device::~Device()
     vkDestroyInstance(m_instance, nullptr);
 }
 
+ven::DescriptorLayoutCache& ven::Device::getLayoutCache() const
+{
+    return *m_layoutCache;
+}
+
 void ven::Device::createInstance()
 {
     if (enableValidationLayers && !checkValidationLayerSupport()) {
@@ -63,7 +84,7 @@ void ven::Device::createInstance()
         .applicationVersion = VK_MAKE_VERSION(1, 0, 0),
         .pEngineName = "VEngine",
         .engineVersion = VK_MAKE_VERSION(1, 0, 0),
-        .apiVersion = VK_API_VERSION_1_0
+        .apiVersion = VK_API_VERSION_1_2
     };
 
     VkInstanceCreateInfo createInfo = {};
@@ -117,6 +138,32 @@ void ven::Device::pickPhysicalDevice()
 
     vkGetPhysicalDeviceProperties(m_physicalDevice, &m_properties);
     std::cout << "physical device: " << m_properties.deviceName << '\n';
+
+    // GPU driven rendering (compute culling + vkCmdDrawIndexedIndirectCount) is optional, the CPU path is used otherwise
+    if (m_properties.apiVersion >= VK_API_VERSION_1_2) {
+        VkPhysicalDeviceVulkan12Features vulkan12Features{};
+        vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+        VkPhysicalDeviceFeatures2 features{};
+        features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        features.pNext = &vulkan12Features;
+        vkGetPhysicalDeviceFeatures2(m_physicalDevice, &features);
+        m_drawIndirectCount = (vulkan12Features.drawIndirectCount != 0U) && (features.features.multiDrawIndirect != 0U) && (features.features.drawIndirectFirstInstance != 0U);
+
+        // task + mesh shaders (SPIR-V 1.4, core in 1.2) for the meshlets, the compute compaction path is used otherwise
+        if (hasDeviceExtension(m_physicalDevice, VK_EXT_MESH_SHADER_EXTENSION_NAME)) {
+            VkPhysicalDeviceMeshShaderFeaturesEXT meshShaderFeatures{};
+            meshShaderFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MESH_SHADER_FEATURES_EXT;
+            features.pNext = &meshShaderFeatures;
+            vkGetPhysicalDeviceFeatures2(m_physicalDevice, &features);
+            m_meshShader = (meshShaderFeatures.taskShader != 0U) && (meshShaderFeatures.meshShader != 0U);
+        }
+    }
+    // fragment shader invocation counts shown by the GUI, nothing depends on them
+    VkPhysicalDeviceFeatures supportedFeatures;
+    vkGetPhysicalDeviceFeatures(m_physicalDevice, &supportedFeatures);
+    m_pipelineStatistics = supportedFeatures.pipelineStatisticsQuery != 0U;
+    std::cout << "draw indirect count: " << (m_drawIndirectCount ? "supported" : "unsupported") << '\n';
+    std::cout << "mesh shader: " << (m_meshShader ? "supported" : "unsupported") << '\n';
 }
 
 void ven::Device::createLogicalDevice()
@@ -138,6 +185,23 @@ void ven::Device::createLogicalDevice()
 
     VkPhysicalDeviceFeatures deviceFeatures = {};
     deviceFeatures.samplerAnisotropy = VK_TRUE;
+    deviceFeatures.multiDrawIndirect = m_drawIndirectCount ? VK_TRUE : VK_FALSE;
+    deviceFeatures.drawIndirectFirstInstance = m_drawIndirectCount ? VK_TRUE : VK_FALSE;
+    deviceFeatures.pipelineStatisticsQuery = m_pipelineStatistics ? VK_TRUE : VK_FALSE;
+
+    VkPhysicalDeviceVulkan12Features vulkan12Features{};
+    vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    vulkan12Features.drawIndirectCount = m_drawIndirectCount ? VK_TRUE : VK_FALSE;
+
+    VkPhysicalDeviceMeshShaderFeaturesEXT meshShaderFeatures{};
+    meshShaderFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MESH_SHADER_FEATURES_EXT;
+    meshShaderFeatures.taskShader = VK_TRUE;
+    meshShaderFeatures.meshShader = VK_TRUE;
+    std::vector<const char *> extensions = m_deviceExtensions;
+    if (m_meshShader) {
+        vulkan12Features.pNext = &meshShaderFeatures;
+        extensions.push_back(VK_EXT_MESH_SHADER_EXTENSION_NAME);
+    }
 
     VkDeviceCreateInfo createInfo = {};
     createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
@@ -146,8 +210,9 @@ void ven::Device::createLogicalDevice()
     createInfo.pQueueCreateInfos = queueCreateInfos.data();
 
     createInfo.pEnabledFeatures = &deviceFeatures;
-    createInfo.enabledExtensionCount = static_cast<uint32_t>(m_deviceExtensions.size());
-    createInfo.ppEnabledExtensionNames = m_deviceExtensions.data();
+    createInfo.pNext = m_properties.apiVersion >= VK_API_VERSION_1_2 ? &vulkan12Features : nullptr;
+    createInfo.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
+    createInfo.ppEnabledExtensionNames = extensions.data();
 
         // might not really be necessary anymore because device specific validation layers
         // have been deprecated
@@ -162,6 +227,11 @@ void ven::Device::createLogicalDevice()
         throw std::runtime_error("failed to create logical device!");
     }
 
+    if (m_meshShader) {
+        m_vkCmdDrawMeshTasks = reinterpret_cast<PFN_vkCmdDrawMeshTasksEXT>(vkGetDeviceProcAddr(m_device, "vkCmdDrawMeshTasksEXT"));
+        m_meshShader = m_vkCmdDrawMeshTasks != nullptr;
+    }
+
     vkGetDeviceQueue(m_device, graphicsFamily, 0, &m_graphicsQueue);
     vkGetDeviceQueue(m_device, presentFamily, 0, &m_presentQueue);
 }
@@ -182,6 +252,38 @@ void ven::Device::createCommandPool()
     }
 }
 
+ven::PipelineCacheIdentity ven::Device::getPipelineCacheIdentity() const
+{
+    PipelineCacheIdentity identity{ .vendorID = m_properties.vendorID, .deviceID = m_properties.deviceID, .driverVersion = m_properties.driverVersion };
+    std::copy_n(std::begin(m_properties.pipelineCacheUUID), identity.uuid.size(), identity.uuid.begin());
+    return identity;
+}
+
+void ven::Device::createPipelineCache()
+{
+    // a missing, corrupted or foreign file leaves the cache empty, the driver then compiles every pipeline
+    const std::vector<uint8_t> data = PipelineCacheFile::load(std::string(PIPELINE_CACHE_PATH), getPipelineCacheIdentity());
+    VkPipelineCacheCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    createInfo.initialDataSize = data.size();
+    createInfo.pInitialData = data.empty() ? nullptr : data.data();
+    if (vkCreatePipelineCache(m_device, &createInfo, nullptr, &m_pipelineCache) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create pipeline cache!");
+    }
+    m_pipelineCacheLoadedSize = data.size();
+}
+
+void ven::Device::savePipelineCache() const
+{
+    std::size_t size = 0;
+    if (vkGetPipelineCacheData(m_device, m_pipelineCache, &size, nullptr) != VK_SUCCESS || size == 0) { return; }
+    std::vector<uint8_t> data(size);
+    if (vkGetPipelineCacheData(m_device, m_pipelineCache, &size, data.data()) != VK_SUCCESS) { return; }
+    data.resize(size);
+    std::filesystem::create_directories(std::filesystem::path(PIPELINE_CACHE_PATH).parent_path());
+    PipelineCacheFile::save(std::string(PIPELINE_CACHE_PATH), getPipelineCacheIdentity(), data);
+}
+
 bool ven::Device::isDeviceSuitable(const VkPhysicalDevice device) const
 {
     const QueueFamilyIndices indices = findQueueFamilies(device);
@@ -282,6 +384,15 @@ void ven::Device::hasGlfwRequiredInstanceExtensions() const
     }
 }
 
+bool ven::Device::hasDeviceExtension(const VkPhysicalDevice device, const std::string_view extension)
+{
+    uint32_t extensionCount = 0;
+    vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
+    std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+    vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, availableExtensions.data());
+    return std::ranges::any_of(availableExtensions, [extension](const VkExtensionProperties& properties) { return extension == properties.extensionName; });
+}
+
 bool ven::Device::checkDeviceExtensionSupport(const VkPhysicalDevice device) const
 {
     uint32_t extensionCount = 0;
@@ -376,6 +487,19 @@ uint32_t ven::Device::findMemoryType(const uint32_t typeFilter, const VkMemoryPr
     throw std::runtime_error("failed to find suitable m_memory type!");
 }
 
+bool ven::Device::hasMemoryType(const uint32_t typeFilter, const VkMemoryPropertyFlags properties) const
+{
+    VkPhysicalDeviceMemoryProperties memProperties;
+    vkGetPhysicalDeviceMemoryProperties(m_physicalDevice, &memProperties);
+
+    for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
+        if (((typeFilter & (1 << i)) != 0U) && (memProperties.memoryTypes[i].propertyFlags & properties) == properties) {
+            return true;
+        }
+    }
+    return false;
+}
+
 void ven::Device::createBuffer(const VkDeviceSize size, const VkBufferUsageFlags usage, const VkMemoryPropertyFlags properties, VkBuffer &buffer, VkDeviceMemory &bufferMemory) const
 {
     VkBufferCreateInfo bufferInfo{};
@@ -473,7 +597,7 @@ void ven::Device::copyBufferToImage(const VkBuffer buffer, const VkImage image,
     endSingleTimeCommands(commandBuffer);
 }
 
-void ven::Device::createImageWithInfo(const VkImageCreateInfo &imageInfo, const VkMemoryPropertyFlags properties, VkImage &image, VkDeviceMemory &imageMemory) const
+void ven::Device::createImageWithInfo(const VkImageCreateInfo &imageInfo, const VkMemoryPropertyFlags properties, VkImage &image, VkDeviceMemory &imageMemory, const VkMemoryPropertyFlags preferredProperties) const
 {
     if (vkCreateImage(m_device, &imageInfo, nullptr, &image) != VK_SUCCESS) {
         throw std::runtime_error("failed to create image!");
@@ -485,7 +609,9 @@ void ven::Device::createImageWithInfo(const VkImageCreateInfo &imageInfo, const
     VkMemoryAllocateInfo allocInfo{};
     allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
     allocInfo.allocationSize = memRequirements.size;
-    allocInfo.memoryTypeIndex = findMemoryType(memRequirements.memoryTypeBits, properties);
+    // a memory type the device exposes is not necessarily one this image can live in
+    const bool preferred = preferredProperties != 0 && hasMemoryType(memRequirements.memoryTypeBits, properties | preferredProperties);
+    allocInfo.memoryTypeIndex = findMemoryType(memRequirements.memoryTypeBits, preferred ? properties | preferredProperties : properties);
 
     if (vkAllocateMemory(m_device, &allocInfo, nullptr, &imageMemory) != VK_SUCCESS) {
         throw std::runtime_error("failed to allocate image memory!");
@@ -1,6 +1,5 @@
 #include "VEngine/Core/Engine.hpp"
 #include "VEngine/Core/EventManager.hpp"
-#include "VEngine/Core/RenderSystem/PointLight.hpp"
 #include "VEngine/Gfx/Descriptors/Writer.hpp"
 #include "VEngine/Factories/Light.hpp"
 #include "VEngine/Factories/Object.hpp"
@@ -9,18 +8,54 @@
 #include "VEngine/Utils/Logger.hpp"
 
 ven::Engine::Engine(const Config& config) : m_state(EDITOR), m_window(config.window.width, config.window.height), m_camera(config.camera.fov, config.camera.near, config.camera.far, config.camera.move_speed, config.camera.look_speed) {
+    // the render systems only queued their base pipelines, the independent ones compile side by side on the pipeline workers
+    m_device.getPipelineThreadPool().waitIdle();
+    m_startupClock.update();
+    const std::size_t pipelineCacheSize = m_device.getPipelineCacheLoadedSize();
+    Logger::logInfo("Device and pipelines created in " + std::to_string(m_startupClock.getDeltaTimeMS()) + " ms, "
+        + (pipelineCacheSize > 0 ? "warm pipeline cache (" + std::to_string(pipelineCacheSize) + " bytes)" : "cold pipeline cache"));
     m_gui.init(m_window.getGLFWindow(), m_device.getInstance(), &m_device);
-    m_globalPool = DescriptorPool::Builder(m_device).setMaxSets(MAX_FRAMES_IN_FLIGHT).addPoolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, MAX_FRAMES_IN_FLIGHT).build();
     m_framePools.resize(MAX_FRAMES_IN_FLIGHT);
     const auto framePoolBuilder = DescriptorPool::Builder(m_device)
                                 .setMaxSets(1000)
                                 .addPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1000)
                                 .addPoolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1000)
+                                .addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1000)
+                                .addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 100)
+                                .addPoolSize(VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, 100)
                                 .setPoolFlags(VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT);
     for (auto & framePool : m_framePools) {
         framePool = framePoolBuilder.build();
     }
-    loadObjects();
+    m_sceneManager.getSceneGraph().setThreadPool(&m_threadPool);
+    if (config.scenePath.empty()) {
+        loadObjects();
+        return;
+    }
+    try {
+        Logger::logExecutionTime("Loading scene " + config.scenePath, [&] {
+            m_sceneManager.load(config.scenePath, &m_threadPool);
+        });
+    } catch (const std::runtime_error& error) {
+        Logger::logWarning("Failed to load scene " + config.scenePath + ": " + error.what() + ", loading the default one");
+        loadObjects();
+    }
+}
+
+void ven::Engine::bakePvs(const Config& config)
+{
+    ThreadPool threadPool;
+    if (config.scenePath.empty()) {
+        ModelFactory::bakePvs(std::string(DEFAULT_MODEL_PATH), &threadPool);
+        return;
+    }
+    SceneFile scene;
+    scene.load(config.scenePath);
+    for (const SceneAsset& asset : scene.assets) {
+        if (asset.kind == AssetKind::MODEL) {
+            ModelFactory::bakePvs(asset.path, &threadPool);
+        }
+    }
 }
 
 void ven::Engine::loadObjects()
@@ -28,15 +63,17 @@ void ven::Engine::loadObjects()
     constexpr std::array lightColors{Colors::RED_4, Colors::GREEN_4, Colors::BLUE_4, Colors::YELLOW_4, Colors::CYAN_4, Colors::MAGENTA_4};
 
     Logger::logExecutionTime("Creating object sponza", [&] {
-        m_sceneManager.addObject(ObjectFactory::create(
+        const Handle sponza = ObjectFactory::create(
+            m_sceneManager.getObjects(),
             nullptr,
-            ModelFactory::get(m_device, "assets/models/sponza/sponza.obj"),
+            ModelFactory::get(m_device, std::string(DEFAULT_MODEL_PATH), &m_threadPool),
             "sponza",
             {
             .translation = {0.F, 0.F, 0.F},
             .scale = {1.0F, 1.0F, 1.0F},
             .rotation = {0.F, 0.F, -3.14159265358979323846264338327950288419716939937510582F} // == -π, why ?
-        }));
+        });
+        m_sceneManager.getObjects().occluders()[m_sceneManager.getObjects().indexOf(sponza)] = 1;
     });
     for (std::size_t i = 0; i < lightColors.size(); i++)
     {
@@ -46,12 +83,13 @@ void ven::Engine::loadObjects()
                 static_cast<float>(i) * glm::two_pi<float>() / 6.0F, // 6 = num of lights
                 {0.F, -1.F, 0.F}
             );
-            m_sceneManager.addLight(LightFactory::create({
+            LightFactory::create(m_sceneManager.getLights(), {
                     .translation = glm::vec3(rotateLight * glm::vec4(-1.F, -1.F, -1.F, 1.F)),
                     .scale = { 0.1F, 0.0F, 0.0F },
                     .rotation = { 0.F, 0.F, 0.F }},
-                lightColors.at(i)
-                ));
+                lightColors.at(i),
+                LIGHT_SHADOW
+                );
         });
     }
 }
@@ -62,22 +100,17 @@ void ven::Engine::run()
     const EventManager eventManager{};
     GlobalUbo ubo{};
     VkCommandBuffer_T *commandBuffer = nullptr;
-    VkDescriptorBufferInfo bufferInfo{};
     float frameTime = 0.0F;
     unsigned long frameIndex = 0;
+    bool hizValid = false;
+    glm::mat4 prevViewProjection{1.F};
     std::vector<std::unique_ptr<Buffer>> uboBuffers(MAX_FRAMES_IN_FLIGHT);
-    std::vector<VkDescriptorSet> globalDescriptorSets(MAX_FRAMES_IN_FLIGHT);
-    const PointLightRenderSystem pointLightRenderSystem(m_device, m_renderer.getSwapChainRenderPass(), m_globalSetLayout->getDescriptorSetLayout());
 
     for (auto& uboBuffer : uboBuffers)
     {
         uboBuffer = std::make_unique<Buffer>(m_device, sizeof(GlobalUbo), 1, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
         uboBuffer->map();
     }
-    for (std::size_t i = 0; i < globalDescriptorSets.size(); i++) {
-        bufferInfo = uboBuffers[i]->descriptorInfo();
-        DescriptorWriter(*m_globalSetLayout, *m_globalPool).writeBuffer(0, &bufferInfo).build(globalDescriptorSets[i]);
-    }
 
     while (m_state != EXIT)
     {
@@ -95,26 +128,146 @@ void ven::Engine::run()
             FrameInfo frameInfo{
                 .frameIndex=frameIndex,
                 .commandBuffer=commandBuffer,
-                .globalDescriptorSet=globalDescriptorSets[frameIndex],
+                .globalDescriptorSet=nullptr,
                 .frameDescriptorPool=*m_framePools[frameIndex],
                 .objects=m_sceneManager.getObjects(),
-                .lights=m_sceneManager.getLights()
+                .lights=m_sceneManager.getLights(),
+                .culler=m_culler,
+                .occlusionCuller=m_occlusionCuller,
+                .lodSelector=m_lodSelector,
+                .shadowCache=m_sceneManager.getShadowCache()
             };
             ubo.projection=m_camera.getProjection();
             ubo.view=m_camera.getView();
             ubo.inverseView=m_camera.getInverseView();
+            m_culler.begin(ubo.projection, ubo.view, static_cast<float>(m_window.getExtent().height));
+            ubo.frustumPlanes = m_culler.getFrustum().getPlanes();
+            m_occlusionCuller.begin(ubo.projection * ubo.view);
+            m_lodSelector.begin(m_culler.getCameraPosition(), m_camera.getFov(), static_cast<float>(m_window.getExtent().height));
+            ubo.prevViewProjection = prevViewProjection;
+            m_lightClusters.begin(ubo.projection, m_camera.getNear(), m_camera.getFar(), {static_cast<float>(m_renderer.getSwapChainExtent().width), static_cast<float>(m_renderer.getSwapChainExtent().height)});
+            ubo.clusterScale = m_lightClusters.getScale();
+            m_sceneManager.getShadowCache().begin(m_culler.getCameraPosition(), m_camera.getFov(), static_cast<float>(m_window.getExtent().height));
             m_sceneManager.updateBuffer(ubo, frameIndex, frameTime);
+            // the lit pipelines skip the shadow lookups while no light has a shadow map
+            frameInfo.shaderVariant.shadows = frameInfo.shadowCache.getShadowMaps().empty() ? VK_FALSE : VK_TRUE;
+            frameInfo.shaderVariant.maxLights = m_gui.getMaxFragmentLights();
             uboBuffers.at(frameIndex)->writeToBuffer(&ubo);
             uboBuffers.at(frameIndex)->flush();
-            m_renderer.beginSwapChainRenderPass(frameInfo.commandBuffer);
-            m_objectRenderSystem.render(frameInfo);
-            pointLightRenderSystem.render(frameInfo);
+            m_lightClusterRenderSystem.prepare(frameInfo);
+            m_shadowRenderSystem.prepare(frameInfo);
+            auto uboInfo = uboBuffers.at(frameIndex)->descriptorInfo();
+            auto lightInfo = m_sceneManager.getLightBuffer(frameIndex).descriptorInfo();
+            auto clusterRangeInfo = m_lightClusterRenderSystem.getRangeBuffer(frameIndex).descriptorInfo();
+            auto clusterIndexInfo = m_lightClusterRenderSystem.getIndexBuffer(frameIndex).descriptorInfo();
+            auto shadowMapInfo = m_shadowRenderSystem.getBuffer(frameIndex).descriptorInfo();
+            auto shadowAtlasInfo = m_shadowRenderSystem.getImageInfo();
+            DescriptorWriter(*m_globalSetLayout, *m_framePools[frameIndex])
+                .writeBuffer(0, &uboInfo)
+                .writeBuffer(2, &lightInfo)
+                .writeBuffer(3, &clusterRangeInfo)
+                .writeBuffer(4, &clusterIndexInfo)
+                .writeBuffer(5, &shadowMapInfo)
+                .writeImage(6, &shadowAtlasInfo)
+                .build(frameInfo.globalDescriptorSet);
+            m_lightClusterRenderSystem.render(frameInfo);
+            m_shadowRenderSystem.render(frameInfo);
+            m_pipelineStatistics.reset(commandBuffer, frameIndex);
+            const bool gpuCulling = m_gui.useGpuCulling() && m_device.hasDrawIndirectCount();
+            // the deferred render pass has no meshlet G-buffer pipeline and cannot be split for the HiZ build, both stay forward only
+            const bool deferred = m_gui.useDeferredShading();
+            // the meshlets are culled against the frustum and their normal cone only, the HiZ pyramid is not used on this path
+            const bool meshlets = gpuCulling && !deferred && m_gui.useMeshletRendering();
+            const bool occlusion = gpuCulling && !deferred && !meshlets && m_gui.useOcclusionCulling();
+            // depth only draws first, the lit draws then shade one fragment per pixel
+            const bool depthPrepass = !deferred && !meshlets && m_gui.useDepthPrepass();
+            const IndirectRenderSystem& indirectRenderSystem = depthPrepass ? m_equalIndirectRenderSystem : m_indirectRenderSystem;
+            const ObjectRenderSystem& objectRenderSystem = depthPrepass ? m_equalObjectRenderSystem : m_objectRenderSystem;
+            if (meshlets) {
+                m_meshletCullingRenderSystem.prepare(frameInfo);
+                m_meshletCullingRenderSystem.render(frameInfo);
+            } else if (gpuCulling) {
+                // the pyramid holds the depth of the previous frame, reprojected with prevViewProjection
+                hizValid = !m_hizRenderSystem.prepare(frameInfo, m_renderer.getSwapChainExtent(), m_renderer.getCurrentDepthImage(), m_renderer.getCurrentDepthImageView(), m_renderer.getSwapChainDepthFormat()) && hizValid;
+                m_cullingRenderSystem.setOcclusion(occlusion && hizValid, occlusion);
+                m_cullingRenderSystem.prepare(frameInfo);
+                m_cullingRenderSystem.render(frameInfo);
+            } else {
+                ObjectRenderSystem::prepare(frameInfo);
+            }
+            if (deferred) {
+                // the G-buffer stays in the pass, the light billboards and the GUI are drawn forward once it is shaded
+                m_renderer.beginDeferredRenderPass(frameInfo.commandBuffer);
+                if (gpuCulling) {
+                    m_gBufferIndirectRenderSystem.render(frameInfo);
+                } else {
+                    m_gBufferObjectRenderSystem.render(frameInfo);
+                }
+                m_renderer.nextSubpass(frameInfo.commandBuffer);
+                m_deferredLightingRenderSystem.setAttachments({
+                    m_renderer.getCurrentGBufferImageView(GBUFFER_ALBEDO),
+                    m_renderer.getCurrentGBufferImageView(GBUFFER_NORMAL),
+                    m_renderer.getCurrentGBufferImageView(GBUFFER_MATERIAL)
+                }, m_renderer.getCurrentDepthImageView());
+                m_deferredLightingRenderSystem.render(frameInfo);
+                m_renderer.endSwapChainRenderPass(commandBuffer);
+                m_renderer.resumeSwapChainRenderPass(commandBuffer);
+                // the G-buffer has no blended class, it is shaded forward over the result
+                if (gpuCulling) {
+                    m_blendIndirectRenderSystem.render(frameInfo);
+                } else {
+                    m_blendObjectRenderSystem.render(frameInfo);
+                }
+            } else {
+                m_renderer.beginSwapChainRenderPass(frameInfo.commandBuffer);
+                if (depthPrepass) {
+                    m_pipelineStatistics.begin(commandBuffer, frameIndex, PipelineStatistics::DEPTH_PREPASS);
+                    if (gpuCulling) {
+                        m_depthIndirectRenderSystem.render(frameInfo);
+                    } else {
+                        m_depthObjectRenderSystem.render(frameInfo);
+                    }
+                    m_pipelineStatistics.end(commandBuffer, frameIndex, PipelineStatistics::DEPTH_PREPASS);
+                }
+                m_pipelineStatistics.begin(commandBuffer, frameIndex, PipelineStatistics::LIT);
+                if (meshlets) {
+                    m_meshletRenderSystem.render(frameInfo);
+                } else if (gpuCulling) {
+                    indirectRenderSystem.render(frameInfo);
+                } else {
+                    objectRenderSystem.render(frameInfo);
+                }
+                m_pipelineStatistics.end(commandBuffer, frameIndex, PipelineStatistics::LIT);
+            }
+            if (occlusion) {
+                // build the pyramid from the early draws, retest what the previous frame pyramid rejected and draw what became visible
+                m_renderer.endSwapChainRenderPass(commandBuffer);
+                m_hizRenderSystem.render(frameInfo);
+                if (hizValid) {
+                    m_cullingRenderSystem.renderLate(frameInfo);
+                }
+                m_renderer.resumeSwapChainRenderPass(commandBuffer);
+                if (hizValid && depthPrepass) {
+                    m_depthIndirectRenderSystem.render(frameInfo);
+                }
+                if (hizValid) {
+                    indirectRenderSystem.render(frameInfo);
+                }
+            }
+            hizValid = occlusion;
+            prevViewProjection = ubo.projection * ubo.view;
+            m_pointLightRenderSystem.prepare(frameInfo);
+            m_pointLightRenderSystem.render(frameInfo);
 
             if (m_gui.getState() != HIDDEN) {
                 m_gui.render(
                     &m_renderer,
                     m_sceneManager,
                     m_camera,
+                    m_culler,
+                    m_occlusionCuller,
+                    m_lodSelector,
+                    m_pipelineStatistics,
                     m_device.getPhysicalDevice(),
                     ubo,
                     { .deltaTimeMS=clock.getDeltaTimeMS(), .fps=clock.getFPS() }
@@ -130,6 +283,20 @@ void ven::Engine::run()
             vkDeviceWaitIdle(m_device.device());
             m_sceneManager.destroyEntity(m_gui.getObjectsToRemove(), m_gui.getLightsToRemove());
         }
+        if (!m_sceneManager.getPendingLoad().empty()) {
+            const std::string scenePath = m_sceneManager.getPendingLoad();
+            m_sceneManager.setPendingLoad({});
+            vkDeviceWaitIdle(m_device.device());
+            try {
+                Logger::logExecutionTime("Loading scene " + scenePath, [&] {
+                    m_sceneManager.load(scenePath, &m_threadPool);
+                });
+            } catch (const std::runtime_error& error) {
+                Logger::logWarning("Failed to load scene " + scenePath + ": " + error.what());
+            }
+        }
     }
+    // a variant still compiling would outlive the render passes and the layouts it was queued with
+    m_device.getPipelineThreadPool().waitIdle();
     vkDeviceWaitIdle(m_device.device());
 }
@@ -1,14 +1,15 @@
-#include <memory>
-
 #include "VEngine/Factories/Light.hpp"
 
-unsigned int ven::LightFactory::m_currentLightId = 0;
+ven::Handle ven::LightFactory::create(LightStore& lights, const Transform3D &transform, const glm::vec4 color, const uint8_t flags)
+{
+    return lights.create(transform, color, DEFAULT_SHININESS, "point light", SceneGraph::NONE, flags);
+}
 
-std::unique_ptr<ven::Light> ven::LightFactory::create(const Transform3D &transform, const glm::vec4 color)
+ven::Handle ven::LightFactory::duplicate(LightStore& lights, const Handle cpyLight)
 {
-    assert(m_currentLightId < MAX_LIGHTS && "Max light count exceeded!");
-    auto light = std::make_unique<Light>(++m_currentLightId);
-    light->color = color;
-    light->transform = transform;
-    return light;
+    const uint32_t index = lights.indexOf(cpyLight);
+    const Transform3D transform = lights.transforms()[index];
+    const glm::vec4 color = lights.colors()[index];
+    const float shininess = lights.shininess()[index];
+    return lights.create(transform, color, shininess, lights.names()[index], lights.getParent(index), lights.flags()[index]);
 }
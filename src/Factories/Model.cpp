@@ -3,14 +3,57 @@
 #include "VEngine/Factories/Model.hpp"
 #include "VEngine/Utils/Logger.hpp"
 
-std::unique_ptr<ven::Model> ven::ModelFactory::get(const Device& device, const std::string& filepath)
+namespace {
+
+    // the level of detail chain and the triangle order the GPU buffers and the PVS content hash are built from
+    void processGeometry(ven::Model::Builder& builder, const std::string& filepath, ven::ThreadPool* threadPool)
+    {
+        ven::Logger::logExecutionTime("Generating LODs " + filepath, [&] {
+            builder.generateLods({}, threadPool);
+        });
+        ven::MeshOptimizationStats stats;
+        ven::Logger::logExecutionTime("Optimizing meshes " + filepath, [&] {
+            stats = builder.optimizeMeshes();
+        });
+        ven::Logger::logInfo(filepath + " ACMR " + std::to_string(stats.before.acmr) + " -> " + std::to_string(stats.after.acmr) + ", ATVR " + std::to_string(stats.before.atvr) + " -> " + std::to_string(stats.after.atvr));
+    }
+
+} // namespace
+
+std::unique_ptr<ven::Model> ven::ModelFactory::get(const Device& device, const std::string& filepath, ThreadPool* threadPool)
 {
     Model::Builder builder{};
     builder.loadModel(device, filepath);
-    return std::make_unique<Model>(device, builder);
+    processGeometry(builder, filepath, threadPool);
+    Logger::logExecutionTime("Building meshlets " + filepath, [&] {
+        builder.generateMeshlets();
+    });
+    auto model = std::make_unique<Model>(device, builder);
+    const std::string pvsPath = filepath + std::string(PVS_EXTENSION);
+    Pvs pvs;
+
+    if (!pvs.load(pvsPath, model->getContentHash()) && std::filesystem::exists(pvsPath)) {
+        Logger::logWarning("Ignoring stale PVS " + pvsPath + ", run with --bake-pvs to rebuild it");
+    }
+    model->setPvs(std::move(pvs));
+    model->setFilepath(filepath);
+    return model;
+}
+
+void ven::ModelFactory::bakePvs(const std::string& filepath, ThreadPool* threadPool)
+{
+    Model::Builder builder{};
+    builder.loadGeometry(filepath);
+    processGeometry(builder, filepath, threadPool);
+    const std::string pvsPath = filepath + std::string(PVS_EXTENSION);
+    Logger::logExecutionTime("Baking PVS " + pvsPath, [&] {
+        const std::vector<glm::vec3> positions = builder.getPositions();
+        const std::vector<PvsMeshRange> meshes = builder.getMeshRanges();
+        Pvs::bake(positions, builder.getBaseIndices(), meshes, Pvs::hashContent(positions, builder.getBaseIndices(), meshes), {}, threadPool).save(pvsPath);
+    });
 }
 
-std::unordered_map<std::string, std::shared_ptr<ven::Model>> ven::ModelFactory::getAll(const Device& device, const std::string& folderPath)
+std::unordered_map<std::string, std::shared_ptr<ven::Model>> ven::ModelFactory::getAll(const Device& device, const std::string& folderPath, ThreadPool* threadPool)
 {
     std::unordered_map<std::string, std::shared_ptr<Model>> modelCache;
 
@@ -18,7 +61,7 @@ std::unordered_map<std::string, std::shared_ptr<ven::Model>> ven::ModelFactory::
         if (entry.is_regular_file()) {
             Logger::logExecutionTime("Creating model " + entry.path().string(), [&]() {
                 const std::string &filepath = entry.path().string();
-                modelCache[filepath] = get(device, filepath);
+                modelCache[filepath] = get(device, filepath, threadPool);
             });
         } else {
             Logger::logWarning("Skipping non-regular file " + entry.path().string());
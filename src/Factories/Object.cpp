@@ -1,14 +1,18 @@
 #include "VEngine/Factories/Object.hpp"
 
-unsigned int ven::ObjectFactory::m_currentObjId = 0;
+ven::Handle ven::ObjectFactory::create(ObjectStore& objects, const std::shared_ptr<Texture>& texture, const std::shared_ptr<Model>& model, const std::string &name, const Transform3D &transform)
+{
+    return objects.create(model, texture, name, transform);
+}
 
-std::unique_ptr<ven::Object> ven::ObjectFactory::create(const std::shared_ptr<Texture>& texture, const std::shared_ptr<Model>& model, const std::string &name, const Transform3D &transform)
+ven::Handle ven::ObjectFactory::duplicate(ObjectStore& objects, const Handle objSrc)
 {
-    assert(m_currentObjId < MAX_OBJECTS && "Max object count exceeded!");
-    auto object = std::make_unique<Object>(++m_currentObjId);
-    object->setDiffuseMap(texture);
-    object->setModel(model);
-    object->setName(name);
-    object->transform = transform;
-    return object;
+    // copies first, inserting may reallocate the columns
+    const uint32_t index = objects.indexOf(objSrc);
+    const Transform3D transform = objects.transforms()[index];
+    const std::shared_ptr<Model> model = objects.models()[index];
+    const std::shared_ptr<Texture> texture = objects.diffuseMaps()[index];
+    const std::string name = objects.names()[index];
+    const bool occluder = objects.occluders()[index] != 0;
+    return objects.create(model, texture, name, transform, occluder, objects.getParent(index));
 }
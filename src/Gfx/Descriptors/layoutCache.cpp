@@ -0,0 +1,55 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include "VEngine/Gfx/Descriptors/LayoutCache.hpp"
+
+ven::DescriptorLayoutCache::~DescriptorLayoutCache()
+{
+    for (const auto& [key, pipelineLayout] : m_pipelineLayouts) {
+        vkDestroyPipelineLayout(m_device.device(), pipelineLayout, nullptr);
+    }
+}
+
+std::shared_ptr<ven::DescriptorSetLayout> ven::DescriptorLayoutCache::getSetLayout(const std::vector<VkDescriptorSetLayoutBinding>& bindings)
+{
+    std::vector<BindingKey> key;
+    key.reserve(bindings.size());
+    for (const VkDescriptorSetLayoutBinding& binding : bindings) {
+        key.push_back({ .binding = binding.binding, .descriptorType = binding.descriptorType, .count = binding.descriptorCount, .stageFlags = binding.stageFlags });
+    }
+    std::ranges::sort(key);
+
+    std::shared_ptr<DescriptorSetLayout>& setLayout = m_setLayouts[key];
+    if (setLayout == nullptr) {
+        DescriptorSetLayout::Builder builder(m_device);
+        for (const BindingKey& binding : key) {
+            builder.addBinding(binding.binding, binding.descriptorType, binding.stageFlags, binding.count);
+        }
+        setLayout = builder.build();
+    }
+    return setLayout;
+}
+
+VkPipelineLayout ven::DescriptorLayoutCache::getPipelineLayout(const std::vector<VkDescriptorSetLayout>& setLayouts, const VkPushConstantRange& pushConstantRange)
+{
+    const bool hasPushConstants = pushConstantRange.size > 0;
+    VkPipelineLayout& pipelineLayout = m_pipelineLayouts[{
+        .setLayouts = setLayouts,
+        .pushConstantStages = hasPushConstants ? pushConstantRange.stageFlags : 0,
+        .pushConstantSize = pushConstantRange.size
+    }];
+    if (pipelineLayout != nullptr) {
+        return pipelineLayout;
+    }
+
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(setLayouts.size());
+    pipelineLayoutInfo.pSetLayouts = setLayouts.data();
+    pipelineLayoutInfo.pushConstantRangeCount = hasPushConstants ? 1 : 0;
+    pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+    if (vkCreatePipelineLayout(m_device.device(), &pipelineLayoutInfo, nullptr, &pipelineLayout) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create pipeline layout");
+    }
+    return pipelineLayout;
+}
@@ -4,7 +4,7 @@
 
 ven::DescriptorWriter &ven::DescriptorWriter::writeBuffer(const uint32_t binding, const VkDescriptorBufferInfo *bufferInfo)
 {
-    assert(m_setLayout.m_bindings.count(binding) == 1 && "Layout does not contain specified binding");
+    if (!m_setLayout.m_bindings.contains(binding)) { return *this; }
 
     const auto &bindingDescription = m_setLayout.m_bindings.at(binding);
 
@@ -23,7 +23,7 @@ ven::DescriptorWriter &ven::DescriptorWriter::writeBuffer(const uint32_t binding
 
 ven::DescriptorWriter &ven::DescriptorWriter::writeImage(const uint32_t binding, const VkDescriptorImageInfo *imageInfo)
 {
-    assert(m_setLayout.m_bindings.count(binding) == 1 && "Layout does not contain specified binding");
+    if (!m_setLayout.m_bindings.contains(binding)) { return *this; }
 
     const VkDescriptorSetLayoutBinding &bindingDescription = m_setLayout.m_bindings.at(binding);
 
@@ -41,7 +41,7 @@ ven::DescriptorWriter &ven::DescriptorWriter::writeImage(const uint32_t binding,
 }
 
 ven::DescriptorWriter &ven::DescriptorWriter::writeImages(const uint32_t binding, const std::vector<VkDescriptorImageInfo> &imageInfos) {
-    assert(m_setLayout.m_bindings.count(binding) == 1 && "Layout does not contain specified binding");
+    if (!m_setLayout.m_bindings.contains(binding)) { return *this; }
 
     const VkDescriptorSetLayoutBinding &bindingDescription = m_setLayout.m_bindings.at(binding);
 
@@ -0,0 +1,17 @@
+#include "VEngine/Gfx/AlphaMode.hpp"
+
+ven::ALPHA_MODE ven::classifyAlpha(const std::span<const uint8_t> rgba)
+{
+    std::size_t holes = 0;
+    std::size_t partial = 0;
+    for (std::size_t i = 3; i < rgba.size(); i += 4) {
+        if (rgba[i] >= ALPHA_OPAQUE_MIN) { continue; }
+        if (rgba[i] <= ALPHA_TRANSPARENT_MAX) {
+            holes++;
+        } else {
+            partial++;
+        }
+    }
+    if (holes + partial == 0) { return ALPHA_OPAQUE; }
+    return static_cast<float>(partial) >= ALPHA_BLEND_MIN_PARTIAL_RATIO * static_cast<float>(holes + partial) ? ALPHA_BLEND : ALPHA_CUTOUT;
+}
@@ -8,6 +8,16 @@ ven::Buffer::Buffer(const Device &device, const VkDeviceSize instanceSize, const
     device.createBuffer(m_bufferSize, m_usageFlags, m_memoryPropertyFlags, m_buffer, m_memory);
 }
 
+bool ven::Buffer::reserve(std::unique_ptr<Buffer>& buffer, const Device& device, const VkDeviceSize instanceSize, const uint32_t instanceCount, const VkBufferUsageFlags usageFlags, const VkMemoryPropertyFlags memoryPropertyFlags, const VkDeviceSize minOffsetAlignment)
+{
+    if (buffer && buffer->getInstanceCount() >= instanceCount) { return false; }
+    buffer = std::make_unique<Buffer>(device, instanceSize, growCapacity(buffer ? buffer->getInstanceCount() : 0, instanceCount), usageFlags, memoryPropertyFlags, minOffsetAlignment);
+    if ((memoryPropertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0) {
+        buffer->map();
+    }
+    return true;
+}
+
 ven::Buffer::~Buffer()
 {
     unmap();
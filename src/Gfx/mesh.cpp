@@ -14,3 +14,16 @@ std::vector<VkVertexInputAttributeDescription> ven::Vertex::getAttributeDescript
         {.location=3, .binding=0, .format=VK_FORMAT_R32G32_SFLOAT, .offset=offsetof(Vertex, uv)}
     };
 }
+
+std::vector<VkVertexInputBindingDescription> ven::DepthVertex::getBindingDescriptions()
+{
+    return {{.binding=0, .stride=sizeof(DepthVertex), .inputRate=VK_VERTEX_INPUT_RATE_VERTEX}};
+}
+
+std::vector<VkVertexInputAttributeDescription> ven::DepthVertex::getAttributeDescriptions()
+{
+    return {
+        {.location=0, .binding=0, .format=VK_FORMAT_R32G32B32_SFLOAT, .offset=offsetof(DepthVertex, position)},
+        {.location=1, .binding=0, .format=VK_FORMAT_R32G32_SFLOAT, .offset=offsetof(DepthVertex, uv)}
+    };
+}
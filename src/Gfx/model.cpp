@@ -1,6 +1,8 @@
+#include <algorithm>
 #include <iostream>
 #include <filesystem>
 
+#include <assimp/GltfMaterial.h>
 #include <assimp/Importer.hpp>
 #include <assimp/postprocess.h>
 
@@ -19,10 +21,37 @@ struct std::hash<ven::Vertex> {
     }
 };
 
-ven::Model::Model(const Device &device, const Builder &builder) : m_device{device}, m_vertexCount(0), m_indexCount(0), m_textures(builder.textures), m_meshes(builder.meshes)
+ven::Model::Model(const Device &device, const Builder &builder) : m_device{device}, m_vertexCount(0), m_indexCount(0), m_textures(builder.textures), m_meshes(builder.meshes), m_lods(builder.lods)
 {
     createVertexBuffer(builder.vertices);
+    createDepthVertexBuffer(builder.vertices);
     createIndexBuffer(builder.indices);
+    createMeshletBuffers(builder.meshlets);
+    // the buffer also holds the simplified levels, draws of the whole model only use the full detail range
+    m_indexCount = static_cast<uint32_t>(builder.getBaseIndices().size());
+
+    for (const Vertex& vertex : builder.vertices) {
+        m_aabb.expand(vertex.position);
+    }
+    m_sphere.center = m_aabb.center();
+    for (const Vertex& vertex : builder.vertices) {
+        m_sphere.radius = std::max(m_sphere.radius, distance(m_sphere.center, vertex.position));
+    }
+
+    m_contentHash = Pvs::hashContent(builder.getPositions(), builder.getBaseIndices(), builder.getMeshRanges());
+
+    // keep a CPU copy of the large meshes (walls, floors) for the software occlusion culling
+    const glm::vec3 modelExtent = m_aabb.extent();
+    const float minOccluderExtent = std::max({modelExtent.x, modelExtent.y, modelExtent.z}) * OCCLUDER_MIN_EXTENT_RATIO;
+    for (Mesh& mesh : m_meshes) {
+        std::array<float, 3> meshExtent{mesh.aabb.extent().x, mesh.aabb.extent().y, mesh.aabb.extent().z};
+        std::ranges::sort(meshExtent);
+        mesh.occluder = !builder.indices.empty() && meshExtent[1] >= minOccluderExtent;
+        if (!mesh.occluder) { continue; }
+        for (uint32_t i = mesh.firstIndex; i < mesh.firstIndex + mesh.indexCount; i++) {
+            m_occluderTriangles.push_back(builder.vertices[builder.indices[i]].position);
+        }
+    }
 }
 
 void ven::Model::createVertexBuffer(const std::vector<Vertex> &vertices)
@@ -36,11 +65,29 @@ void ven::Model::createVertexBuffer(const std::vector<Vertex> &vertices)
     stagingBuffer.map();
     stagingBuffer.writeToBuffer(vertices.data());
 
-    m_vertexBuffer = std::make_unique<Buffer>(m_device, vertexSize, m_vertexCount, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    // also read as floats by the mesh shader
+    m_vertexBuffer = std::make_unique<Buffer>(m_device, vertexSize, m_vertexCount, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 
     m_device.copyBuffer(stagingBuffer.getBuffer(), m_vertexBuffer->getBuffer(), vertexSize * m_vertexCount);
 }
 
+void ven::Model::createDepthVertexBuffer(const std::vector<Vertex> &vertices)
+{
+    // 20 bytes per vertex instead of 44, the pre-pass only fetches what the depth and the alpha test need
+    std::vector<DepthVertex> depthVertices(vertices.size());
+    std::ranges::transform(vertices, depthVertices.begin(), [](const Vertex& vertex) { return DepthVertex{.position = vertex.position, .uv = vertex.uv}; });
+    constexpr unsigned long vertexSize = sizeof(DepthVertex);
+
+    Buffer stagingBuffer{m_device, vertexSize, m_vertexCount, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT};
+
+    stagingBuffer.map();
+    stagingBuffer.writeToBuffer(depthVertices.data());
+
+    m_depthVertexBuffer = std::make_unique<Buffer>(m_device, vertexSize, m_vertexCount, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+    m_device.copyBuffer(stagingBuffer.getBuffer(), m_depthVertexBuffer->getBuffer(), vertexSize * m_vertexCount);
+}
+
 void ven::Model::createIndexBuffer(const std::vector<uint32_t> &indices)
 {
     m_indexCount = static_cast<uint32_t>(indices.size());
@@ -62,20 +109,48 @@ void ven::Model::createIndexBuffer(const std::vector<uint32_t> &indices)
     m_device.copyBuffer(stagingBuffer.getBuffer(), m_indexBuffer->getBuffer(), indexSize * m_indexCount);
 }
 
-void ven::Model::draw(const VkCommandBuffer commandBuffer) const
+void ven::Model::createMeshletBuffers(const MeshletData& meshlets)
 {
-    if (m_hasIndexBuffer) {
+    m_meshletCount = static_cast<uint32_t>(meshlets.meshlets.size());
+    if (m_meshletCount == 0) {
+        return;
+    }
+    m_meshletBuffer = createStorageBuffer(meshlets.meshlets.data(), sizeof(Meshlet), m_meshletCount);
+    m_meshletVertexBuffer = createStorageBuffer(meshlets.vertices.data(), sizeof(uint32_t), static_cast<uint32_t>(meshlets.vertices.size()));
+    m_meshletTriangleBuffer = createStorageBuffer(meshlets.triangles.data(), sizeof(uint32_t), static_cast<uint32_t>(meshlets.triangles.size()));
+}
+
+std::unique_ptr<ven::Buffer> ven::Model::createStorageBuffer(const void* data, const VkDeviceSize instanceSize, const uint32_t instanceCount) const
+{
+    Buffer stagingBuffer{m_device, instanceSize, instanceCount, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT};
+
+    stagingBuffer.map();
+    stagingBuffer.writeToBuffer(data);
+
+    auto buffer = std::make_unique<Buffer>(m_device, instanceSize, instanceCount, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+    m_device.copyBuffer(stagingBuffer.getBuffer(), buffer->getBuffer(), instanceSize * instanceCount);
+    return buffer;
+}
+
+void ven::Model::draw(const VkCommandBuffer commandBuffer, const uint8_t lod) const
+{
+    if (m_hasIndexBuffer && lod > 0 && lod < m_lods.size()) {
+        vkCmdDrawIndexed(commandBuffer, m_lods[lod].indexCount, 1, m_lods[lod].firstIndex, 0, 0);
+    } else if (m_hasIndexBuffer) {
         vkCmdDrawIndexed(commandBuffer, m_indexCount, 1, 0, 0, 0);
     } else {
         vkCmdDraw(commandBuffer, m_vertexCount, 1, 0, 0);
     }
 }
 
-void ven::Model::drawMesh(const VkCommandBuffer commandBuffer, const Mesh& mesh) const {
-    if (m_hasIndexBuffer) {
-        vkCmdDrawIndexed(commandBuffer, static_cast<uint32_t>(mesh.indices.size()), 1, 0, 0, 0);
+void ven::Model::drawMesh(const VkCommandBuffer commandBuffer, const Mesh& mesh, const uint8_t lod) const {
+    if (m_hasIndexBuffer && lod > 0 && lod < mesh.lods.size()) {
+        vkCmdDrawIndexed(commandBuffer, mesh.lods[lod].indexCount, 1, mesh.lods[lod].firstIndex, 0, 0);
+    } else if (m_hasIndexBuffer) {
+        vkCmdDrawIndexed(commandBuffer, mesh.indexCount, 1, mesh.firstIndex, 0, 0);
     } else {
-        vkCmdDraw(commandBuffer, static_cast<uint32_t>(mesh.vertices.size()), 1, 0, 0);
+        vkCmdDraw(commandBuffer, mesh.indexCount, 1, mesh.firstIndex, 0);
     }
 }
 
@@ -90,6 +165,17 @@ void ven::Model::bind(const VkCommandBuffer commandBuffer) const
     }
 }
 
+void ven::Model::bindDepth(const VkCommandBuffer commandBuffer) const
+{
+    const std::array buffers{m_depthVertexBuffer->getBuffer()};
+    constexpr std::array<VkDeviceSize, 1> offsets{0};
+    vkCmdBindVertexBuffers(commandBuffer, 0, 1, buffers.data(), offsets.data());
+
+    if (m_hasIndexBuffer) {
+        vkCmdBindIndexBuffer(commandBuffer, m_indexBuffer->getBuffer(), 0, VK_INDEX_TYPE_UINT32);
+    }
+}
+
 void ven::Model::bindMesh(const VkCommandBuffer commandBuffer, const Mesh& mesh) const
 {
     const std::array buffers{m_vertexBuffer->getBuffer()};
@@ -101,7 +187,7 @@ void ven::Model::bindMesh(const VkCommandBuffer commandBuffer, const Mesh& mesh)
     }
 }
 
-void ven::Model::Builder::loadModel(const Device& device, const std::string &filename)
+void ven::Model::Builder::load(const Device* device, const std::string &filename)
 {
     Assimp::Importer importer;
 
@@ -113,11 +199,14 @@ void ven::Model::Builder::loadModel(const Device& device, const std::string &fil
 
     vertices.clear();
     indices.clear();
+    meshes.clear();
+    lods.clear();
+    meshlets = {};
 
     processNode(device, scene->mRootNode, scene);
 }
 
-void ven::Model::Builder::processNode(const Device& device, const aiNode* node, const aiScene* scene) {
+void ven::Model::Builder::processNode(const Device* device, const aiNode* node, const aiScene* scene) {
     for (unsigned int i = 0; i < node->mNumMeshes; i++) {
         const aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
         processMesh(mesh);
@@ -129,20 +218,20 @@ void ven::Model::Builder::processNode(const Device& device, const aiNode* node,
     }
 }
 
-void loadMaterialTextures(const ven::Device& device, const aiMaterial* material, const aiTextureType type, aiString &texturePath, std::unordered_map<std::string, std::shared_ptr<ven::Texture>>& textures, std::vector<std::shared_ptr<ven::Texture>>& meshTextures) {
+void loadMaterialTextures(const ven::Device* device, const aiMaterial* material, const aiTextureType type, aiString &texturePath, std::unordered_map<std::string, std::shared_ptr<ven::Texture>>& textures, std::vector<std::shared_ptr<ven::Texture>>& meshTextures) {
 
-    if (material->GetTexture(type, 0, &texturePath) == aiReturn_SUCCESS) {
+    if (device != nullptr && material->GetTexture(type, 0, &texturePath) == aiReturn_SUCCESS) {
         const std::string fullPath = std::filesystem::absolute(ven::MODEL_PATH.data() + std::string(texturePath.C_Str())).string();
 
         if (!textures.contains(fullPath)) {
             std::cout << "Loading texture: " << fullPath << '\n';
-            textures[fullPath] = std::make_shared<ven::Texture>(device, fullPath);
+            textures[fullPath] = std::make_shared<ven::Texture>(*device, fullPath);
         }
         meshTextures.push_back(textures[fullPath]);
     }
 }
 
-void ven::Model::Builder::processMaterial(const Device &device, const aiMesh *mesh, const aiScene *scene)
+void ven::Model::Builder::processMaterial(const Device* device, const aiMesh *mesh, const aiScene *scene)
 {
     Material meshMaterial{};
 
@@ -174,9 +263,19 @@ void ven::Model::Builder::processMaterial(const Device &device, const aiMesh *me
         // loadMaterialTextures(device, material, aiTextureType_MAYA_BASE, texturePath, textures, meshMaterial);
         // loadMaterialTextures(device, material, aiTextureType_MAYA_SPECULAR, texturePath, textures, meshMaterial);
         // loadMaterialTextures(device, material, aiTextureType_MAYA_SPECULAR_COLOR, texturePath, textures, meshMaterial);
+
+        // the diffuse alpha is what the shaders read, a glTF material may still state its mode explicitly
+        if (!meshMaterial.diffuseTextures.empty()) {
+            meshMaterial.alphaMode = meshMaterial.diffuseTextures[0]->getAlphaMode();
+        }
+        aiString alphaMode;
+        if (material->Get(AI_MATKEY_GLTF_ALPHAMODE, alphaMode) == aiReturn_SUCCESS) {
+            const std::string_view mode = alphaMode.C_Str();
+            meshMaterial.alphaMode = mode == "BLEND" ? ALPHA_BLEND : mode == "MASK" ? ALPHA_CUTOUT : ALPHA_OPAQUE;
+        }
     }
 
-    meshes.push_back({ .vertices = vertices, .indices = indices, .material = meshMaterial });
+    meshes.back().material = meshMaterial;
 
     /**
 for (const auto& mesh: meshes) {
@@ -194,6 +293,7 @@ for (const auto& mesh: meshes) {
 void ven::Model::Builder::processMesh(const aiMesh* mesh)
 {
     std::unordered_map<Vertex, uint32_t> uniqueVertices;
+    Mesh subMesh{ .firstIndex = static_cast<uint32_t>(indices.size()) };
 
     for (unsigned int i = 0; i < mesh->mNumVertices; i++) {
         Vertex vertex{};
@@ -226,7 +326,70 @@ void ven::Model::Builder::processMesh(const aiMesh* mesh)
         }
 
         indices.push_back(uniqueVertices[vertex]);
+        subMesh.aabb.expand(vertex.position);
+    }
+
+    subMesh.indexCount = static_cast<uint32_t>(indices.size()) - subMesh.firstIndex;
+    subMesh.sphere.center = subMesh.aabb.center();
+    for (uint32_t i = subMesh.firstIndex; i < subMesh.firstIndex + subMesh.indexCount; i++) {
+        subMesh.sphere.radius = std::max(subMesh.sphere.radius, distance(subMesh.sphere.center, vertices[indices[i]].position));
     }
+    meshes.push_back(subMesh);
 }
 
+std::vector<glm::vec3> ven::Model::Builder::getPositions() const
+{
+    std::vector<glm::vec3> positions(vertices.size());
+    std::ranges::transform(vertices, positions.begin(), [](const Vertex& vertex) { return vertex.position; });
+    return positions;
+}
 
+std::vector<ven::PvsMeshRange> ven::Model::Builder::getMeshRanges() const
+{
+    std::vector<PvsMeshRange> ranges(meshes.size());
+    std::ranges::transform(meshes, ranges.begin(), [](const Mesh& mesh) { return PvsMeshRange{ .firstIndex = mesh.firstIndex, .indexCount = mesh.indexCount }; });
+    return ranges;
+}
+
+void ven::Model::Builder::generateLods(const LodSettings& settings, ThreadPool* threadPool)
+{
+    const std::vector<PvsMeshRange> ranges = getMeshRanges();
+    LodChain chain = MeshSimplifier::buildChain(getPositions(), indices, ranges, settings, threadPool);
+    for (std::size_t i = 0; i < meshes.size(); i++) {
+        meshes[i].lods = std::move(chain.meshes[i]);
+    }
+    lods = std::move(chain.levels);
+}
+
+ven::MeshOptimizationStats ven::Model::Builder::optimizeMeshes()
+{
+    const std::vector<glm::vec3> positions = getPositions();
+    const VertexCacheStats before = MeshOptimizer::analyzeVertexCache(getBaseIndices());
+    for (const Mesh& mesh : meshes) {
+        const std::span<uint32_t> base = std::span(indices).subspan(mesh.firstIndex, mesh.indexCount);
+        MeshOptimizer::optimizeVertexCache(base);
+        MeshOptimizer::optimizeOverdraw(base, positions);
+        // distant levels cover few pixels, only their cache order matters
+        for (std::size_t level = 1; level < mesh.lods.size(); level++) {
+            MeshOptimizer::optimizeVertexCache(std::span(indices).subspan(mesh.lods[level].firstIndex, mesh.lods[level].indexCount));
+        }
+    }
+
+    const std::vector<uint32_t> remap = MeshOptimizer::optimizeVertexFetch(indices, vertices.size());
+    std::vector<Vertex> reordered(vertices.size());
+    for (std::size_t i = 0; i < vertices.size(); i++) {
+        reordered[remap[i]] = vertices[i];
+    }
+    vertices = std::move(reordered);
+    return { .before = before, .after = MeshOptimizer::analyzeVertexCache(getBaseIndices()) };
+}
+
+void ven::Model::Builder::generateMeshlets()
+{
+    const std::vector<glm::vec3> positions = getPositions();
+    meshlets = {};
+    for (Mesh& mesh : meshes) {
+        mesh.firstMeshlet = static_cast<uint32_t>(meshlets.meshlets.size());
+        mesh.meshletCount = MeshletBuilder::build(positions, std::span(indices).subspan(mesh.firstIndex, mesh.indexCount), meshlets);
+    }
+}
@@ -0,0 +1,104 @@
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+#include "VEngine/Gfx/PipelineCacheFile.hpp"
+#include "VEngine/Utils/HashCombine.hpp"
+
+namespace {
+
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        ven::PipelineCacheIdentity identity;
+        uint32_t padding;
+        uint64_t dataSize;
+        uint64_t dataHash;
+    };
+    static_assert(sizeof(Header) == 56);
+
+    // VkPipelineCacheHeaderVersionOne, at the start of every vkGetPipelineCacheData blob
+    struct VulkanHeader {
+        uint32_t headerSize;
+        uint32_t headerVersion;
+        uint32_t vendorID;
+        uint32_t deviceID;
+        std::array<uint8_t, ven::PIPELINE_CACHE_UUID_SIZE> uuid;
+    };
+    static_assert(sizeof(VulkanHeader) == 32);
+
+    constexpr uint32_t VULKAN_HEADER_VERSION_ONE = 1; // VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+
+} // namespace
+
+std::vector<uint8_t> ven::PipelineCacheFile::pack(const PipelineCacheIdentity& identity, const std::span<const uint8_t> data)
+{
+    const Header header{
+        .magic = FILE_MAGIC,
+        .version = FILE_VERSION,
+        .identity = identity,
+        .padding = 0,
+        .dataSize = data.size(),
+        .dataHash = fnv1a(data.data(), data.size())
+    };
+    std::vector<uint8_t> file(sizeof(Header) + data.size());
+    std::memcpy(file.data(), &header, sizeof(Header));
+    if (!data.empty()) {
+        std::memcpy(file.data() + sizeof(Header), data.data(), data.size());
+    }
+    return file;
+}
+
+std::optional<std::span<const uint8_t>> ven::PipelineCacheFile::unpack(const PipelineCacheIdentity& identity, const std::span<const uint8_t> file)
+{
+    Header header{};
+    if (file.size() < sizeof(Header)) { return std::nullopt; }
+    std::memcpy(&header, file.data(), sizeof(Header));
+    const std::span<const uint8_t> data = file.subspan(sizeof(Header));
+    if (header.magic != FILE_MAGIC || header.version != FILE_VERSION || header.identity != identity || header.dataSize != data.size()) {
+        return std::nullopt;
+    }
+    if (header.dataHash != fnv1a(data.data(), data.size())) { return std::nullopt; }
+
+    // the driver checks it as well, a mismatch there would only cost the whole cache silently
+    VulkanHeader vulkanHeader{};
+    if (data.size() < sizeof(VulkanHeader)) { return std::nullopt; }
+    std::memcpy(&vulkanHeader, data.data(), sizeof(VulkanHeader));
+    if (vulkanHeader.headerSize < sizeof(VulkanHeader) || vulkanHeader.headerSize > data.size() || vulkanHeader.headerVersion != VULKAN_HEADER_VERSION_ONE
+        || vulkanHeader.vendorID != identity.vendorID || vulkanHeader.deviceID != identity.deviceID || vulkanHeader.uuid != identity.uuid) {
+        return std::nullopt;
+    }
+    return data;
+}
+
+void ven::PipelineCacheFile::save(const std::string& filepath, const PipelineCacheIdentity& identity, const std::span<const uint8_t> data)
+{
+    const std::vector<uint8_t> file = pack(identity, data);
+    const std::string tmpPath = filepath + ".tmp";
+    {
+        std::ofstream stream(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!stream) {
+            throw std::runtime_error("failed to open file: " + tmpPath);
+        }
+        stream.write(reinterpret_cast<const char*>(file.data()), static_cast<std::streamsize>(file.size()));
+        if (!stream) {
+            throw std::runtime_error("failed to write file: " + tmpPath);
+        }
+    }
+    std::filesystem::rename(tmpPath, filepath);
+}
+
+std::vector<uint8_t> ven::PipelineCacheFile::load(const std::string& filepath, const PipelineCacheIdentity& identity)
+{
+    std::ifstream stream(filepath, std::ios::binary | std::ios::ate);
+    if (!stream) { return {}; }
+    const std::streamoff size = stream.tellg();
+    if (size <= 0) { return {}; }
+    std::vector<uint8_t> file(static_cast<std::size_t>(size));
+    stream.seekg(0);
+    if (!stream.read(reinterpret_cast<char*>(file.data()), size)) { return {}; }
+    const std::optional<std::span<const uint8_t>> data = unpack(identity, file);
+    if (!data) { return {}; }
+    return { data->begin(), data->end() };
+}
@@ -0,0 +1,49 @@
+#include "VEngine/Gfx/PipelineStatistics.hpp"
+
+ven::PipelineStatistics::PipelineStatistics(const Device& device) : m_device{device}
+{
+    if (!device.hasPipelineStatistics()) { return; }
+    VkQueryPoolCreateInfo queryPoolInfo{};
+    queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    queryPoolInfo.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+    queryPoolInfo.queryCount = MAX_FRAMES_IN_FLIGHT * SCOPE_COUNT;
+    queryPoolInfo.pipelineStatistics = VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT;
+    if (vkCreateQueryPool(device.device(), &queryPoolInfo, nullptr, &m_queryPool) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create query pool!");
+    }
+}
+
+ven::PipelineStatistics::~PipelineStatistics()
+{
+    if (m_queryPool != VK_NULL_HANDLE) {
+        vkDestroyQueryPool(m_device.device(), m_queryPool, nullptr);
+    }
+}
+
+void ven::PipelineStatistics::reset(const VkCommandBuffer commandBuffer, const unsigned long frameIndex)
+{
+    if (!isSupported()) { return; }
+    // the frame fence has been waited on, the queries it recorded are available
+    for (uint8_t scope = 0; scope < SCOPE_COUNT; scope++) {
+        uint64_t invocations = 0;
+        if ((m_recorded.at(frameIndex) & (1U << scope)) != 0U) {
+            vkGetQueryPoolResults(m_device.device(), m_queryPool, getQuery(frameIndex, static_cast<SCOPE>(scope)), 1, sizeof(invocations), &invocations, sizeof(invocations), VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT);
+        }
+        m_fragmentInvocations.at(scope) = invocations;
+    }
+    m_recorded.at(frameIndex) = 0;
+    vkCmdResetQueryPool(commandBuffer, m_queryPool, getQuery(frameIndex, DEPTH_PREPASS), SCOPE_COUNT);
+}
+
+void ven::PipelineStatistics::begin(const VkCommandBuffer commandBuffer, const unsigned long frameIndex, const SCOPE scope)
+{
+    if (!isSupported()) { return; }
+    m_recorded.at(frameIndex) |= static_cast<uint8_t>(1U << scope);
+    vkCmdBeginQuery(commandBuffer, m_queryPool, getQuery(frameIndex, scope), 0);
+}
+
+void ven::PipelineStatistics::end(const VkCommandBuffer commandBuffer, const unsigned long frameIndex, const SCOPE scope) const
+{
+    if (!isSupported()) { return; }
+    vkCmdEndQuery(commandBuffer, m_queryPool, getQuery(frameIndex, scope));
+}
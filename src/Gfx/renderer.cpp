@@ -85,21 +85,21 @@ void ven::Renderer::endFrame()
     m_currentFrameIndex = (m_currentFrameIndex + 1) % MAX_FRAMES_IN_FLIGHT;
 }
 
-void ven::Renderer::beginSwapChainRenderPass(const VkCommandBuffer commandBuffer) const
+void ven::Renderer::beginRenderPass(const VkCommandBuffer commandBuffer, const VkRenderPass renderPass, const VkFramebuffer framebuffer, const std::span<const VkClearValue> clearValues) const
 {
     assert(m_isFrameStarted && "Can't begin render pass when frame not in progress");
     assert(commandBuffer == getCurrentCommandBuffer() && "Can't begin render pass on command m_buffer from a different frame");
 
     VkRenderPassBeginInfo renderPassInfo{};
     renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-    renderPassInfo.renderPass = m_swapChain->getRenderPass();
-    renderPassInfo.framebuffer = m_swapChain->getFrameBuffer(m_currentImageIndex);
+    renderPassInfo.renderPass = renderPass;
+    renderPassInfo.framebuffer = framebuffer;
 
     renderPassInfo.renderArea.offset = {.x=0, .y=0};
     renderPassInfo.renderArea.extent = m_swapChain->getSwapChainExtent();
 
-    renderPassInfo.clearValueCount = static_cast<uint32_t>(m_clearValues.size());
-    renderPassInfo.pClearValues = m_clearValues.data();
+    renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
+    renderPassInfo.pClearValues = clearValues.empty() ? nullptr : clearValues.data();
 
     vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
 
@@ -115,6 +115,31 @@ void ven::Renderer::beginSwapChainRenderPass(const VkCommandBuffer commandBuffer
     vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
 }
 
+void ven::Renderer::beginSwapChainRenderPass(const VkCommandBuffer commandBuffer) const
+{
+    beginRenderPass(commandBuffer, m_swapChain->getRenderPass(), m_swapChain->getFrameBuffer(m_currentImageIndex), m_clearValues);
+}
+
+void ven::Renderer::resumeSwapChainRenderPass(const VkCommandBuffer commandBuffer) const
+{
+    beginRenderPass(commandBuffer, m_swapChain->getLoadRenderPass(), m_swapChain->getFrameBuffer(m_currentImageIndex), {});
+}
+
+void ven::Renderer::beginDeferredRenderPass(const VkCommandBuffer commandBuffer) const
+{
+    // the G-buffer clears to zero, the lighting finds the background from the cleared depth
+    const std::array<VkClearValue, 2 + GBUFFER_ATTACHMENT_COUNT> clearValues{m_clearValues[0], m_clearValues[1]};
+    beginRenderPass(commandBuffer, m_swapChain->getDeferredRenderPass(), m_swapChain->getDeferredFrameBuffer(m_currentImageIndex), clearValues);
+}
+
+void ven::Renderer::nextSubpass(const VkCommandBuffer commandBuffer) const
+{
+    assert(m_isFrameStarted && "Can't change subpass when frame not in progress");
+    assert(commandBuffer == getCurrentCommandBuffer() && "Can't change subpass on command m_buffer from a different frame");
+
+    vkCmdNextSubpass(commandBuffer, VK_SUBPASS_CONTENTS_INLINE);
+}
+
 void ven::Renderer::endSwapChainRenderPass(const VkCommandBuffer commandBuffer) const
 {
     assert(m_isFrameStarted && "Can't end render pass when frame not in progress");
@@ -0,0 +1,405 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "VEngine/Gfx/ShaderReflection.hpp"
+
+namespace {
+
+    constexpr uint32_t SPIRV_MAGIC = 0x07230203;
+    constexpr std::size_t SPIRV_HEADER_WORDS = 5;
+
+    // numbers of the SPIR-V specification, only the ones the layouts depend on
+    enum SPIRV_OP : uint16_t {
+        OP_LINE = 8,
+        OP_ENTRY_POINT = 15,
+        OP_TYPE_INT = 21,
+        OP_TYPE_FLOAT = 22,
+        OP_TYPE_VECTOR = 23,
+        OP_TYPE_MATRIX = 24,
+        OP_TYPE_IMAGE = 25,
+        OP_TYPE_SAMPLER = 26,
+        OP_TYPE_SAMPLED_IMAGE = 27,
+        OP_TYPE_ARRAY = 28,
+        OP_TYPE_RUNTIME_ARRAY = 29,
+        OP_TYPE_STRUCT = 30,
+        OP_TYPE_POINTER = 32,
+        OP_CONSTANT = 43,
+        OP_SPEC_CONSTANT = 50,
+        OP_FUNCTION = 54,
+        OP_VARIABLE = 59,
+        OP_DECORATE = 71,
+        OP_MEMBER_DECORATE = 72
+    };
+
+    enum SPIRV_STORAGE_CLASS : uint32_t {
+        STORAGE_UNIFORM_CONSTANT = 0,
+        STORAGE_UNIFORM = 2,
+        STORAGE_PUSH_CONSTANT = 9,
+        STORAGE_STORAGE_BUFFER = 12
+    };
+
+    enum SPIRV_DECORATION : uint32_t {
+        DECORATION_BLOCK = 2,
+        DECORATION_BUFFER_BLOCK = 3,
+        DECORATION_ROW_MAJOR = 4,
+        DECORATION_ARRAY_STRIDE = 6,
+        DECORATION_MATRIX_STRIDE = 7,
+        DECORATION_BINDING = 33,
+        DECORATION_DESCRIPTOR_SET = 34,
+        DECORATION_OFFSET = 35
+    };
+
+    enum SPIRV_DIM : uint32_t {
+        DIM_BUFFER = 5,
+        DIM_SUBPASS_DATA = 6
+    };
+
+    constexpr uint32_t IMAGE_SAMPLED_STORAGE = 2; // Sampled operand of an image only read and written without sampler
+
+    struct Type {
+        uint16_t op{0};
+        std::vector<uint32_t> operands; // after the result id
+    };
+
+    struct Decoration {
+        std::optional<uint32_t> set;
+        std::optional<uint32_t> binding;
+        uint32_t arrayStride{0};
+        bool bufferBlock{false};
+    };
+
+    struct MemberDecoration {
+        uint32_t offset{0};
+        uint32_t matrixStride{0};
+        bool rowMajor{false};
+    };
+
+    struct Variable {
+        uint32_t id{0};
+        uint32_t pointerType{0};
+        uint32_t storageClass{0};
+    };
+
+    VkShaderStageFlags getStage(const uint32_t executionModel)
+    {
+        switch (executionModel) {
+            case 0: return VK_SHADER_STAGE_VERTEX_BIT;
+            case 1: return VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT;
+            case 2: return VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT;
+            case 3: return VK_SHADER_STAGE_GEOMETRY_BIT;
+            case 4: return VK_SHADER_STAGE_FRAGMENT_BIT;
+            case 5: return VK_SHADER_STAGE_COMPUTE_BIT;
+            case 5364: return VK_SHADER_STAGE_TASK_BIT_EXT;
+            case 5365: return VK_SHADER_STAGE_MESH_BIT_EXT;
+            default: throw std::runtime_error("unsupported SPIR-V execution model " + std::to_string(executionModel));
+        }
+    }
+
+    void sortBindings(std::vector<ven::ReflectedBinding>& bindings)
+    {
+        std::ranges::sort(bindings, [](const ven::ReflectedBinding& lhs, const ven::ReflectedBinding& rhs) {
+            return lhs.set != rhs.set ? lhs.set < rhs.set : lhs.binding < rhs.binding;
+        });
+    }
+
+    class Module {
+
+        public:
+
+            explicit Module(const std::span<const uint32_t> code)
+            {
+                if (code.size() < SPIRV_HEADER_WORDS || code[0] != SPIRV_MAGIC) {
+                    throw std::runtime_error("invalid SPIR-V module");
+                }
+                bool inFunctions = false;
+                std::size_t position = SPIRV_HEADER_WORDS;
+                while (position < code.size()) {
+                    const uint32_t wordCount = code[position] >> 16;
+                    const auto op = static_cast<uint16_t>(code[position] & 0xFFFF);
+                    if (wordCount == 0 || position + wordCount > code.size()) {
+                        throw std::runtime_error("truncated SPIR-V module");
+                    }
+                    parse(op, code.subspan(position + 1, wordCount - 1), inFunctions);
+                    position += wordCount;
+                }
+            }
+
+            VkShaderStageFlags stageFlags{0};
+            std::unordered_map<uint32_t, Type> types;
+            std::unordered_map<uint32_t, uint32_t> constants;
+            std::unordered_map<uint32_t, Decoration> decorations;
+            std::unordered_map<uint64_t, MemberDecoration> memberDecorations; // struct id << 32 | member
+            std::vector<Variable> variables;
+            std::unordered_set<uint32_t> variableIds;
+            std::unordered_set<uint32_t> used;
+
+            [[nodiscard]] const Type& getType(const uint32_t id) const
+            {
+                const auto it = types.find(id);
+                if (it == types.end()) {
+                    throw std::runtime_error("SPIR-V module without type " + std::to_string(id));
+                }
+                return it->second;
+            }
+
+            [[nodiscard]] uint32_t getConstant(const uint32_t id) const
+            {
+                const auto it = constants.find(id);
+                if (it == constants.end()) {
+                    throw std::runtime_error("SPIR-V module without constant " + std::to_string(id));
+                }
+                return it->second;
+            }
+
+            [[nodiscard]] uint32_t getSize(const uint32_t typeId, const uint32_t matrixStride = 0, const bool rowMajor = false) const
+            {
+                const Type& type = getType(typeId);
+                switch (type.op) {
+                    case OP_TYPE_INT:
+                    case OP_TYPE_FLOAT:
+                        return type.operands[0] / 8;
+                    case OP_TYPE_VECTOR:
+                        return type.operands[1] * getSize(type.operands[0]);
+                    case OP_TYPE_MATRIX: {
+                        const uint32_t rows = getType(type.operands[0]).operands[1];
+                        const uint32_t columns = type.operands[1];
+                        const uint32_t stride = matrixStride != 0 ? matrixStride : getSize(type.operands[0]);
+                        return (rowMajor ? rows : columns) * stride;
+                    }
+                    case OP_TYPE_ARRAY: {
+                        const auto it = decorations.find(typeId);
+                        const uint32_t stride = it != decorations.end() && it->second.arrayStride != 0 ? it->second.arrayStride : getSize(type.operands[0], matrixStride, rowMajor);
+                        return getConstant(type.operands[1]) * stride;
+                    }
+                    case OP_TYPE_STRUCT: {
+                        uint32_t size = 0;
+                        for (uint32_t member = 0; member < type.operands.size(); member++) {
+                            const auto it = memberDecorations.find(static_cast<uint64_t>(typeId) << 32 | member);
+                            const MemberDecoration memberDecoration = it != memberDecorations.end() ? it->second : MemberDecoration{};
+                            size = std::max(size, memberDecoration.offset + getSize(type.operands[member], memberDecoration.matrixStride, memberDecoration.rowMajor));
+                        }
+                        return size;
+                    }
+                    default:
+                        // runtime arrays end a buffer and take no room of a push constant block
+                        return 0;
+                }
+            }
+
+            [[nodiscard]] VkDescriptorType getDescriptorType(const uint32_t storageClass, const uint32_t typeId) const
+            {
+                if (storageClass == STORAGE_STORAGE_BUFFER) { return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER; }
+                if (storageClass == STORAGE_UNIFORM) {
+                    // the storage buffers of SPIR-V before 1.3 are uniform blocks decorated BufferBlock
+                    const auto it = decorations.find(typeId);
+                    return it != decorations.end() && it->second.bufferBlock ? VK_DESCRIPTOR_TYPE_STORAGE_BUFFER : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+                }
+                const Type& type = getType(typeId);
+                switch (type.op) {
+                    case OP_TYPE_SAMPLER:
+                        return VK_DESCRIPTOR_TYPE_SAMPLER;
+                    case OP_TYPE_SAMPLED_IMAGE:
+                        return getType(type.operands[0]).operands[1] == DIM_BUFFER ? VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER : VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+                    case OP_TYPE_IMAGE: {
+                        const uint32_t dim = type.operands[1];
+                        const bool storage = type.operands[5] == IMAGE_SAMPLED_STORAGE;
+                        if (dim == DIM_SUBPASS_DATA) { return VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT; }
+                        if (dim == DIM_BUFFER) { return storage ? VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER : VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER; }
+                        return storage ? VK_DESCRIPTOR_TYPE_STORAGE_IMAGE : VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+                    }
+                    default:
+                        throw std::runtime_error("unsupported SPIR-V descriptor type " + std::to_string(type.op));
+                }
+            }
+
+        private:
+
+            void parse(const uint16_t op, const std::span<const uint32_t> operands, bool& inFunctions)
+            {
+                // a global is accessed when any instruction of a function names it, the debug lines carry literals only
+                if (inFunctions && op != OP_LINE) {
+                    for (const uint32_t operand : operands) {
+                        if (variableIds.contains(operand)) { used.insert(operand); }
+                    }
+                }
+                switch (op) {
+                    case OP_ENTRY_POINT:
+                        stageFlags |= getStage(operands[0]);
+                        break;
+                    case OP_TYPE_INT:
+                    case OP_TYPE_FLOAT:
+                    case OP_TYPE_VECTOR:
+                    case OP_TYPE_MATRIX:
+                    case OP_TYPE_IMAGE:
+                    case OP_TYPE_SAMPLER:
+                    case OP_TYPE_SAMPLED_IMAGE:
+                    case OP_TYPE_ARRAY:
+                    case OP_TYPE_RUNTIME_ARRAY:
+                    case OP_TYPE_STRUCT:
+                    case OP_TYPE_POINTER:
+                        types[operands[0]] = { .op = op, .operands = { operands.begin() + 1, operands.end() } };
+                        break;
+                    case OP_CONSTANT:
+                    case OP_SPEC_CONSTANT:
+                        // array lengths, a specialized length keeps its default
+                        constants[operands[1]] = operands[2];
+                        break;
+                    case OP_VARIABLE:
+                        if (!inFunctions && (operands[2] == STORAGE_UNIFORM_CONSTANT || operands[2] == STORAGE_UNIFORM || operands[2] == STORAGE_PUSH_CONSTANT || operands[2] == STORAGE_STORAGE_BUFFER)) {
+                            variables.push_back({ .id = operands[1], .pointerType = operands[0], .storageClass = operands[2] });
+                            variableIds.insert(operands[1]);
+                        }
+                        break;
+                    case OP_DECORATE:
+                        decorate(decorations[operands[0]], operands.subspan(1));
+                        break;
+                    case OP_MEMBER_DECORATE:
+                        decorateMember(memberDecorations[static_cast<uint64_t>(operands[0]) << 32 | operands[1]], operands.subspan(2));
+                        break;
+                    case OP_FUNCTION:
+                        inFunctions = true;
+                        break;
+                    default:
+                        break;
+                }
+            }
+
+            static void decorate(Decoration& decoration, const std::span<const uint32_t> operands)
+            {
+                switch (operands[0]) {
+                    case DECORATION_DESCRIPTOR_SET: decoration.set = operands[1]; break;
+                    case DECORATION_BINDING: decoration.binding = operands[1]; break;
+                    case DECORATION_ARRAY_STRIDE: decoration.arrayStride = operands[1]; break;
+                    case DECORATION_BUFFER_BLOCK: decoration.bufferBlock = true; break;
+                    default: break;
+                }
+            }
+
+            static void decorateMember(MemberDecoration& decoration, const std::span<const uint32_t> operands)
+            {
+                switch (operands[0]) {
+                    case DECORATION_OFFSET: decoration.offset = operands[1]; break;
+                    case DECORATION_MATRIX_STRIDE: decoration.matrixStride = operands[1]; break;
+                    case DECORATION_ROW_MAJOR: decoration.rowMajor = true; break;
+                    default: break;
+                }
+            }
+
+    }; // class Module
+
+} // namespace
+
+ven::ShaderReflection::ShaderReflection(const std::span<const uint32_t> code)
+{
+    const Module module(code);
+    m_stageFlags = module.stageFlags;
+    for (const Variable& variable : module.variables) {
+        if (!module.used.contains(variable.id)) { continue; }
+        uint32_t typeId = module.getType(variable.pointerType).operands[1];
+        if (variable.storageClass == STORAGE_PUSH_CONSTANT) {
+            m_pushConstantRange = { .stageFlags = m_stageFlags, .offset = 0, .size = module.getSize(typeId) };
+            continue;
+        }
+        const auto decoration = module.decorations.find(variable.id);
+        if (decoration == module.decorations.end() || !decoration->second.set || !decoration->second.binding) {
+            throw std::runtime_error("SPIR-V descriptor " + std::to_string(variable.id) + " without set or binding");
+        }
+        uint32_t count = 1;
+        for (const Type* type = &module.getType(typeId); type->op == OP_TYPE_ARRAY || type->op == OP_TYPE_RUNTIME_ARRAY; type = &module.getType(typeId)) {
+            if (type->op == OP_TYPE_RUNTIME_ARRAY) {
+                throw std::runtime_error("unsized descriptor arrays are not supported");
+            }
+            count *= module.getConstant(type->operands[1]);
+            typeId = type->operands[0];
+        }
+        m_bindings.push_back({
+            .set = *decoration->second.set,
+            .binding = *decoration->second.binding,
+            .descriptorType = module.getDescriptorType(variable.storageClass, typeId),
+            .count = count,
+            .stageFlags = m_stageFlags
+        });
+    }
+    sortBindings(m_bindings);
+}
+
+ven::ShaderReflection ven::ShaderReflection::fromFile(const std::string& filepath)
+{
+    std::ifstream file(filepath, std::ios::binary | std::ios::ate);
+    if (!file) {
+        throw std::runtime_error("failed to open file: " + filepath);
+    }
+    const std::streamoff size = file.tellg();
+    if (size <= 0 || size % static_cast<std::streamoff>(sizeof(uint32_t)) != 0) {
+        throw std::runtime_error("invalid SPIR-V module: " + filepath);
+    }
+    std::vector<uint32_t> code(static_cast<std::size_t>(size) / sizeof(uint32_t));
+    file.seekg(0);
+    if (!file.read(reinterpret_cast<char*>(code.data()), size)) {
+        throw std::runtime_error("failed to read file: " + filepath);
+    }
+    return ShaderReflection(code);
+}
+
+ven::ShaderReflection ven::ShaderReflection::fromFiles(const std::vector<std::string>& filepaths)
+{
+    ShaderReflection reflection;
+    for (const std::string& filepath : filepaths) {
+        if (!filepath.empty()) {
+            reflection.merge(fromFile(filepath));
+        }
+    }
+    return reflection;
+}
+
+ven::ShaderReflection ven::ShaderReflection::fromDirectory(const std::string& path, const VkShaderStageFlags stageFlags)
+{
+    ShaderReflection reflection;
+    for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(path)) {
+        if (entry.path().extension() != ".spv") { continue; }
+        const ShaderReflection module = fromFile(entry.path().string());
+        if ((module.getStageFlags() & ~stageFlags) == 0) {
+            reflection.merge(module);
+        }
+    }
+    return reflection;
+}
+
+void ven::ShaderReflection::merge(const ShaderReflection& other)
+{
+    for (const ReflectedBinding& binding : other.m_bindings) {
+        const auto it = std::ranges::find_if(m_bindings, [&binding](const ReflectedBinding& current) {
+            return current.set == binding.set && current.binding == binding.binding;
+        });
+        if (it == m_bindings.end()) {
+            m_bindings.push_back(binding);
+            continue;
+        }
+        if (it->descriptorType != binding.descriptorType) {
+            throw std::runtime_error("binding " + std::to_string(binding.binding) + " of set " + std::to_string(binding.set) + " declared with two descriptor types");
+        }
+        it->count = std::max(it->count, binding.count);
+        it->stageFlags |= binding.stageFlags;
+    }
+    sortBindings(m_bindings);
+    m_pushConstantRange.stageFlags |= other.m_pushConstantRange.stageFlags;
+    m_pushConstantRange.size = std::max(m_pushConstantRange.size, other.m_pushConstantRange.size);
+    m_stageFlags |= other.m_stageFlags;
+}
+
+std::vector<VkDescriptorSetLayoutBinding> ven::ShaderReflection::getSetBindings(const uint32_t set) const
+{
+    std::vector<VkDescriptorSetLayoutBinding> bindings;
+    for (const ReflectedBinding& binding : m_bindings) {
+        if (binding.set == set) {
+            bindings.push_back({ .binding = binding.binding, .descriptorType = binding.descriptorType, .descriptorCount = binding.count, .stageFlags = binding.stageFlags, .pImmutableSamplers = nullptr });
+        }
+    }
+    return bindings;
+}
@@ -0,0 +1,33 @@
+#include <cstddef>
+
+#include "VEngine/Gfx/ShaderVariant.hpp"
+
+ven::ShaderVariant ven::ShaderVariant::select(const ShaderVariant& variant, const uint8_t constants) const
+{
+    ShaderVariant selected = *this;
+    if ((constants & (1U << SHADER_CONSTANT_ALPHA_MODE)) != 0) { selected.alphaMode = variant.alphaMode; }
+    if ((constants & (1U << SHADER_CONSTANT_SHADOWS)) != 0) { selected.shadows = variant.shadows; }
+    if ((constants & (1U << SHADER_CONSTANT_MAX_LIGHTS)) != 0) { selected.maxLights = variant.maxLights; }
+    return selected;
+}
+
+uint64_t ven::ShaderVariant::getKey() const
+{
+    return static_cast<uint64_t>(maxLights) << 32 | static_cast<uint64_t>(shadows != VK_FALSE) << 8 | alphaMode;
+}
+
+VkSpecializationInfo ven::ShaderVariant::getSpecializationInfo() const
+{
+    const std::array<VkSpecializationMapEntry, SHADER_CONSTANT_COUNT>& mapEntries = getMapEntries();
+    return { .mapEntryCount = static_cast<uint32_t>(mapEntries.size()), .pMapEntries = mapEntries.data(), .dataSize = sizeof(ShaderVariant), .pData = this };
+}
+
+const std::array<VkSpecializationMapEntry, ven::SHADER_CONSTANT_COUNT>& ven::ShaderVariant::getMapEntries()
+{
+    static constexpr std::array<VkSpecializationMapEntry, SHADER_CONSTANT_COUNT> MAP_ENTRIES{{
+        { .constantID = SHADER_CONSTANT_ALPHA_MODE, .offset = offsetof(ShaderVariant, alphaMode), .size = sizeof(uint32_t) },
+        { .constantID = SHADER_CONSTANT_SHADOWS, .offset = offsetof(ShaderVariant, shadows), .size = sizeof(VkBool32) },
+        { .constantID = SHADER_CONSTANT_MAX_LIGHTS, .offset = offsetof(ShaderVariant, maxLights), .size = sizeof(uint32_t) }
+    }};
+    return MAP_ENTRIES;
+}
@@ -7,7 +7,10 @@ ven::Shaders::~Shaders()
 {
     vkDestroyShaderModule(m_device.device(), m_vertShaderModule, nullptr);
     vkDestroyShaderModule(m_device.device(), m_fragShaderModule, nullptr);
-    vkDestroyPipeline(m_device.device(), m_graphicsPipeline, nullptr);
+    vkDestroyShaderModule(m_device.device(), m_compShaderModule, nullptr);
+    vkDestroyShaderModule(m_device.device(), m_taskShaderModule, nullptr);
+    vkDestroyShaderModule(m_device.device(), m_meshShaderModule, nullptr);
+    vkDestroyPipeline(m_device.device(), m_pipeline, nullptr);
 }
 
 std::vector<char> ven::Shaders::readFile(const std::string &filename) {
@@ -26,10 +29,12 @@ std::vector<char> ven::Shaders::readFile(const std::string &filename) {
 void ven::Shaders::createGraphicsPipeline(const std::string& vertFilepath, const std::string& fragFilepath, const PipelineConfigInfo& configInfo)
 {
     const std::vector<char> vertCode = readFile(vertFilepath);
-    const std::vector<char> fragCode = readFile(fragFilepath);
-
     createShaderModule(vertCode, &m_vertShaderModule);
-    createShaderModule(fragCode, &m_fragShaderModule);
+    if (!fragFilepath.empty()) {
+        createShaderModule(readFile(fragFilepath), &m_fragShaderModule);
+    }
+
+    const VkSpecializationInfo specializationInfo = configInfo.variant.getSpecializationInfo();
 
     std::array<VkPipelineShaderStageCreateInfo, 2> shaderStages{};
     shaderStages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
@@ -38,7 +43,7 @@ void ven::Shaders::createGraphicsPipeline(const std::string& vertFilepath, const
     shaderStages[0].pName = "main";
     shaderStages[0].flags = 0;
     shaderStages[0].pNext = nullptr;
-    shaderStages[0].pSpecializationInfo = nullptr;
+    shaderStages[0].pSpecializationInfo = &specializationInfo;
 
     shaderStages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
     shaderStages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
@@ -46,7 +51,7 @@ void ven::Shaders::createGraphicsPipeline(const std::string& vertFilepath, const
     shaderStages[1].pName = "main";
     shaderStages[1].flags = 0;
     shaderStages[1].pNext = nullptr;
-    shaderStages[1].pSpecializationInfo = nullptr;
+    shaderStages[1].pSpecializationInfo = &specializationInfo;
 
     const auto& bindingDescriptions = configInfo.bindingDescriptions;
     const auto& attributeDescriptions = configInfo.attributeDescriptions;
@@ -68,7 +73,7 @@ void ven::Shaders::createGraphicsPipeline(const std::string& vertFilepath, const
 
     VkGraphicsPipelineCreateInfo pipelineInfo{};
     pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-    pipelineInfo.stageCount = 2;
+    pipelineInfo.stageCount = m_fragShaderModule != nullptr ? 2 : 1;
     pipelineInfo.pStages = shaderStages.data();
     pipelineInfo.pVertexInputState = &vertexInputInfo;
     pipelineInfo.pInputAssemblyState = &configInfo.inputAssemblyInfo;
@@ -87,11 +92,79 @@ void ven::Shaders::createGraphicsPipeline(const std::string& vertFilepath, const
     pipelineInfo.basePipelineIndex = -1;
     pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
 
-    if (vkCreateGraphicsPipelines(m_device.device(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_graphicsPipeline) != VK_SUCCESS) {
+    if (vkCreateGraphicsPipelines(m_device.device(), m_device.getPipelineCache(), 1, &pipelineInfo, nullptr, &m_pipeline) != VK_SUCCESS) {
         throw std::runtime_error("failed to create graphics pipeline");
     }
 }
 
+void ven::Shaders::createMeshPipeline(const std::string& taskFilepath, const std::string& meshFilepath, const std::string& fragFilepath, const PipelineConfigInfo& configInfo)
+{
+    createShaderModule(readFile(taskFilepath), &m_taskShaderModule);
+    createShaderModule(readFile(meshFilepath), &m_meshShaderModule);
+    createShaderModule(readFile(fragFilepath), &m_fragShaderModule);
+
+    const VkSpecializationInfo specializationInfo = configInfo.variant.getSpecializationInfo();
+
+    std::array<VkPipelineShaderStageCreateInfo, 3> shaderStages{};
+    const std::array stages{VK_SHADER_STAGE_TASK_BIT_EXT, VK_SHADER_STAGE_MESH_BIT_EXT, VK_SHADER_STAGE_FRAGMENT_BIT};
+    const std::array modules{m_taskShaderModule, m_meshShaderModule, m_fragShaderModule};
+    for (std::size_t i = 0; i < shaderStages.size(); i++) {
+        shaderStages[i].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        shaderStages[i].stage = stages[i];
+        shaderStages[i].module = modules[i];
+        shaderStages[i].pName = "main";
+        shaderStages[i].pSpecializationInfo = &specializationInfo;
+    }
+
+    VkPipelineViewportStateCreateInfo viewportInfo{};
+    viewportInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+    viewportInfo.viewportCount = 1;
+    viewportInfo.scissorCount = 1;
+
+    // the mesh shader outputs the primitives, there is no vertex input nor input assembly
+    VkGraphicsPipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    pipelineInfo.stageCount = static_cast<uint32_t>(shaderStages.size());
+    pipelineInfo.pStages = shaderStages.data();
+    pipelineInfo.pViewportState = &viewportInfo;
+    pipelineInfo.pRasterizationState = &configInfo.rasterizationInfo;
+    pipelineInfo.pMultisampleState = &configInfo.multisampleInfo;
+    pipelineInfo.pColorBlendState = &configInfo.colorBlendInfo;
+    pipelineInfo.pDepthStencilState = &configInfo.depthStencilInfo;
+    pipelineInfo.pDynamicState = &configInfo.dynamicStateInfo;
+    pipelineInfo.layout = configInfo.pipelineLayout;
+    pipelineInfo.renderPass = configInfo.renderPass;
+    pipelineInfo.subpass = configInfo.subpass;
+    pipelineInfo.basePipelineIndex = -1;
+    pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
+
+    if (vkCreateGraphicsPipelines(m_device.device(), m_device.getPipelineCache(), 1, &pipelineInfo, nullptr, &m_pipeline) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create mesh shader pipeline");
+    }
+}
+
+void ven::Shaders::createComputePipeline(const std::string& compFilepath, const VkPipelineLayout pipelineLayout)
+{
+    const std::vector<char> compCode = readFile(compFilepath);
+
+    createShaderModule(compCode, &m_compShaderModule);
+
+    VkComputePipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipelineInfo.stage.module = m_compShaderModule;
+    pipelineInfo.stage.pName = "main";
+    pipelineInfo.stage.pSpecializationInfo = nullptr;
+    pipelineInfo.layout = pipelineLayout;
+    pipelineInfo.basePipelineIndex = -1;
+    pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
+
+    if (vkCreateComputePipelines(m_device.device(), m_device.getPipelineCache(), 1, &pipelineInfo, nullptr, &m_pipeline) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create compute pipeline");
+    }
+}
+
 void ven::Shaders::createShaderModule(const std::vector<char> &code, VkShaderModule *shaderModule) const
 {
     VkShaderModuleCreateInfo createInfo{};
@@ -131,7 +204,8 @@ void ven::Shaders::defaultPipelineConfigInfo(PipelineConfigInfo& configInfo)
     configInfo.multisampleInfo.alphaToOneEnable = VK_FALSE;
 
     configInfo.colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-    configInfo.colorBlendAttachment.blendEnable = VK_TRUE;
+    // opaque by default, the pipelines drawing transparent surfaces turn it on
+    configInfo.colorBlendAttachment.blendEnable = VK_FALSE;
     configInfo.colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
     configInfo.colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
     configInfo.colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
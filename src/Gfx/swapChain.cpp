@@ -1,5 +1,6 @@
 #include <iostream>
 #include <limits>
+#include <utility>
 
 #include "VEngine/Gfx/SwapChain.hpp"
 
@@ -21,11 +22,22 @@ ven::SwapChain::~SwapChain()
         vkFreeMemory(m_device.device(), m_depthImageMemory[i], nullptr);
     }
 
+    for (size_t i = 0; i < m_gBufferImages.size(); i++) {
+        vkDestroyImageView(m_device.device(), m_gBufferImageViews[i], nullptr);
+        vkDestroyImage(m_device.device(), m_gBufferImages[i], nullptr);
+        vkFreeMemory(m_device.device(), m_gBufferImageMemory[i], nullptr);
+    }
+
     for (VkFramebuffer_T *framebuffer : m_swapChainFrameBuffers) {
         vkDestroyFramebuffer(m_device.device(), framebuffer, nullptr);
     }
+    for (VkFramebuffer_T *framebuffer : m_deferredFrameBuffers) {
+        vkDestroyFramebuffer(m_device.device(), framebuffer, nullptr);
+    }
 
     vkDestroyRenderPass(m_device.device(), m_renderPass, nullptr);
+    vkDestroyRenderPass(m_device.device(), m_loadRenderPass, nullptr);
+    vkDestroyRenderPass(m_device.device(), m_deferredRenderPass, nullptr);
 
     // cleanup synchronization objects
     for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
@@ -39,8 +51,18 @@ void ven::SwapChain::init()
 {
     createSwapChain();
     createImageViews();
-    createRenderPass();
+    m_swapChainDepthFormat = findDepthFormat();
+    // the render passes only depend on the formats, taking over the previous ones keeps the pipelines built against them valid
+    if (m_oldSwapChain != nullptr && compareSwapFormats(*m_oldSwapChain)) {
+        m_renderPass = std::exchange(m_oldSwapChain->m_renderPass, VK_NULL_HANDLE);
+        m_loadRenderPass = std::exchange(m_oldSwapChain->m_loadRenderPass, VK_NULL_HANDLE);
+        m_deferredRenderPass = std::exchange(m_oldSwapChain->m_deferredRenderPass, VK_NULL_HANDLE);
+    } else {
+        createRenderPass();
+        createDeferredRenderPass();
+    }
     createDepthResources();
+    createGBufferResources();
     createFrameBuffers();
     createSyncObjects();
 }
@@ -183,7 +205,7 @@ void ven::SwapChain::createRenderPass()
     depthAttachment.format = findDepthFormat();
     depthAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
     depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-    depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE; // sampled by the HiZ pass
     depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
     depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
     depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
@@ -234,6 +256,122 @@ void ven::SwapChain::createRenderPass()
     if (vkCreateRenderPass(m_device.device(), &renderPassInfo, nullptr, &m_renderPass) != VK_SUCCESS) {
         throw std::runtime_error("failed to create render pass!");
     }
+
+    // compatible pass resuming the frame after the depth has been read by compute (HiZ build, late culling)
+    std::array<VkAttachmentDescription, 2> loadAttachments = {colorAttachment, depthAttachment};
+    loadAttachments[0].loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+    loadAttachments[0].initialLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    loadAttachments[1].loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+    loadAttachments[1].initialLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+
+    VkSubpassDependency loadDependency = {};
+    loadDependency.srcSubpass = VK_SUBPASS_EXTERNAL;
+    loadDependency.srcStageMask = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    loadDependency.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    loadDependency.dstSubpass = 0;
+    loadDependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    loadDependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+    renderPassInfo.pAttachments = loadAttachments.data();
+    renderPassInfo.pDependencies = &loadDependency;
+
+    if (vkCreateRenderPass(m_device.device(), &renderPassInfo, nullptr, &m_loadRenderPass) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create render pass!");
+    }
+}
+
+void ven::SwapChain::createDeferredRenderPass()
+{
+    // 0: swap chain image, 1: depth, 2..: G-buffer
+    std::array<VkAttachmentDescription, 2 + GBUFFER_ATTACHMENT_COUNT> attachments{};
+    attachments[0].format = getSwapChainImageFormat();
+    attachments[0].samples = VK_SAMPLE_COUNT_1_BIT;
+    attachments[0].loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR; // the background keeps the clear color, the lighting skips it
+    attachments[0].storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    attachments[0].stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    attachments[0].stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    attachments[0].initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    attachments[0].finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+
+    attachments[1].format = findDepthFormat();
+    attachments[1].samples = VK_SAMPLE_COUNT_1_BIT;
+    attachments[1].loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    attachments[1].storeOp = VK_ATTACHMENT_STORE_OP_STORE; // depth tested by the light billboards drawn after the pass
+    attachments[1].stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    attachments[1].stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    attachments[1].initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    attachments[1].finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+
+    // never stored, the G-buffer lives and dies in the pass (in tile memory on tiled GPUs)
+    for (uint32_t i = 0; i < GBUFFER_ATTACHMENT_COUNT; i++) {
+        VkAttachmentDescription& attachment = attachments.at(2 + i);
+        attachment.format = GBUFFER_FORMATS.at(i);
+        attachment.samples = VK_SAMPLE_COUNT_1_BIT;
+        attachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        attachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        attachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        attachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        attachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        attachment.finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    }
+
+    std::array<VkAttachmentReference, GBUFFER_ATTACHMENT_COUNT> gBufferRefs{};
+    // the G-buffer in attachment order then the depth, see the input_attachment_index of fragment_deferred_lighting.frag
+    std::array<VkAttachmentReference, GBUFFER_ATTACHMENT_COUNT + 1> inputRefs{};
+    for (uint32_t i = 0; i < GBUFFER_ATTACHMENT_COUNT; i++) {
+        gBufferRefs.at(i) = {.attachment = 2 + i, .layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+        inputRefs.at(i) = {.attachment = 2 + i, .layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+    }
+    inputRefs.back() = {.attachment = 1, .layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL};
+    const VkAttachmentReference depthRef{.attachment = 1, .layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL};
+    const VkAttachmentReference colorRef{.attachment = 0, .layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+
+    std::array<VkSubpassDescription, 2> subpasses{};
+    subpasses[0].pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpasses[0].colorAttachmentCount = static_cast<uint32_t>(gBufferRefs.size());
+    subpasses[0].pColorAttachments = gBufferRefs.data();
+    subpasses[0].pDepthStencilAttachment = &depthRef;
+    subpasses[1].pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpasses[1].inputAttachmentCount = static_cast<uint32_t>(inputRefs.size());
+    subpasses[1].pInputAttachments = inputRefs.data();
+    subpasses[1].colorAttachmentCount = 1;
+    subpasses[1].pColorAttachments = &colorRef;
+
+    std::array<VkSubpassDependency, 3> dependencies{};
+    dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+    dependencies[0].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+    dependencies[0].srcAccessMask = 0;
+    dependencies[0].dstSubpass = 0;
+    dependencies[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+    dependencies[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    // by region: a pixel only reads its own G-buffer texel, the tile can be shaded as soon as it is written
+    dependencies[1].srcSubpass = 0;
+    dependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    dependencies[1].dstSubpass = 1;
+    dependencies[1].dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    dependencies[1].dstAccessMask = VK_ACCESS_INPUT_ATTACHMENT_READ_BIT;
+    dependencies[1].dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+    // the depth read as input attachment is tested and written again by the pass resuming the frame
+    dependencies[2].srcSubpass = 1;
+    dependencies[2].srcStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    dependencies[2].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    dependencies[2].dstSubpass = VK_SUBPASS_EXTERNAL;
+    dependencies[2].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    dependencies[2].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+    VkRenderPassCreateInfo renderPassInfo = {};
+    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+    renderPassInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+    renderPassInfo.pAttachments = attachments.data();
+    renderPassInfo.subpassCount = static_cast<uint32_t>(subpasses.size());
+    renderPassInfo.pSubpasses = subpasses.data();
+    renderPassInfo.dependencyCount = static_cast<uint32_t>(dependencies.size());
+    renderPassInfo.pDependencies = dependencies.data();
+
+    if (vkCreateRenderPass(m_device.device(), &renderPassInfo, nullptr, &m_deferredRenderPass) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create render pass!");
+    }
 }
 
 void ven::SwapChain::createFrameBuffers()
@@ -256,14 +394,35 @@ void ven::SwapChain::createFrameBuffers()
             throw std::runtime_error("failed to create framebuffer!");
         }
     }
+
+    m_deferredFrameBuffers.resize(imageCount());
+    for (size_t i = 0; i < imageCount(); i++) {
+        std::array<VkImageView, 2 + GBUFFER_ATTACHMENT_COUNT> attachments = {m_swapChainImageViews[i], m_depthImageViews[i]};
+        for (uint32_t attachment = 0; attachment < GBUFFER_ATTACHMENT_COUNT; attachment++) {
+            attachments.at(2 + attachment) = m_gBufferImageViews[(i * GBUFFER_ATTACHMENT_COUNT) + attachment];
+        }
+
+        const auto [width, height] = getSwapChainExtent();
+        VkFramebufferCreateInfo framebufferInfo = {};
+        framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+        framebufferInfo.renderPass = m_deferredRenderPass;
+        framebufferInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+        framebufferInfo.pAttachments = attachments.data();
+        framebufferInfo.width = width;
+        framebufferInfo.height = height;
+        framebufferInfo.layers = 1;
+
+        if (vkCreateFramebuffer(m_device.device(), &framebufferInfo, nullptr, &m_deferredFrameBuffers[i]) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create framebuffer!");
+        }
+    }
 }
 
 void ven::SwapChain::createDepthResources()
 {
-    const VkFormat depthFormat = findDepthFormat();
+    const VkFormat depthFormat = m_swapChainDepthFormat;
     const auto [width, height] = getSwapChainExtent();
 
-    m_swapChainDepthFormat = depthFormat;
     m_depthImages.resize(imageCount());
     m_depthImageMemory.resize(imageCount());
     m_depthImageViews.resize(imageCount());
@@ -280,7 +439,7 @@ void ven::SwapChain::createDepthResources()
         imageInfo.format = depthFormat;
         imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
         imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-        imageInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+        imageInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT;
         imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
         imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
         imageInfo.flags = 0;
@@ -304,6 +463,51 @@ void ven::SwapChain::createDepthResources()
     }
 }
 
+void ven::SwapChain::createGBufferResources()
+{
+    const auto [width, height] = getSwapChainExtent();
+
+    m_gBufferImages.resize(imageCount() * GBUFFER_ATTACHMENT_COUNT);
+    m_gBufferImageMemory.resize(m_gBufferImages.size());
+    m_gBufferImageViews.resize(m_gBufferImages.size());
+
+    for (size_t i = 0; i < m_gBufferImages.size(); i++) {
+        const VkFormat format = GBUFFER_FORMATS.at(i % GBUFFER_ATTACHMENT_COUNT);
+        VkImageCreateInfo imageInfo{};
+        imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageInfo.extent.width = width;
+        imageInfo.extent.height = height;
+        imageInfo.extent.depth = 1;
+        imageInfo.mipLevels = 1;
+        imageInfo.arrayLayers = 1;
+        imageInfo.format = format;
+        imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+        imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        imageInfo.flags = 0;
+
+        m_device.createImageWithInfo(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_gBufferImages[i], m_gBufferImageMemory[i], VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT);
+
+        VkImageViewCreateInfo viewInfo{};
+        viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewInfo.image = m_gBufferImages[i];
+        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewInfo.format = format;
+        viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        viewInfo.subresourceRange.baseMipLevel = 0;
+        viewInfo.subresourceRange.levelCount = 1;
+        viewInfo.subresourceRange.baseArrayLayer = 0;
+        viewInfo.subresourceRange.layerCount = 1;
+
+        if (vkCreateImageView(m_device.device(), &viewInfo, nullptr, &m_gBufferImageViews[i]) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create texture image view!");
+        }
+    }
+}
+
 void ven::SwapChain::createSyncObjects()
 {
     m_imageAvailableSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
@@ -375,5 +579,5 @@ VkFormat ven::SwapChain::findDepthFormat() const
     return m_device.findSupportedFormat(
         {VK_FORMAT_D32_SFLOAT, VK_FORMAT_D32_SFLOAT_S8_UINT, VK_FORMAT_D24_UNORM_S8_UINT},
         VK_IMAGE_TILING_OPTIMAL,
-        VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT);
+        VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT);
 }
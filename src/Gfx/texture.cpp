@@ -4,7 +4,7 @@
 
 #include "VEngine/Gfx/Texture.hpp"
 
-ven::Texture::Texture(const Device &device, const std::string &textureFilepath) : m_device{device}
+ven::Texture::Texture(const Device &device, const std::string &textureFilepath) : m_device{device}, m_filepath{textureFilepath}
 {
     createTextureImage(textureFilepath);
     createTextureImageView(VK_IMAGE_VIEW_TYPE_2D);
@@ -116,6 +116,10 @@ void ven::Texture::createTextureImage(const std::string &filepath)
     if (pixels == nullptr) {
         throw std::runtime_error("failed to load texture image! texture path: " + filepath);
     }
+    // files without an alpha channel are expanded to 255
+    if (texChannels == 2 || texChannels == 4) {
+        m_alphaMode = classifyAlpha(std::span(pixels, static_cast<std::size_t>(imageSize)));
+    }
 
     // mMipLevels = static_cast<uint32_t>(std::floor(std::log2(std::max(texWidth, texHeight)))) + 1;
     m_mipLevels = 1;
@@ -0,0 +1,49 @@
+#include "VEngine/Scene/Entities/Object.hpp"
+
+uint32_t ven::ObjectStore::updateWorld()
+{
+    const std::span<const Transform3D> locals = column<TRANSFORM>();
+    const std::span<const uint32_t> nodes = column<NODE>();
+    const std::span<const std::shared_ptr<Model>> models = column<MODEL>();
+    std::vector<WorldMatrices>& worlds = column<WORLD>();
+    std::vector<AABB>& bounds = column<BOUNDS>();
+    std::vector<uint64_t>& versions = column<VERSION>();
+    std::vector<uint32_t>& proxies = column<PROXY>();
+    const std::vector<Handle>& objectHandles = handles();
+
+    m_changed.clear();
+    m_batchIndices.clear();
+    m_batch.clear();
+    for (uint32_t i = 0; i < size(); i++) {
+        const uint64_t version = m_sceneGraph.getVersion(nodes[i]);
+        if (versions[i] == version) { continue; }
+        versions[i] = version;
+        m_changed.push_back(i);
+        if (m_sceneGraph.getParent(nodes[i]) == SceneGraph::NONE) {
+            // world == local TRS, the batch kernel computes both matrices
+            m_batchIndices.push_back(i);
+            m_batch.push(locals[i]);
+            continue;
+        }
+        worlds[i].model = m_sceneGraph.getWorld(nodes[i]);
+        worlds[i].normal = glm::mat4(transpose(inverse(glm::mat3(worlds[i].model))));
+    }
+
+    m_batchModels.resize(m_batch.size());
+    m_batchNormals.resize(m_batch.size());
+    m_batch.compute(m_batchModels, m_batchNormals);
+    for (std::size_t j = 0; j < m_batchIndices.size(); j++) {
+        worlds[m_batchIndices[j]] = { .model = m_batchModels[j], .normal = m_batchNormals[j] };
+    }
+
+    for (const uint32_t i : m_changed) {
+        bounds[i] = models[i] != nullptr ? models[i]->getAABB().transform(worlds[i].model) : AABB{};
+        if (!bounds[i].isValid()) { continue; }
+        if (proxies[i] == SpatialIndex::NONE) {
+            proxies[i] = m_spatialIndex.insert(bounds[i], objectHandles[i]);
+        } else {
+            m_spatialIndex.update(proxies[i], bounds[i]);
+        }
+    }
+    return static_cast<uint32_t>(m_changed.size());
+}
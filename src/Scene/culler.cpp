@@ -0,0 +1,126 @@
+#include <bit>
+#include <chrono>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define VEN_CULLER_SSE
+    #include <emmintrin.h>
+#endif
+
+#include "VEngine/Scene/Culler.hpp"
+
+void ven::FrustumCuller::begin(const glm::mat4& projection, const glm::mat4& view, const float viewportHeight)
+{
+    m_frustum.update(projection * view);
+    m_cameraPosition = glm::vec3(inverse(view)[3]);
+    // projected diameter in pixels = 2 * radius * m_projectionScale / distance
+    m_projectionScale = std::abs(projection[1][1]) * 0.5F * viewportHeight;
+
+    m_centerX.clear();
+    m_centerY.clear();
+    m_centerZ.clear();
+    m_radius.clear();
+    m_stats = {};
+}
+
+uint32_t ven::FrustumCuller::add(const BoundingSphere& sphere)
+{
+    m_centerX.push_back(sphere.center.x);
+    m_centerY.push_back(sphere.center.y);
+    m_centerZ.push_back(sphere.center.z);
+    m_radius.push_back(sphere.radius);
+    return static_cast<uint32_t>(m_radius.size() - 1);
+}
+
+uint32_t ven::FrustumCuller::addHidden()
+{
+    // a negative radius never passes the frustum test
+    m_stats.pvsCulled++;
+    return add({ .center = glm::vec3(0.F), .radius = -1.F });
+}
+
+void ven::FrustumCuller::cull()
+{
+    const auto start = std::chrono::high_resolution_clock::now();
+    const std::size_t count = m_radius.size();
+
+    m_visible.assign(count, 1);
+    m_stats.tested = static_cast<uint32_t>(count);
+    if (!m_enabled) {
+        for (std::size_t i = 0; i < count; i++) {
+            m_visible[i] = m_radius[i] < 0.F ? 0 : 1;
+        }
+        m_stats.submitted = m_stats.tested - m_stats.pvsCulled;
+        return;
+    }
+
+    std::size_t i = 0;
+#ifdef VEN_CULLER_SSE
+    const float sizeScaleSq = 4.F * m_projectionScale * m_projectionScale;
+    const float minSizeSq = m_minPixelSize * m_minPixelSize;
+    const __m128 camX = _mm_set1_ps(m_cameraPosition.x);
+    const __m128 camY = _mm_set1_ps(m_cameraPosition.y);
+    const __m128 camZ = _mm_set1_ps(m_cameraPosition.z);
+    const __m128 sizeScale = _mm_set1_ps(sizeScaleSq);
+    const __m128 minSize = _mm_set1_ps(minSizeSq);
+    const __m128 zero = _mm_setzero_ps();
+
+    for (; i + 4 <= count; i += 4) {
+        const __m128 cx = _mm_loadu_ps(&m_centerX[i]);
+        const __m128 cy = _mm_loadu_ps(&m_centerY[i]);
+        const __m128 cz = _mm_loadu_ps(&m_centerZ[i]);
+        const __m128 radius = _mm_loadu_ps(&m_radius[i]);
+        const __m128 negRadius = _mm_sub_ps(zero, radius);
+        __m128 inside = _mm_cmpge_ps(radius, zero);
+
+        for (const glm::vec4& plane : m_frustum.getPlanes()) {
+            __m128 dist = _mm_add_ps(_mm_mul_ps(cx, _mm_set1_ps(plane.x)), _mm_set1_ps(plane.w));
+            dist = _mm_add_ps(dist, _mm_mul_ps(cy, _mm_set1_ps(plane.y)));
+            dist = _mm_add_ps(dist, _mm_mul_ps(cz, _mm_set1_ps(plane.z)));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(dist, negRadius));
+        }
+
+        const __m128 dx = _mm_sub_ps(cx, camX);
+        const __m128 dy = _mm_sub_ps(cy, camY);
+        const __m128 dz = _mm_sub_ps(cz, camZ);
+        const __m128 distSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+        const __m128 large = _mm_cmpge_ps(_mm_mul_ps(_mm_mul_ps(radius, radius), sizeScale), _mm_mul_ps(distSq, minSize));
+
+        const auto insideMask = static_cast<unsigned int>(_mm_movemask_ps(inside));
+        const auto largeMask = static_cast<unsigned int>(_mm_movemask_ps(large));
+        const unsigned int visibleMask = insideMask & largeMask;
+
+        m_stats.frustumCulled += static_cast<uint32_t>(std::popcount(~insideMask & 0xFU));
+        m_stats.smallCulled += static_cast<uint32_t>(std::popcount(insideMask & ~largeMask & 0xFU));
+        for (unsigned int lane = 0; lane < 4; lane++) {
+            m_visible[i + lane] = static_cast<uint8_t>((visibleMask >> lane) & 1U);
+        }
+    }
+#endif
+    cullRange(i, count);
+
+    // hidden entries were counted by the frustum test
+    m_stats.frustumCulled -= m_stats.pvsCulled;
+    m_stats.submitted = m_stats.tested - m_stats.pvsCulled - m_stats.frustumCulled - m_stats.smallCulled;
+    m_stats.timeMS = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+void ven::FrustumCuller::cullRange(const std::size_t first, const std::size_t last)
+{
+    const float sizeScaleSq = 4.F * m_projectionScale * m_projectionScale;
+    const float minSizeSq = m_minPixelSize * m_minPixelSize;
+
+    for (std::size_t i = first; i < last; i++) {
+        const BoundingSphere sphere{ .center = {m_centerX[i], m_centerY[i], m_centerZ[i]}, .radius = m_radius[i] };
+
+        if (sphere.radius < 0.F || !m_frustum.intersects(sphere)) {
+            m_visible[i] = 0;
+            m_stats.frustumCulled++;
+            continue;
+        }
+        const glm::vec3 delta = sphere.center - m_cameraPosition;
+        if (sphere.radius * sphere.radius * sizeScaleSq < dot(delta, delta) * minSizeSq) {
+            m_visible[i] = 0;
+            m_stats.smallCulled++;
+        }
+    }
+}
@@ -0,0 +1,41 @@
+#include <algorithm>
+
+#include "VEngine/Scene/Frustum.hpp"
+
+void ven::Frustum::update(const glm::mat4& viewProjection)
+{
+    // Gribb/Hartmann extraction, clip volume is -w <= x,y <= w and 0 <= z <= w (Vulkan depth range)
+    const glm::vec4 row0{viewProjection[0][0], viewProjection[1][0], viewProjection[2][0], viewProjection[3][0]};
+    const glm::vec4 row1{viewProjection[0][1], viewProjection[1][1], viewProjection[2][1], viewProjection[3][1]};
+    const glm::vec4 row2{viewProjection[0][2], viewProjection[1][2], viewProjection[2][2], viewProjection[3][2]};
+    const glm::vec4 row3{viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]};
+
+    m_planes[PLANE_LEFT] = row3 + row0;
+    m_planes[PLANE_RIGHT] = row3 - row0;
+    m_planes[PLANE_BOTTOM] = row3 + row1;
+    m_planes[PLANE_TOP] = row3 - row1;
+    m_planes[PLANE_NEAR] = row2;
+    m_planes[PLANE_FAR] = row3 - row2;
+
+    for (glm::vec4& plane : m_planes) {
+        plane /= length(glm::vec3(plane));
+    }
+}
+
+bool ven::Frustum::intersects(const BoundingSphere& sphere) const
+{
+    return std::ranges::all_of(m_planes, [&sphere](const glm::vec4& plane) {
+        return dot(glm::vec3(plane), sphere.center) + plane.w >= -sphere.radius;
+    });
+}
+
+bool ven::Frustum::intersects(const AABB& box) const
+{
+    const glm::vec3 center = box.center();
+    const glm::vec3 extent = box.extent();
+
+    return std::ranges::all_of(m_planes, [&center, &extent](const glm::vec4& plane) {
+        const float radius = dot(extent, glm::abs(glm::vec3(plane)));
+        return dot(glm::vec3(plane), center) + plane.w >= -radius;
+    });
+}
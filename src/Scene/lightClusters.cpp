@@ -0,0 +1,57 @@
+#include <cmath>
+
+#include "VEngine/Scene/LightClusters.hpp"
+
+void ven::LightClusters::begin(const glm::mat4& projection, const float near, const float far, const glm::vec2& viewport)
+{
+    m_projectionScale = {projection[0][0], projection[1][1]};
+    // slice k starts at near * (far / near)^(k / CLUSTER_GRID_Z), so slice = log(depth) * scale + bias
+    const float logRatio = std::log(far / near);
+    m_scale = {
+        static_cast<float>(CLUSTER_GRID_X) / viewport.x,
+        static_cast<float>(CLUSTER_GRID_Y) / viewport.y,
+        static_cast<float>(CLUSTER_GRID_Z) / logRatio,
+        -static_cast<float>(CLUSTER_GRID_Z) * std::log(near) / logRatio
+    };
+}
+
+glm::uvec3 ven::LightClusters::getCluster(const glm::vec2& pixel, const float depth) const
+{
+    const float slice = std::max((std::log(depth) * m_scale.z) + m_scale.w, 0.F);
+    return {
+        std::min(static_cast<uint32_t>(std::max(pixel.x * m_scale.x, 0.F)), CLUSTER_GRID_X - 1),
+        std::min(static_cast<uint32_t>(std::max(pixel.y * m_scale.y, 0.F)), CLUSTER_GRID_Y - 1),
+        std::min(static_cast<uint32_t>(slice), CLUSTER_GRID_Z - 1)
+    };
+}
+
+ven::AABB ven::LightClusters::getBounds(const glm::uvec3& cluster) const
+{
+    const glm::vec2 grid{static_cast<float>(CLUSTER_GRID_X), static_cast<float>(CLUSTER_GRID_Y)};
+    const glm::vec2 tile{static_cast<float>(cluster.x), static_cast<float>(cluster.y)};
+    const glm::vec2 ndcMin = (tile / grid * 2.F) - 1.F;
+    const glm::vec2 ndcMax = ((tile + 1.F) / grid * 2.F) - 1.F;
+    const float depthNear = std::exp((static_cast<float>(cluster.z) - m_scale.w) / m_scale.z);
+    const float depthFar = std::exp((static_cast<float>(cluster.z + 1) - m_scale.w) / m_scale.z);
+
+    // the tile corners on the near and far planes of the slice, the frustum widens with the depth
+    AABB bounds;
+    for (const float depth : {depthNear, depthFar}) {
+        for (const glm::vec2& ndc : {ndcMin, ndcMax}) {
+            bounds.expand(glm::vec3(ndc.x * depth / m_projectionScale.x, ndc.y * depth / m_projectionScale.y, depth));
+        }
+    }
+    return bounds;
+}
+
+bool ven::LightClusters::intersects(const AABB& bounds, const glm::vec3& center, const float range)
+{
+    const glm::vec3 offset = center - glm::clamp(center, bounds.min, bounds.max);
+    return dot(offset, offset) <= range * range;
+}
+
+float ven::LightClusters::getRange(const float intensity, const float radius, const float cutoff)
+{
+    // intensity * (radius + 1) / distance² == cutoff
+    return std::sqrt(std::max(intensity, 0.F) * (radius + 1.F) / cutoff);
+}
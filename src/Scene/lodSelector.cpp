@@ -0,0 +1,45 @@
+#include <cmath>
+
+#include "VEngine/Scene/LodSelector.hpp"
+
+void ven::LodSelector::begin(const glm::vec3& cameraPosition, const float fov, const float viewportHeight)
+{
+    m_cameraPosition = cameraPosition;
+    // a world space length at distance d covers length * m_projectionScale / d pixels
+    m_projectionScale = viewportHeight / (2.F * std::tan(fov * 0.5F));
+    m_stats = {};
+}
+
+float ven::LodSelector::getScreenError(const float error, const BoundingSphere& sphere) const
+{
+    static constexpr float MIN_DISTANCE = 1e-3F;
+    const float distance = std::max(glm::length(sphere.center - m_cameraPosition) - sphere.radius, MIN_DISTANCE);
+    return error * m_projectionScale / distance;
+}
+
+uint8_t ven::LodSelector::select(const std::span<const MeshLod> lods, const BoundingSphere& sphere, const glm::mat4& model, const uint8_t current)
+{
+    const auto count = static_cast<uint8_t>(std::min(lods.size(), MAX_LOD_COUNT));
+    uint8_t level = 0;
+    if (m_enabled && count > 1) {
+        const BoundingSphere worldSphere = sphere.transform(model);
+        const float scale = sphere.radius > 0.F ? worldSphere.radius / sphere.radius : 1.F;
+        const auto screenError = [&](const uint8_t lod) { return getScreenError(lods[lod].error * scale, worldSphere); };
+        const uint8_t previous = std::min(current, static_cast<uint8_t>(count - 1));
+
+        // coarsest level under the threshold, the errors grow with the level
+        level = previous;
+        while (level + 1 < count && screenError(static_cast<uint8_t>(level + 1)) <= m_pixelError * (1.F - m_hysteresis)) {
+            level++;
+        }
+        if (level == previous) {
+            while (level > 0 && screenError(level) > m_pixelError * (1.F + m_hysteresis)) {
+                level--;
+            }
+        }
+    }
+    m_stats.selected[level]++;
+    m_stats.indexCount += lods.empty() ? 0 : lods[level].indexCount;
+    m_stats.baseIndexCount += lods.empty() ? 0 : lods[0].indexCount;
+    return level;
+}
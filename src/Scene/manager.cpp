@@ -1,66 +1,239 @@
+#include <algorithm>
 #include <numeric>
-#include <ranges>
+#include <unordered_map>
 
+#include "VEngine/Factories/Model.hpp"
 #include "VEngine/Factories/Texture.hpp"
 #include "VEngine/Scene/Manager.hpp"
 #include "VEngine/Utils/Logger.hpp"
 
-ven::SceneManager::SceneManager(const Device& device)
-{
+ven::SceneManager::SceneManager(const Device& device) : m_device{device},
     // including nonCoherentAtomSize allows us to flush a specific index at once
-    unsigned long alignment = std::lcm(
-        device.getProperties().limits.nonCoherentAtomSize,
-        device.getProperties().limits.minUniformBufferOffsetAlignment
-        );
-    for (auto & uboBuffer : m_uboBuffers) {
-        uboBuffer = std::make_unique<Buffer>(
-            device,
-            sizeof(ObjectBufferData),
-            MAX_OBJECTS,
-            VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
-            alignment);
-        uboBuffer->map();
+    m_uboAlignment{std::lcm(device.getProperties().limits.nonCoherentAtomSize, device.getProperties().limits.minUniformBufferOffsetAlignment)}
+{
+    for (unsigned long i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+        reserve(i, DEFAULT_OBJECT_CAPACITY);
+        reserveLights(i, DEFAULT_LIGHT_CAPACITY);
     }
     Logger::logExecutionTime("Creating default texture", [&] {
         m_textureDefault = TextureFactory::create(device, "assets/textures/owned/default.png");
     });
 }
 
+void ven::SceneManager::reserve(const unsigned long frameIndex, const uint32_t objectCount)
+{
+    std::unique_ptr<Buffer>& uboBuffer = m_uboBuffers.at(frameIndex);
+    if (Buffer::reserve(uboBuffer, m_device, sizeof(ObjectBufferData), objectCount, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, m_uboAlignment)) {
+        // the new buffer holds nothing, every object is uploaded again and gets a descriptor into it
+        m_uploadedVersions.at(frameIndex).assign(uboBuffer->getInstanceCount(), 0);
+    }
+}
+
+void ven::SceneManager::reserveLights(const unsigned long frameIndex, const uint32_t lightCount)
+{
+    Buffer::reserve(m_lightBuffers.at(frameIndex), m_device, sizeof(PointLightData), lightCount, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+}
+
 void ven::SceneManager::updateBuffer(GlobalUbo &ubo, const unsigned long frameIndex, const float frameTime)
 {
-    uint8_t lightIndex = 0;
     const glm::mat4 rotateLight = rotate(glm::mat4(1.F), frameTime, {0.F, -1.F, 0.F});
+    const std::span<const uint8_t> lightFlags = m_lights.flags();
+    for (uint32_t i = 0; i < m_lights.size(); i++) {
+        if ((lightFlags[i] & LIGHT_ANIMATED) == 0) { continue; }
+        Transform3D transform = m_lights.transforms()[i];
+        transform.translation = glm::vec3(rotateLight * glm::vec4(transform.translation, transform.scale.x));
+        m_lights.setTransform(i, transform);
+    }
+
+    m_sceneGraph.update();
+    m_objects.updateWorld();
+    m_lights.updateWorld();
+    reserve(frameIndex, m_objects.size());
+    const std::span<const WorldMatrices> worlds = m_objects.worlds();
+    const std::span<const uint64_t> versions = m_objects.versions();
+    const std::span<ObjectBufferInfos> bufferInfos = m_objects.bufferInfos();
+    const Buffer& uboBuffer = *m_uboBuffers.at(frameIndex);
+    std::vector<uint64_t>& uploadedVersions = m_uploadedVersions.at(frameIndex);
 
-    for (Object& object : m_objects | std::views::values) {
+    // the dense index is the uniform buffer slot, each frame in flight keeps the version it holds per slot
+    // versions are unique, so an object moved into another slot by an erase is uploaded again as well
+    for (uint32_t i = 0; i < m_objects.size(); i++) {
+        if (uploadedVersions[i] == versions[i]) { continue; }
         const ObjectBufferData data{
-            .modelMatrix = object.transform.transformMatrix(),
-            .normalMatrix = object.transform.normalMatrix()
+            .modelMatrix = worlds[i].model,
+            .normalMatrix = worlds[i].normal
         };
-        m_uboBuffers.at(frameIndex)->writeToIndex(&data, object.getId());
-        object.setBufferInfo(static_cast<int>(frameIndex), m_uboBuffers.at(frameIndex)->descriptorInfoForIndex(object.getId()));
+        uboBuffer.writeToIndex(&data, i);
+        uboBuffer.flushIndex(i);
+        bufferInfos[i][frameIndex] = uboBuffer.descriptorInfoForIndex(i);
+        uploadedVersions[i] = versions[i];
     }
 
-    for (Light &light : m_lights | std::views::values) {
-        auto&[position, color, shininess, padding] = ubo.pointLights.at(lightIndex);
-        light.transform.translation = glm::vec3(rotateLight * glm::vec4(light.transform.translation, light.transform.scale.x));
-        position = glm::vec4(light.transform.translation, light.transform.scale.x);
-        color = light.color;
-        shininess = light.getShininess();
-        lightIndex++;
+    const std::span<const Transform3D> lightTransforms = m_lights.transforms();
+    const std::span<const glm::vec3> positions = m_lights.positions();
+    const std::span<const glm::vec4> colors = m_lights.colors();
+    const std::span<const float> shininess = m_lights.shininess();
+    // the cache needs the world bounds of this frame, it picks the shadow maps to render again
+    m_shadowLights.clear();
+    for (uint32_t i = 0; i < m_lights.size(); i++) {
+        if ((lightFlags[i] & LIGHT_SHADOW) == 0) { continue; }
+        m_shadowLights.push_back({ .handle = m_lights.handles()[i], .position = positions[i], .range = LightClusters::getRange(colors[i].a, lightTransforms[i].scale.x) });
+    }
+    m_shadowCache.update(m_objects.handles(), m_objects.bounds(), versions, m_shadowLights);
+    const std::span<const int32_t> lightShadows = m_shadowCache.getLightShadows();
+    // every light is uploaded, light_cluster.comp gives each cluster of the view the list of the ones reaching it
+    const auto lightCount = static_cast<uint32_t>(m_lights.size());
+    reserveLights(frameIndex, lightCount);
+    m_lightData.resize(lightCount);
+    for (uint32_t i = 0, shadowLight = 0; i < lightCount; i++) {
+        m_lightData[i] = {
+            .position = glm::vec4(positions[i], lightTransforms[i].scale.x),
+            .color = colors[i],
+            .shininess = shininess[i],
+            .range = LightClusters::getRange(colors[i].a, lightTransforms[i].scale.x),
+            .shadow = (lightFlags[i] & LIGHT_SHADOW) != 0 ? lightShadows[shadowLight++] : -1,
+            .padding = 0.F
+        };
+    }
+    if (lightCount > 0) {
+        m_lightBuffers.at(frameIndex)->writeToBuffer(m_lightData.data(), lightCount * sizeof(PointLightData));
     }
-    ubo.numLights = lightIndex;
+    ubo.clusterGrid.w = lightCount;
 }
 
-void ven::SceneManager::destroyEntity(std::vector<unsigned int>& objectsIds, std::vector<unsigned int>& lightsIds)
+void ven::SceneManager::destroyEntity(std::vector<Handle>& objects, std::vector<Handle>& lights)
 {
-    for (const unsigned int objectId : objectsIds) {
-        m_objects.erase(objectId);
+    // stale handles (removed twice from the GUI) are ignored
+    for (const Handle object : objects) {
+        m_objects.erase(object);
     }
-    for (const unsigned int lightId : lightsIds) {
-        m_lights.erase(lightId);
+    for (const Handle light : lights) {
+        m_lights.erase(light);
     }
-    objectsIds.clear();
-    lightsIds.clear();
+    objects.clear();
+    lights.clear();
     m_destroyState = false;
 }
+
+void ven::SceneManager::save(const std::string& filepath, ThreadPool* threadPool) const
+{
+    SceneFile scene;
+    std::unordered_map<uint32_t, uint32_t> objectIndices; // scene graph node -> object index in the file
+    const std::span<const uint32_t> nodes = m_objects.nodes();
+    for (uint32_t i = 0; i < m_objects.size(); i++) {
+        objectIndices.emplace(nodes[i], i);
+    }
+    const auto parentIndex = [&](const uint32_t parentNode) {
+        const auto it = objectIndices.find(parentNode);
+        return it == objectIndices.end() ? SceneFile::NONE : it->second;
+    };
+    const auto assetIndex = [&](const AssetKind kind, const std::string& path) {
+        return path.empty() ? SceneFile::NONE : scene.addAsset(kind, path, 0);
+    };
+
+    scene.objects.resize(m_objects.size());
+    for (uint32_t i = 0; i < m_objects.size(); i++) {
+        const std::shared_ptr<Model>& model = m_objects.models()[i];
+        const std::shared_ptr<Texture>& diffuseMap = m_objects.diffuseMaps()[i];
+        scene.objects[i] = {
+            .transform = m_objects.transforms()[i],
+            .parent = parentIndex(m_objects.getParent(i)),
+            .model = model != nullptr ? assetIndex(AssetKind::MODEL, model->getFilepath()) : SceneFile::NONE,
+            .diffuseMap = diffuseMap != nullptr ? assetIndex(AssetKind::TEXTURE, diffuseMap->getFilepath()) : SceneFile::NONE,
+            .occluder = m_objects.occluders()[i] != 0,
+            .name = m_objects.names()[i]
+        };
+    }
+    scene.lights.resize(m_lights.size());
+    for (uint32_t i = 0; i < m_lights.size(); i++) {
+        scene.lights[i] = {
+            .transform = m_lights.transforms()[i],
+            .color = m_lights.colors()[i],
+            .shininess = m_lights.shininess()[i],
+            .parent = parentIndex(m_lights.getParent(i)),
+            .flags = m_lights.flags()[i],
+            .name = m_lights.names()[i]
+        };
+    }
+
+    const auto hashAssets = [&scene](const std::size_t begin, const std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            scene.assets[i].contentHash = SceneFile::hashFile(scene.assets[i].path);
+        }
+    };
+    if (threadPool != nullptr) {
+        threadPool->parallelFor(scene.assets.size(), hashAssets);
+    } else {
+        hashAssets(0, scene.assets.size());
+    }
+    scene.save(filepath);
+}
+
+void ven::SceneManager::load(const std::string& filepath, ThreadPool* threadPool)
+{
+    SceneFile scene;
+    scene.load(filepath);
+
+    // hashing reads every asset file, it runs in parallel; the GPU uploads stay on this thread
+    std::vector<uint64_t> hashes(scene.assets.size(), 0);
+    const auto hashAssets = [&](const std::size_t begin, const std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            hashes[i] = SceneFile::hashFile(scene.assets[i].path);
+        }
+    };
+    if (threadPool != nullptr) {
+        threadPool->parallelFor(scene.assets.size(), hashAssets);
+    } else {
+        hashAssets(0, scene.assets.size());
+    }
+    std::vector<std::shared_ptr<Model>> models(scene.assets.size());
+    std::vector<std::shared_ptr<Texture>> textures(scene.assets.size());
+    for (std::size_t i = 0; i < scene.assets.size(); i++) {
+        const SceneAsset& asset = scene.assets[i];
+        if (hashes[i] == 0) {
+            Logger::logWarning("Missing scene asset " + asset.path);
+            continue;
+        }
+        if (hashes[i] != asset.contentHash) {
+            Logger::logWarning("Scene asset " + asset.path + " changed since the scene was saved");
+        }
+        try {
+            if (asset.kind == AssetKind::MODEL) {
+                models[i] = ModelFactory::get(m_device, asset.path, threadPool);
+            } else {
+                textures[i] = TextureFactory::create(m_device, asset.path);
+            }
+        } catch (const std::runtime_error& error) {
+            Logger::logWarning("Failed to load scene asset " + asset.path + ": " + error.what());
+        }
+    }
+
+    m_objects.clear();
+    m_lights.clear();
+
+    // created as roots first, an entity can be saved before its parent
+    m_objects.reserve(scene.objects.size());
+    std::vector<uint32_t> objectNodes(scene.objects.size());
+    for (std::size_t i = 0; i < scene.objects.size(); i++) {
+        const SceneObject& object = scene.objects[i];
+        const Handle handle = m_objects.create(
+            object.model != SceneFile::NONE ? models[object.model] : nullptr,
+            object.diffuseMap != SceneFile::NONE ? textures[object.diffuseMap] : nullptr,
+            object.name,
+            object.transform,
+            object.occluder);
+        objectNodes[i] = m_objects.nodes()[m_objects.indexOf(handle)];
+    }
+    for (std::size_t i = 0; i < scene.objects.size(); i++) {
+        if (scene.objects[i].parent == SceneFile::NONE) { continue; }
+        try {
+            m_sceneGraph.setParent(objectNodes[i], objectNodes[scene.objects[i].parent]);
+        } catch (const std::invalid_argument&) {
+            Logger::logWarning("Ignoring the cyclic parent of scene object " + scene.objects[i].name);
+        }
+    }
+    m_lights.reserve(scene.lights.size());
+    for (const SceneLight& light : scene.lights) {
+        m_lights.create(light.transform, light.color, light.shininess, light.name, light.parent != SceneFile::NONE ? objectNodes[light.parent] : SceneGraph::NONE, light.flags);
+    }
+}
@@ -0,0 +1,308 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numeric>
+#include <utility>
+
+#include "VEngine/Scene/MeshOptimizer.hpp"
+
+namespace {
+
+    constexpr uint32_t NONE = UINT32_MAX;
+
+    // Forsyth scoring: LRU cache of 32 entries, the last triangle vertices get a fixed score so they are not reused right away
+    constexpr uint32_t FORSYTH_CACHE_SIZE = 32;
+    constexpr uint32_t FORSYTH_MAX_VALENCE = 32;
+    constexpr float FORSYTH_LAST_TRIANGLE_SCORE = 0.75F;
+    constexpr float FORSYTH_CACHE_DECAY_POWER = 1.5F;
+    constexpr float FORSYTH_VALENCE_BOOST_SCALE = 2.F;
+    constexpr float FORSYTH_VALENCE_BOOST_POWER = 0.5F;
+
+    struct ForsythTables {
+        std::array<float, FORSYTH_CACHE_SIZE> cache{};
+        std::array<float, FORSYTH_MAX_VALENCE> valence{};
+
+        ForsythTables()
+        {
+            for (uint32_t i = 0; i < FORSYTH_CACHE_SIZE; i++) {
+                cache[i] = i < 3 ? FORSYTH_LAST_TRIANGLE_SCORE : std::pow(1.F - (static_cast<float>(i - 3) / static_cast<float>(FORSYTH_CACHE_SIZE - 3)), FORSYTH_CACHE_DECAY_POWER);
+            }
+            for (uint32_t i = 1; i < FORSYTH_MAX_VALENCE; i++) {
+                // vertices with few triangles left are finished first so they leave no lone triangle behind
+                valence[i] = FORSYTH_VALENCE_BOOST_SCALE * std::pow(static_cast<float>(i), -FORSYTH_VALENCE_BOOST_POWER);
+            }
+        }
+
+        [[nodiscard]] float score(const uint32_t cachePosition, const uint32_t remaining) const
+        {
+            if (remaining == 0) { return -1.F; }
+            return (cachePosition == NONE ? 0.F : cache[cachePosition]) + valence[std::min(remaining, FORSYTH_MAX_VALENCE - 1)];
+        }
+    };
+
+    ///
+    /// @brief FIFO cache simulation, a vertex is cached while fewer than size misses happened since its own
+    ///
+    class FifoCache {
+
+        public:
+
+            FifoCache(const uint32_t firstVertex, const std::size_t vertexCount, const uint32_t size) : m_stamps(vertexCount, 0), m_first{firstVertex}, m_size{size}, m_time{size} {}
+
+            ///
+            /// @return true on a miss
+            ///
+            bool access(const uint32_t vertex)
+            {
+                uint32_t& stamp = m_stamps[vertex - m_first];
+                if (m_time - stamp < m_size) { return false; }
+                stamp = ++m_time;
+                return true;
+            }
+            void reset() { m_time += m_size; }
+
+        private:
+
+            std::vector<uint32_t> m_stamps;
+            uint32_t m_first;
+            uint32_t m_size;
+            uint32_t m_time;
+
+    };
+
+    ///
+    /// @brief Smallest index and size of the index range, so the per vertex arrays of a mesh don't span the whole model vertex buffer
+    ///
+    std::pair<uint32_t, std::size_t> vertexRange(const std::span<const uint32_t> indices)
+    {
+        const auto [first, last] = std::ranges::minmax_element(indices);
+        return { *first, static_cast<std::size_t>(*last - *first) + 1 };
+    }
+
+    uint32_t triangleMisses(FifoCache& cache, const std::span<const uint32_t> indices, const std::size_t triangle)
+    {
+        uint32_t misses = 0;
+        for (std::size_t corner = 0; corner < 3; corner++) {
+            misses += cache.access(indices[(triangle * 3) + corner]) ? 1U : 0U;
+        }
+        return misses;
+    }
+
+} // namespace
+
+ven::VertexCacheStats ven::MeshOptimizer::analyzeVertexCache(const std::span<const uint32_t> indices, const uint32_t cacheSize)
+{
+    const std::size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0) { return {}; }
+    const auto [firstVertex, vertexCount] = vertexRange(indices);
+    FifoCache cache(firstVertex, vertexCount, cacheSize);
+    std::vector<uint8_t> referenced(vertexCount, 0);
+    uint32_t misses = 0;
+    uint32_t unique = 0;
+    for (std::size_t triangle = 0; triangle < triangleCount; triangle++) {
+        misses += triangleMisses(cache, indices, triangle);
+    }
+    for (const uint32_t index : indices) {
+        unique += referenced[index - firstVertex] == 0 ? 1U : 0U;
+        referenced[index - firstVertex] = 1;
+    }
+    return { .acmr = static_cast<float>(misses) / static_cast<float>(triangleCount), .atvr = static_cast<float>(misses) / static_cast<float>(unique) };
+}
+
+void ven::MeshOptimizer::optimizeVertexCache(const std::span<uint32_t> indices)
+{
+    static const ForsythTables tables;
+    const std::size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0) { return; }
+    // local vertex numbering, restored on output
+    const auto [firstVertex, vertexCount] = vertexRange(indices);
+    std::vector<uint32_t> source(triangleCount * 3);
+    std::ranges::transform(indices.first(source.size()), source.begin(), [firstVertex](const uint32_t index) { return index - firstVertex; });
+
+    // vertex -> live triangles, the first remaining[vertex] entries of its range
+    std::vector<uint32_t> remaining(vertexCount, 0);
+    for (const uint32_t index : source) {
+        remaining[index]++;
+    }
+    std::vector<uint32_t> offsets(vertexCount + 1, 0);
+    std::partial_sum(remaining.begin(), remaining.end(), offsets.begin() + 1);
+    std::vector<uint32_t> adjacency(source.size());
+    std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+    for (std::size_t i = 0; i < source.size(); i++) {
+        adjacency[fill[source[i]]++] = static_cast<uint32_t>(i / 3);
+    }
+
+    std::vector<uint32_t> cachePositions(vertexCount, NONE);
+    std::vector<float> vertexScores(vertexCount, 0.F);
+    for (std::size_t vertex = 0; vertex < vertexCount; vertex++) {
+        vertexScores[vertex] = tables.score(NONE, remaining[vertex]);
+    }
+    std::vector<float> triangleScores(triangleCount, 0.F);
+    uint32_t best = 0;
+    for (std::size_t triangle = 0; triangle < triangleCount; triangle++) {
+        triangleScores[triangle] = vertexScores[source[triangle * 3]] + vertexScores[source[(triangle * 3) + 1]] + vertexScores[source[(triangle * 3) + 2]];
+        best = triangleScores[triangle] > triangleScores[best] ? static_cast<uint32_t>(triangle) : best;
+    }
+
+    std::vector<uint8_t> emitted(triangleCount, 0);
+    std::vector<uint32_t> cache;
+    std::vector<uint32_t> nextCache;
+    std::size_t cursor = 0;
+    for (std::size_t output = 0; output < triangleCount; output++) {
+        if (best == NONE) {
+            // nothing left around the cache, restart from the next triangle of the input order
+            while (emitted[cursor] != 0) { cursor++; }
+            best = static_cast<uint32_t>(cursor);
+        }
+        emitted[best] = 1;
+        nextCache.clear();
+        for (uint32_t corner = 0; corner < 3; corner++) {
+            const uint32_t vertex = source[(best * 3) + corner];
+            indices[(output * 3) + corner] = vertex + firstVertex;
+            const auto live = adjacency.begin() + offsets[vertex];
+            std::iter_swap(std::find(live, live + remaining[vertex], best), live + remaining[vertex] - 1);
+            remaining[vertex]--;
+            if (std::ranges::find(nextCache, vertex) == nextCache.end()) {
+                nextCache.push_back(vertex);
+            }
+        }
+        const std::size_t triangleVertices = nextCache.size();
+        for (const uint32_t vertex : cache) {
+            if (std::find(nextCache.begin(), nextCache.begin() + static_cast<std::ptrdiff_t>(triangleVertices), vertex) == nextCache.begin() + static_cast<std::ptrdiff_t>(triangleVertices)) {
+                nextCache.push_back(vertex);
+            }
+        }
+
+        // rescore the vertices whose cache position or valence changed, the evicted ones included
+        for (std::size_t i = 0; i < nextCache.size(); i++) {
+            const uint32_t vertex = nextCache[i];
+            cachePositions[vertex] = i < FORSYTH_CACHE_SIZE ? static_cast<uint32_t>(i) : NONE;
+            const float score = tables.score(cachePositions[vertex], remaining[vertex]);
+            const float delta = score - vertexScores[vertex];
+            vertexScores[vertex] = score;
+            for (uint32_t j = offsets[vertex]; j < offsets[vertex] + remaining[vertex]; j++) {
+                triangleScores[adjacency[j]] += delta;
+            }
+        }
+        if (nextCache.size() > FORSYTH_CACHE_SIZE) {
+            nextCache.resize(FORSYTH_CACHE_SIZE);
+        }
+        std::swap(cache, nextCache);
+
+        best = NONE;
+        float bestScore = 0.F;
+        for (const uint32_t vertex : cache) {
+            for (uint32_t j = offsets[vertex]; j < offsets[vertex] + remaining[vertex]; j++) {
+                const uint32_t triangle = adjacency[j];
+                if (best == NONE || triangleScores[triangle] > bestScore || (triangleScores[triangle] == bestScore && triangle < best)) {
+                    best = triangle;
+                    bestScore = triangleScores[triangle];
+                }
+            }
+        }
+    }
+}
+
+void ven::MeshOptimizer::optimizeOverdraw(const std::span<uint32_t> indices, const std::span<const glm::vec3> positions, const float threshold)
+{
+    const std::size_t triangleCount = indices.size() / 3;
+    if (triangleCount < 2) { return; }
+
+    // hard boundaries: the cache starts over where a triangle misses its three vertices, reordering there costs nothing
+    const auto [firstVertex, vertexCount] = vertexRange(indices);
+    FifoCache cache(firstVertex, vertexCount, DEFAULT_VERTEX_CACHE_SIZE);
+    std::vector<uint32_t> hardClusters;
+    for (std::size_t triangle = 0; triangle < triangleCount; triangle++) {
+        if (triangleMisses(cache, indices, triangle) == 3) {
+            hardClusters.push_back(static_cast<uint32_t>(triangle));
+        }
+    }
+    hardClusters.push_back(static_cast<uint32_t>(triangleCount));
+
+    // soft boundaries: split a hard cluster wherever restarting the cache keeps its ACMR under threshold times the cluster one
+    std::vector<uint32_t> clusters;
+    for (std::size_t hard = 0; hard + 1 < hardClusters.size(); hard++) {
+        const uint32_t start = hardClusters[hard];
+        const uint32_t end = hardClusters[hard + 1];
+        cache.reset();
+        uint32_t clusterMisses = 0;
+        for (uint32_t triangle = start; triangle < end; triangle++) {
+            clusterMisses += triangleMisses(cache, indices, triangle);
+        }
+        const float limit = threshold * static_cast<float>(clusterMisses) / static_cast<float>(end - start);
+        cache.reset();
+        clusters.push_back(start);
+        uint32_t misses = 0;
+        uint32_t count = 0;
+        for (uint32_t triangle = start; triangle + 1 < end; triangle++) {
+            misses += triangleMisses(cache, indices, triangle);
+            count++;
+            if (static_cast<float>(misses) <= limit * static_cast<float>(count)) {
+                clusters.push_back(triangle + 1);
+                cache.reset();
+                misses = 0;
+                count = 0;
+            }
+        }
+    }
+    clusters.push_back(static_cast<uint32_t>(triangleCount));
+
+    // clusters facing away from the mesh center are on its outside, drawn first they hide the inner ones
+    const std::size_t clusterCount = clusters.size() - 1;
+    std::vector<glm::vec3> centroids(clusterCount, glm::vec3(0.F));
+    std::vector<glm::vec3> normals(clusterCount, glm::vec3(0.F));
+    std::vector<float> areas(clusterCount, 0.F);
+    glm::vec3 meshCentroid{0.F};
+    float meshArea = 0.F;
+    for (std::size_t cluster = 0; cluster < clusterCount; cluster++) {
+        for (uint32_t triangle = clusters[cluster]; triangle < clusters[cluster + 1]; triangle++) {
+            const glm::vec3& p0 = positions[indices[triangle * 3]];
+            const glm::vec3& p1 = positions[indices[(triangle * 3) + 1]];
+            const glm::vec3& p2 = positions[indices[(triangle * 3) + 2]];
+            const glm::vec3 normal = cross(p1 - p0, p2 - p0);
+            const float area = glm::length(normal);
+            centroids[cluster] += (p0 + p1 + p2) * (area / 3.F);
+            normals[cluster] += normal;
+            areas[cluster] += area;
+        }
+        meshCentroid += centroids[cluster];
+        meshArea += areas[cluster];
+    }
+    if (meshArea <= 0.F) { return; }
+    meshCentroid /= meshArea;
+    std::vector<float> keys(clusterCount, 0.F);
+    for (std::size_t cluster = 0; cluster < clusterCount; cluster++) {
+        const float normalLength = glm::length(normals[cluster]);
+        if (areas[cluster] <= 0.F || normalLength <= 0.F) { continue; }
+        keys[cluster] = dot((centroids[cluster] / areas[cluster]) - meshCentroid, normals[cluster] / normalLength);
+    }
+    std::vector<uint32_t> order(clusterCount);
+    std::iota(order.begin(), order.end(), 0);
+    std::ranges::stable_sort(order, [&keys](const uint32_t a, const uint32_t b) { return keys[a] > keys[b]; });
+
+    const std::vector<uint32_t> source(indices.begin(), indices.begin() + static_cast<std::ptrdiff_t>(triangleCount * 3));
+    std::size_t output = 0;
+    for (const uint32_t cluster : order) {
+        for (uint32_t i = clusters[cluster] * 3; i < clusters[cluster + 1] * 3; i++) {
+            indices[output++] = source[i];
+        }
+    }
+}
+
+std::vector<uint32_t> ven::MeshOptimizer::optimizeVertexFetch(const std::span<uint32_t> indices, const std::size_t vertexCount)
+{
+    std::vector<uint32_t> remap(vertexCount, NONE);
+    uint32_t next = 0;
+    for (uint32_t& index : indices) {
+        if (remap[index] == NONE) {
+            remap[index] = next++;
+        }
+        index = remap[index];
+    }
+    for (uint32_t& index : remap) {
+        if (index == NONE) {
+            index = next++;
+        }
+    }
+    return remap;
+}
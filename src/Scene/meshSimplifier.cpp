@@ -0,0 +1,349 @@
+#include <array>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+
+#include "VEngine/Scene/MeshSimplifier.hpp"
+
+namespace {
+
+    // cosine of the largest normal rotation a collapse may cause on the triangles it moves
+    constexpr float MIN_NORMAL_DOT = 0.2F;
+
+    ///
+    /// @brief Sum of squared distances to a set of planes, symmetric 4x4 matrix stored as its upper triangle
+    ///
+    struct Quadric {
+        std::array<double, 10> m{};
+
+        static Quadric fromPlane(const double a, const double b, const double c, const double d) {
+            return { .m = { a * a, a * b, a * c, a * d, b * b, b * c, b * d, c * c, c * d, d * d } };
+        }
+
+        Quadric& operator+=(const Quadric& other) {
+            for (std::size_t i = 0; i < m.size(); i++) { m[i] += other.m[i]; }
+            return *this;
+        }
+
+        [[nodiscard]] double evaluate(const glm::vec3& point) const {
+            const double x = point.x;
+            const double y = point.y;
+            const double z = point.z;
+            return (m[0] * x * x) + (2.0 * m[1] * x * y) + (2.0 * m[2] * x * z) + (2.0 * m[3] * x)
+                + (m[4] * y * y) + (2.0 * m[5] * y * z) + (2.0 * m[6] * y)
+                + (m[7] * z * z) + (2.0 * m[8] * z)
+                + m[9];
+        }
+    };
+
+    struct Collapse {
+        double cost{0.0};
+        uint32_t from{0};
+        uint32_t to{0};
+        uint32_t fromVersion{0};
+        uint32_t toVersion{0};
+
+        bool operator>(const Collapse& other) const { return cost > other.cost; }
+    };
+
+    uint64_t edgeKey(const uint32_t a, const uint32_t b)
+    {
+        return (static_cast<uint64_t>(std::min(a, b)) << 32U) | std::max(a, b);
+    }
+
+    glm::vec3 triangleNormal(const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2)
+    {
+        return cross(p1 - p0, p2 - p0);
+    }
+
+    class Simplifier {
+
+        public:
+
+            Simplifier(const std::span<const glm::vec3> positions, const std::span<const uint32_t> indices)
+            {
+                // compact the vertices referenced by the range, a mesh only uses a small part of the model vertex buffer
+                std::unordered_map<uint32_t, uint32_t> remap;
+                for (std::size_t i = 0; i + 2 < indices.size(); i += 3) {
+                    std::array<uint32_t, 3> triangle{};
+                    for (std::size_t corner = 0; corner < 3; corner++) {
+                        const auto [it, inserted] = remap.try_emplace(indices[i + corner], static_cast<uint32_t>(m_globals.size()));
+                        if (inserted) {
+                            m_globals.push_back(indices[i + corner]);
+                            m_points.push_back(positions[indices[i + corner]]);
+                        }
+                        triangle[corner] = it->second;
+                    }
+                    if (triangle[0] != triangle[1] && triangle[1] != triangle[2] && triangle[0] != triangle[2]) {
+                        m_triangles.push_back(triangle);
+                    }
+                }
+                const std::size_t vertexCount = m_globals.size();
+                m_quadrics.resize(vertexCount);
+                m_locked.assign(vertexCount, 0);
+                m_removed.assign(vertexCount, 0);
+                m_versions.assign(vertexCount, 0);
+                m_vertexTriangles.resize(vertexCount);
+                m_alive.assign(m_triangles.size(), 1);
+                m_indexCount = m_triangles.size() * 3;
+
+                lockSeams();
+                lockOpenEdges();
+                for (uint32_t triangle = 0; triangle < m_triangles.size(); triangle++) {
+                    const auto& [v0, v1, v2] = m_triangles[triangle];
+                    glm::vec3 normal = triangleNormal(m_points[v0], m_points[v1], m_points[v2]);
+                    const float length = glm::length(normal);
+                    for (const uint32_t vertex : m_triangles[triangle]) {
+                        m_vertexTriangles[vertex].push_back(triangle);
+                    }
+                    if (length <= 0.F) { continue; }
+                    normal /= length;
+                    const Quadric quadric = Quadric::fromPlane(normal.x, normal.y, normal.z, -static_cast<double>(dot(normal, m_points[v0])));
+                    for (const uint32_t vertex : m_triangles[triangle]) {
+                        m_quadrics[vertex] += quadric;
+                    }
+                }
+                for (uint32_t vertex = 0; vertex < vertexCount; vertex++) {
+                    pushCandidates(vertex);
+                }
+            }
+
+            ven::SimplifiedMesh run(const std::size_t targetIndexCount, const float maxError)
+            {
+                ven::SimplifiedMesh result;
+                const double maxCost = static_cast<double>(maxError) * static_cast<double>(maxError);
+                while (m_indexCount > targetIndexCount && !m_heap.empty()) {
+                    const Collapse collapse = m_heap.top();
+                    m_heap.pop();
+                    if (m_removed[collapse.from] != 0 || m_removed[collapse.to] != 0 || m_versions[collapse.from] != collapse.fromVersion || m_versions[collapse.to] != collapse.toVersion) {
+                        continue;
+                    }
+                    // the remaining valid candidates all cost more
+                    if (collapse.cost > maxCost) { break; }
+                    if (!canCollapse(collapse.from, collapse.to)) { continue; }
+                    apply(collapse.from, collapse.to);
+                    result.error = std::max(result.error, static_cast<float>(std::sqrt(std::max(collapse.cost, 0.0))));
+                }
+                result.indices.reserve(m_indexCount);
+                for (std::size_t triangle = 0; triangle < m_triangles.size(); triangle++) {
+                    if (m_alive[triangle] == 0) { continue; }
+                    for (const uint32_t vertex : m_triangles[triangle]) {
+                        result.indices.push_back(m_globals[vertex]);
+                    }
+                }
+                return result;
+            }
+
+        private:
+
+            void lockSeams()
+            {
+                // split vertices sharing a position: UV or normal seams, and the corners of disconnected parts
+                std::vector<uint32_t> order(m_points.size());
+                for (uint32_t i = 0; i < order.size(); i++) { order[i] = i; }
+                const auto less = [this](const uint32_t a, const uint32_t b) {
+                    const glm::vec3& pa = m_points[a];
+                    const glm::vec3& pb = m_points[b];
+                    if (pa.x != pb.x) { return pa.x < pb.x; }
+                    if (pa.y != pb.y) { return pa.y < pb.y; }
+                    return pa.z < pb.z;
+                };
+                std::ranges::sort(order, less);
+                for (std::size_t i = 1; i < order.size(); i++) {
+                    if (m_points[order[i]] == m_points[order[i - 1]]) {
+                        m_locked[order[i]] = 1;
+                        m_locked[order[i - 1]] = 1;
+                    }
+                }
+            }
+
+            void lockOpenEdges()
+            {
+                // borders with other meshes, holes, seams and non manifold edges are not shared by exactly two triangles
+                std::unordered_map<uint64_t, uint32_t> edgeUses;
+                edgeUses.reserve(m_triangles.size() * 3);
+                for (const auto& triangle : m_triangles) {
+                    for (std::size_t corner = 0; corner < 3; corner++) {
+                        edgeUses[edgeKey(triangle[corner], triangle[(corner + 1) % 3])]++;
+                    }
+                }
+                for (const auto& [key, uses] : edgeUses) {
+                    if (uses == 2) { continue; }
+                    m_locked[static_cast<uint32_t>(key >> 32U)] = 1;
+                    m_locked[static_cast<uint32_t>(key & UINT32_MAX)] = 1;
+                }
+            }
+
+            void pushCandidates(const uint32_t vertex)
+            {
+                for (const uint32_t triangle : m_vertexTriangles[vertex]) {
+                    if (m_alive[triangle] == 0) { continue; }
+                    for (const uint32_t other : m_triangles[triangle]) {
+                        if (other == vertex) { continue; }
+                        push(vertex, other);
+                        push(other, vertex);
+                    }
+                }
+            }
+
+            void push(const uint32_t from, const uint32_t to)
+            {
+                if (m_locked[from] != 0) { return; }
+                Quadric quadric = m_quadrics[from];
+                quadric += m_quadrics[to];
+                m_heap.push({ .cost = quadric.evaluate(m_points[to]), .from = from, .to = to, .fromVersion = m_versions[from], .toVersion = m_versions[to] });
+            }
+
+            [[nodiscard]] bool canCollapse(const uint32_t from, const uint32_t to)
+            {
+                // the edge must still exist and the vertices may only share the neighbours of its triangles (link condition), otherwise the surface folds
+                m_fromNeighbours.clear();
+                m_toNeighbours.clear();
+                uint32_t sharedTriangles = 0;
+                for (const uint32_t triangle : m_vertexTriangles[from]) {
+                    if (m_alive[triangle] == 0) { continue; }
+                    bool shared = false;
+                    for (const uint32_t vertex : m_triangles[triangle]) {
+                        shared = shared || vertex == to;
+                        if (vertex != from) { m_fromNeighbours.push_back(vertex); }
+                    }
+                    if (shared) {
+                        sharedTriangles++;
+                        continue;
+                    }
+                    const auto& [v0, v1, v2] = m_triangles[triangle];
+                    const glm::vec3 before = triangleNormal(m_points[v0], m_points[v1], m_points[v2]);
+                    const glm::vec3 after = triangleNormal(v0 == from ? m_points[to] : m_points[v0], v1 == from ? m_points[to] : m_points[v1], v2 == from ? m_points[to] : m_points[v2]);
+                    const float afterLength = glm::length(after);
+                    if (afterLength <= 0.F || dot(before, after) < MIN_NORMAL_DOT * glm::length(before) * afterLength) {
+                        return false;
+                    }
+                }
+                if (sharedTriangles == 0) { return false; }
+                for (const uint32_t triangle : m_vertexTriangles[to]) {
+                    if (m_alive[triangle] == 0) { continue; }
+                    for (const uint32_t vertex : m_triangles[triangle]) {
+                        if (vertex != to) { m_toNeighbours.push_back(vertex); }
+                    }
+                }
+                std::ranges::sort(m_fromNeighbours);
+                std::ranges::sort(m_toNeighbours);
+                const auto [fromEnd, fromLast] = std::ranges::unique(m_fromNeighbours);
+                m_fromNeighbours.erase(fromEnd, fromLast);
+                const auto [toEnd, toLast] = std::ranges::unique(m_toNeighbours);
+                m_toNeighbours.erase(toEnd, toLast);
+                std::size_t common = 0;
+                for (std::size_t i = 0, j = 0; i < m_fromNeighbours.size() && j < m_toNeighbours.size();) {
+                    if (m_fromNeighbours[i] < m_toNeighbours[j]) { i++; }
+                    else if (m_toNeighbours[j] < m_fromNeighbours[i]) { j++; }
+                    else { common++; i++; j++; }
+                }
+                return common == sharedTriangles;
+            }
+
+            void apply(const uint32_t from, const uint32_t to)
+            {
+                for (const uint32_t triangle : m_vertexTriangles[from]) {
+                    if (m_alive[triangle] == 0) { continue; }
+                    auto& vertices = m_triangles[triangle];
+                    if (std::ranges::find(vertices, to) != vertices.end()) {
+                        m_alive[triangle] = 0;
+                        m_indexCount -= 3;
+                        continue;
+                    }
+                    *std::ranges::find(vertices, from) = to;
+                    m_vertexTriangles[to].push_back(triangle);
+                }
+                m_vertexTriangles[from].clear();
+                std::erase_if(m_vertexTriangles[to], [this](const uint32_t triangle) { return m_alive[triangle] == 0; });
+                m_quadrics[to] += m_quadrics[from];
+                m_removed[from] = 1;
+                m_versions[to]++;
+                pushCandidates(to);
+            }
+
+            std::vector<uint32_t> m_globals;
+            std::vector<glm::vec3> m_points;
+            std::vector<std::array<uint32_t, 3>> m_triangles;
+            std::vector<uint8_t> m_alive;
+            std::vector<Quadric> m_quadrics;
+            std::vector<uint8_t> m_locked;
+            std::vector<uint8_t> m_removed;
+            std::vector<uint32_t> m_versions;
+            std::vector<std::vector<uint32_t>> m_vertexTriangles;
+            std::vector<uint32_t> m_fromNeighbours;
+            std::vector<uint32_t> m_toNeighbours;
+            std::priority_queue<Collapse, std::vector<Collapse>, std::greater<>> m_heap;
+            std::size_t m_indexCount{0};
+
+    };
+
+    float halfDiagonal(const std::span<const glm::vec3> positions, const std::span<const uint32_t> indices)
+    {
+        ven::AABB bounds;
+        for (const uint32_t index : indices) {
+            bounds.expand(positions[index]);
+        }
+        return bounds.isValid() ? glm::length(bounds.extent()) : 0.F;
+    }
+
+} // namespace
+
+ven::SimplifiedMesh ven::MeshSimplifier::simplify(const std::span<const glm::vec3> positions, const std::span<const uint32_t> indices, const std::size_t targetIndexCount, const float maxError)
+{
+    Simplifier simplifier(positions, indices);
+    return simplifier.run(targetIndexCount, maxError);
+}
+
+ven::LodChain ven::MeshSimplifier::buildChain(const std::span<const glm::vec3> positions, std::vector<uint32_t>& indices, const std::span<const PvsMeshRange> meshes, const LodSettings& settings, ThreadPool* threadPool)
+{
+    LodChain chain;
+    chain.meshes.resize(meshes.size());
+    std::vector<float> maxErrors(meshes.size());
+    uint32_t baseFirst = UINT32_MAX;
+    uint32_t baseEnd = 0;
+    for (std::size_t mesh = 0; mesh < meshes.size(); mesh++) {
+        const PvsMeshRange& range = meshes[mesh];
+        chain.meshes[mesh].push_back({ .firstIndex = range.firstIndex, .indexCount = range.indexCount, .error = 0.F });
+        maxErrors[mesh] = halfDiagonal(positions, std::span(indices).subspan(range.firstIndex, range.indexCount)) * settings.maxRelativeError;
+        baseFirst = std::min(baseFirst, range.firstIndex);
+        baseEnd = std::max(baseEnd, range.firstIndex + range.indexCount);
+    }
+    if (meshes.empty()) { return chain; }
+    chain.levels.push_back({ .firstIndex = baseFirst, .indexCount = baseEnd - baseFirst, .error = 0.F });
+
+    std::vector<SimplifiedMesh> simplified(meshes.size());
+    for (uint32_t level = 1; level < std::min<std::size_t>(settings.levelCount, MAX_LOD_COUNT); level++) {
+        // each level is simplified from the previous one, the errors add up
+        const auto simplifyRange = [&](const std::size_t begin, const std::size_t end) {
+            for (std::size_t mesh = begin; mesh < end; mesh++) {
+                const MeshLod& previous = chain.meshes[mesh].back();
+                const auto target = static_cast<std::size_t>(static_cast<float>(previous.indexCount) * settings.reduction);
+                simplified[mesh] = simplify(positions, std::span(indices).subspan(previous.firstIndex, previous.indexCount), target - (target % 3), maxErrors[mesh]);
+                simplified[mesh].error += previous.error;
+            }
+        };
+        if (threadPool != nullptr) {
+            threadPool->parallelFor(meshes.size(), simplifyRange);
+        } else {
+            simplifyRange(0, meshes.size());
+        }
+
+        const MeshLod& previousLevel = chain.levels.back();
+        std::size_t levelCount = 0;
+        for (const SimplifiedMesh& mesh : simplified) {
+            levelCount += mesh.indices.size();
+        }
+        if (static_cast<float>(levelCount) > static_cast<float>(previousLevel.indexCount) * settings.minLevelReduction) {
+            break;
+        }
+        MeshLod levelRange{ .firstIndex = static_cast<uint32_t>(indices.size()), .indexCount = static_cast<uint32_t>(levelCount), .error = 0.F };
+        for (std::size_t mesh = 0; mesh < meshes.size(); mesh++) {
+            chain.meshes[mesh].push_back({ .firstIndex = static_cast<uint32_t>(indices.size()), .indexCount = static_cast<uint32_t>(simplified[mesh].indices.size()), .error = simplified[mesh].error });
+            levelRange.error = std::max(levelRange.error, simplified[mesh].error);
+            indices.insert(indices.end(), simplified[mesh].indices.begin(), simplified[mesh].indices.end());
+        }
+        chain.levels.push_back(levelRange);
+    }
+    return chain;
+}
@@ -0,0 +1,184 @@
+#include <unordered_map>
+
+#include "VEngine/Scene/Meshlet.hpp"
+
+namespace {
+
+    // normal cones wider than this (cosine of the spread to the axis) never face away, the backface test is disabled
+    constexpr float MIN_CONE_DOT = 0.1F;
+
+    void computeBounds(const std::span<const glm::vec3> positions, const std::span<const uint32_t> indices, const std::span<const uint32_t> triangles, ven::Meshlet& meshlet)
+    {
+        ven::AABB box;
+        for (uint32_t i = 0; i < meshlet.vertexCount; i++) {
+            box.expand(positions[indices[meshlet.vertexOffset + i]]);
+        }
+        const glm::vec3 center = box.center();
+        float radius = 0.F;
+        for (uint32_t i = 0; i < meshlet.vertexCount; i++) {
+            radius = std::max(radius, glm::length(positions[indices[meshlet.vertexOffset + i]] - center));
+        }
+        meshlet.sphere = glm::vec4(center, radius);
+
+        std::vector<glm::vec3> normals;
+        normals.reserve(meshlet.triangleCount);
+        glm::vec3 axis{0.F};
+        for (uint32_t i = 0; i < meshlet.triangleCount; i++) {
+            const uint32_t packed = triangles[meshlet.triangleOffset + i];
+            const glm::vec3& p0 = positions[indices[meshlet.vertexOffset + (packed & 0xFFU)]];
+            const glm::vec3& p1 = positions[indices[meshlet.vertexOffset + ((packed >> 8U) & 0xFFU)]];
+            const glm::vec3& p2 = positions[indices[meshlet.vertexOffset + ((packed >> 16U) & 0xFFU)]];
+            const glm::vec3 normal = cross(p1 - p0, p2 - p0);
+            const float length = glm::length(normal);
+            if (length <= 0.F) { continue; }
+            normals.push_back(normal / length);
+            axis += normals.back();
+        }
+        meshlet.cone = glm::vec4(0.F, 0.F, 1.F, 1.F);
+        const float axisLength = glm::length(axis);
+        if (axisLength <= 0.F) { return; }
+        axis /= axisLength;
+        float minDot = 1.F;
+        for (const glm::vec3& normal : normals) {
+            minDot = std::min(minDot, dot(normal, axis));
+        }
+        if (minDot <= MIN_CONE_DOT) {
+            meshlet.cone = glm::vec4(axis, 1.F);
+            return;
+        }
+        // a triangle faces away when the view direction is within 90 degrees - spread of the axis, i.e. their dot product reaches sin(spread)
+        meshlet.cone = glm::vec4(axis, std::sqrt(1.F - (minDot * minDot)));
+    }
+
+} // namespace
+
+uint32_t ven::MeshletBuilder::build(const std::span<const glm::vec3> positions, const std::span<const uint32_t> indices, MeshletData& data)
+{
+    const std::size_t triangleCount = indices.size() / 3;
+    // compact the vertices referenced by the range, then link each vertex to its triangles (CSR)
+    std::unordered_map<uint32_t, uint32_t> remap;
+    std::vector<uint32_t> corners(triangleCount * 3);
+    for (std::size_t i = 0; i < corners.size(); i++) {
+        corners[i] = remap.try_emplace(indices[i], static_cast<uint32_t>(remap.size())).first->second;
+    }
+    const std::size_t vertexCount = remap.size();
+    std::vector<uint32_t> triangleOffsets(vertexCount + 1, 0);
+    for (const uint32_t corner : corners) {
+        triangleOffsets[corner + 1]++;
+    }
+    for (std::size_t i = 0; i < vertexCount; i++) {
+        triangleOffsets[i + 1] += triangleOffsets[i];
+    }
+    std::vector<uint32_t> vertexTriangles(corners.size());
+    std::vector<uint32_t> fill(triangleOffsets.begin(), triangleOffsets.end() - 1);
+    for (std::size_t i = 0; i < corners.size(); i++) {
+        vertexTriangles[fill[corners[i]]++] = static_cast<uint32_t>(i / 3);
+    }
+
+    std::vector<uint8_t> used(triangleCount, 0);
+    std::vector<uint8_t> queued(triangleCount, 0);
+    std::vector<uint32_t> localIndex(vertexCount, UINT32_MAX);
+    std::vector<uint32_t> candidates;
+    std::size_t scan = 0;
+    const auto firstMeshlet = static_cast<uint32_t>(data.meshlets.size());
+    Meshlet meshlet{ .vertexOffset = static_cast<uint32_t>(data.vertices.size()), .triangleOffset = static_cast<uint32_t>(data.triangles.size()) };
+
+    glm::vec3 centerSum{0.F};
+    const auto centroid = [&](const uint32_t triangle) {
+        return (positions[indices[triangle * 3]] + positions[indices[(triangle * 3) + 1]] + positions[indices[(triangle * 3) + 2]]) * (1.F / 3.F);
+    };
+    const auto newVertexCount = [&](const uint32_t triangle) {
+        uint32_t count = 0;
+        for (uint32_t corner = 0; corner < 3; corner++) {
+            count += localIndex[corners[(triangle * 3) + corner]] == UINT32_MAX ? 1U : 0U;
+        }
+        return count;
+    };
+    const auto flush = [&] {
+        if (meshlet.triangleCount == 0) { return; }
+        for (uint32_t i = 0; i < meshlet.vertexCount; i++) {
+            localIndex[remap.at(data.vertices[meshlet.vertexOffset + i])] = UINT32_MAX;
+        }
+        for (const uint32_t triangle : candidates) {
+            queued[triangle] = 0;
+        }
+        candidates.clear();
+        centerSum = glm::vec3(0.F);
+        computeBounds(positions, data.vertices, data.triangles, meshlet);
+        data.meshlets.push_back(meshlet);
+        meshlet = { .vertexOffset = static_cast<uint32_t>(data.vertices.size()), .triangleOffset = static_cast<uint32_t>(data.triangles.size()) };
+    };
+
+    for (std::size_t added = 0; added < triangleCount; added++) {
+        // best adjacent triangle, dropping the ones already taken: fewest new vertices, then closest to the meshlet center so it stays round instead of following the strips of the input
+        uint32_t best = UINT32_MAX;
+        uint32_t bestCost = 4;
+        float bestDistance = 0.F;
+        const glm::vec3 center = meshlet.triangleCount == 0 ? glm::vec3(0.F) : centerSum * (1.F / static_cast<float>(meshlet.triangleCount));
+        for (std::size_t i = 0; i < candidates.size();) {
+            const uint32_t triangle = candidates[i];
+            if (used[triangle] != 0) {
+                queued[triangle] = 0;
+                candidates[i] = candidates.back();
+                candidates.pop_back();
+                continue;
+            }
+            const uint32_t cost = newVertexCount(triangle);
+            const glm::vec3 offset = centroid(triangle) - center;
+            const float distance = dot(offset, offset);
+            if (cost < bestCost || (cost == bestCost && (distance < bestDistance || (distance == bestDistance && triangle < best)))) {
+                best = triangle;
+                bestCost = cost;
+                bestDistance = distance;
+            }
+            i++;
+        }
+        if (best == UINT32_MAX) {
+            // nothing adjacent left, continue with the next triangle of the input order
+            while (used[scan] != 0) { scan++; }
+            best = static_cast<uint32_t>(scan);
+            bestCost = newVertexCount(best);
+        }
+        if (meshlet.vertexCount + bestCost > MESHLET_MAX_VERTICES || meshlet.triangleCount == MESHLET_MAX_TRIANGLES) {
+            flush();
+            // restart from the same triangle, every vertex is new in an empty meshlet
+            bestCost = 3;
+        }
+
+        uint32_t packed = 0;
+        for (uint32_t corner = 0; corner < 3; corner++) {
+            const uint32_t vertex = corners[(best * 3) + corner];
+            if (localIndex[vertex] == UINT32_MAX) {
+                localIndex[vertex] = meshlet.vertexCount++;
+                data.vertices.push_back(indices[(best * 3) + corner]);
+            }
+            packed |= localIndex[vertex] << (8U * corner);
+            for (uint32_t i = triangleOffsets[vertex]; i < triangleOffsets[vertex + 1]; i++) {
+                const uint32_t neighbour = vertexTriangles[i];
+                if (used[neighbour] == 0 && queued[neighbour] == 0) {
+                    queued[neighbour] = 1;
+                    candidates.push_back(neighbour);
+                }
+            }
+        }
+        data.triangles.push_back(packed);
+        centerSum += centroid(best);
+        meshlet.triangleCount++;
+        used[best] = 1;
+    }
+    flush();
+    return static_cast<uint32_t>(data.meshlets.size()) - firstMeshlet;
+}
+
+bool ven::MeshletBuilder::isBackfacing(const Meshlet& meshlet, const glm::vec3& cameraPosition)
+{
+    const glm::vec3 center{meshlet.sphere};
+    const glm::vec3 toCenter = center - cameraPosition;
+    return dot(toCenter, glm::vec3(meshlet.cone)) >= (meshlet.cone.w * glm::length(toCenter)) + meshlet.sphere.w;
+}
+
+bool ven::MeshletBuilder::isOutside(const Meshlet& meshlet, const Frustum& frustum, const glm::mat4& model)
+{
+    const BoundingSphere sphere{ .center = glm::vec3(meshlet.sphere), .radius = meshlet.sphere.w };
+    return !frustum.intersects(sphere.transform(model));
+}
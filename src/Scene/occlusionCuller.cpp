@@ -0,0 +1,297 @@
+#include <atomic>
+#include <chrono>
+
+// SSE2 is part of the x86-64 baseline, the AVX2 kernel has its own translation unit and is picked at runtime
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define VEN_OCCLUSION_SSE
+    #include <emmintrin.h>
+#endif
+
+#include "VEngine/Scene/OcclusionCuller.hpp"
+#include "VEngine/Scene/OcclusionKernel.hpp"
+
+namespace {
+
+    constexpr std::size_t TEST_GRAIN_SIZE = 64;
+
+    // Vulkan clip space keeps 0 <= z <= w, the near plane is z = 0
+    glm::vec4 intersectNear(const glm::vec4& inside, const glm::vec4& outside)
+    {
+        const float t = inside.z / (inside.z - outside.z);
+        return inside + (outside - inside) * t;
+    }
+
+} // namespace
+
+ven::OcclusionCuller::OcclusionCuller(const uint32_t width, const uint32_t height, ThreadPool* threadPool)
+    : m_width{(std::max(width, 1U) + TILE_WIDTH - 1) / TILE_WIDTH * TILE_WIDTH},
+      m_height{(std::max(height, 1U) + TILE_HEIGHT - 1) / TILE_HEIGHT * TILE_HEIGHT},
+      m_tilesX{m_width / TILE_WIDTH}, m_tilesY{m_height / TILE_HEIGHT}, m_threadPool{threadPool},
+      m_depth(static_cast<std::size_t>(m_width) * m_height, 1.F), m_tileMax(static_cast<std::size_t>(m_tilesX) * m_tilesY, 1.F)
+{
+}
+
+void ven::OcclusionCuller::setLevel(const SimdLevel level)
+{
+    m_level = static_cast<uint8_t>(level) > static_cast<uint8_t>(getSupportedSimdLevel()) ? getSupportedSimdLevel() : level;
+}
+
+void ven::OcclusionCuller::begin(const glm::mat4& viewProjection)
+{
+    m_viewProjection = viewProjection;
+    m_triangles.clear();
+    m_boxes.clear();
+    m_stats = {};
+}
+
+void ven::OcclusionCuller::addOccluder(const std::span<const glm::vec3> triangles, const glm::mat4& modelMatrix)
+{
+    const glm::mat4 modelViewProjection = m_viewProjection * modelMatrix;
+    for (std::size_t i = 0; i + 2 < triangles.size(); i += 3) {
+        addClipTriangle({modelViewProjection * glm::vec4(triangles[i], 1.F), modelViewProjection * glm::vec4(triangles[i + 1], 1.F), modelViewProjection * glm::vec4(triangles[i + 2], 1.F)});
+    }
+}
+
+void ven::OcclusionCuller::addClipTriangle(const std::array<glm::vec4, 3>& clip)
+{
+    // clip against the near plane, the result is a triangle or a quad
+    std::array<glm::vec4, 4> polygon{};
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < 3; i++) {
+        const glm::vec4& current = clip[i];
+        const glm::vec4& next = clip[(i + 1) % 3];
+        if (current.z >= 0.F) {
+            polygon[count++] = current;
+        }
+        if ((current.z >= 0.F) != (next.z >= 0.F)) {
+            polygon[count++] = current.z >= 0.F ? intersectNear(current, next) : intersectNear(next, current);
+        }
+    }
+    if (count < 3) { return; }
+
+    std::array<glm::vec3, 4> screen{};
+    for (std::size_t i = 0; i < count; i++) {
+        const float invW = 1.F / std::max(polygon[i].w, 1e-6F);
+        screen[i] = {
+            (polygon[i].x * invW * 0.5F + 0.5F) * static_cast<float>(m_width),
+            (polygon[i].y * invW * 0.5F + 0.5F) * static_cast<float>(m_height),
+            std::min(polygon[i].z * invW, 1.F)
+        };
+    }
+    for (std::size_t i = 1; i + 1 < count; i++) {
+        const std::array vertices{screen[0], screen[i], screen[i + 1]};
+        m_triangles.push_back({
+            .vertices = vertices,
+            .minY = std::min({vertices[0].y, vertices[1].y, vertices[2].y}),
+            .maxY = std::max({vertices[0].y, vertices[1].y, vertices[2].y})
+        });
+    }
+}
+
+uint32_t ven::OcclusionCuller::add(const AABB& aabb)
+{
+    m_boxes.push_back(aabb);
+    return static_cast<uint32_t>(m_boxes.size() - 1);
+}
+
+void ven::OcclusionCuller::cull(const std::vector<uint8_t>* candidates)
+{
+    const auto start = std::chrono::high_resolution_clock::now();
+    const std::size_t count = m_boxes.size();
+
+    m_stats.tested = static_cast<uint32_t>(count);
+    m_stats.occluderTriangles = static_cast<uint32_t>(m_triangles.size());
+    m_visible.assign(count, 1);
+    if (candidates != nullptr) {
+        for (std::size_t i = 0; i < count; i++) {
+            m_visible[i] = (*candidates)[i];
+        }
+    }
+    if (!m_enabled) {
+        return;
+    }
+
+    // each band owns TILE_HEIGHT rows, bands never write the same pixels
+    const auto rasterBands = [this](const std::size_t first, const std::size_t last) {
+        for (std::size_t tileRow = first; tileRow < last; tileRow++) {
+            rasterizeBand(static_cast<uint32_t>(tileRow));
+        }
+    };
+    if (m_threadPool != nullptr) {
+        m_threadPool->parallelFor(m_tilesY, rasterBands);
+    } else {
+        rasterBands(0, m_tilesY);
+    }
+    const auto rasterEnd = std::chrono::high_resolution_clock::now();
+    m_stats.rasterMS = std::chrono::duration<float, std::milli>(rasterEnd - start).count();
+
+    std::atomic<uint32_t> occluded{0};
+    const auto testBoxes = [this, &occluded](const std::size_t first, const std::size_t last) {
+        uint32_t localOccluded = 0;
+        for (std::size_t i = first; i < last; i++) {
+            if (m_visible[i] != 0 && isOccluded(m_boxes[i])) {
+                m_visible[i] = 0;
+                localOccluded++;
+            }
+        }
+        occluded += localOccluded;
+    };
+    if (m_threadPool != nullptr) {
+        m_threadPool->parallelFor(count, testBoxes, TEST_GRAIN_SIZE);
+    } else {
+        testBoxes(0, count);
+    }
+    m_stats.occluded = occluded;
+    m_stats.testMS = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - rasterEnd).count();
+}
+
+void ven::OcclusionCuller::rasterizeBand(const uint32_t tileRow)
+{
+    const uint32_t firstRow = tileRow * TILE_HEIGHT;
+    const uint32_t lastRow = firstRow + TILE_HEIGHT - 1;
+    std::fill_n(m_depth.begin() + static_cast<std::ptrdiff_t>(firstRow) * m_width, static_cast<std::ptrdiff_t>(TILE_HEIGHT) * m_width, 1.F);
+
+    for (const ScreenTriangle& triangle : m_triangles) {
+        // pixel centers are at +0.5
+        if (triangle.maxY < static_cast<float>(firstRow) + 0.5F || triangle.minY > static_cast<float>(lastRow) + 0.5F) { continue; }
+        rasterizeTriangle(triangle, firstRow, lastRow);
+    }
+
+    for (uint32_t tileX = 0; tileX < m_tilesX; tileX++) {
+        float tileMax = 0.F;
+        for (uint32_t y = firstRow; y <= lastRow; y++) {
+            const float* row = &m_depth[static_cast<std::size_t>(y) * m_width + tileX * TILE_WIDTH];
+            tileMax = std::max(tileMax, *std::max_element(row, row + TILE_WIDTH));
+        }
+        m_tileMax[static_cast<std::size_t>(tileRow) * m_tilesX + tileX] = tileMax;
+    }
+}
+
+void ven::OcclusionCuller::rasterizeTriangle(const ScreenTriangle& triangle, const uint32_t firstRow, const uint32_t lastRow)
+{
+    glm::vec3 v0 = triangle.vertices[0];
+    glm::vec3 v1 = triangle.vertices[1];
+    glm::vec3 v2 = triangle.vertices[2];
+    float area = (v1.x - v0.x) * (v2.y - v0.y) - (v1.y - v0.y) * (v2.x - v0.x);
+    if (std::abs(area) < 1e-8F) { return; }
+    // occluders are two sided
+    if (area < 0.F) {
+        std::swap(v1, v2);
+        area = -area;
+    }
+
+    const float minX = std::ceil(std::min({v0.x, v1.x, v2.x}) - 0.5F);
+    const float maxX = std::floor(std::max({v0.x, v1.x, v2.x}) - 0.5F);
+    const float minY = std::ceil(triangle.minY - 0.5F);
+    const float maxY = std::floor(triangle.maxY - 0.5F);
+    if (maxX < 0.F || minX > static_cast<float>(m_width - 1) || maxY < static_cast<float>(firstRow) || minY > static_cast<float>(lastRow)) { return; }
+    const auto xBegin = static_cast<uint32_t>(std::max(minX, 0.F));
+    const auto xEnd = static_cast<uint32_t>(std::min(maxX, static_cast<float>(m_width - 1)));
+    const auto yBegin = std::max(static_cast<uint32_t>(std::max(minY, 0.F)), firstRow);
+    const auto yEnd = std::min(static_cast<uint32_t>(maxY), lastRow);
+
+    // edge functions E(x, y) = a * x + b * y + c, positive inside, and the screen space depth plane
+    const std::array<glm::vec3, 3> edges{
+        glm::vec3(v1.y - v2.y, v2.x - v1.x, v1.x * v2.y - v1.y * v2.x),
+        glm::vec3(v2.y - v0.y, v0.x - v2.x, v2.x * v0.y - v2.y * v0.x),
+        glm::vec3(v0.y - v1.y, v1.x - v0.x, v0.x * v1.y - v0.y * v1.x)
+    };
+    const glm::vec3 depthPlane = (edges[0] * v0.z + edges[1] * v1.z + edges[2] * v2.z) / area;
+
+    if (m_level == SimdLevel::AVX2) {
+        OcclusionRaster raster{ .edges = {}, .depthPlane = { depthPlane.x, depthPlane.y, depthPlane.z }, .xBegin = xBegin, .xEnd = xEnd, .yBegin = yBegin, .yEnd = yEnd };
+        for (std::size_t i = 0; i < edges.size(); i++) {
+            raster.edges[i][0] = edges[i].x;
+            raster.edges[i][1] = edges[i].y;
+            raster.edges[i][2] = edges[i].z;
+        }
+        rasterizeOccluderAvx2(raster, m_depth.data(), m_width);
+        return;
+    }
+
+#if defined(VEN_OCCLUSION_SSE)
+    constexpr uint32_t LANES = 4;
+    const __m128 laneOffset = _mm_setr_ps(0.5F, 1.5F, 2.5F, 3.5F);
+    const __m128 zero = _mm_setzero_ps();
+#else
+    constexpr uint32_t LANES = 1;
+#endif
+
+    for (uint32_t y = yBegin; y <= yEnd; y++) {
+        const float py = static_cast<float>(y) + 0.5F;
+        float* row = &m_depth[static_cast<std::size_t>(y) * m_width];
+        // the width is a multiple of the tile width, aligned groups of lanes never leave the row
+        for (uint32_t x = xBegin / LANES * LANES; x <= xEnd; x += LANES) {
+#if defined(VEN_OCCLUSION_SSE)
+            const __m128 px = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), laneOffset);
+            __m128 inside = _mm_and_ps(
+                _mm_cmpge_ps(px, _mm_set1_ps(static_cast<float>(xBegin))),
+                _mm_cmplt_ps(px, _mm_set1_ps(static_cast<float>(xEnd) + 1.F)));
+            for (const glm::vec3& edge : edges) {
+                const __m128 value = _mm_add_ps(_mm_mul_ps(px, _mm_set1_ps(edge.x)), _mm_set1_ps(edge.y * py + edge.z));
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(value, zero));
+            }
+            const __m128 depth = _mm_add_ps(_mm_mul_ps(px, _mm_set1_ps(depthPlane.x)), _mm_set1_ps(depthPlane.y * py + depthPlane.z));
+            const __m128 current = _mm_loadu_ps(row + x);
+            const __m128 nearest = _mm_min_ps(current, depth);
+            _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, current)));
+#else
+            const float px = static_cast<float>(x) + 0.5F;
+            if (edges[0].x * px + edges[0].y * py + edges[0].z >= 0.F && edges[1].x * px + edges[1].y * py + edges[1].z >= 0.F && edges[2].x * px + edges[2].y * py + edges[2].z >= 0.F) {
+                row[x] = std::min(row[x], depthPlane.x * px + depthPlane.y * py + depthPlane.z);
+            }
+#endif
+        }
+    }
+}
+
+bool ven::OcclusionCuller::isOccluded(const AABB& aabb) const
+{
+    if (!aabb.isValid()) {
+        return false; // empty box, queued to keep the indices aligned without being tested
+    }
+    glm::vec2 rectMin{std::numeric_limits<float>::max()};
+    glm::vec2 rectMax{std::numeric_limits<float>::lowest()};
+    float minDepth = 1.F;
+    for (uint32_t i = 0; i < 8; i++) {
+        const glm::vec3 corner{(i & 1U) != 0 ? aabb.max.x : aabb.min.x, (i & 2U) != 0 ? aabb.max.y : aabb.min.y, (i & 4U) != 0 ? aabb.max.z : aabb.min.z};
+        const glm::vec4 clip = m_viewProjection * glm::vec4(corner, 1.F);
+        if (clip.z < 0.F) {
+            return false; // crosses the near plane
+        }
+        const glm::vec3 ndc = glm::vec3(clip) / clip.w;
+        rectMin = glm::min(rectMin, glm::vec2(ndc));
+        rectMax = glm::max(rectMax, glm::vec2(ndc));
+        minDepth = std::min(minDepth, ndc.z);
+    }
+
+    // every pixel touched by the rectangle
+    const float xMin = std::floor((rectMin.x * 0.5F + 0.5F) * static_cast<float>(m_width));
+    const float xMax = std::floor((rectMax.x * 0.5F + 0.5F) * static_cast<float>(m_width));
+    const float yMin = std::floor((rectMin.y * 0.5F + 0.5F) * static_cast<float>(m_height));
+    const float yMax = std::floor((rectMax.y * 0.5F + 0.5F) * static_cast<float>(m_height));
+    if (xMax < 0.F || yMax < 0.F || xMin > static_cast<float>(m_width - 1) || yMin > static_cast<float>(m_height - 1)) {
+        return false; // off screen, left to the frustum test
+    }
+    const auto x0 = static_cast<uint32_t>(std::max(xMin, 0.F));
+    const auto x1 = static_cast<uint32_t>(std::min(xMax, static_cast<float>(m_width - 1)));
+    const auto y0 = static_cast<uint32_t>(std::max(yMin, 0.F));
+    const auto y1 = static_cast<uint32_t>(std::min(yMax, static_cast<float>(m_height - 1)));
+
+    for (uint32_t tileY = y0 / TILE_HEIGHT; tileY <= y1 / TILE_HEIGHT; tileY++) {
+        for (uint32_t tileX = x0 / TILE_WIDTH; tileX <= x1 / TILE_WIDTH; tileX++) {
+            // the whole tile is nearer than the box, no need to look at the pixels
+            if (m_tileMax[static_cast<std::size_t>(tileY) * m_tilesX + tileX] <= minDepth) { continue; }
+            const uint32_t yEnd = std::min(y1, tileY * TILE_HEIGHT + TILE_HEIGHT - 1);
+            const uint32_t xEnd = std::min(x1, tileX * TILE_WIDTH + TILE_WIDTH - 1);
+            for (uint32_t y = std::max(y0, tileY * TILE_HEIGHT); y <= yEnd; y++) {
+                for (uint32_t x = std::max(x0, tileX * TILE_WIDTH); x <= xEnd; x++) {
+                    if (minDepth < m_depth[static_cast<std::size_t>(y) * m_width + x]) {
+                        return false;
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
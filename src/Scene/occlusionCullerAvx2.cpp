@@ -0,0 +1,39 @@
+// compiled with AVX2 and FMA enabled, only reached when the OcclusionCuller detected them at runtime
+#include "VEngine/Scene/OcclusionKernel.hpp"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+
+#include <cstddef>
+#include <immintrin.h>
+
+void ven::rasterizeOccluderAvx2(const OcclusionRaster& raster, float* depth, const uint32_t width)
+{
+    constexpr uint32_t LANES = 8;
+    const __m256 laneOffset = _mm256_setr_ps(0.5F, 1.5F, 2.5F, 3.5F, 4.5F, 5.5F, 6.5F, 7.5F);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 first = _mm256_set1_ps(static_cast<float>(raster.xBegin));
+    const __m256 last = _mm256_set1_ps(static_cast<float>(raster.xEnd) + 1.F);
+
+    for (uint32_t y = raster.yBegin; y <= raster.yEnd; y++) {
+        const float py = static_cast<float>(y) + 0.5F;
+        float* row = depth + (static_cast<std::size_t>(y) * width);
+        // the width is a multiple of the tile width, aligned groups of lanes never leave the row
+        for (uint32_t x = raster.xBegin / LANES * LANES; x <= raster.xEnd; x += LANES) {
+            const __m256 px = _mm256_add_ps(_mm256_set1_ps(static_cast<float>(x)), laneOffset);
+            __m256 inside = _mm256_and_ps(_mm256_cmp_ps(px, first, _CMP_GE_OQ), _mm256_cmp_ps(px, last, _CMP_LT_OQ));
+            for (const auto& edge : raster.edges) {
+                const __m256 value = _mm256_add_ps(_mm256_mul_ps(px, _mm256_set1_ps(edge[0])), _mm256_set1_ps((edge[1] * py) + edge[2]));
+                inside = _mm256_and_ps(inside, _mm256_cmp_ps(value, zero, _CMP_GE_OQ));
+            }
+            const __m256 triangleDepth = _mm256_add_ps(_mm256_mul_ps(px, _mm256_set1_ps(raster.depthPlane[0])), _mm256_set1_ps((raster.depthPlane[1] * py) + raster.depthPlane[2]));
+            const __m256 current = _mm256_loadu_ps(row + x);
+            _mm256_storeu_ps(row + x, _mm256_blendv_ps(current, _mm256_min_ps(current, triangleDepth), inside));
+        }
+    }
+}
+
+#else
+
+void ven::rasterizeOccluderAvx2(const OcclusionRaster& /*raster*/, float* /*depth*/, const uint32_t /*width*/) {} // never selected off x86
+
+#endif
@@ -0,0 +1,394 @@
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <random>
+
+#include "VEngine/Scene/Pvs.hpp"
+#include "VEngine/Utils/HashCombine.hpp"
+
+namespace {
+
+    constexpr uint32_t BVH_LEAF_SIZE = 4;
+    constexpr uint32_t BVH_STACK_SIZE = 64;
+    constexpr float RAY_EPSILON = 1e-6F;
+
+    struct Triangle {
+        glm::vec3 v0;
+        glm::vec3 edge1;
+        glm::vec3 edge2;
+        uint32_t mesh;
+    };
+
+    // inner nodes have count == 0, their left child follows them, right is an index
+    struct BvhNode {
+        ven::AABB bounds;
+        uint32_t first{0};
+        uint32_t count{0};
+        uint32_t right{0};
+    };
+
+    ///
+    /// @brief Static triangle bvh (median split), closest hit queries only
+    ///
+    class TriangleBvh {
+
+        public:
+
+            explicit TriangleBvh(std::vector<Triangle> triangles) : m_triangles{std::move(triangles)}
+            {
+                if (m_triangles.empty()) { return; }
+                std::vector<glm::vec3> centroids(m_triangles.size());
+                for (std::size_t i = 0; i < m_triangles.size(); i++) {
+                    const Triangle& triangle = m_triangles[i];
+                    centroids[i] = triangle.v0 + (triangle.edge1 + triangle.edge2) / 3.F;
+                }
+                std::vector<uint32_t> order(m_triangles.size());
+                std::iota(order.begin(), order.end(), 0U);
+                m_nodes.reserve(m_triangles.size() * 2 / BVH_LEAF_SIZE + 1);
+                build(order, centroids, 0, static_cast<uint32_t>(order.size()));
+
+                std::vector<Triangle> sorted(m_triangles.size());
+                for (std::size_t i = 0; i < order.size(); i++) {
+                    sorted[i] = m_triangles[order[i]];
+                }
+                m_triangles = std::move(sorted);
+            }
+
+            ///
+            /// @return Mesh of the closest triangle hit, ven::Pvs::OUTSIDE if nothing is hit
+            ///
+            [[nodiscard]] uint32_t castRay(const glm::vec3& origin, const glm::vec3& direction) const
+            {
+                if (m_nodes.empty()) { return ven::Pvs::OUTSIDE; }
+                const glm::vec3 invDirection{1.F / direction.x, 1.F / direction.y, 1.F / direction.z};
+                float closest = std::numeric_limits<float>::max();
+                uint32_t hitMesh = ven::Pvs::OUTSIDE;
+                std::array<uint32_t, BVH_STACK_SIZE> stack{};
+                uint32_t stackSize = 0;
+                stack[stackSize++] = 0;
+
+                while (stackSize > 0) {
+                    const BvhNode& node = m_nodes[stack[--stackSize]];
+                    if (!intersects(node.bounds, origin, invDirection, closest)) { continue; }
+                    if (node.count > 0) {
+                        for (uint32_t i = node.first; i < node.first + node.count; i++) {
+                            if (const float distance = intersect(m_triangles[i], origin, direction); distance < closest) {
+                                closest = distance;
+                                hitMesh = m_triangles[i].mesh;
+                            }
+                        }
+                    } else if (stackSize + 2 <= BVH_STACK_SIZE) {
+                        stack[stackSize++] = node.right;
+                        stack[stackSize++] = static_cast<uint32_t>(&node - m_nodes.data()) + 1;
+                    }
+                }
+                return hitMesh;
+            }
+
+        private:
+
+            uint32_t build(std::vector<uint32_t>& order, const std::vector<glm::vec3>& centroids, const uint32_t first, const uint32_t last)
+            {
+                const auto nodeIndex = static_cast<uint32_t>(m_nodes.size());
+                m_nodes.emplace_back();
+                ven::AABB bounds;
+                ven::AABB centroidBounds;
+                for (uint32_t i = first; i < last; i++) {
+                    const Triangle& triangle = m_triangles[order[i]];
+                    bounds.expand(triangle.v0);
+                    bounds.expand(triangle.v0 + triangle.edge1);
+                    bounds.expand(triangle.v0 + triangle.edge2);
+                    centroidBounds.expand(centroids[order[i]]);
+                }
+                m_nodes[nodeIndex].bounds = bounds;
+
+                if (last - first <= BVH_LEAF_SIZE) {
+                    m_nodes[nodeIndex].first = first;
+                    m_nodes[nodeIndex].count = last - first;
+                    return nodeIndex;
+                }
+                const glm::vec3 size = centroidBounds.max - centroidBounds.min;
+                const int axis = size.x > size.y && size.x > size.z ? 0 : (size.y > size.z ? 1 : 2);
+                const uint32_t middle = first + (last - first) / 2;
+                std::nth_element(order.begin() + first, order.begin() + middle, order.begin() + last, [&](const uint32_t a, const uint32_t b) { return centroids[a][axis] < centroids[b][axis]; });
+
+                build(order, centroids, first, middle);
+                const uint32_t right = build(order, centroids, middle, last);
+                m_nodes[nodeIndex].right = right;
+                return nodeIndex;
+            }
+
+            static bool intersects(const ven::AABB& bounds, const glm::vec3& origin, const glm::vec3& invDirection, const float maxDistance)
+            {
+                float tMin = 0.F;
+                float tMax = maxDistance;
+                for (int axis = 0; axis < 3; axis++) {
+                    float t0 = (bounds.min[axis] - origin[axis]) * invDirection[axis];
+                    float t1 = (bounds.max[axis] - origin[axis]) * invDirection[axis];
+                    if (t0 > t1) { std::swap(t0, t1); }
+                    tMin = std::max(tMin, t0);
+                    tMax = std::min(tMax, t1);
+                }
+                return tMin <= tMax;
+            }
+
+            // Moller-Trumbore, two sided
+            static float intersect(const Triangle& triangle, const glm::vec3& origin, const glm::vec3& direction)
+            {
+                const glm::vec3 p = cross(direction, triangle.edge2);
+                const float determinant = dot(triangle.edge1, p);
+                if (std::abs(determinant) < RAY_EPSILON) { return std::numeric_limits<float>::max(); }
+                const float invDeterminant = 1.F / determinant;
+                const glm::vec3 s = origin - triangle.v0;
+                const float u = dot(s, p) * invDeterminant;
+                if (u < 0.F || u > 1.F) { return std::numeric_limits<float>::max(); }
+                const glm::vec3 q = cross(s, triangle.edge1);
+                const float v = dot(direction, q) * invDeterminant;
+                if (v < 0.F || u + v > 1.F) { return std::numeric_limits<float>::max(); }
+                const float distance = dot(triangle.edge2, q) * invDeterminant;
+                return distance > RAY_EPSILON ? distance : std::numeric_limits<float>::max();
+            }
+
+            std::vector<Triangle> m_triangles;
+            std::vector<BvhNode> m_nodes;
+
+    }; // class TriangleBvh
+
+    glm::vec3 randomPoint(const ven::AABB& bounds, std::mt19937& rng)
+    {
+        std::uniform_real_distribution<float> unit(0.F, 1.F);
+        return bounds.min + (bounds.max - bounds.min) * glm::vec3(unit(rng), unit(rng), unit(rng));
+    }
+
+    glm::vec3 randomDirection(std::mt19937& rng)
+    {
+        std::uniform_real_distribution<float> unit(0.F, 1.F);
+        const float z = unit(rng) * 2.F - 1.F;
+        const float angle = unit(rng) * glm::two_pi<float>();
+        const float radius = std::sqrt(std::max(0.F, 1.F - z * z));
+        return {radius * std::cos(angle), radius * std::sin(angle), z};
+    }
+
+    void writeVarint(uint32_t value, std::vector<uint8_t>& out)
+    {
+        while (value >= 0x80) {
+            out.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    template<typename T>
+    void writeValue(std::ofstream& file, const T& value) { file.write(reinterpret_cast<const char*>(&value), sizeof(T)); }
+
+    template<typename T>
+    bool readValue(std::ifstream& file, T& value) { return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T))); }
+
+} // namespace
+
+uint64_t ven::Pvs::hashContent(const std::span<const glm::vec3> positions, const std::span<const uint32_t> indices, const std::span<const PvsMeshRange> meshes)
+{
+    uint64_t hash = fnv1a(positions.data(), positions.size_bytes());
+    hash = fnv1a(indices.data(), indices.size_bytes(), hash);
+    return fnv1a(meshes.data(), meshes.size_bytes(), hash);
+}
+
+ven::Pvs ven::Pvs::bake(const std::span<const glm::vec3> positions, const std::span<const uint32_t> indices, const std::span<const PvsMeshRange> meshes, const uint64_t contentHash, const PvsSettings& settings, ThreadPool* threadPool)
+{
+    Pvs pvs;
+    pvs.m_contentHash = contentHash;
+    pvs.m_meshCount = static_cast<uint32_t>(meshes.size());
+    if (positions.empty() || meshes.empty()) {
+        return pvs;
+    }
+
+    std::vector<Triangle> triangles;
+    std::vector<AABB> meshBounds(meshes.size());
+    for (uint32_t mesh = 0; mesh < meshes.size(); mesh++) {
+        for (uint32_t i = meshes[mesh].firstIndex; i + 2 < meshes[mesh].firstIndex + meshes[mesh].indexCount; i += 3) {
+            const glm::vec3& v0 = positions[indices[i]];
+            const glm::vec3& v1 = positions[indices[i + 1]];
+            const glm::vec3& v2 = positions[indices[i + 2]];
+            triangles.push_back({ .v0 = v0, .edge1 = v1 - v0, .edge2 = v2 - v0, .mesh = mesh });
+            meshBounds[mesh].expand(v0);
+            meshBounds[mesh].expand(v1);
+            meshBounds[mesh].expand(v2);
+        }
+    }
+    const TriangleBvh bvh(std::move(triangles));
+
+    for (const glm::vec3& position : positions) {
+        pvs.m_bounds.expand(position);
+    }
+    const glm::vec3 size = pvs.m_bounds.max - pvs.m_bounds.min;
+    pvs.m_cellSize = std::max({size.x, size.y, size.z, RAY_EPSILON}) / static_cast<float>(std::max(settings.cellsPerAxis, 1U));
+    pvs.m_cellCounts = {
+        std::max(1U, static_cast<uint32_t>(std::ceil(size.x / pvs.m_cellSize))),
+        std::max(1U, static_cast<uint32_t>(std::ceil(size.y / pvs.m_cellSize))),
+        std::max(1U, static_cast<uint32_t>(std::ceil(size.z / pvs.m_cellSize)))
+    };
+    pvs.m_bounds.max = pvs.m_bounds.min + glm::vec3(static_cast<float>(pvs.m_cellCounts.x), static_cast<float>(pvs.m_cellCounts.y), static_cast<float>(pvs.m_cellCounts.z)) * pvs.m_cellSize;
+
+    std::vector<std::vector<uint8_t>> encodedCells(pvs.getCellCount());
+    const auto bakeCells = [&](const std::size_t first, const std::size_t last) {
+        std::vector<uint8_t> visible(meshes.size());
+        for (std::size_t cell = first; cell < last; cell++) {
+            const AABB cellBounds = pvs.getCellBounds(static_cast<uint32_t>(cell));
+            // deterministic per cell whatever the thread count
+            std::mt19937 rng(static_cast<uint32_t>(cell) * 2654435761U + 1U);
+            std::ranges::fill(visible, 0);
+            for (uint32_t mesh = 0; mesh < meshes.size(); mesh++) {
+                const AABB& bounds = meshBounds[mesh];
+                if (bounds.isValid() && bounds.min.x <= cellBounds.max.x && bounds.max.x >= cellBounds.min.x && bounds.min.y <= cellBounds.max.y && bounds.max.y >= cellBounds.min.y && bounds.min.z <= cellBounds.max.z && bounds.max.z >= cellBounds.min.z) {
+                    visible[mesh] = 1;
+                }
+            }
+            for (uint32_t sample = 0; sample < settings.samplesPerCell; sample++) {
+                const glm::vec3 eye = randomPoint(cellBounds, rng);
+                for (uint32_t mesh = 0; mesh < meshes.size(); mesh++) {
+                    if (!meshBounds[mesh].isValid()) { continue; }
+                    for (uint32_t ray = 0; ray < settings.raysPerTarget && visible[mesh] == 0; ray++) {
+                        const glm::vec3 toTarget = randomPoint(meshBounds[mesh], rng) - eye;
+                        if (dot(toTarget, toTarget) < RAY_EPSILON) { continue; }
+                        if (bvh.castRay(eye, normalize(toTarget)) == mesh) {
+                            visible[mesh] = 1;
+                        }
+                    }
+                }
+                for (uint32_t ray = 0; ray < settings.randomRays; ray++) {
+                    if (const uint32_t hit = bvh.castRay(eye, randomDirection(rng)); hit != OUTSIDE) {
+                        visible[hit] = 1;
+                    }
+                }
+            }
+            encode(visible, encodedCells[cell]);
+        }
+    };
+    if (threadPool != nullptr) {
+        threadPool->parallelFor(encodedCells.size(), bakeCells);
+    } else {
+        bakeCells(0, encodedCells.size());
+    }
+
+    pvs.m_cellOffsets.reserve(encodedCells.size() + 1);
+    for (const std::vector<uint8_t>& encoded : encodedCells) {
+        pvs.m_cellOffsets.push_back(static_cast<uint32_t>(pvs.m_data.size()));
+        pvs.m_data.insert(pvs.m_data.end(), encoded.begin(), encoded.end());
+    }
+    pvs.m_cellOffsets.push_back(static_cast<uint32_t>(pvs.m_data.size()));
+    return pvs;
+}
+
+void ven::Pvs::encode(const std::vector<uint8_t>& visible, std::vector<uint8_t>& out)
+{
+    // alternating run lengths as varints, starting with a (possibly empty) run of hidden meshes
+    out.clear();
+    uint8_t value = 0;
+    std::size_t i = 0;
+    while (i < visible.size()) {
+        uint32_t run = 0;
+        while (i < visible.size() && (visible[i] != 0) == (value != 0)) {
+            run++;
+            i++;
+        }
+        writeVarint(run, out);
+        value ^= 1U;
+    }
+}
+
+void ven::Pvs::decodeCell(const uint32_t cell, std::vector<uint8_t>& visible) const
+{
+    visible.assign(m_meshCount, 0);
+    uint32_t position = 0;
+    uint8_t value = 0;
+    for (uint32_t offset = m_cellOffsets[cell]; offset < m_cellOffsets[cell + 1] && position < m_meshCount;) {
+        uint32_t run = 0;
+        for (uint32_t shift = 0; offset < m_cellOffsets[cell + 1]; shift += 7) {
+            const uint8_t byte = m_data[offset++];
+            run |= static_cast<uint32_t>(byte & 0x7FU) << shift;
+            if ((byte & 0x80U) == 0 || shift >= 28) { break; }
+        }
+        run = std::min(run, m_meshCount - position);
+        std::fill_n(visible.begin() + position, run, value);
+        position += run;
+        value ^= 1U;
+    }
+}
+
+uint32_t ven::Pvs::findCell(const glm::vec3& position) const
+{
+    if (!isValid() || m_cellSize <= 0.F) { return OUTSIDE; }
+    const glm::vec3 local = (position - m_bounds.min) / m_cellSize;
+    if (local.x < 0.F || local.y < 0.F || local.z < 0.F) { return OUTSIDE; }
+    const glm::uvec3 cell{static_cast<uint32_t>(local.x), static_cast<uint32_t>(local.y), static_cast<uint32_t>(local.z)};
+    if (cell.x >= m_cellCounts.x || cell.y >= m_cellCounts.y || cell.z >= m_cellCounts.z) { return OUTSIDE; }
+    return cell.x + m_cellCounts.x * (cell.y + m_cellCounts.y * cell.z);
+}
+
+ven::AABB ven::Pvs::getCellBounds(const uint32_t cell) const
+{
+    const glm::vec3 coords{
+        static_cast<float>(cell % m_cellCounts.x),
+        static_cast<float>(cell / m_cellCounts.x % m_cellCounts.y),
+        static_cast<float>(cell / (m_cellCounts.x * m_cellCounts.y))
+    };
+    const glm::vec3 min = m_bounds.min + coords * m_cellSize;
+    return { .min = min, .max = min + glm::vec3(m_cellSize) };
+}
+
+void ven::Pvs::save(const std::string& filepath) const
+{
+    const std::string tmpPath = filepath + ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            throw std::runtime_error("failed to open file: " + tmpPath);
+        }
+        writeValue(file, FILE_MAGIC);
+        writeValue(file, FILE_VERSION);
+        writeValue(file, m_contentHash);
+        writeValue(file, m_meshCount);
+        writeValue(file, m_bounds.min);
+        writeValue(file, m_cellSize);
+        writeValue(file, m_cellCounts);
+        writeValue(file, static_cast<uint32_t>(m_data.size()));
+        file.write(reinterpret_cast<const char*>(m_cellOffsets.data()), static_cast<std::streamsize>(m_cellOffsets.size() * sizeof(uint32_t)));
+        file.write(reinterpret_cast<const char*>(m_data.data()), static_cast<std::streamsize>(m_data.size()));
+        if (!file) {
+            throw std::runtime_error("failed to write file: " + tmpPath);
+        }
+    }
+    std::filesystem::rename(tmpPath, filepath);
+}
+
+bool ven::Pvs::load(const std::string& filepath, const uint64_t expectedContentHash)
+{
+    std::ifstream file(filepath, std::ios::binary);
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    uint32_t dataSize = 0;
+    Pvs pvs;
+    if (!file || !readValue(file, magic) || !readValue(file, version) || magic != FILE_MAGIC || version != FILE_VERSION) {
+        return false;
+    }
+    if (!readValue(file, pvs.m_contentHash) || pvs.m_contentHash != expectedContentHash) {
+        return false;
+    }
+    if (!readValue(file, pvs.m_meshCount) || !readValue(file, pvs.m_bounds.min) || !readValue(file, pvs.m_cellSize) || !readValue(file, pvs.m_cellCounts) || !readValue(file, dataSize)) {
+        return false;
+    }
+    const uint64_t cellCount = static_cast<uint64_t>(pvs.m_cellCounts.x) * pvs.m_cellCounts.y * pvs.m_cellCounts.z;
+    if (cellCount == 0 || cellCount > UINT32_MAX - 1 || !(pvs.m_cellSize > 0.F)) {
+        return false;
+    }
+    pvs.m_cellOffsets.resize(cellCount + 1);
+    pvs.m_data.resize(dataSize);
+    file.read(reinterpret_cast<char*>(pvs.m_cellOffsets.data()), static_cast<std::streamsize>(pvs.m_cellOffsets.size() * sizeof(uint32_t)));
+    file.read(reinterpret_cast<char*>(pvs.m_data.data()), static_cast<std::streamsize>(pvs.m_data.size()));
+    if (!file || pvs.m_cellOffsets.front() != 0 || pvs.m_cellOffsets.back() != dataSize || !std::ranges::is_sorted(pvs.m_cellOffsets)) {
+        return false;
+    }
+    pvs.m_bounds.max = pvs.m_bounds.min + glm::vec3(static_cast<float>(pvs.m_cellCounts.x), static_cast<float>(pvs.m_cellCounts.y), static_cast<float>(pvs.m_cellCounts.z)) * pvs.m_cellSize;
+    *this = std::move(pvs);
+    return true;
+}
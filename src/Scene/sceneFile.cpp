@@ -0,0 +1,457 @@
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+#include "VEngine/Scene/SceneFile.hpp"
+#include "VEngine/Scene/Entities/Light.hpp"
+#include "VEngine/Utils/HashCombine.hpp"
+#include "VEngine/Utils/MappedFile.hpp"
+
+namespace {
+
+    constexpr std::string_view TEXT_MAGIC = "vscene";
+
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t assetCount;
+        uint32_t objectCount;
+        uint32_t lightCount;
+        uint32_t stringSize;
+    };
+
+    struct AssetRecord {
+        uint64_t contentHash;
+        uint32_t pathOffset;
+        uint32_t pathLength;
+        uint32_t kind;
+        uint32_t padding;
+    };
+
+    struct TransformRecord {
+        float translation[3];
+        float rotation[3];
+        float scale[3];
+    };
+
+    struct ObjectRecord {
+        TransformRecord transform;
+        uint32_t parent;
+        uint32_t model;
+        uint32_t diffuseMap;
+        uint32_t nameOffset;
+        uint32_t nameLength;
+        uint32_t occluder;
+    };
+
+    struct LightRecord {
+        TransformRecord transform;
+        float color[4];
+        float shininess;
+        uint32_t parent;
+        uint32_t nameOffset;
+        uint32_t nameLength;
+        uint32_t flags;
+    };
+
+    // version 1 light, the version 2 one without the trailing flags
+    struct LightRecordV1 {
+        TransformRecord transform;
+        float color[4];
+        float shininess;
+        uint32_t parent;
+        uint32_t nameOffset;
+        uint32_t nameLength;
+    };
+
+    // version 1 lights all orbited and had no shadows
+    constexpr uint8_t V1_LIGHT_FLAGS = ven::LIGHT_ANIMATED;
+
+    static_assert(sizeof(Header) == 24 && sizeof(AssetRecord) == 24 && sizeof(ObjectRecord) == 60 && sizeof(LightRecord) == 72, "scene records must not have padding");
+    static_assert(sizeof(LightRecordV1) == 68 && offsetof(LightRecord, flags) == sizeof(LightRecordV1), "version 1 lights must be a prefix of the current ones");
+
+    std::vector<LightRecord> upgradeLights(const std::vector<LightRecordV1>& records)
+    {
+        std::vector<LightRecord> lights(records.size());
+        for (std::size_t i = 0; i < records.size(); i++) {
+            std::memcpy(&lights[i], &records[i], sizeof(LightRecordV1));
+            lights[i].flags = V1_LIGHT_FLAGS;
+        }
+        return lights;
+    }
+
+    TransformRecord toRecord(const ven::Transform3D& transform)
+    {
+        return {
+            .translation = { transform.translation.x, transform.translation.y, transform.translation.z },
+            .rotation = { transform.rotation.x, transform.rotation.y, transform.rotation.z },
+            .scale = { transform.scale.x, transform.scale.y, transform.scale.z }
+        };
+    }
+
+    ven::Transform3D fromRecord(const TransformRecord& record)
+    {
+        return {
+            .translation = { record.translation[0], record.translation[1], record.translation[2] },
+            .scale = { record.scale[0], record.scale[1], record.scale[2] },
+            .rotation = { record.rotation[0], record.rotation[1], record.rotation[2] }
+        };
+    }
+
+    class StringTable {
+
+        public:
+
+            void add(const std::string& string, uint32_t& offset, uint32_t& length) {
+                offset = static_cast<uint32_t>(m_data.size());
+                length = static_cast<uint32_t>(string.size());
+                m_data += string;
+            }
+            [[nodiscard]] const std::string& getData() const { return m_data; }
+
+        private:
+
+            std::string m_data;
+
+    }; // class StringTable
+
+    // records are copied out of the mapping, it has no alignment guarantee
+    template<typename T>
+    std::vector<T> readRecords(const std::span<const uint8_t> data, std::size_t& offset, const uint32_t count)
+    {
+        std::vector<T> records(count);
+        std::memcpy(records.data(), data.data() + offset, count * sizeof(T));
+        offset += count * sizeof(T);
+        return records;
+    }
+
+    std::string readString(const std::string_view strings, const uint32_t offset, const uint32_t length)
+    {
+        if (static_cast<uint64_t>(offset) + length > strings.size()) {
+            throw std::runtime_error("scene file: string out of the string table");
+        }
+        return std::string(strings.substr(offset, length));
+    }
+
+    void checkIndex(const uint32_t index, const std::size_t count, const char* what)
+    {
+        if (index != ven::SceneFile::NONE && index >= count) {
+            throw std::runtime_error(std::string("scene file: invalid ") + what + " index");
+        }
+    }
+
+    void writeIndex(std::ostream& stream, const uint32_t index)
+    {
+        if (index == ven::SceneFile::NONE) {
+            stream << '-';
+        } else {
+            stream << index;
+        }
+    }
+
+    uint32_t readIndex(std::istream& stream)
+    {
+        std::string token;
+        stream >> token;
+        if (token == "-") { return ven::SceneFile::NONE; }
+        try {
+            return static_cast<uint32_t>(std::stoul(token));
+        } catch (const std::exception&) {
+            throw std::runtime_error("scene file: invalid index '" + token + "'");
+        }
+    }
+
+    void expectKeyword(std::istream& stream, const std::string_view keyword)
+    {
+        std::string token;
+        if (!(stream >> token) || token != keyword) {
+            throw std::runtime_error("scene file: expected '" + std::string(keyword) + "', got '" + token + "'");
+        }
+    }
+
+    void writeVec3(std::ostream& stream, const glm::vec3& value) { stream << ' ' << value.x << ' ' << value.y << ' ' << value.z; }
+    void readVec3(std::istream& stream, glm::vec3& value) { stream >> value.x >> value.y >> value.z; }
+
+    void writeTransform(std::ostream& stream, const ven::Transform3D& transform)
+    {
+        stream << " translation";
+        writeVec3(stream, transform.translation);
+        stream << " rotation";
+        writeVec3(stream, transform.rotation);
+        stream << " scale";
+        writeVec3(stream, transform.scale);
+    }
+
+    void readTransform(std::istream& stream, ven::Transform3D& transform)
+    {
+        expectKeyword(stream, "translation");
+        readVec3(stream, transform.translation);
+        expectKeyword(stream, "rotation");
+        readVec3(stream, transform.rotation);
+        expectKeyword(stream, "scale");
+        readVec3(stream, transform.scale);
+    }
+
+} // namespace
+
+uint32_t ven::SceneFile::addAsset(const AssetKind kind, const std::string& path, const uint64_t contentHash)
+{
+    for (std::size_t i = 0; i < assets.size(); i++) {
+        if (assets[i].kind == kind && assets[i].path == path) { return static_cast<uint32_t>(i); }
+    }
+    assets.push_back({ .kind = kind, .contentHash = contentHash, .path = path });
+    return static_cast<uint32_t>(assets.size() - 1);
+}
+
+uint64_t ven::SceneFile::hashFile(const std::string& filepath)
+{
+    try {
+        const MappedFile file(filepath);
+        return fnv1a(file.getData().data(), file.getSize());
+    } catch (const std::runtime_error&) {
+        return 0;
+    }
+}
+
+void ven::SceneFile::save(const std::string& filepath) const
+{
+    if (filepath.ends_with(SCENE_TEXT_EXTENSION)) {
+        saveText(filepath);
+    } else {
+        saveBinary(filepath);
+    }
+}
+
+void ven::SceneFile::load(const std::string& filepath)
+{
+    const MappedFile file(filepath);
+    const std::span<const uint8_t> data = file.getData();
+    uint32_t magic = 0;
+    if (data.size() >= sizeof(magic)) {
+        std::memcpy(&magic, data.data(), sizeof(magic));
+    }
+    if (magic == FILE_MAGIC) {
+        loadBinary(data);
+    } else {
+        loadText({ reinterpret_cast<const char*>(data.data()), data.size() });
+    }
+}
+
+void ven::SceneFile::saveBinary(const std::string& filepath) const
+{
+    StringTable strings;
+    std::vector<AssetRecord> assetRecords(assets.size());
+    std::vector<ObjectRecord> objectRecords(objects.size());
+    std::vector<LightRecord> lightRecords(lights.size());
+    for (std::size_t i = 0; i < assets.size(); i++) {
+        assetRecords[i] = { .contentHash = assets[i].contentHash, .pathOffset = 0, .pathLength = 0, .kind = static_cast<uint32_t>(assets[i].kind), .padding = 0 };
+        strings.add(assets[i].path, assetRecords[i].pathOffset, assetRecords[i].pathLength);
+    }
+    for (std::size_t i = 0; i < objects.size(); i++) {
+        const SceneObject& object = objects[i];
+        ObjectRecord& record = objectRecords[i];
+        record = { .transform = toRecord(object.transform), .parent = object.parent, .model = object.model, .diffuseMap = object.diffuseMap, .nameOffset = 0, .nameLength = 0, .occluder = object.occluder ? 1U : 0U };
+        strings.add(object.name, record.nameOffset, record.nameLength);
+    }
+    for (std::size_t i = 0; i < lights.size(); i++) {
+        const SceneLight& light = lights[i];
+        LightRecord& record = lightRecords[i];
+        record = { .transform = toRecord(light.transform), .color = { light.color.x, light.color.y, light.color.z, light.color.w }, .shininess = light.shininess, .parent = light.parent, .nameOffset = 0, .nameLength = 0, .flags = light.flags };
+        strings.add(light.name, record.nameOffset, record.nameLength);
+    }
+    const Header header{
+        .magic = FILE_MAGIC,
+        .version = FILE_VERSION,
+        .assetCount = static_cast<uint32_t>(assets.size()),
+        .objectCount = static_cast<uint32_t>(objects.size()),
+        .lightCount = static_cast<uint32_t>(lights.size()),
+        .stringSize = static_cast<uint32_t>(strings.getData().size())
+    };
+
+    const std::string tmpPath = filepath + ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            throw std::runtime_error("failed to open file: " + tmpPath);
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(assetRecords.data()), static_cast<std::streamsize>(assetRecords.size() * sizeof(AssetRecord)));
+        file.write(reinterpret_cast<const char*>(objectRecords.data()), static_cast<std::streamsize>(objectRecords.size() * sizeof(ObjectRecord)));
+        file.write(reinterpret_cast<const char*>(lightRecords.data()), static_cast<std::streamsize>(lightRecords.size() * sizeof(LightRecord)));
+        file.write(strings.getData().data(), static_cast<std::streamsize>(strings.getData().size()));
+        if (!file) {
+            throw std::runtime_error("failed to write file: " + tmpPath);
+        }
+    }
+    std::filesystem::rename(tmpPath, filepath);
+}
+
+void ven::SceneFile::loadBinary(const std::span<const uint8_t> data)
+{
+    Header header{};
+    if (data.size() < sizeof(header)) {
+        throw std::runtime_error("scene file: truncated header");
+    }
+    std::memcpy(&header, data.data(), sizeof(header));
+    if (header.magic != FILE_MAGIC || (header.version != FILE_VERSION && header.version != FILE_VERSION_V1)) {
+        throw std::runtime_error("scene file: unsupported format or version");
+    }
+    const bool v1 = header.version == FILE_VERSION_V1;
+    const uint64_t expectedSize = sizeof(Header) + (static_cast<uint64_t>(header.assetCount) * sizeof(AssetRecord)) + (static_cast<uint64_t>(header.objectCount) * sizeof(ObjectRecord))
+        + (static_cast<uint64_t>(header.lightCount) * (v1 ? sizeof(LightRecordV1) : sizeof(LightRecord))) + header.stringSize;
+    if (expectedSize != data.size()) {
+        throw std::runtime_error("scene file: size does not match its header");
+    }
+
+    std::size_t offset = sizeof(Header);
+    const std::vector<AssetRecord> assetRecords = readRecords<AssetRecord>(data, offset, header.assetCount);
+    const std::vector<ObjectRecord> objectRecords = readRecords<ObjectRecord>(data, offset, header.objectCount);
+    const std::vector<LightRecord> lightRecords = v1 ? upgradeLights(readRecords<LightRecordV1>(data, offset, header.lightCount)) : readRecords<LightRecord>(data, offset, header.lightCount);
+    const std::string_view strings(reinterpret_cast<const char*>(data.data() + offset), header.stringSize);
+
+    SceneFile scene;
+    scene.assets.resize(assetRecords.size());
+    for (std::size_t i = 0; i < assetRecords.size(); i++) {
+        const AssetRecord& record = assetRecords[i];
+        if (record.kind > static_cast<uint32_t>(AssetKind::TEXTURE)) {
+            throw std::runtime_error("scene file: unknown asset kind");
+        }
+        scene.assets[i] = { .kind = static_cast<AssetKind>(record.kind), .contentHash = record.contentHash, .path = readString(strings, record.pathOffset, record.pathLength) };
+    }
+    scene.objects.resize(objectRecords.size());
+    for (std::size_t i = 0; i < objectRecords.size(); i++) {
+        const ObjectRecord& record = objectRecords[i];
+        checkIndex(record.parent, objectRecords.size(), "parent");
+        checkIndex(record.model, assetRecords.size(), "model");
+        checkIndex(record.diffuseMap, assetRecords.size(), "texture");
+        scene.objects[i] = { .transform = fromRecord(record.transform), .parent = record.parent, .model = record.model, .diffuseMap = record.diffuseMap, .occluder = record.occluder != 0, .name = readString(strings, record.nameOffset, record.nameLength) };
+    }
+    scene.lights.resize(lightRecords.size());
+    for (std::size_t i = 0; i < lightRecords.size(); i++) {
+        const LightRecord& record = lightRecords[i];
+        checkIndex(record.parent, objectRecords.size(), "parent");
+        scene.lights[i] = {
+            .transform = fromRecord(record.transform),
+            .color = { record.color[0], record.color[1], record.color[2], record.color[3] },
+            .shininess = record.shininess,
+            .parent = record.parent,
+            .flags = static_cast<uint8_t>(record.flags),
+            .name = readString(strings, record.nameOffset, record.nameLength)
+        };
+    }
+    *this = std::move(scene);
+}
+
+void ven::SceneFile::saveText(const std::string& filepath) const
+{
+    std::ostringstream stream;
+    stream << std::setprecision(std::numeric_limits<float>::max_digits10);
+    stream << TEXT_MAGIC << ' ' << FILE_VERSION << '\n';
+    for (const SceneAsset& asset : assets) {
+        stream << "asset " << (asset.kind == AssetKind::MODEL ? "model" : "texture") << ' ' << std::hex << std::setw(16) << std::setfill('0') << asset.contentHash << std::dec << std::setfill(' ') << ' ' << std::quoted(asset.path) << '\n';
+    }
+    for (const SceneObject& object : objects) {
+        stream << "object " << std::quoted(object.name);
+        writeTransform(stream, object.transform);
+        stream << " parent ";
+        writeIndex(stream, object.parent);
+        stream << " model ";
+        writeIndex(stream, object.model);
+        stream << " texture ";
+        writeIndex(stream, object.diffuseMap);
+        stream << " occluder " << (object.occluder ? 1 : 0) << '\n';
+    }
+    for (const SceneLight& light : lights) {
+        stream << "light " << std::quoted(light.name);
+        writeTransform(stream, light.transform);
+        stream << " color " << light.color.x << ' ' << light.color.y << ' ' << light.color.z << ' ' << light.color.w;
+        stream << " shininess " << light.shininess << " parent ";
+        writeIndex(stream, light.parent);
+        stream << " flags " << static_cast<uint32_t>(light.flags) << '\n';
+    }
+
+    std::ofstream file(filepath, std::ios::trunc);
+    if (!file || !(file << stream.str())) {
+        throw std::runtime_error("failed to write file: " + filepath);
+    }
+}
+
+void ven::SceneFile::loadText(const std::string_view text)
+{
+    std::istringstream input{std::string(text)};
+    std::string line;
+    SceneFile scene;
+    std::string magic;
+    uint32_t version = 0;
+    std::getline(input, line);
+    std::istringstream(line) >> magic >> version;
+    if (magic != TEXT_MAGIC || (version != FILE_VERSION && version != FILE_VERSION_V1)) {
+        throw std::runtime_error("scene file: unsupported format or version");
+    }
+    for (std::size_t lineNumber = 2; std::getline(input, line); lineNumber++) {
+        std::istringstream stream(line);
+        std::string type;
+        if (!(stream >> type) || type.starts_with('#')) { continue; }
+        if (type == "asset") {
+            std::string kind;
+            SceneAsset asset;
+            stream >> kind >> std::hex >> asset.contentHash >> std::dec >> std::quoted(asset.path);
+            if (kind != "model" && kind != "texture") {
+                throw std::runtime_error("scene file: unknown asset kind at line " + std::to_string(lineNumber));
+            }
+            asset.kind = kind == "model" ? AssetKind::MODEL : AssetKind::TEXTURE;
+            scene.assets.push_back(std::move(asset));
+        } else if (type == "object") {
+            SceneObject object;
+            int occluder = 0;
+            stream >> std::quoted(object.name);
+            readTransform(stream, object.transform);
+            expectKeyword(stream, "parent");
+            object.parent = readIndex(stream);
+            expectKeyword(stream, "model");
+            object.model = readIndex(stream);
+            expectKeyword(stream, "texture");
+            object.diffuseMap = readIndex(stream);
+            expectKeyword(stream, "occluder");
+            stream >> occluder;
+            object.occluder = occluder != 0;
+            scene.objects.push_back(std::move(object));
+        } else if (type == "light") {
+            SceneLight light;
+            uint32_t flags = V1_LIGHT_FLAGS;
+            stream >> std::quoted(light.name);
+            readTransform(stream, light.transform);
+            expectKeyword(stream, "color");
+            stream >> light.color.x >> light.color.y >> light.color.z >> light.color.w;
+            expectKeyword(stream, "shininess");
+            stream >> light.shininess;
+            expectKeyword(stream, "parent");
+            light.parent = readIndex(stream);
+            if (version != FILE_VERSION_V1) {
+                expectKeyword(stream, "flags");
+                stream >> flags;
+            }
+            light.flags = static_cast<uint8_t>(flags);
+            scene.lights.push_back(std::move(light));
+        } else {
+            throw std::runtime_error("scene file: unknown entry '" + type + "' at line " + std::to_string(lineNumber));
+        }
+        if (stream.fail()) {
+            throw std::runtime_error("scene file: malformed " + type + " at line " + std::to_string(lineNumber));
+        }
+    }
+    for (const SceneObject& object : scene.objects) {
+        checkIndex(object.parent, scene.objects.size(), "parent");
+        checkIndex(object.model, scene.assets.size(), "model");
+        checkIndex(object.diffuseMap, scene.assets.size(), "texture");
+    }
+    for (const SceneLight& light : scene.lights) {
+        checkIndex(light.parent, scene.objects.size(), "parent");
+    }
+    *this = std::move(scene);
+}
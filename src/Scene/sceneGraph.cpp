@@ -0,0 +1,239 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include "VEngine/Scene/SceneGraph.hpp"
+
+uint32_t ven::SceneGraph::add(const glm::mat4& local, const uint32_t parent)
+{
+    if (parent != NONE && !contains(parent)) {
+        throw std::invalid_argument("SceneGraph: unknown parent node");
+    }
+    uint32_t node = 0;
+    if (m_freeIds.empty()) {
+        node = static_cast<uint32_t>(m_parents.size());
+        m_parents.push_back(NONE);
+        m_firstChildren.push_back(NONE);
+        m_nextSiblings.push_back(NONE);
+        m_prevSiblings.push_back(NONE);
+        m_dense.push_back(NONE);
+    } else {
+        node = m_freeIds.back();
+        m_freeIds.pop_back();
+    }
+    link(node, parent);
+    m_dense[node] = static_cast<uint32_t>(m_ids.size());
+    m_ids.push_back(node);
+    m_denseParents.push_back(NONE); // resolved by rebuild
+    m_locals.push_back(local);
+    m_worlds.push_back(local);
+    m_versions.push_back(0);
+    m_dirty.push_back(1);
+    m_removed.push_back(0);
+    m_structureDirty = true;
+    return node;
+}
+
+void ven::SceneGraph::remove(const uint32_t node)
+{
+    if (!contains(node)) {
+        throw std::out_of_range("SceneGraph: unknown node");
+    }
+    const uint32_t parent = m_parents[node];
+    unlink(node);
+    while (m_firstChildren[node] != NONE) {
+        const uint32_t child = m_firstChildren[node];
+        unlink(child);
+        link(child, parent);
+        markDirty(m_dense[child]);
+    }
+    m_removed[m_dense[node]] = 1;
+    m_dense[node] = NONE;
+    m_freeIds.push_back(node);
+    m_pendingRemovals++;
+    m_structureDirty = true;
+}
+
+void ven::SceneGraph::setParent(const uint32_t node, const uint32_t parent)
+{
+    if (!contains(node) || (parent != NONE && !contains(parent))) {
+        throw std::out_of_range("SceneGraph: unknown node");
+    }
+    for (uint32_t ancestor = parent; ancestor != NONE; ancestor = m_parents[ancestor]) {
+        if (ancestor == node) {
+            throw std::invalid_argument("SceneGraph: parenting would create a cycle");
+        }
+    }
+    unlink(node);
+    link(node, parent);
+    markDirty(m_dense[node]);
+    m_structureDirty = true;
+}
+
+void ven::SceneGraph::link(const uint32_t node, const uint32_t parent)
+{
+    m_parents[node] = parent;
+    if (parent == NONE) { return; }
+    m_prevSiblings[node] = NONE;
+    m_nextSiblings[node] = m_firstChildren[parent];
+    if (m_firstChildren[parent] != NONE) {
+        m_prevSiblings[m_firstChildren[parent]] = node;
+    }
+    m_firstChildren[parent] = node;
+}
+
+void ven::SceneGraph::unlink(const uint32_t node)
+{
+    const uint32_t parent = m_parents[node];
+    if (parent == NONE) { return; }
+    if (m_prevSiblings[node] == NONE) {
+        m_firstChildren[parent] = m_nextSiblings[node];
+    } else {
+        m_nextSiblings[m_prevSiblings[node]] = m_nextSiblings[node];
+    }
+    if (m_nextSiblings[node] != NONE) {
+        m_prevSiblings[m_nextSiblings[node]] = m_prevSiblings[node];
+    }
+    m_parents[node] = NONE;
+    m_prevSiblings[node] = NONE;
+    m_nextSiblings[node] = NONE;
+}
+
+void ven::SceneGraph::setLocal(const uint32_t node, const glm::mat4& local)
+{
+    if (!contains(node)) {
+        throw std::out_of_range("SceneGraph: unknown node");
+    }
+    m_locals[m_dense[node]] = local;
+    markDirty(m_dense[node]);
+}
+
+void ven::SceneGraph::markDirty(const uint32_t dense)
+{
+    if (m_dirty[dense] != 0) { return; }
+    m_dirty[dense] = 1;
+    if (!m_structureDirty) {
+        const auto level = std::upper_bound(m_levelOffsets.begin(), m_levelOffsets.end(), dense) - m_levelOffsets.begin() - 1;
+        m_levelDirty[static_cast<std::size_t>(level)].push_back(dense);
+    }
+}
+
+void ven::SceneGraph::rebuild()
+{
+    // depth of every live node, walking up to the first ancestor whose depth is known
+    std::vector<uint32_t> levels(m_parents.size(), NONE);
+    std::vector<uint32_t> chain;
+    uint32_t levelCount = 0;
+    for (std::size_t dense = 0; dense < m_ids.size(); dense++) {
+        if (m_removed[dense] != 0) { continue; }
+        uint32_t node = m_ids[dense];
+        while (node != NONE && levels[node] == NONE) {
+            chain.push_back(node);
+            node = m_parents[node];
+        }
+        uint32_t level = node == NONE ? 0 : levels[node] + 1;
+        for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+            levels[*it] = level++;
+        }
+        levelCount = std::max(levelCount, level);
+        chain.clear();
+    }
+
+    // stable counting sort of the dense arrays by level
+    m_levelOffsets.assign(levelCount + 1, 0);
+    for (std::size_t dense = 0; dense < m_ids.size(); dense++) {
+        if (m_removed[dense] == 0) { m_levelOffsets[levels[m_ids[dense]] + 1]++; }
+    }
+    for (std::size_t level = 0; level < levelCount; level++) {
+        m_levelOffsets[level + 1] += m_levelOffsets[level];
+    }
+    const uint32_t count = m_levelOffsets.back();
+    std::vector<uint32_t> cursor(m_levelOffsets.begin(), m_levelOffsets.end() - 1);
+    std::vector<uint32_t> ids(count);
+    std::vector<glm::mat4> locals(count);
+    std::vector<glm::mat4> worlds(count);
+    std::vector<uint64_t> versions(count);
+    std::vector<uint8_t> dirty(count);
+    m_levelDirty.assign(levelCount, {});
+    for (std::size_t dense = 0; dense < m_ids.size(); dense++) {
+        if (m_removed[dense] != 0) { continue; }
+        const uint32_t level = levels[m_ids[dense]];
+        const uint32_t target = cursor[level]++;
+        ids[target] = m_ids[dense];
+        locals[target] = m_locals[dense];
+        worlds[target] = m_worlds[dense];
+        versions[target] = m_versions[dense];
+        dirty[target] = m_dirty[dense];
+        if (dirty[target] != 0) {
+            m_levelDirty[level].push_back(target);
+        }
+    }
+    m_ids = std::move(ids);
+    m_locals = std::move(locals);
+    m_worlds = std::move(worlds);
+    m_versions = std::move(versions);
+    m_dirty = std::move(dirty);
+    m_removed.assign(count, 0);
+    m_denseParents.resize(count);
+    for (uint32_t dense = 0; dense < count; dense++) {
+        m_dense[m_ids[dense]] = dense;
+    }
+    for (uint32_t dense = 0; dense < count; dense++) {
+        const uint32_t parent = m_parents[m_ids[dense]];
+        m_denseParents[dense] = parent == NONE ? NONE : m_dense[parent];
+    }
+    m_pendingRemovals = 0;
+    m_structureDirty = false;
+}
+
+void ven::SceneGraph::updateNodes(const std::span<const uint32_t> nodes, std::vector<uint32_t>& children)
+{
+    for (const uint32_t dense : nodes) {
+        const uint32_t parent = m_denseParents[dense];
+        m_dirty[dense] = 0;
+        m_worlds[dense] = parent == NONE ? m_locals[dense] : m_worlds[parent] * m_locals[dense];
+        m_versions[dense] = (m_updateCount << 32U) | m_ids[dense];
+        for (uint32_t child = m_firstChildren[m_ids[dense]]; child != NONE; child = m_nextSiblings[child]) {
+            children.push_back(m_dense[child]);
+        }
+    }
+}
+
+uint32_t ven::SceneGraph::update()
+{
+    if (m_structureDirty) {
+        rebuild();
+    }
+    m_updateCount++;
+    uint32_t changed = 0;
+    std::vector<std::vector<uint32_t>> chunkChildren;
+    for (uint32_t level = 0; level < getLevelCount(); level++) {
+        // only the nodes touched since the last update and the subtrees below them are visited
+        std::vector<uint32_t>& nodes = m_levelDirty[level];
+        if (nodes.empty()) { continue; }
+        const std::size_t chunkCount = (nodes.size() + PARALLEL_GRAIN - 1) / PARALLEL_GRAIN;
+        chunkChildren.resize(std::max(chunkChildren.size(), chunkCount));
+        if (m_threadPool != nullptr && nodes.size() > PARALLEL_GRAIN) {
+            m_threadPool->parallelFor(nodes.size(), [&](const std::size_t chunkBegin, const std::size_t chunkEnd) {
+                updateNodes(std::span(nodes).subspan(chunkBegin, chunkEnd - chunkBegin), chunkChildren[chunkBegin / PARALLEL_GRAIN]);
+            }, PARALLEL_GRAIN);
+        } else {
+            updateNodes(nodes, chunkChildren[0]);
+        }
+        changed += static_cast<uint32_t>(nodes.size());
+        nodes.clear();
+
+        // a child already queued by setLocal is not queued twice, each child has one parent so the chunks never share one
+        if (level + 1 < getLevelCount()) {
+            std::vector<uint32_t>& next = m_levelDirty[level + 1];
+            for (std::size_t chunk = 0; chunk < chunkCount; chunk++) {
+                for (const uint32_t child : chunkChildren[chunk]) {
+                    if (m_dirty[child] != 0) { continue; }
+                    m_dirty[child] = 1;
+                    next.push_back(child);
+                }
+                chunkChildren[chunk].clear();
+            }
+        }
+    }
+    return changed;
+}
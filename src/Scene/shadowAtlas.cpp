@@ -0,0 +1,84 @@
+#include <algorithm>
+#include <bit>
+#include <cassert>
+
+#include "VEngine/Scene/ShadowAtlas.hpp"
+
+ven::ShadowAtlas::ShadowAtlas(const uint32_t size, const uint32_t minTileSize) : m_size{size}, m_minTileSize{minTileSize}
+{
+    assert(std::has_single_bit(size) && std::has_single_bit(minTileSize) && minTileSize <= size && "atlas and tile sizes must be powers of two");
+    m_freeTiles.resize(static_cast<std::size_t>(std::countr_zero(size) - std::countr_zero(minTileSize)) + 1);
+    clear();
+}
+
+void ven::ShadowAtlas::clear()
+{
+    for (std::vector<ShadowTile>& tiles : m_freeTiles) {
+        tiles.clear();
+    }
+    m_freeTiles[0].push_back({ .x = 0, .y = 0, .size = m_size });
+}
+
+uint32_t ven::ShadowAtlas::getLevel(const uint32_t size) const
+{
+    return static_cast<uint32_t>(std::countr_zero(m_size) - std::countr_zero(size));
+}
+
+std::optional<ven::ShadowTile> ven::ShadowAtlas::allocate(const uint32_t size)
+{
+    if (!std::has_single_bit(size) || size < m_minTileSize || size > m_size) { return std::nullopt; }
+    const uint32_t level = getLevel(size);
+
+    // the smallest free tile able to hold the request is split down to its size
+    uint32_t source = level + 1;
+    while (source > 0 && m_freeTiles[source - 1].empty()) {
+        source--;
+    }
+    if (source == 0) { return std::nullopt; }
+    source--;
+    for (; source < level; source++) {
+        const ShadowTile parent = m_freeTiles[source].back();
+        m_freeTiles[source].pop_back();
+        const uint32_t half = parent.size / 2;
+        std::vector<ShadowTile>& children = m_freeTiles[source + 1];
+        // the first child is pushed last so it is taken first, allocations pack toward the origin
+        children.push_back({ .x = parent.x + half, .y = parent.y + half, .size = half });
+        children.push_back({ .x = parent.x, .y = parent.y + half, .size = half });
+        children.push_back({ .x = parent.x + half, .y = parent.y, .size = half });
+        children.push_back({ .x = parent.x, .y = parent.y, .size = half });
+    }
+    const ShadowTile tile = m_freeTiles[level].back();
+    m_freeTiles[level].pop_back();
+    return tile;
+}
+
+void ven::ShadowAtlas::free(const ShadowTile& tile)
+{
+    ShadowTile current = tile;
+    for (uint32_t level = getLevel(tile.size); level > 0; level--) {
+        std::vector<ShadowTile>& tiles = m_freeTiles[level];
+        const uint32_t parentSize = current.size * 2;
+        const ShadowTile parent{ .x = current.x & ~(parentSize - 1), .y = current.y & ~(parentSize - 1), .size = parentSize };
+        const auto isSibling = [&](const ShadowTile& other) {
+            return other.x >= parent.x && other.x < parent.x + parentSize && other.y >= parent.y && other.y < parent.y + parentSize;
+        };
+        if (std::count_if(tiles.begin(), tiles.end(), isSibling) != 3) {
+            tiles.push_back(current);
+            return;
+        }
+        std::erase_if(tiles, isSibling);
+        current = parent;
+    }
+    m_freeTiles[0].push_back(current);
+}
+
+uint64_t ven::ShadowAtlas::getFreeArea() const
+{
+    uint64_t area = 0;
+    for (const std::vector<ShadowTile>& tiles : m_freeTiles) {
+        for (const ShadowTile& tile : tiles) {
+            area += static_cast<uint64_t>(tile.size) * tile.size;
+        }
+    }
+    return area;
+}
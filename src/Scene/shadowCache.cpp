@@ -0,0 +1,281 @@
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <numeric>
+
+#include "VEngine/Scene/Frustum.hpp"
+#include "VEngine/Scene/ShadowCache.hpp"
+
+namespace {
+
+    constexpr float MOVE_EPSILON = 1e-4F;
+    constexpr float MIN_DISTANCE = 1e-3F;
+
+    bool intersects(const ven::AABB& bounds, const glm::vec3& center, const float radius)
+    {
+        const glm::vec3 offset = center - glm::clamp(center, bounds.min, bounds.max);
+        return dot(offset, offset) <= radius * radius;
+    }
+
+} // namespace
+
+void ven::ShadowCache::begin(const glm::vec3& cameraPosition, const float fov, const float viewportHeight)
+{
+    m_cameraPosition = cameraPosition;
+    // a world space length at distance d covers length * m_projectionScale / d pixels
+    m_projectionScale = viewportHeight / (2.F * std::tan(fov * 0.5F));
+}
+
+void ven::ShadowCache::clear()
+{
+    m_atlas.clear();
+    m_objectStates.clear();
+    m_lightStates.clear();
+    m_shadowMaps.clear();
+    m_lightShadows.clear();
+    m_stats = {};
+}
+
+bool ven::ShadowCache::isStatic(const Handle object) const
+{
+    return object.index < m_objectStates.size() && m_objectStates[object.index].frame != 0 && m_objectStates[object.index].generation == object.generation
+        && m_objectStates[object.index].stillFrames >= SHADOW_SETTLE_FRAMES;
+}
+
+uint32_t ven::ShadowCache::getFaceSize(const ShadowLight& light) const
+{
+    const uint32_t maxSize = std::max(std::min(SHADOW_MAX_FACE_SIZE, m_atlas.getSize() / 4), m_atlas.getMinTileSize());
+    // the camera inside the range sees the shadows of the light all around it
+    const float distance = glm::length(light.position - m_cameraPosition) - light.range;
+    if (distance < MIN_DISTANCE) { return maxSize; }
+    // a face spans a quarter of the circumference, about half the screen size of the range sphere
+    const float faceSize = std::min(light.range * m_projectionScale / distance, static_cast<float>(maxSize));
+    return std::clamp(std::bit_ceil(static_cast<uint32_t>(faceSize)), m_atlas.getMinTileSize(), maxSize);
+}
+
+glm::mat4 ven::ShadowCache::getFaceViewProjection(const glm::vec3& position, const float range, const uint32_t face)
+{
+    static constexpr std::array<glm::vec3, CUBE_FACE_COUNT> DIRECTIONS{{{1.F, 0.F, 0.F}, {-1.F, 0.F, 0.F}, {0.F, 1.F, 0.F}, {0.F, -1.F, 0.F}, {0.F, 0.F, 1.F}, {0.F, 0.F, -1.F}}};
+    static constexpr std::array<glm::vec3, CUBE_FACE_COUNT> UPS{{{0.F, -1.F, 0.F}, {0.F, -1.F, 0.F}, {0.F, 0.F, 1.F}, {0.F, 0.F, -1.F}, {0.F, -1.F, 0.F}, {0.F, -1.F, 0.F}}};
+
+    // same conventions as Camera::setViewDirection and Camera::setPerspectiveProjection, with a square 90 degrees frustum
+    const glm::vec3 w = DIRECTIONS.at(face);
+    const glm::vec3 u{normalize(cross(w, UPS.at(face)))};
+    const glm::vec3 v{cross(w, u)};
+    glm::mat4 view{1.F};
+    view[0][0] = u.x;
+    view[1][0] = u.y;
+    view[2][0] = u.z;
+    view[0][1] = v.x;
+    view[1][1] = v.y;
+    view[2][1] = v.z;
+    view[0][2] = w.x;
+    view[1][2] = w.y;
+    view[2][2] = w.z;
+    view[3][0] = -dot(u, position);
+    view[3][1] = -dot(v, position);
+    view[3][2] = -dot(w, position);
+
+    const float far = std::max(range, SHADOW_NEAR * 2.F);
+    glm::mat4 projection{0.F};
+    projection[0][0] = 1.F;
+    projection[1][1] = 1.F;
+    projection[2][2] = far / (far - SHADOW_NEAR);
+    projection[2][3] = 1.F;
+    projection[3][2] = -(far * SHADOW_NEAR) / (far - SHADOW_NEAR);
+    return projection * view;
+}
+
+std::optional<std::array<ven::ShadowTile, ven::CUBE_FACE_COUNT>> ven::ShadowCache::allocateFaces(const uint32_t faceSize)
+{
+    std::array<ShadowTile, CUBE_FACE_COUNT> tiles{};
+    for (uint32_t face = 0; face < CUBE_FACE_COUNT; face++) {
+        const std::optional<ShadowTile> tile = m_atlas.allocate(faceSize);
+        if (!tile) {
+            for (uint32_t i = 0; i < face; i++) {
+                m_atlas.free(tiles.at(i));
+            }
+            return std::nullopt;
+        }
+        tiles.at(face) = *tile;
+    }
+    return tiles;
+}
+
+void ven::ShadowCache::freeFaces(LightState& state)
+{
+    if (state.faceSize == 0) { return; }
+    for (const ShadowTile& tile : state.tiles) {
+        m_atlas.free(tile);
+    }
+    state.faceSize = 0;
+}
+
+void ven::ShadowCache::updateObjects(const std::span<const Handle> objects, const std::span<const AABB> bounds, const std::span<const uint64_t> versions)
+{
+    m_dynamicObjects.clear();
+    m_invalidBounds.clear();
+    for (uint32_t i = 0; i < objects.size(); i++) {
+        const Handle handle = objects[i];
+        if (handle.index >= m_objectStates.size()) {
+            m_objectStates.resize(static_cast<std::size_t>(handle.index) + 1);
+        }
+        ObjectState& state = m_objectStates[handle.index];
+        if (state.frame == 0 || state.generation != handle.generation) {
+            // a new object, maybe in the slot of an erased static one whose shadow must go
+            if (state.frame != 0 && state.stillFrames >= SHADOW_SETTLE_FRAMES) {
+                m_invalidBounds.push_back(state.bounds);
+            }
+            state = { .generation = handle.generation, .version = versions[i], .frame = m_frame, .stillFrames = 0, .bounds = {} };
+        } else if (state.version != versions[i]) {
+            // it leaves the static layer, its baked shadow must go
+            if (state.stillFrames >= SHADOW_SETTLE_FRAMES) {
+                m_invalidBounds.push_back(state.bounds);
+            }
+            state.version = versions[i];
+            state.stillFrames = 0;
+        } else if (state.stillFrames < SHADOW_SETTLE_FRAMES) {
+            state.stillFrames++;
+            if (state.stillFrames == SHADOW_SETTLE_FRAMES) {
+                state.bounds = bounds[i];
+                m_invalidBounds.push_back(bounds[i]);
+            }
+        }
+        state.frame = m_frame;
+        if (state.stillFrames < SHADOW_SETTLE_FRAMES) {
+            m_dynamicObjects.push_back(i);
+        }
+    }
+    for (ObjectState& state : m_objectStates) {
+        if (state.frame == 0 || state.frame == m_frame) { continue; }
+        // erased since the last update
+        if (state.stillFrames >= SHADOW_SETTLE_FRAMES) {
+            m_invalidBounds.push_back(state.bounds);
+        }
+        state = {};
+    }
+}
+
+void ven::ShadowCache::assignTiles(const std::span<const ShadowLight> lights)
+{
+    m_moved.assign(lights.size(), 0);
+    std::vector<uint32_t> faceSizes(lights.size());
+    std::vector<float> importances(lights.size());
+    for (uint32_t i = 0; i < lights.size(); i++) {
+        const Handle handle = lights[i].handle;
+        if (handle.index >= m_lightStates.size()) {
+            m_lightStates.resize(static_cast<std::size_t>(handle.index) + 1);
+        }
+        LightState& state = m_lightStates[handle.index];
+        if (state.frame == 0 || state.generation != handle.generation) {
+            freeFaces(state);
+            state = { .generation = handle.generation };
+        }
+        state.frame = m_frame;
+        faceSizes[i] = getFaceSize(lights[i]);
+        importances[i] = lights[i].range / std::max(glm::length(lights[i].position - m_cameraPosition) - lights[i].range, MIN_DISTANCE);
+        // a light only shrinks two sizes down, so moving around a threshold does not bake it every frame
+        if (state.faceSize != 0 && faceSizes[i] * 4 <= state.faceSize) {
+            freeFaces(state);
+        }
+    }
+    // lights erased or no longer casting shadows give their tiles back
+    for (LightState& state : m_lightStates) {
+        if (state.frame == 0 || state.frame == m_frame) { continue; }
+        freeFaces(state);
+        state = {};
+    }
+
+    std::vector<uint32_t> order(lights.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](const uint32_t lhs, const uint32_t rhs) { return importances[lhs] > importances[rhs]; });
+    std::size_t evictable = order.size(); // lights of order[rank + 1, evictable) may lose their tiles
+    for (std::size_t rank = 0; rank < order.size(); rank++) {
+        const uint32_t light = order[rank];
+        LightState& state = m_lightStates[lights[light].handle.index];
+        if (state.faceSize >= faceSizes[light]) { continue; }
+        std::optional<std::array<ShadowTile, CUBE_FACE_COUNT>> tiles;
+        uint32_t faceSize = 0;
+        while (true) {
+            // a light holding tiles only tries the sizes above its own, the others go down to the smallest one
+            for (uint32_t size = faceSizes[light]; size >= m_atlas.getMinTileSize() && size > state.faceSize; size /= 2) {
+                tiles = allocateFaces(size);
+                if (tiles) {
+                    faceSize = size;
+                    break;
+                }
+            }
+            if (tiles || state.faceSize != 0) { break; }
+            // the atlas is full, the least important light holding tiles makes room
+            while (evictable > rank + 1 && m_lightStates[lights[order[evictable - 1]].handle.index].faceSize == 0) {
+                evictable--;
+            }
+            if (evictable <= rank + 1) { break; }
+            freeFaces(m_lightStates[lights[order[--evictable]].handle.index]);
+        }
+        if (!tiles) { continue; }
+        freeFaces(state);
+        state.tiles = *tiles;
+        state.faceSize = faceSize;
+        m_moved[light] = 1;
+    }
+}
+
+void ven::ShadowCache::update(const std::span<const Handle> objects, const std::span<const AABB> bounds, const std::span<const uint64_t> versions, const std::span<const ShadowLight> lights)
+{
+    m_frame++;
+    updateObjects(objects, bounds, versions);
+    assignTiles(lights);
+
+    m_shadowMaps.clear();
+    m_lightShadows.assign(lights.size(), -1);
+    m_stats = { .shadowMaps = 0, .baked = 0, .composited = 0, .dynamicObjects = static_cast<uint32_t>(m_dynamicObjects.size()) };
+    std::array<Frustum, CUBE_FACE_COUNT> faceFrustums;
+    for (uint32_t i = 0; i < lights.size(); i++) {
+        const ShadowLight& light = lights[i];
+        LightState& state = m_lightStates[light.handle.index];
+        if (state.faceSize == 0) { continue; }
+        bool bake = m_moved[i] != 0 || glm::length(light.position - state.position) > MOVE_EPSILON || std::abs(light.range - state.range) > MOVE_EPSILON;
+        for (std::size_t j = 0; !bake && j < m_invalidBounds.size(); j++) {
+            bake = intersects(m_invalidBounds[j], light.position, light.range);
+        }
+        state.position = light.position;
+        state.range = light.range;
+
+        ShadowMap& map = m_shadowMaps.emplace_back();
+        map.light = i;
+        map.tiles = state.tiles;
+        map.bake = bake;
+        for (uint32_t face = 0; face < CUBE_FACE_COUNT; face++) {
+            map.faceViewProjections.at(face) = getFaceViewProjection(light.position, light.range, face);
+            faceFrustums.at(face).update(map.faceViewProjections.at(face));
+        }
+        const auto addCaster = [&](std::array<std::vector<uint32_t>, CUBE_FACE_COUNT>& casters, const uint32_t object) {
+            for (uint32_t face = 0; face < CUBE_FACE_COUNT; face++) {
+                if (faceFrustums.at(face).intersects(bounds[object])) {
+                    casters.at(face).push_back(object);
+                }
+            }
+        };
+        bool hasDynamic = false;
+        for (const uint32_t object : m_dynamicObjects) {
+            if (!intersects(bounds[object], light.position, light.range)) { continue; }
+            hasDynamic = true;
+            addCaster(map.dynamicCasters, object);
+        }
+        if (bake) {
+            for (uint32_t object = 0; object < objects.size(); object++) {
+                if (m_objectStates[objects[object].index].stillFrames >= SHADOW_SETTLE_FRAMES && intersects(bounds[object], light.position, light.range)) {
+                    addCaster(map.staticCasters, object);
+                }
+            }
+        }
+        // the dynamic casters of the previous frame must be wiped from the final layer as well
+        map.composite = bake || hasDynamic || state.hadDynamic;
+        state.hadDynamic = hasDynamic;
+        m_lightShadows[i] = static_cast<int32_t>(m_shadowMaps.size() - 1);
+        m_stats.shadowMaps++;
+        m_stats.baked += bake ? 1 : 0;
+        m_stats.composited += map.composite ? 1 : 0;
+    }
+}
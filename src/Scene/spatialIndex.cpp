@@ -0,0 +1,367 @@
+#include <cmath>
+
+#include "VEngine/Scene/SpatialIndex.hpp"
+
+namespace {
+
+    constexpr std::size_t STACK_RESERVE = 64;
+
+    ven::AABB combine(const ven::AABB& lhs, const ven::AABB& rhs)
+    {
+        return { .min = glm::min(lhs.min, rhs.min), .max = glm::max(lhs.max, rhs.max) };
+    }
+
+    float surfaceArea(const ven::AABB& box)
+    {
+        const glm::vec3 size = box.max - box.min;
+        return 2.F * (size.x * size.y + size.y * size.z + size.z * size.x);
+    }
+
+    bool contains(const ven::AABB& outer, const ven::AABB& inner)
+    {
+        return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.min.z <= inner.min.z
+            && inner.max.x <= outer.max.x && inner.max.y <= outer.max.y && inner.max.z <= outer.max.z;
+    }
+
+    bool overlaps(const ven::AABB& lhs, const ven::AABB& rhs)
+    {
+        return lhs.min.x <= rhs.max.x && rhs.min.x <= lhs.max.x && lhs.min.y <= rhs.max.y && rhs.min.y <= lhs.max.y && lhs.min.z <= rhs.max.z && rhs.min.z <= lhs.max.z;
+    }
+
+    ///
+    /// @return Entry distance of the ray into the box, or a negative value if it misses it within [0, maxDistance]
+    ///
+    float intersect(const ven::Ray& ray, const glm::vec3& inverseDirection, const ven::AABB& box)
+    {
+        float near = 0.F;
+        float far = ray.maxDistance;
+        for (int axis = 0; axis < 3; axis++) {
+            if (std::isinf(inverseDirection[axis])) {
+                // parallel to the slab
+                if (ray.origin[axis] < box.min[axis] || ray.origin[axis] > box.max[axis]) { return -1.F; }
+                continue;
+            }
+            float t1 = (box.min[axis] - ray.origin[axis]) * inverseDirection[axis];
+            float t2 = (box.max[axis] - ray.origin[axis]) * inverseDirection[axis];
+            if (t1 > t2) { std::swap(t1, t2); }
+            near = std::max(near, t1);
+            far = std::min(far, t2);
+            if (near > far) { return -1.F; }
+        }
+        return near;
+    }
+
+} // namespace
+
+uint32_t ven::SpatialIndex::allocateNode()
+{
+    if (m_freeList == NONE) {
+        m_nodes.emplace_back();
+        m_nodes.back().height = 0;
+        return static_cast<uint32_t>(m_nodes.size() - 1);
+    }
+    const uint32_t node = m_freeList;
+    m_freeList = m_nodes[node].parent;
+    m_nodes[node] = Node{};
+    m_nodes[node].height = 0;
+    return node;
+}
+
+void ven::SpatialIndex::freeNode(const uint32_t node)
+{
+    m_nodes[node].parent = m_freeList;
+    m_nodes[node].height = -1;
+    m_freeList = node;
+}
+
+uint32_t ven::SpatialIndex::insert(const AABB& bounds, const Handle handle)
+{
+    const uint32_t proxy = allocateNode();
+    m_nodes[proxy].bounds = { .min = bounds.min - glm::vec3(m_fatMargin), .max = bounds.max + glm::vec3(m_fatMargin) };
+    m_nodes[proxy].handle = handle;
+    insertLeaf(proxy);
+    m_proxyCount++;
+    return proxy;
+}
+
+void ven::SpatialIndex::remove(const uint32_t proxy)
+{
+    removeLeaf(proxy);
+    freeNode(proxy);
+    m_proxyCount--;
+}
+
+bool ven::SpatialIndex::update(const uint32_t proxy, const AABB& bounds)
+{
+    if (contains(m_nodes[proxy].bounds, bounds)) { return false; }
+    removeLeaf(proxy);
+    m_nodes[proxy].bounds = { .min = bounds.min - glm::vec3(m_fatMargin), .max = bounds.max + glm::vec3(m_fatMargin) };
+    insertLeaf(proxy);
+    return true;
+}
+
+void ven::SpatialIndex::insertLeaf(const uint32_t leaf)
+{
+    if (m_root == NONE) {
+        m_root = leaf;
+        m_nodes[leaf].parent = NONE;
+        return;
+    }
+
+    // descend towards the sibling minimizing the surface area added to the tree
+    const AABB leafBounds = m_nodes[leaf].bounds;
+    uint32_t index = m_root;
+    while (!m_nodes[index].isLeaf()) {
+        const Node& node = m_nodes[index];
+        const float area = surfaceArea(node.bounds);
+        const float combinedArea = surfaceArea(combine(node.bounds, leafBounds));
+        const float cost = 2.F * combinedArea;
+        const float inheritanceCost = 2.F * (combinedArea - area);
+        const auto childCost = [&](const uint32_t child) {
+            const float childArea = surfaceArea(combine(leafBounds, m_nodes[child].bounds));
+            return (m_nodes[child].isLeaf() ? childArea : childArea - surfaceArea(m_nodes[child].bounds)) + inheritanceCost;
+        };
+        const float cost1 = childCost(node.child1);
+        const float cost2 = childCost(node.child2);
+        if (cost < cost1 && cost < cost2) { break; }
+        index = cost1 < cost2 ? node.child1 : node.child2;
+    }
+
+    const uint32_t sibling = index;
+    const uint32_t oldParent = m_nodes[sibling].parent;
+    const uint32_t newParent = allocateNode();
+    m_nodes[newParent].parent = oldParent;
+    m_nodes[newParent].bounds = combine(leafBounds, m_nodes[sibling].bounds);
+    m_nodes[newParent].height = m_nodes[sibling].height + 1;
+    m_nodes[newParent].child1 = sibling;
+    m_nodes[newParent].child2 = leaf;
+    if (oldParent == NONE) {
+        m_root = newParent;
+    } else if (m_nodes[oldParent].child1 == sibling) {
+        m_nodes[oldParent].child1 = newParent;
+    } else {
+        m_nodes[oldParent].child2 = newParent;
+    }
+    m_nodes[sibling].parent = newParent;
+    m_nodes[leaf].parent = newParent;
+
+    for (index = m_nodes[leaf].parent; index != NONE; index = m_nodes[index].parent) {
+        index = balance(index);
+        Node& node = m_nodes[index];
+        node.height = 1 + std::max(m_nodes[node.child1].height, m_nodes[node.child2].height);
+        node.bounds = combine(m_nodes[node.child1].bounds, m_nodes[node.child2].bounds);
+    }
+}
+
+void ven::SpatialIndex::removeLeaf(const uint32_t leaf)
+{
+    if (leaf == m_root) {
+        m_root = NONE;
+        return;
+    }
+    const uint32_t parent = m_nodes[leaf].parent;
+    const uint32_t grandParent = m_nodes[parent].parent;
+    const uint32_t sibling = m_nodes[parent].child1 == leaf ? m_nodes[parent].child2 : m_nodes[parent].child1;
+
+    freeNode(parent);
+    if (grandParent == NONE) {
+        m_root = sibling;
+        m_nodes[sibling].parent = NONE;
+        return;
+    }
+    if (m_nodes[grandParent].child1 == parent) {
+        m_nodes[grandParent].child1 = sibling;
+    } else {
+        m_nodes[grandParent].child2 = sibling;
+    }
+    m_nodes[sibling].parent = grandParent;
+    for (uint32_t index = grandParent; index != NONE; index = m_nodes[index].parent) {
+        index = balance(index);
+        Node& node = m_nodes[index];
+        node.height = 1 + std::max(m_nodes[node.child1].height, m_nodes[node.child2].height);
+        node.bounds = combine(m_nodes[node.child1].bounds, m_nodes[node.child2].bounds);
+    }
+}
+
+uint32_t ven::SpatialIndex::balance(const uint32_t iA)
+{
+    // rotate the taller grandchild subtree up when the children heights differ by more than one
+    Node& a = m_nodes[iA];
+    if (a.isLeaf() || a.height < 2) { return iA; }
+    const uint32_t iB = a.child1;
+    const uint32_t iC = a.child2;
+    const int32_t heightDelta = m_nodes[iC].height - m_nodes[iB].height;
+    if (heightDelta >= -1 && heightDelta <= 1) { return iA; }
+
+    // the taller child (up) replaces a, a keeps the other child (kept)
+    const bool rotateC = heightDelta > 1;
+    const uint32_t iUp = rotateC ? iC : iB;
+    const uint32_t iKept = rotateC ? iB : iC;
+    Node& up = m_nodes[iUp];
+    const uint32_t iF = up.child1;
+    const uint32_t iG = up.child2;
+
+    up.child1 = iA;
+    up.parent = a.parent;
+    a.parent = iUp;
+    if (up.parent == NONE) {
+        m_root = iUp;
+    } else if (m_nodes[up.parent].child1 == iA) {
+        m_nodes[up.parent].child1 = iUp;
+    } else {
+        m_nodes[up.parent].child2 = iUp;
+    }
+
+    // the taller grandchild stays under up, the other one moves under a in place of up
+    const bool keepF = m_nodes[iF].height > m_nodes[iG].height;
+    const uint32_t iStay = keepF ? iF : iG;
+    const uint32_t iMove = keepF ? iG : iF;
+    up.child2 = iStay;
+    if (rotateC) {
+        a.child2 = iMove;
+    } else {
+        a.child1 = iMove;
+    }
+    m_nodes[iMove].parent = iA;
+    a.bounds = combine(m_nodes[iKept].bounds, m_nodes[iMove].bounds);
+    a.height = 1 + std::max(m_nodes[iKept].height, m_nodes[iMove].height);
+    up.bounds = combine(a.bounds, m_nodes[iStay].bounds);
+    up.height = 1 + std::max(a.height, m_nodes[iStay].height);
+    return iUp;
+}
+
+template<typename Overlaps>
+void ven::SpatialIndex::collect(const Overlaps& overlapsBounds, std::vector<Handle>& results) const
+{
+    if (m_root == NONE) { return; }
+    std::vector<uint32_t> stack;
+    stack.reserve(STACK_RESERVE);
+    stack.push_back(m_root);
+    while (!stack.empty()) {
+        const Node& node = m_nodes[stack.back()];
+        stack.pop_back();
+        if (!overlapsBounds(node.bounds)) { continue; }
+        if (node.isLeaf()) {
+            results.push_back(node.handle);
+        } else {
+            stack.push_back(node.child1);
+            stack.push_back(node.child2);
+        }
+    }
+}
+
+void ven::SpatialIndex::collectSubtree(const uint32_t node, std::vector<Handle>& results) const
+{
+    std::vector<uint32_t> stack{node};
+    while (!stack.empty()) {
+        const Node& current = m_nodes[stack.back()];
+        stack.pop_back();
+        if (current.isLeaf()) {
+            results.push_back(current.handle);
+        } else {
+            stack.push_back(current.child1);
+            stack.push_back(current.child2);
+        }
+    }
+}
+
+void ven::SpatialIndex::query(const Frustum& frustum, std::vector<Handle>& results) const
+{
+    if (m_root == NONE) { return; }
+    constexpr uint8_t ALL_PLANES = (1U << PLANE_COUNT) - 1U;
+    const std::array<glm::vec4, PLANE_COUNT>& planes = frustum.getPlanes();
+    // planes a node is fully inside of are not tested again for its children
+    std::vector<std::pair<uint32_t, uint8_t>> stack;
+    stack.reserve(STACK_RESERVE);
+    stack.emplace_back(m_root, ALL_PLANES);
+    while (!stack.empty()) {
+        const auto [index, parentMask] = stack.back();
+        stack.pop_back();
+        const Node& node = m_nodes[index];
+        const glm::vec3 center = node.bounds.center();
+        const glm::vec3 extent = node.bounds.extent();
+        uint8_t mask = parentMask;
+        bool outside = false;
+        for (uint8_t plane = 0; plane < PLANE_COUNT && !outside; plane++) {
+            if ((mask & (1U << plane)) == 0) { continue; }
+            const float distance = dot(glm::vec3(planes[plane]), center) + planes[plane].w;
+            const float radius = dot(extent, glm::abs(glm::vec3(planes[plane])));
+            if (distance < -radius) {
+                outside = true;
+            } else if (distance >= radius) {
+                mask = static_cast<uint8_t>(mask & ~(1U << plane));
+            }
+        }
+        if (outside) { continue; }
+        if (mask == 0) {
+            collectSubtree(index, results);
+        } else if (node.isLeaf()) {
+            results.push_back(node.handle);
+        } else {
+            stack.emplace_back(node.child1, mask);
+            stack.emplace_back(node.child2, mask);
+        }
+    }
+}
+
+void ven::SpatialIndex::query(const BoundingSphere& sphere, std::vector<Handle>& results) const
+{
+    collect([&sphere](const AABB& bounds) {
+        const glm::vec3 closest = glm::clamp(sphere.center, bounds.min, bounds.max);
+        const glm::vec3 delta = closest - sphere.center;
+        return dot(delta, delta) <= sphere.radius * sphere.radius;
+    }, results);
+}
+
+void ven::SpatialIndex::query(const AABB& box, std::vector<Handle>& results) const
+{
+    collect([&box](const AABB& bounds) { return overlaps(bounds, box); }, results);
+}
+
+void ven::SpatialIndex::raycast(const std::span<const Ray> rays, const std::span<RayHit> hits) const
+{
+    std::vector<std::pair<uint32_t, float>> stack;
+    stack.reserve(STACK_RESERVE);
+    for (std::size_t i = 0; i < rays.size(); i++) {
+        const Ray& ray = rays[i];
+        const glm::vec3 inverseDirection = glm::vec3(1.F) / ray.direction;
+        RayHit& hit = hits[i];
+        hit = RayHit{};
+        if (m_root == NONE) { continue; }
+        const float rootDistance = intersect(ray, inverseDirection, m_nodes[m_root].bounds);
+        if (rootDistance < 0.F) { continue; }
+        stack.emplace_back(m_root, rootDistance);
+        while (!stack.empty()) {
+            const auto [index, distance] = stack.back();
+            stack.pop_back();
+            if (distance >= hit.distance) { continue; }
+            const Node& node = m_nodes[index];
+            if (node.isLeaf()) {
+                hit = { .handle = node.handle, .distance = distance };
+                continue;
+            }
+            // nearest child on top of the stack, the farther one is often pruned by its hit
+            float distance1 = intersect(ray, inverseDirection, m_nodes[node.child1].bounds);
+            float distance2 = intersect(ray, inverseDirection, m_nodes[node.child2].bounds);
+            uint32_t child1 = node.child1;
+            uint32_t child2 = node.child2;
+            if (distance1 >= 0.F && distance2 >= 0.F && distance2 > distance1) {
+                std::swap(distance1, distance2);
+                std::swap(child1, child2);
+            }
+            if (distance1 >= 0.F) { stack.emplace_back(child1, distance1); }
+            if (distance2 >= 0.F) { stack.emplace_back(child2, distance2); }
+        }
+    }
+}
+
+float ven::SpatialIndex::getAreaRatio() const
+{
+    if (m_root == NONE) { return 0.F; }
+    const float rootArea = surfaceArea(m_nodes[m_root].bounds);
+    float totalArea = 0.F;
+    for (const Node& node : m_nodes) {
+        if (node.height > 0) { totalArea += surfaceArea(node.bounds); }
+    }
+    return rootArea > 0.F ? totalArea / rootArea : 0.F;
+}
@@ -0,0 +1,105 @@
+#include <cmath>
+#include <stdexcept>
+
+#include "VEngine/Scene/TransformBatch.hpp"
+#include "VEngine/Scene/TransformKernel.hpp"
+
+namespace {
+
+    struct Scalar {
+        using Type = float;
+        static constexpr std::size_t WIDTH = 1;
+
+        static float set1(const float value) { return value; }
+        static float load(const float* ptr) { return *ptr; }
+        static float sub(const float lhs, const float rhs) { return lhs - rhs; }
+        static float mul(const float lhs, const float rhs) { return lhs * rhs; }
+        static float div(const float lhs, const float rhs) { return lhs / rhs; }
+        static float fmadd(const float a, const float b, const float c) { return (a * b) + c; }
+        static float fnmadd(const float a, const float b, const float c) { return c - (a * b); }
+        static void sincos(const float x, float& sine, float& cosine) { sine = std::sin(x); cosine = std::cos(x); }
+        static void storeColumn(float* matrix, const std::size_t column, const float x, const float y, const float z, const float w) {
+            float* out = matrix + (column * 4);
+            out[0] = x;
+            out[1] = y;
+            out[2] = z;
+            out[3] = w;
+        }
+    };
+
+} // namespace
+
+ven::SimdLevel ven::TransformBatch::getSupportedLevel()
+{
+    return getSupportedSimdLevel();
+}
+
+void ven::TransformBatch::setLevel(const SimdLevel level)
+{
+    m_level = static_cast<uint8_t>(level) > static_cast<uint8_t>(getSupportedLevel()) ? getSupportedLevel() : level;
+}
+
+void ven::TransformBatch::clear()
+{
+    resize(0);
+}
+
+void ven::TransformBatch::resize(const std::size_t count)
+{
+    for (std::size_t axis = 0; axis < 3; axis++) {
+        m_translation[axis].resize(count);
+        m_rotation[axis].resize(count);
+        m_scale[axis].resize(count, 1.F);
+    }
+    m_size = count;
+}
+
+void ven::TransformBatch::push(const Transform3D& transform)
+{
+    resize(m_size + 1);
+    set(m_size - 1, transform);
+}
+
+void ven::TransformBatch::set(const std::size_t index, const Transform3D& transform)
+{
+    m_translation[0][index] = transform.translation.x;
+    m_translation[1][index] = transform.translation.y;
+    m_translation[2][index] = transform.translation.z;
+    m_rotation[0][index] = transform.rotation.x;
+    m_rotation[1][index] = transform.rotation.y;
+    m_rotation[2][index] = transform.rotation.z;
+    m_scale[0][index] = transform.scale.x;
+    m_scale[1][index] = transform.scale.y;
+    m_scale[2][index] = transform.scale.z;
+}
+
+void ven::TransformBatch::compute(const std::span<glm::mat4> models, const std::span<glm::mat4> normals) const
+{
+    if (models.size() < m_size || normals.size() < m_size) {
+        throw std::invalid_argument("TransformBatch: output spans are smaller than the batch");
+    }
+    if (m_size == 0) { return; }
+    const TrsStreams streams{
+        .translation = { m_translation[0].data(), m_translation[1].data(), m_translation[2].data() },
+        .rotation = { m_rotation[0].data(), m_rotation[1].data(), m_rotation[2].data() },
+        .scale = { m_scale[0].data(), m_scale[1].data(), m_scale[2].data() }
+    };
+    float* modelData = &models[0][0][0];
+    float* normalData = &normals[0][0][0];
+
+    std::size_t vectorized = 0;
+    switch (m_level) {
+        case SimdLevel::AVX2:
+            vectorized = m_size - (m_size % 8);
+            computeTrsAvx2(streams, 0, vectorized, modelData, normalData);
+            break;
+        case SimdLevel::SSE4:
+            vectorized = m_size - (m_size % 4);
+            computeTrsSse4(streams, 0, vectorized, modelData, normalData);
+            break;
+        case SimdLevel::SCALAR:
+        default:
+            break;
+    }
+    computeTrs<Scalar>(streams, vectorized, m_size, modelData, normalData);
+}
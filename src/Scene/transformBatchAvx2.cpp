@@ -0,0 +1,59 @@
+// compiled with AVX2 and FMA enabled, only reached when TransformBatch detected them at runtime
+#include "VEngine/Scene/TransformKernel.hpp"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+
+#include <immintrin.h>
+
+namespace {
+
+    struct Avx2 {
+        using Type = __m256;
+        static constexpr std::size_t WIDTH = 8;
+
+        static __m256 set1(const float value) { return _mm256_set1_ps(value); }
+        static __m256 load(const float* ptr) { return _mm256_loadu_ps(ptr); }
+        static __m256 sub(const __m256 lhs, const __m256 rhs) { return _mm256_sub_ps(lhs, rhs); }
+        static __m256 mul(const __m256 lhs, const __m256 rhs) { return _mm256_mul_ps(lhs, rhs); }
+        static __m256 div(const __m256 lhs, const __m256 rhs) { return _mm256_div_ps(lhs, rhs); }
+        static __m256 fmadd(const __m256 a, const __m256 b, const __m256 c) { return _mm256_fmadd_ps(a, b, c); }
+        static __m256 fnmadd(const __m256 a, const __m256 b, const __m256 c) { return _mm256_fnmadd_ps(a, b, c); }
+        static __m256 floor(const __m256 value) { return _mm256_floor_ps(value); }
+        static __m256 equal(const __m256 lhs, const __m256 rhs) { return _mm256_cmp_ps(lhs, rhs, _CMP_EQ_OQ); }
+        static __m256 greater(const __m256 lhs, const __m256 rhs) { return _mm256_cmp_ps(lhs, rhs, _CMP_GT_OQ); }
+        static __m256 select(const __m256 mask, const __m256 ifTrue, const __m256 ifFalse) { return _mm256_blendv_ps(ifFalse, ifTrue, mask); }
+        static void sincos(const __m256 x, __m256& sine, __m256& cosine) { ven::polynomialSincos<Avx2>(x, sine, cosine); }
+        static void storeColumn(float* matrices, const std::size_t column, const __m256 x, const __m256 y, const __m256 z, const __m256 w) {
+            // 4x4 transposes inside each 128 bit half: objects 0-3 end up in the low halves, 4-7 in the high ones
+            const __m256 xy0 = _mm256_unpacklo_ps(x, y);
+            const __m256 xy1 = _mm256_unpackhi_ps(x, y);
+            const __m256 zw0 = _mm256_unpacklo_ps(z, w);
+            const __m256 zw1 = _mm256_unpackhi_ps(z, w);
+            const __m256 c0 = _mm256_shuffle_ps(xy0, zw0, _MM_SHUFFLE(1, 0, 1, 0));
+            const __m256 c1 = _mm256_shuffle_ps(xy0, zw0, _MM_SHUFFLE(3, 2, 3, 2));
+            const __m256 c2 = _mm256_shuffle_ps(xy1, zw1, _MM_SHUFFLE(1, 0, 1, 0));
+            const __m256 c3 = _mm256_shuffle_ps(xy1, zw1, _MM_SHUFFLE(3, 2, 3, 2));
+            float* out = matrices + (column * 4);
+            _mm_storeu_ps(out, _mm256_castps256_ps128(c0));
+            _mm_storeu_ps(out + 16, _mm256_castps256_ps128(c1));
+            _mm_storeu_ps(out + 32, _mm256_castps256_ps128(c2));
+            _mm_storeu_ps(out + 48, _mm256_castps256_ps128(c3));
+            _mm_storeu_ps(out + 64, _mm256_extractf128_ps(c0, 1));
+            _mm_storeu_ps(out + 80, _mm256_extractf128_ps(c1, 1));
+            _mm_storeu_ps(out + 96, _mm256_extractf128_ps(c2, 1));
+            _mm_storeu_ps(out + 112, _mm256_extractf128_ps(c3, 1));
+        }
+    };
+
+} // namespace
+
+void ven::computeTrsAvx2(const TrsStreams& in, const std::size_t begin, const std::size_t end, float* models, float* normals)
+{
+    computeTrs<Avx2>(in, begin, end, models, normals);
+}
+
+#else
+
+void ven::computeTrsAvx2(const TrsStreams& /*in*/, const std::size_t /*begin*/, const std::size_t /*end*/, float* /*models*/, float* /*normals*/) {} // never selected off x86
+
+#endif
@@ -0,0 +1,47 @@
+// compiled with SSE4.1 enabled, only reached when TransformBatch detected it at runtime
+#include "VEngine/Scene/TransformKernel.hpp"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+
+#include <immintrin.h>
+
+namespace {
+
+    struct Sse4 {
+        using Type = __m128;
+        static constexpr std::size_t WIDTH = 4;
+
+        static __m128 set1(const float value) { return _mm_set1_ps(value); }
+        static __m128 load(const float* ptr) { return _mm_loadu_ps(ptr); }
+        static __m128 sub(const __m128 lhs, const __m128 rhs) { return _mm_sub_ps(lhs, rhs); }
+        static __m128 mul(const __m128 lhs, const __m128 rhs) { return _mm_mul_ps(lhs, rhs); }
+        static __m128 div(const __m128 lhs, const __m128 rhs) { return _mm_div_ps(lhs, rhs); }
+        static __m128 fmadd(const __m128 a, const __m128 b, const __m128 c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+        static __m128 fnmadd(const __m128 a, const __m128 b, const __m128 c) { return _mm_sub_ps(c, _mm_mul_ps(a, b)); }
+        static __m128 floor(const __m128 value) { return _mm_floor_ps(value); }
+        static __m128 equal(const __m128 lhs, const __m128 rhs) { return _mm_cmpeq_ps(lhs, rhs); }
+        static __m128 greater(const __m128 lhs, const __m128 rhs) { return _mm_cmpgt_ps(lhs, rhs); }
+        static __m128 select(const __m128 mask, const __m128 ifTrue, const __m128 ifFalse) { return _mm_blendv_ps(ifFalse, ifTrue, mask); }
+        static void sincos(const __m128 x, __m128& sine, __m128& cosine) { ven::polynomialSincos<Sse4>(x, sine, cosine); }
+        static void storeColumn(float* matrices, const std::size_t column, __m128 x, __m128 y, __m128 z, __m128 w) {
+            _MM_TRANSPOSE4_PS(x, y, z, w);
+            float* out = matrices + (column * 4);
+            _mm_storeu_ps(out, x);
+            _mm_storeu_ps(out + 16, y);
+            _mm_storeu_ps(out + 32, z);
+            _mm_storeu_ps(out + 48, w);
+        }
+    };
+
+} // namespace
+
+void ven::computeTrsSse4(const TrsStreams& in, const std::size_t begin, const std::size_t end, float* models, float* normals)
+{
+    computeTrs<Sse4>(in, begin, end, models, normals);
+}
+
+#else
+
+void ven::computeTrsSse4(const TrsStreams& /*in*/, const std::size_t /*begin*/, const std::size_t /*end*/, float* /*models*/, float* /*normals*/) {} // never selected off x86
+
+#endif
@@ -0,0 +1,115 @@
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#include "VEngine/Utils/MappedFile.hpp"
+
+#ifdef _WIN32
+
+ven::MappedFile::MappedFile(const std::string& filepath)
+{
+    m_file = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE) {
+        m_file = nullptr;
+        throw std::runtime_error("failed to open file: " + filepath);
+    }
+    LARGE_INTEGER size{};
+    if (GetFileSizeEx(m_file, &size) == 0) {
+        unmap();
+        throw std::runtime_error("failed to stat file: " + filepath);
+    }
+    m_size = static_cast<std::size_t>(size.QuadPart);
+    if (m_size == 0) { return; } // empty files can't be mapped
+    m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    const void* view = m_mapping != nullptr ? MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (view == nullptr) {
+        unmap();
+        throw std::runtime_error("failed to map file: " + filepath);
+    }
+    m_data = static_cast<const uint8_t*>(view);
+}
+
+void ven::MappedFile::unmap()
+{
+    if (m_data != nullptr) { UnmapViewOfFile(m_data); }
+    if (m_mapping != nullptr) { CloseHandle(m_mapping); }
+    if (m_file != nullptr) { CloseHandle(m_file); }
+    m_data = nullptr;
+    m_mapping = nullptr;
+    m_file = nullptr;
+    m_size = 0;
+}
+
+#else
+
+ven::MappedFile::MappedFile(const std::string& filepath)
+{
+    const int file = open(filepath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (file < 0) {
+        throw std::runtime_error("failed to open file: " + filepath);
+    }
+    struct stat status{};
+    if (fstat(file, &status) != 0) {
+        close(file);
+        throw std::runtime_error("failed to stat file: " + filepath);
+    }
+    m_size = static_cast<std::size_t>(status.st_size);
+    if (m_size > 0) { // empty files can't be mapped
+        void* view = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file, 0);
+        if (view == MAP_FAILED) {
+            close(file);
+            throw std::runtime_error("failed to map file: " + filepath);
+        }
+        madvise(view, m_size, MADV_SEQUENTIAL);
+        m_data = static_cast<const uint8_t*>(view);
+    }
+    // the mapping keeps the file alive
+    close(file);
+}
+
+void ven::MappedFile::unmap()
+{
+    if (m_data != nullptr) { munmap(const_cast<uint8_t*>(m_data), m_size); }
+    m_data = nullptr;
+    m_size = 0;
+}
+
+#endif
+
+ven::MappedFile::~MappedFile()
+{
+    unmap();
+}
+
+ven::MappedFile::MappedFile(MappedFile&& other) noexcept
+    : m_data{std::exchange(other.m_data, nullptr)}, m_size{std::exchange(other.m_size, 0)}
+#ifdef _WIN32
+    , m_file{std::exchange(other.m_file, nullptr)}, m_mapping{std::exchange(other.m_mapping, nullptr)}
+#endif
+{
+}
+
+ven::MappedFile& ven::MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this != &other) {
+        unmap();
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+#ifdef _WIN32
+        m_file = std::exchange(other.m_file, nullptr);
+        m_mapping = std::exchange(other.m_mapping, nullptr);
+#endif
+    }
+    return *this;
+}
@@ -0,0 +1,39 @@
+#include <array>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    #include <immintrin.h>
+    #include <intrin.h>
+#endif
+
+#include "VEngine/Utils/Simd.hpp"
+
+namespace {
+
+    ven::SimdLevel detectLevel()
+    {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2") != 0 && __builtin_cpu_supports("fma") != 0) { return ven::SimdLevel::AVX2; }
+        if (__builtin_cpu_supports("sse4.1") != 0) { return ven::SimdLevel::SSE4; }
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        std::array<int, 4> info{};
+        __cpuid(info.data(), 1);
+        const bool sse41 = (info[2] & (1 << 19)) != 0;
+        const bool fma = (info[2] & (1 << 12)) != 0;
+        // AVX state must also be enabled by the OS
+        const bool avx = (info[2] & (1 << 28)) != 0 && (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+        __cpuidex(info.data(), 7, 0);
+        const bool avx2 = (info[1] & (1 << 5)) != 0;
+        if (avx && avx2 && fma) { return ven::SimdLevel::AVX2; }
+        if (sse41) { return ven::SimdLevel::SSE4; }
+#endif
+        return ven::SimdLevel::SCALAR;
+    }
+
+} // namespace
+
+ven::SimdLevel ven::getSupportedSimdLevel()
+{
+    static const SimdLevel level = detectLevel();
+    return level;
+}
@@ -0,0 +1,87 @@
+#include <algorithm>
+#include <atomic>
+#include <latch>
+
+#include "VEngine/Utils/ThreadPool.hpp"
+
+ven::ThreadPool::ThreadPool(const unsigned int workerCount)
+{
+    m_workers.reserve(workerCount);
+    for (unsigned int i = 0; i < workerCount; i++) {
+        m_workers.emplace_back([this] { workerLoop(); });
+    }
+}
+
+ven::ThreadPool::~ThreadPool()
+{
+    {
+        std::scoped_lock lock(m_mutex);
+        m_stop = true;
+    }
+    m_condition.notify_all();
+    for (std::thread& worker : m_workers) {
+        worker.join();
+    }
+}
+
+void ven::ThreadPool::submit(std::function<void()> task)
+{
+    {
+        std::scoped_lock lock(m_mutex);
+        m_tasks.push(std::move(task));
+    }
+    m_condition.notify_one();
+}
+
+void ven::ThreadPool::workerLoop()
+{
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock lock(m_mutex);
+            m_condition.wait(lock, [this] { return m_stop || !m_tasks.empty(); });
+            if (m_stop && m_tasks.empty()) { return; }
+            task = std::move(m_tasks.front());
+            m_tasks.pop();
+            m_runningTasks++;
+        }
+        task();
+        {
+            std::scoped_lock lock(m_mutex);
+            m_runningTasks--;
+        }
+        m_idleCondition.notify_all();
+    }
+}
+
+void ven::ThreadPool::waitIdle()
+{
+    std::unique_lock lock(m_mutex);
+    m_idleCondition.wait(lock, [this] { return m_tasks.empty() && m_runningTasks == 0; });
+}
+
+void ven::ThreadPool::parallelFor(const std::size_t count, const std::function<void(std::size_t begin, std::size_t end)>& task, const std::size_t grainSize)
+{
+    if (count == 0) { return; }
+    const std::size_t grain = std::max<std::size_t>(grainSize, 1);
+    const std::size_t chunkCount = (count + grain - 1) / grain;
+    const std::size_t helperCount = std::min<std::size_t>(m_workers.size(), chunkCount - 1);
+    if (helperCount == 0) {
+        task(0, count);
+        return;
+    }
+
+    // chunks are claimed dynamically so uneven work balances itself
+    std::atomic<std::size_t> nextChunk{0};
+    std::latch done(static_cast<std::ptrdiff_t>(helperCount));
+    const auto run = [&] {
+        for (std::size_t chunk = nextChunk++; chunk < chunkCount; chunk = nextChunk++) {
+            task(chunk * grain, std::min(count, (chunk + 1) * grain));
+        }
+    };
+    for (std::size_t i = 0; i < helperCount; i++) {
+        submit([&] { run(); done.count_down(); });
+    }
+    run();
+    done.wait();
+}
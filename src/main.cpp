@@ -8,7 +8,12 @@ int main(const int argc, char *argv[], char *envp[])
 {
     try {
         Logger::getInstance();
-        Engine(Parser(argc, argv, envp).getConfig()).run();
+        const Config config = Parser(argc, argv, envp).getConfig();
+        if (config.bakePvs) {
+            Engine::bakePvs(config);
+            return EXIT_SUCCESS;
+        }
+        Engine(config).run();
     } catch (const ParserException &e) {
         return EXIT_SUCCESS;
     } catch (const std::exception &e) {
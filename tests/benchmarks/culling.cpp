@@ -0,0 +1,46 @@
+#include <iostream>
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include "VEngine/Scene/Camera.hpp"
+#include "VEngine/Scene/Culler.hpp"
+
+namespace {
+
+    constexpr float VIEWPORT_HEIGHT = 1080.F;
+
+    ven::Camera makeCamera()
+    {
+        ven::Camera camera(ven::DEFAULT_FOV, ven::DEFAULT_NEAR, ven::DEFAULT_FAR, ven::DEFAULT_MOVE_SPEED, ven::DEFAULT_LOOK_SPEED);
+        camera.setViewDirection({0.F, 0.F, 0.F}, {0.F, 0.F, 1.F});
+        camera.setPerspectiveProjection(16.F / 9.F);
+        return camera;
+    }
+
+} // namespace
+
+TEST(FrustumCuller, cull100k)
+{
+    static constexpr std::size_t INSTANCE_COUNT = 100000;
+    const ven::Camera camera = makeCamera();
+    ven::FrustumCuller culler;
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> position(-100.F, 100.F);
+    std::uniform_real_distribution<float> radius(0.005F, 2.F);
+    std::vector<ven::BoundingSphere> spheres(INSTANCE_COUNT);
+
+    for (auto& sphere : spheres) {
+        sphere = { .center = {position(rng), position(rng), position(rng)}, .radius = radius(rng) };
+    }
+    culler.begin(camera.getProjection(), camera.getView(), VIEWPORT_HEIGHT);
+    for (const auto& sphere : spheres) {
+        culler.add(sphere);
+    }
+    culler.cull();
+
+    const ven::CullingStats& stats = culler.getStats();
+    std::cout << "[ BENCH    ] " << stats.tested << " instances: " << stats.frustumCulled << " frustum culled, " << stats.smallCulled << " small culled, " << stats.submitted << " submitted in " << stats.timeMS << "ms\n";
+    EXPECT_EQ(stats.tested, INSTANCE_COUNT);
+    EXPECT_EQ(stats.frustumCulled + stats.smallCulled + stats.submitted, INSTANCE_COUNT);
+}
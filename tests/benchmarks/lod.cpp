@@ -0,0 +1,63 @@
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <numbers>
+
+#include <gtest/gtest.h>
+
+#include "VEngine/Scene/MeshSimplifier.hpp"
+
+namespace {
+
+    struct TestMesh {
+        std::vector<glm::vec3> positions;
+        std::vector<uint32_t> indices;
+    };
+
+    // closed sphere without seams: the poles are single vertices and the rings wrap around
+    TestMesh makeSphere(const uint32_t rings, const uint32_t segments, const float radius)
+    {
+        TestMesh mesh;
+        mesh.positions.emplace_back(0.F, radius, 0.F);
+        for (uint32_t ring = 1; ring < rings; ring++) {
+            const float theta = std::numbers::pi_v<float> * static_cast<float>(ring) / static_cast<float>(rings);
+            for (uint32_t segment = 0; segment < segments; segment++) {
+                const float phi = 2.F * std::numbers::pi_v<float> * static_cast<float>(segment) / static_cast<float>(segments);
+                mesh.positions.emplace_back(radius * std::sin(theta) * std::cos(phi), radius * std::cos(theta), radius * std::sin(theta) * std::sin(phi));
+            }
+        }
+        mesh.positions.emplace_back(0.F, -radius, 0.F);
+        const auto ringVertex = [&](const uint32_t ring, const uint32_t segment) { return 1 + ((ring - 1) * segments) + (segment % segments); };
+        const auto south = static_cast<uint32_t>(mesh.positions.size() - 1);
+        for (uint32_t segment = 0; segment < segments; segment++) {
+            mesh.indices.insert(mesh.indices.end(), { 0, ringVertex(1, segment + 1), ringVertex(1, segment) });
+            mesh.indices.insert(mesh.indices.end(), { south, ringVertex(rings - 1, segment), ringVertex(rings - 1, segment + 1) });
+            for (uint32_t ring = 1; ring + 1 < rings; ring++) {
+                const uint32_t a = ringVertex(ring, segment);
+                const uint32_t b = ringVertex(ring, segment + 1);
+                const uint32_t c = ringVertex(ring + 1, segment);
+                const uint32_t d = ringVertex(ring + 1, segment + 1);
+                mesh.indices.insert(mesh.indices.end(), { a, b, c, b, d, c });
+            }
+        }
+        return mesh;
+    }
+
+} // namespace
+
+TEST(MeshSimplifier, buildChain)
+{
+    const TestMesh sphere = makeSphere(128, 256, 1.F);
+    std::vector<uint32_t> indices = sphere.indices;
+    const std::array<ven::PvsMeshRange, 1> meshes{{ { .firstIndex = 0, .indexCount = static_cast<uint32_t>(indices.size()) } }};
+    const auto start = std::chrono::high_resolution_clock::now();
+    const ven::LodChain chain = ven::MeshSimplifier::buildChain(sphere.positions, indices, meshes);
+    const double elapsed = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+    std::cout << "[ BENCH    ] " << sphere.indices.size() / 3 << " triangles, " << chain.levels.size() << " levels in " << elapsed << "ms:";
+    for (const ven::MeshLod& level : chain.levels) {
+        std::cout << ' ' << level.indexCount / 3 << " (" << level.error << ')';
+    }
+    std::cout << '\n';
+    EXPECT_GE(chain.levels.size(), 2U);
+}
@@ -0,0 +1,66 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <numbers>
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include "VEngine/Scene/MeshOptimizer.hpp"
+
+namespace {
+
+    struct TestMesh {
+        std::vector<glm::vec3> positions;
+        std::vector<uint32_t> indices;
+    };
+
+    // outward facing sphere
+    TestMesh makeSphere(const uint32_t rings, const uint32_t segments, const float radius)
+    {
+        TestMesh mesh;
+        for (uint32_t ring = 0; ring <= rings; ring++) {
+            const float theta = std::numbers::pi_v<float> * static_cast<float>(ring) / static_cast<float>(rings);
+            for (uint32_t segment = 0; segment <= segments; segment++) {
+                const float phi = 2.F * std::numbers::pi_v<float> * static_cast<float>(segment) / static_cast<float>(segments);
+                mesh.positions.emplace_back(radius * std::sin(theta) * std::cos(phi), radius * std::cos(theta), radius * std::sin(theta) * std::sin(phi));
+            }
+        }
+        for (uint32_t ring = 0; ring < rings; ring++) {
+            for (uint32_t segment = 0; segment < segments; segment++) {
+                const uint32_t a = (ring * (segments + 1)) + segment;
+                const uint32_t b = a + segments + 1;
+                mesh.indices.insert(mesh.indices.end(), { a, a + 1, b, a + 1, b + 1, b });
+            }
+        }
+        return mesh;
+    }
+
+    // fixed seed Fisher-Yates, the same order on every platform
+    void shuffleTriangles(std::vector<uint32_t>& indices, const uint32_t seed)
+    {
+        std::mt19937 random(seed);
+        for (std::size_t i = (indices.size() / 3) - 1; i > 0; i--) {
+            const std::size_t j = random() % (i + 1);
+            std::swap_ranges(indices.begin() + static_cast<std::ptrdiff_t>(i * 3), indices.begin() + static_cast<std::ptrdiff_t>((i * 3) + 3), indices.begin() + static_cast<std::ptrdiff_t>(j * 3));
+        }
+    }
+
+} // namespace
+
+TEST(MeshOptimizer, optimize)
+{
+    TestMesh sphere = makeSphere(128, 256, 1.F);
+    shuffleTriangles(sphere.indices, 1);
+    const ven::VertexCacheStats before = ven::MeshOptimizer::analyzeVertexCache(sphere.indices);
+    const auto start = std::chrono::high_resolution_clock::now();
+    ven::MeshOptimizer::optimizeVertexCache(sphere.indices);
+    ven::MeshOptimizer::optimizeOverdraw(sphere.indices, sphere.positions);
+    const std::vector<uint32_t> remap = ven::MeshOptimizer::optimizeVertexFetch(sphere.indices, sphere.positions.size());
+    const double elapsed = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    const ven::VertexCacheStats after = ven::MeshOptimizer::analyzeVertexCache(sphere.indices);
+
+    std::cout << "[ BENCH    ] " << sphere.indices.size() / 3 << " triangles in " << elapsed << "ms, ACMR " << before.acmr << " -> " << after.acmr << ", ATVR " << before.atvr << " -> " << after.atvr << '\n';
+    EXPECT_LT(after.acmr, before.acmr);
+}
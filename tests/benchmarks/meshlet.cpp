@@ -0,0 +1,57 @@
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <numbers>
+
+#include <gtest/gtest.h>
+
+#include "VEngine/Scene/Meshlet.hpp"
+
+namespace {
+
+    struct TestMesh {
+        std::vector<glm::vec3> positions;
+        std::vector<uint32_t> indices;
+    };
+
+    // outward facing (counter clockwise seen from outside) sphere
+    TestMesh makeSphere(const uint32_t rings, const uint32_t segments, const float radius)
+    {
+        TestMesh mesh;
+        for (uint32_t ring = 0; ring <= rings; ring++) {
+            const float theta = std::numbers::pi_v<float> * static_cast<float>(ring) / static_cast<float>(rings);
+            for (uint32_t segment = 0; segment <= segments; segment++) {
+                const float phi = 2.F * std::numbers::pi_v<float> * static_cast<float>(segment) / static_cast<float>(segments);
+                mesh.positions.emplace_back(radius * std::sin(theta) * std::cos(phi), radius * std::cos(theta), radius * std::sin(theta) * std::sin(phi));
+            }
+        }
+        for (uint32_t ring = 0; ring < rings; ring++) {
+            for (uint32_t segment = 0; segment < segments; segment++) {
+                const uint32_t a = (ring * (segments + 1)) + segment;
+                const uint32_t b = a + segments + 1;
+                mesh.indices.insert(mesh.indices.end(), { a, a + 1, b, a + 1, b + 1, b });
+            }
+        }
+        return mesh;
+    }
+
+} // namespace
+
+TEST(MeshletBuilder, build)
+{
+    const TestMesh sphere = makeSphere(128, 256, 1.F);
+    ven::MeshletData data;
+    const auto start = std::chrono::high_resolution_clock::now();
+    const uint32_t count = ven::MeshletBuilder::build(sphere.positions, sphere.indices, data);
+    const double elapsed = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+    double triangles = 0.0;
+    double vertices = 0.0;
+    for (const ven::Meshlet& meshlet : data.meshlets) {
+        triangles += meshlet.triangleCount;
+        vertices += meshlet.vertexCount;
+    }
+    std::cout << "[ BENCH    ] " << sphere.indices.size() / 3 << " triangles, " << count << " meshlets in " << elapsed << "ms, "
+              << triangles / count << " triangles and " << vertices / count << " vertices per meshlet\n";
+    EXPECT_GT(count, 0U);
+}
@@ -0,0 +1,39 @@
+#include <chrono>
+#include <iostream>
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include "VEngine/Scene/Entities/Object.hpp"
+
+TEST(ObjectStore, millionCreateDestroy)
+{
+    constexpr uint32_t CREATED = 1000000;
+    constexpr uint32_t MAX_LIVE = 1000;
+    ven::SceneGraph graph;
+    ven::SpatialIndex index;
+    ven::ObjectStore objects(graph, index);
+    std::mt19937 rng(5);
+    double updateMS = 0.0;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < CREATED; i++) {
+        if (objects.size() == MAX_LIVE) {
+            static_cast<void>(objects.erase(objects.handles()[std::uniform_int_distribution<uint32_t>(0, MAX_LIVE - 1)(rng)]));
+        }
+        const auto position = glm::vec3(static_cast<float>(i % 100));
+        const uint32_t parent = i % 10 == 0 && !objects.empty() ? objects.nodes()[0] : ven::SceneGraph::NONE;
+        static_cast<void>(objects.create(nullptr, nullptr, "object", { .translation = position, .scale = glm::vec3(1.F), .rotation = glm::vec3(0.F) }, false, parent));
+        if (i % 10000 == 0) {
+            const auto updateStart = std::chrono::steady_clock::now();
+            static_cast<void>(graph.update());
+            static_cast<void>(objects.updateWorld());
+            updateMS += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - updateStart).count();
+        }
+    }
+    const double totalMS = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "[ BENCH    ] " << CREATED << " objects created with at most " << MAX_LIVE << " alive: " << totalMS << "ms, " << updateMS << "ms of it in " << CREATED / 10000 << " updates\n";
+    EXPECT_EQ(objects.size(), MAX_LIVE);
+    EXPECT_EQ(graph.size(), MAX_LIVE);
+}
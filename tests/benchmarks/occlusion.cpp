@@ -0,0 +1,75 @@
+#include <iostream>
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include "VEngine/Scene/Camera.hpp"
+#include "VEngine/Scene/OcclusionCuller.hpp"
+
+namespace {
+
+    ven::Camera makeCamera()
+    {
+        ven::Camera camera(ven::DEFAULT_FOV, ven::DEFAULT_NEAR, ven::DEFAULT_FAR, ven::DEFAULT_MOVE_SPEED, ven::DEFAULT_LOOK_SPEED);
+        camera.setViewDirection({0.F, 0.F, 0.F}, {0.F, 0.F, 1.F});
+        camera.setPerspectiveProjection(16.F / 9.F);
+        return camera;
+    }
+
+    // two triangles facing the camera at depth z
+    std::vector<glm::vec3> makeWall(const float halfSize, const float z)
+    {
+        return {
+            {-halfSize, -halfSize, z}, {halfSize, -halfSize, z}, {halfSize, halfSize, z},
+            {-halfSize, -halfSize, z}, {halfSize, halfSize, z}, {-halfSize, halfSize, z}
+        };
+    }
+
+    ven::AABB makeBox(const glm::vec3& center, const float halfSize)
+    {
+        return { .min = center - glm::vec3(halfSize), .max = center + glm::vec3(halfSize) };
+    }
+
+} // namespace
+
+TEST(OcclusionCuller, rasterizeAndTest)
+{
+    static constexpr std::size_t OCCLUDER_COUNT = 200;
+    static constexpr std::size_t BOX_COUNT = 20000;
+    const ven::Camera camera = makeCamera();
+    ven::ThreadPool pool;
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> position(-30.F, 30.F);
+    std::uniform_real_distribution<float> depth(2.F, 90.F);
+    std::uniform_real_distribution<float> size(0.1F, 4.F);
+    std::vector<std::pair<std::vector<glm::vec3>, glm::mat4>> occluders(OCCLUDER_COUNT);
+    std::vector<ven::AABB> boxes(BOX_COUNT);
+
+    for (auto& [wall, model] : occluders) {
+        wall = makeWall(size(rng), depth(rng));
+        model = glm::translate(glm::mat4(1.F), {position(rng), position(rng), 0.F});
+    }
+    for (ven::AABB& box : boxes) {
+        box = makeBox({position(rng), position(rng), depth(rng)}, size(rng) * 0.25F);
+    }
+    for (const ven::SimdLevel level : {ven::SimdLevel::SCALAR, ven::SimdLevel::AVX2}) {
+        for (ven::ThreadPool* threadPool : {static_cast<ven::ThreadPool*>(nullptr), &pool}) {
+            ven::OcclusionCuller culler(ven::DEFAULT_OCCLUSION_WIDTH, ven::DEFAULT_OCCLUSION_HEIGHT, threadPool);
+            culler.setLevel(level);
+            if (culler.getLevel() != level) {
+                continue;
+            }
+            culler.begin(camera.getProjection() * camera.getView());
+            for (const auto& [wall, model] : occluders) {
+                culler.addOccluder(wall, model);
+            }
+            for (const ven::AABB& box : boxes) {
+                culler.add(box);
+            }
+            culler.cull();
+            const ven::OcclusionStats& stats = culler.getStats();
+            std::cout << "[ BENCH    ] " << (level == ven::SimdLevel::AVX2 ? "AVX2" : "scalar") << ", " << (threadPool != nullptr ? pool.getWorkerCount() : 0) << " workers: " << stats.occluderTriangles << " occluder triangles rasterized in " << stats.rasterMS << "ms, " << stats.occluded << "/" << stats.tested << " boxes occluded in " << stats.testMS << "ms\n";
+            EXPECT_EQ(stats.tested, BOX_COUNT);
+        }
+    }
+}
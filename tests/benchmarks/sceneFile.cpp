@@ -0,0 +1,59 @@
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+
+#include <gtest/gtest.h>
+
+#include "VEngine/Scene/SceneFile.hpp"
+
+namespace {
+
+    ven::SceneFile makeScene(const uint32_t objectCount, const uint32_t lightCount)
+    {
+        ven::SceneFile scene;
+        const uint32_t model = scene.addAsset(ven::AssetKind::MODEL, "assets/models/cube.obj", 0x0123456789abcdefULL);
+        const uint32_t texture = scene.addAsset(ven::AssetKind::TEXTURE, "assets/textures/with space.png", 42);
+        scene.objects.reserve(objectCount);
+        for (uint32_t i = 0; i < objectCount; i++) {
+            const auto value = static_cast<float>(i);
+            scene.objects.push_back({
+                .transform = { .translation = {value, -value, 0.1F * value}, .scale = {1.F, 2.F, 3.F}, .rotation = {0.001F * value, 0.F, -1.F / 3.F} },
+                .parent = i == 0 ? ven::SceneFile::NONE : (i - 1) / 4,
+                .model = i % 3 == 0 ? ven::SceneFile::NONE : model,
+                .diffuseMap = i % 2 == 0 ? texture : ven::SceneFile::NONE,
+                .occluder = i % 5 == 0,
+                .name = "object \"" + std::to_string(i) + "\""
+            });
+        }
+        for (uint32_t i = 0; i < lightCount; i++) {
+            scene.lights.push_back({
+                .transform = { .translation = {1.F, 2.F, 3.F}, .scale = {0.1F, 0.F, 0.F}, .rotation = {} },
+                .color = {1.F, 0.5F, 0.25F, 0.2F},
+                .shininess = 32.F,
+                .parent = objectCount > 0 ? i % objectCount : ven::SceneFile::NONE,
+                .flags = static_cast<uint8_t>(i % 4),
+                .name = "light " + std::to_string(i)
+            });
+        }
+        return scene;
+    }
+
+    std::string tempPath(const std::string& name) { return (std::filesystem::temp_directory_path() / name).string(); }
+
+} // namespace
+
+TEST(SceneFile, saveAndLoad)
+{
+    const ven::SceneFile scene = makeScene(100000, 1000);
+    const std::string path = tempPath("vengine_bench" + std::string(ven::SCENE_EXTENSION));
+    auto start = std::chrono::steady_clock::now();
+    scene.save(path);
+    const double saveMS = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    ven::SceneFile loaded;
+    start = std::chrono::steady_clock::now();
+    loaded.load(path);
+    const double loadMS = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    EXPECT_EQ(loaded.objects.size(), 100000U);
+    std::cout << "[ BENCH    ] 100000 objects, 1000 lights, " << std::filesystem::file_size(path) / 1024 << "KiB: save " << saveMS << "ms, load " << loadMS << "ms\n";
+    std::filesystem::remove(path);
+}
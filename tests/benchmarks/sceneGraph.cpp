@@ -0,0 +1,58 @@
+#include <chrono>
+#include <iostream>
+
+#include <gtest/gtest.h>
+
+#include "VEngine/Scene/SceneGraph.hpp"
+
+namespace {
+
+    glm::mat4 translation(const glm::vec3& offset) { return glm::translate(glm::mat4(1.F), offset); }
+
+    // tree with FANOUT children per node, node i is the child of (i - 1) / FANOUT
+    constexpr uint32_t FANOUT = 8;
+
+    void buildTree(ven::SceneGraph& graph, const uint32_t count)
+    {
+        graph.add(glm::mat4(1.F));
+        for (uint32_t i = 1; i < count; i++) {
+            graph.add(ven::Transform3D{ .translation = {1.F, 0.F, 0.F}, .scale = {1.F, 1.F, 1.F}, .rotation = {0.F, 0.01F, 0.F} }, (i - 1) / FANOUT);
+        }
+    }
+
+    double updateMS(ven::SceneGraph& graph)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        static_cast<void>(graph.update());
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+} // namespace
+
+TEST(SceneGraph, update)
+{
+    ven::ThreadPool pool;
+    for (const uint32_t count : {10000U, 100000U, 1000000U}) {
+        ven::SceneGraph graph(&pool);
+        buildTree(graph, count);
+        const double fullMS = updateMS(graph);
+        const double idleMS = updateMS(graph);
+        // move one node of the second level, only its subtree is propagated
+        graph.setLocal(1, translation({2.F, 0.F, 0.F}));
+        const double subtreeMS = updateMS(graph);
+        graph.setLocal(0, translation({0.F, 1.F, 0.F}));
+        graph.setThreadPool(nullptr);
+        const double serialMS = updateMS(graph);
+        graph.setLocal(0, translation({0.F, 2.F, 0.F}));
+        graph.setThreadPool(&pool);
+        const double parallelMS = updateMS(graph);
+        EXPECT_EQ(graph.size(), count);
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32_t node = 0; node < count; node++) {
+            graph.remove(node);
+        }
+        const double removeMS = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "[ BENCH    ] " << count << " nodes, " << graph.getLevelCount() << " levels: first update " << fullMS << "ms, idle " << idleMS << "ms, one subtree " << subtreeMS << "ms, full serial " << serialMS << "ms, full parallel " << parallelMS << "ms, remove all " << removeMS << "ms (" << pool.getWorkerCount() << " workers)\n";
+        EXPECT_EQ(graph.size(), 0U);
+    }
+}
@@ -0,0 +1,101 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include "VEngine/Scene/Camera.hpp"
+#include "VEngine/Scene/SpatialIndex.hpp"
+
+namespace {
+
+    struct Scene {
+        std::vector<ven::AABB> boxes;
+        ven::SpatialIndex index{0.F};
+        std::vector<uint32_t> proxies;
+    };
+
+    void fill(Scene& scene, const uint32_t count, const float worldSize)
+    {
+        std::mt19937 rng(42);
+        std::uniform_real_distribution position(-worldSize, worldSize);
+        std::uniform_real_distribution size(0.1F, 2.F);
+        for (uint32_t i = 0; i < count; i++) {
+            const glm::vec3 min{position(rng), position(rng), position(rng)};
+            scene.boxes.push_back({ .min = min, .max = min + glm::vec3(size(rng), size(rng), size(rng)) });
+            scene.proxies.push_back(scene.index.insert(scene.boxes.back(), ven::Handle{ .index = i, .generation = 0 }));
+        }
+    }
+
+    bool sphereOverlaps(const ven::BoundingSphere& sphere, const ven::AABB& box)
+    {
+        const glm::vec3 delta = glm::clamp(sphere.center, box.min, box.max) - sphere.center;
+        return dot(delta, delta) <= sphere.radius * sphere.radius;
+    }
+
+    ven::Frustum makeFrustum(const glm::vec3& position, const glm::vec3& direction)
+    {
+        ven::Camera camera(ven::DEFAULT_FOV, ven::DEFAULT_NEAR, ven::DEFAULT_FAR, ven::DEFAULT_MOVE_SPEED, ven::DEFAULT_LOOK_SPEED);
+        camera.setViewDirection(position, direction);
+        camera.setPerspectiveProjection(16.F / 9.F);
+        return ven::Frustum(camera.getProjection() * camera.getView());
+    }
+
+    template<typename Func>
+    double timeMS(Func&& func)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        func();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+} // namespace
+
+TEST(SpatialIndex, treeAgainstBruteForce)
+{
+    constexpr uint32_t queryCount = 100;
+    for (const uint32_t count : {1000U, 10000U, 100000U}) {
+        Scene scene;
+        const double buildMS = timeMS([&] { fill(scene, count, 500.F); });
+        std::mt19937 rng(3);
+        std::uniform_real_distribution position(-500.F, 500.F);
+        std::vector<ven::BoundingSphere> spheres;
+        std::vector<ven::Ray> rays;
+        for (uint32_t i = 0; i < queryCount; i++) {
+            spheres.push_back({ .center = {position(rng), position(rng), position(rng)}, .radius = 20.F });
+            rays.push_back({ .origin = spheres.back().center, .direction = normalize(glm::vec3(position(rng), position(rng), position(rng))) });
+        }
+        const ven::Frustum frustum = makeFrustum({0.F, 0.F, -600.F}, {0.F, 0.F, 1.F});
+
+        std::vector<ven::Handle> results;
+        std::size_t treeFound = 0;
+        std::size_t bruteFound = 0;
+        const double treeSphereMS = timeMS([&] {
+            for (const ven::BoundingSphere& sphere : spheres) {
+                results.clear();
+                scene.index.query(sphere, results);
+                treeFound += results.size();
+            }
+        });
+        const double bruteSphereMS = timeMS([&] {
+            for (const ven::BoundingSphere& sphere : spheres) {
+                bruteFound += static_cast<std::size_t>(std::ranges::count_if(scene.boxes, [&sphere](const ven::AABB& box) { return sphereOverlaps(sphere, box); }));
+            }
+        });
+        EXPECT_EQ(treeFound, bruteFound);
+
+        std::size_t treeFrustum = 0;
+        std::size_t bruteFrustum = 0;
+        const double treeFrustumMS = timeMS([&] { results.clear(); scene.index.query(frustum, results); treeFrustum = results.size(); });
+        const double bruteFrustumMS = timeMS([&] { bruteFrustum = static_cast<std::size_t>(std::ranges::count_if(scene.boxes, [&frustum](const ven::AABB& box) { return frustum.intersects(box); })); });
+        EXPECT_EQ(treeFrustum, bruteFrustum);
+
+        std::vector<ven::RayHit> hits(rays.size());
+        const double treeRayMS = timeMS([&] { scene.index.raycast(rays, hits); });
+
+        std::cout << "[ BENCH    ] " << count << " boxes, height " << scene.index.getHeight() << ", area ratio " << scene.index.getAreaRatio() << ": build " << buildMS << "ms, "
+            << queryCount << " spheres tree " << treeSphereMS << "ms / brute force " << bruteSphereMS << "ms, frustum tree " << treeFrustumMS << "ms / brute force " << bruteFrustumMS << "ms, "
+            << queryCount << " rays tree " << treeRayMS << "ms\n";
+    }
+}
@@ -0,0 +1,80 @@
+#include <chrono>
+#include <iostream>
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include "VEngine/Scene/TransformBatch.hpp"
+
+namespace {
+
+    std::vector<ven::Transform3D> randomTransforms(const std::size_t count)
+    {
+        std::mt19937 rng(11);
+        std::uniform_real_distribution position(-100.F, 100.F);
+        std::uniform_real_distribution angle(-10.F, 10.F);
+        std::uniform_real_distribution scale(0.1F, 4.F);
+        std::vector<ven::Transform3D> transforms(count);
+        for (ven::Transform3D& transform : transforms) {
+            transform.translation = {position(rng), position(rng), position(rng)};
+            transform.rotation = {angle(rng), angle(rng), angle(rng)};
+            transform.scale = {scale(rng), scale(rng), scale(rng)};
+        }
+        return transforms;
+    }
+
+    std::vector<ven::SimdLevel> supportedLevels()
+    {
+        std::vector<ven::SimdLevel> levels;
+        for (const ven::SimdLevel level : {ven::SimdLevel::SCALAR, ven::SimdLevel::SSE4, ven::SimdLevel::AVX2}) {
+            if (level <= ven::TransformBatch::getSupportedLevel()) { levels.push_back(level); }
+        }
+        return levels;
+    }
+
+    const char* levelName(const ven::SimdLevel level)
+    {
+        switch (level) {
+            case ven::SimdLevel::AVX2: return "AVX2";
+            case ven::SimdLevel::SSE4: return "SSE4";
+            case ven::SimdLevel::SCALAR:
+            default: return "scalar";
+        }
+    }
+
+    template<typename Function>
+    double timeMS(const Function& function)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        function();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+} // namespace
+
+TEST(TransformBatch, compute)
+{
+    for (const std::size_t count : {1000U, 100000U}) {
+        const std::vector<ven::Transform3D> transforms = randomTransforms(count);
+        ven::TransformBatch batch;
+        batch.resize(count);
+        for (std::size_t i = 0; i < count; i++) {
+            batch.set(i, transforms[i]);
+        }
+        std::vector<glm::mat4> models(count);
+        std::vector<glm::mat4> normals(count);
+
+        const double referenceMS = timeMS([&] {
+            for (std::size_t i = 0; i < count; i++) {
+                models[i] = transforms[i].transformMatrix();
+                normals[i] = glm::mat4(transforms[i].normalMatrix());
+            }
+        });
+        std::cout << "[ BENCH    ] " << count << " transforms: Transform3D " << referenceMS << "ms";
+        for (const ven::SimdLevel level : supportedLevels()) {
+            batch.setLevel(level);
+            std::cout << ", " << levelName(level) << " " << timeMS([&] { batch.compute(models, normals); }) << "ms";
+        }
+        std::cout << '\n';
+    }
+}
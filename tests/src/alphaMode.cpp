@@ -0,0 +1,56 @@
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "VEngine/Gfx/AlphaMode.hpp"
+
+namespace {
+
+    constexpr uint32_t SIZE = 64;
+
+    // SIZE x SIZE RGBA8 texels, the alpha given per texel
+    template<typename F>
+    std::vector<uint8_t> makeTexture(F alpha)
+    {
+        std::vector<uint8_t> rgba;
+        for (uint32_t y = 0; y < SIZE; y++) {
+            for (uint32_t x = 0; x < SIZE; x++) {
+                rgba.insert(rgba.end(), {200, 100, 50, alpha(x, y)});
+            }
+        }
+        return rgba;
+    }
+
+} // namespace
+
+TEST(AlphaMode, opaque)
+{
+    EXPECT_EQ(ven::classifyAlpha(makeTexture([](uint32_t, uint32_t) -> uint8_t { return 255; })), ven::ALPHA_OPAQUE);
+    // compression noise near the top stays opaque
+    EXPECT_EQ(ven::classifyAlpha(makeTexture([](const uint32_t x, uint32_t) -> uint8_t { return x % 2 == 0 ? 255 : ven::ALPHA_OPAQUE_MIN; })), ven::ALPHA_OPAQUE);
+    EXPECT_EQ(ven::classifyAlpha({}), ven::ALPHA_OPAQUE);
+}
+
+TEST(AlphaMode, cutout)
+{
+    // a leaf: a disc with a one texel filtered rim, holes around it
+    const auto leaf = [](const uint32_t x, const uint32_t y) -> uint8_t {
+        const int dx = static_cast<int>(x) - static_cast<int>(SIZE / 2);
+        const int dy = static_cast<int>(y) - static_cast<int>(SIZE / 2);
+        const int distance = (dx * dx) + (dy * dy);
+        if (distance < 20 * 20) { return 255; }
+        return distance < 21 * 21 ? 128 : 0;
+    };
+    EXPECT_EQ(ven::classifyAlpha(makeTexture(leaf)), ven::ALPHA_CUTOUT);
+    EXPECT_EQ(ven::classifyAlpha(makeTexture([](const uint32_t x, uint32_t) -> uint8_t { return x < SIZE / 2 ? 255 : 0; })), ven::ALPHA_CUTOUT);
+}
+
+TEST(AlphaMode, blend)
+{
+    // glass: uniform partial coverage
+    EXPECT_EQ(ven::classifyAlpha(makeTexture([](uint32_t, uint32_t) -> uint8_t { return 96; })), ven::ALPHA_BLEND);
+    // smoke: a gradient down to nothing
+    EXPECT_EQ(ven::classifyAlpha(makeTexture([](const uint32_t x, uint32_t) -> uint8_t { return static_cast<uint8_t>(x * 255 / (SIZE - 1)); })), ven::ALPHA_BLEND);
+    // an opaque frame around a tinted window
+    EXPECT_EQ(ven::classifyAlpha(makeTexture([](const uint32_t x, const uint32_t y) -> uint8_t { return x > 8 && x < SIZE - 8 && y > 8 && y < SIZE - 8 ? 160 : 255; })), ven::ALPHA_BLEND);
+}
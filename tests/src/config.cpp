@@ -51,3 +51,16 @@ TEST(FUNCTION_MAP_OPT_LONG, near)
     ven::FUNCTION_MAP_OPT_LONG.at("near")(conf, "55");
     EXPECT_EQ(conf.camera.near, 55.0F);
 }
+
+TEST(FUNCTION_MAP_OPT_LONG, bakePvs)
+{
+    ven::FUNCTION_MAP_OPT_LONG.at("bake-pvs")(conf, "");
+    EXPECT_TRUE(conf.bakePvs);
+}
+
+TEST(FUNCTION_MAP_OPT_LONG, scene)
+{
+    ven::FUNCTION_MAP_OPT_LONG.at("scene")(conf, "assets/scenes/test.vscene");
+    EXPECT_EQ(conf.scenePath, "assets/scenes/test.vscene");
+    EXPECT_THROW(ven::FUNCTION_MAP_OPT_LONG.at("scene")(conf, ""), std::invalid_argument);
+}
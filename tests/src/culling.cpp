@@ -0,0 +1,119 @@
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include "VEngine/Scene/Camera.hpp"
+#include "VEngine/Scene/Culler.hpp"
+
+namespace {
+
+    constexpr float VIEWPORT_HEIGHT = 1080.F;
+
+    ven::Camera makeCamera()
+    {
+        ven::Camera camera(ven::DEFAULT_FOV, ven::DEFAULT_NEAR, ven::DEFAULT_FAR, ven::DEFAULT_MOVE_SPEED, ven::DEFAULT_LOOK_SPEED);
+        camera.setViewDirection({0.F, 0.F, 0.F}, {0.F, 0.F, 1.F});
+        camera.setPerspectiveProjection(16.F / 9.F);
+        return camera;
+    }
+
+} // namespace
+
+TEST(Frustum, sphere)
+{
+    const ven::Camera camera = makeCamera();
+    const ven::Frustum frustum(camera.getProjection() * camera.getView());
+
+    EXPECT_TRUE(frustum.intersects(ven::BoundingSphere{ .center = {0.F, 0.F, 10.F}, .radius = 1.F }));
+    EXPECT_FALSE(frustum.intersects(ven::BoundingSphere{ .center = {0.F, 0.F, -10.F}, .radius = 1.F }));
+    EXPECT_FALSE(frustum.intersects(ven::BoundingSphere{ .center = {0.F, 0.F, 200.F}, .radius = 1.F }));
+    EXPECT_FALSE(frustum.intersects(ven::BoundingSphere{ .center = {50.F, 0.F, 10.F}, .radius = 1.F }));
+    EXPECT_TRUE(frustum.intersects(ven::BoundingSphere{ .center = {0.F, 0.F, -0.5F}, .radius = 1.F }));
+}
+
+TEST(Frustum, aabb)
+{
+    const ven::Camera camera = makeCamera();
+    const ven::Frustum frustum(camera.getProjection() * camera.getView());
+
+    EXPECT_TRUE(frustum.intersects(ven::AABB{ .min = {-1.F, -1.F, 5.F}, .max = {1.F, 1.F, 6.F} }));
+    EXPECT_FALSE(frustum.intersects(ven::AABB{ .min = {-1.F, -1.F, -6.F}, .max = {1.F, 1.F, -5.F} }));
+    EXPECT_FALSE(frustum.intersects(ven::AABB{ .min = {0.F, 40.F, 5.F}, .max = {1.F, 41.F, 6.F} }));
+}
+
+TEST(FrustumCuller, matchesScalarTest)
+{
+    const ven::Camera camera = makeCamera();
+    ven::FrustumCuller culler;
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> position(-60.F, 60.F);
+    std::uniform_real_distribution<float> radius(0.01F, 3.F);
+    std::vector<ven::BoundingSphere> spheres(1003);
+
+    culler.setMinPixelSize(0.F);
+    culler.begin(camera.getProjection(), camera.getView(), VIEWPORT_HEIGHT);
+    for (auto& sphere : spheres) {
+        sphere = { .center = {position(rng), position(rng), position(rng)}, .radius = radius(rng) };
+        culler.add(sphere);
+    }
+    culler.cull();
+
+    const ven::Frustum& frustum = culler.getFrustum();
+    for (uint32_t i = 0; i < spheres.size(); i++) {
+        EXPECT_EQ(culler.isVisible(i), frustum.intersects(spheres[i])) << "sphere " << i;
+    }
+    EXPECT_EQ(culler.getStats().tested, spheres.size());
+    EXPECT_EQ(culler.getStats().smallCulled, 0U);
+}
+
+TEST(FrustumCuller, smallObjects)
+{
+    const ven::Camera camera = makeCamera();
+    ven::FrustumCuller culler;
+
+    culler.setMinPixelSize(4.F);
+    culler.begin(camera.getProjection(), camera.getView(), VIEWPORT_HEIGHT);
+    const uint32_t near = culler.add({ .center = {0.F, 0.F, 5.F}, .radius = 0.01F });
+    const uint32_t far = culler.add({ .center = {0.F, 0.F, 90.F}, .radius = 0.01F });
+    const uint32_t big = culler.add({ .center = {0.F, 0.F, 90.F}, .radius = 5.F });
+    culler.cull();
+
+    EXPECT_TRUE(culler.isVisible(near));
+    EXPECT_FALSE(culler.isVisible(far));
+    EXPECT_TRUE(culler.isVisible(big));
+    EXPECT_EQ(culler.getStats().smallCulled, 1U);
+    EXPECT_EQ(culler.getStats().submitted, 2U);
+}
+
+TEST(FrustumCuller, disabled)
+{
+    const ven::Camera camera = makeCamera();
+    ven::FrustumCuller culler;
+
+    culler.setEnabled(false);
+    culler.begin(camera.getProjection(), camera.getView(), VIEWPORT_HEIGHT);
+    const uint32_t behind = culler.add({ .center = {0.F, 0.F, -10.F}, .radius = 1.F });
+    culler.cull();
+
+    EXPECT_TRUE(culler.isVisible(behind));
+    EXPECT_EQ(culler.getStats().submitted, 1U);
+}
+
+TEST(FrustumCuller, hiddenEntries)
+{
+    const ven::Camera camera = makeCamera();
+    ven::FrustumCuller culler;
+
+    culler.begin(camera.getProjection(), camera.getView(), VIEWPORT_HEIGHT);
+    const uint32_t visible = culler.add({ .center = {0.F, 0.F, 10.F}, .radius = 1.F });
+    const uint32_t hidden = culler.addHidden();
+    const uint32_t behind = culler.add({ .center = {0.F, 0.F, -10.F}, .radius = 1.F });
+    culler.cull();
+
+    EXPECT_TRUE(culler.isVisible(visible));
+    EXPECT_FALSE(culler.isVisible(hidden));
+    EXPECT_FALSE(culler.isVisible(behind));
+    EXPECT_EQ(culler.getStats().pvsCulled, 1U);
+    EXPECT_EQ(culler.getStats().frustumCulled, 1U);
+    EXPECT_EQ(culler.getStats().submitted, 1U);
+}
@@ -0,0 +1,101 @@
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include "VEngine/Scene/Camera.hpp"
+#include "VEngine/Scene/LightClusters.hpp"
+
+namespace {
+
+    constexpr glm::vec2 VIEWPORT{1280.F, 720.F};
+
+    glm::mat4 makeProjection()
+    {
+        ven::Camera camera(ven::DEFAULT_FOV, ven::DEFAULT_NEAR, ven::DEFAULT_FAR, 0.F, 0.F);
+        camera.setPerspectiveProjection(VIEWPORT.x / VIEWPORT.y);
+        return camera.getProjection();
+    }
+
+    // view space position of a fragment, as the projection of ven::Camera maps it
+    glm::vec3 unproject(const glm::mat4& projection, const glm::vec2& pixel, const float depth)
+    {
+        const glm::vec2 ndc = (pixel / VIEWPORT * 2.F) - 1.F;
+        return {ndc.x * depth / projection[0][0], ndc.y * depth / projection[1][1], depth};
+    }
+
+    bool contains(const ven::AABB& bounds, const glm::vec3& point)
+    {
+        constexpr float EPSILON = 1e-4F;
+        for (int axis = 0; axis < 3; axis++) {
+            if (point[axis] < bounds.min[axis] - EPSILON || point[axis] > bounds.max[axis] + EPSILON) { return false; }
+        }
+        return true;
+    }
+
+} // namespace
+
+TEST(LightClusters, slicesCoverTheFrustum)
+{
+    ven::LightClusters clusters;
+    clusters.begin(makeProjection(), ven::DEFAULT_NEAR, ven::DEFAULT_FAR, VIEWPORT);
+
+    EXPECT_NEAR(clusters.getBounds({0, 0, 0}).min.z, ven::DEFAULT_NEAR, 1e-4F);
+    EXPECT_NEAR(clusters.getBounds({0, 0, ven::CLUSTER_GRID_Z - 1}).max.z, ven::DEFAULT_FAR, 1e-2F);
+    for (uint32_t z = 1; z < ven::CLUSTER_GRID_Z; z++) {
+        // contiguous slices, each one deeper than the previous
+        EXPECT_NEAR(clusters.getBounds({0, 0, z}).min.z, clusters.getBounds({0, 0, z - 1}).max.z, 1e-3F);
+        EXPECT_GT(clusters.getBounds({0, 0, z}).max.z - clusters.getBounds({0, 0, z}).min.z, clusters.getBounds({0, 0, z - 1}).max.z - clusters.getBounds({0, 0, z - 1}).min.z);
+    }
+    EXPECT_EQ(clusters.getCluster({0.F, 0.F}, ven::DEFAULT_NEAR * 0.5F), glm::uvec3(0));
+    EXPECT_EQ(clusters.getCluster(VIEWPORT, ven::DEFAULT_FAR * 2.F), glm::uvec3(ven::CLUSTER_GRID_X - 1, ven::CLUSTER_GRID_Y - 1, ven::CLUSTER_GRID_Z - 1));
+    EXPECT_EQ(ven::LightClusters::getClusterIndex({ven::CLUSTER_GRID_X - 1, ven::CLUSTER_GRID_Y - 1, ven::CLUSTER_GRID_Z - 1}), ven::CLUSTER_COUNT - 1);
+}
+
+TEST(LightClusters, clusterBoundsHoldTheirFragments)
+{
+    ven::LightClusters clusters;
+    const glm::mat4 projection = makeProjection();
+    clusters.begin(projection, ven::DEFAULT_NEAR, ven::DEFAULT_FAR, VIEWPORT);
+
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> unit(0.F, 1.F);
+    for (uint32_t i = 0; i < 10000; i++) {
+        const glm::vec2 pixel{unit(random) * VIEWPORT.x, unit(random) * VIEWPORT.y};
+        const float depth = ven::DEFAULT_NEAR * std::pow(ven::DEFAULT_FAR / ven::DEFAULT_NEAR, unit(random));
+        const glm::uvec3 cluster = clusters.getCluster(pixel, depth);
+        ASSERT_TRUE(contains(clusters.getBounds(cluster), unproject(projection, pixel, depth))) << "pixel " << pixel.x << ' ' << pixel.y << " depth " << depth;
+    }
+}
+
+TEST(LightClusters, lightsReachTheClustersOfWhatTheyLight)
+{
+    ven::LightClusters clusters;
+    const glm::mat4 projection = makeProjection();
+    clusters.begin(projection, ven::DEFAULT_NEAR, ven::DEFAULT_FAR, VIEWPORT);
+
+    const glm::vec3 light{1.F, -0.5F, 6.F};
+    const float range = ven::LightClusters::getRange(1.F, 0.1F, 1.F / 16.F);
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> unit(0.F, 1.F);
+    uint32_t lit = 0;
+    for (uint32_t i = 0; i < 10000; i++) {
+        const glm::vec2 pixel{unit(random) * VIEWPORT.x, unit(random) * VIEWPORT.y};
+        const float depth = 1.F + (unit(random) * 10.F);
+        const glm::vec3 position = unproject(projection, pixel, depth);
+        if (glm::length(position - light) > range) { continue; }
+        // a fragment in range of the light must find it in the list of its cluster
+        lit++;
+        ASSERT_TRUE(ven::LightClusters::intersects(clusters.getBounds(clusters.getCluster(pixel, depth)), light, range));
+    }
+    EXPECT_GT(lit, 100U);
+
+    // far away clusters skip the light
+    EXPECT_FALSE(ven::LightClusters::intersects(clusters.getBounds(clusters.getCluster({0.F, 0.F}, 50.F)), light, range));
+}
+
+TEST(LightClusters, range)
+{
+    const float range = ven::LightClusters::getRange(0.5F, 0.2F, 1.F / 256.F);
+    EXPECT_NEAR(0.5F * 1.2F / (range * range), 1.F / 256.F, 1e-6F);
+    EXPECT_FLOAT_EQ(ven::LightClusters::getRange(0.F, 0.2F), 0.F);
+}
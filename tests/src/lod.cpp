@@ -0,0 +1,180 @@
+#include <cmath>
+#include <numbers>
+
+#include <gtest/gtest.h>
+
+#include "VEngine/Scene/MeshSimplifier.hpp"
+
+namespace {
+
+    struct TestMesh {
+        std::vector<glm::vec3> positions;
+        std::vector<uint32_t> indices;
+    };
+
+    // flat square of size x size quads in the xz plane, starting at offset
+    void addGrid(TestMesh& mesh, const uint32_t size, const float offset)
+    {
+        const auto first = static_cast<uint32_t>(mesh.positions.size());
+        for (uint32_t z = 0; z <= size; z++) {
+            for (uint32_t x = 0; x <= size; x++) {
+                mesh.positions.emplace_back(offset + static_cast<float>(x), 0.F, static_cast<float>(z));
+            }
+        }
+        for (uint32_t z = 0; z < size; z++) {
+            for (uint32_t x = 0; x < size; x++) {
+                const uint32_t corner = first + (z * (size + 1)) + x;
+                mesh.indices.insert(mesh.indices.end(), { corner, corner + size + 1, corner + 1, corner + 1, corner + size + 1, corner + size + 2 });
+            }
+        }
+    }
+
+    // closed sphere without seams: the poles are single vertices and the rings wrap around
+    TestMesh makeSphere(const uint32_t rings, const uint32_t segments, const float radius)
+    {
+        TestMesh mesh;
+        mesh.positions.emplace_back(0.F, radius, 0.F);
+        for (uint32_t ring = 1; ring < rings; ring++) {
+            const float theta = std::numbers::pi_v<float> * static_cast<float>(ring) / static_cast<float>(rings);
+            for (uint32_t segment = 0; segment < segments; segment++) {
+                const float phi = 2.F * std::numbers::pi_v<float> * static_cast<float>(segment) / static_cast<float>(segments);
+                mesh.positions.emplace_back(radius * std::sin(theta) * std::cos(phi), radius * std::cos(theta), radius * std::sin(theta) * std::sin(phi));
+            }
+        }
+        mesh.positions.emplace_back(0.F, -radius, 0.F);
+        const auto ringVertex = [&](const uint32_t ring, const uint32_t segment) { return 1 + ((ring - 1) * segments) + (segment % segments); };
+        const auto south = static_cast<uint32_t>(mesh.positions.size() - 1);
+        for (uint32_t segment = 0; segment < segments; segment++) {
+            mesh.indices.insert(mesh.indices.end(), { 0, ringVertex(1, segment + 1), ringVertex(1, segment) });
+            mesh.indices.insert(mesh.indices.end(), { south, ringVertex(rings - 1, segment), ringVertex(rings - 1, segment + 1) });
+            for (uint32_t ring = 1; ring + 1 < rings; ring++) {
+                const uint32_t a = ringVertex(ring, segment);
+                const uint32_t b = ringVertex(ring, segment + 1);
+                const uint32_t c = ringVertex(ring + 1, segment);
+                const uint32_t d = ringVertex(ring + 1, segment + 1);
+                mesh.indices.insert(mesh.indices.end(), { a, b, c, b, d, c });
+            }
+        }
+        return mesh;
+    }
+
+    bool references(const std::vector<uint32_t>& indices, const uint32_t vertex)
+    {
+        return std::ranges::find(indices, vertex) != indices.end();
+    }
+
+} // namespace
+
+TEST(MeshSimplifier, flatGridCollapsesWithoutError)
+{
+    TestMesh grid;
+    addGrid(grid, 16, 0.F);
+    const ven::SimplifiedMesh result = ven::MeshSimplifier::simplify(grid.positions, grid.indices, 0);
+
+    EXPECT_LT(result.indices.size(), grid.indices.size() / 4);
+    EXPECT_EQ(result.indices.size() % 3, 0U);
+    EXPECT_NEAR(result.error, 0.F, 1e-3F);
+    // the border is locked, the outline of the grid is unchanged
+    for (uint32_t i = 0; i <= 16; i++) {
+        EXPECT_TRUE(references(result.indices, i));
+        EXPECT_TRUE(references(result.indices, (16 * 17) + i));
+    }
+    for (std::size_t i = 0; i < result.indices.size(); i += 3) {
+        const glm::vec3 normal = cross(grid.positions[result.indices[i + 1]] - grid.positions[result.indices[i]], grid.positions[result.indices[i + 2]] - grid.positions[result.indices[i]]);
+        EXPECT_GT(normal.y, 0.F);
+    }
+}
+
+TEST(MeshSimplifier, sphereStopsAtErrorBudget)
+{
+    const TestMesh sphere = makeSphere(32, 64, 1.F);
+    const ven::SimplifiedMesh quarter = ven::MeshSimplifier::simplify(sphere.positions, sphere.indices, sphere.indices.size() / 4);
+    EXPECT_LE(quarter.indices.size(), sphere.indices.size() / 4);
+    EXPECT_GT(quarter.error, 0.F);
+    EXPECT_LT(quarter.error, 0.1F);
+
+    const ven::SimplifiedMesh bounded = ven::MeshSimplifier::simplify(sphere.positions, sphere.indices, 0, quarter.error * 0.5F);
+    EXPECT_GT(bounded.indices.size(), quarter.indices.size());
+    EXPECT_LE(bounded.error, quarter.error * 0.5F);
+}
+
+TEST(MeshSimplifier, seamsAndMaterialBordersAreKept)
+{
+    // two grids touching along x = 8: same positions, different vertices, like a UV seam or two materials
+    TestMesh mesh;
+    addGrid(mesh, 8, 0.F);
+    addGrid(mesh, 8, 8.F);
+    const ven::SimplifiedMesh result = ven::MeshSimplifier::simplify(mesh.positions, mesh.indices, 0);
+
+    EXPECT_LT(result.indices.size(), mesh.indices.size() / 2);
+    for (uint32_t z = 0; z <= 8; z++) {
+        EXPECT_TRUE(references(result.indices, (z * 9) + 8));
+        EXPECT_TRUE(references(result.indices, 81 + (z * 9)));
+    }
+}
+
+TEST(MeshSimplifier, buildChain)
+{
+    TestMesh model = makeSphere(32, 64, 1.F);
+    const auto sphereIndexCount = static_cast<uint32_t>(model.indices.size());
+    addGrid(model, 16, 2.F);
+    const std::array<ven::PvsMeshRange, 2> meshes{{ { .firstIndex = 0, .indexCount = sphereIndexCount }, { .firstIndex = sphereIndexCount, .indexCount = static_cast<uint32_t>(model.indices.size()) - sphereIndexCount } }};
+    const std::size_t baseIndexCount = model.indices.size();
+    const ven::LodChain chain = ven::MeshSimplifier::buildChain(model.positions, model.indices, meshes);
+
+    ASSERT_GE(chain.levels.size(), 3U);
+    ASSERT_EQ(chain.meshes.size(), meshes.size());
+    EXPECT_EQ(chain.levels[0].firstIndex, 0U);
+    EXPECT_EQ(chain.levels[0].indexCount, baseIndexCount);
+    for (std::size_t level = 1; level < chain.levels.size(); level++) {
+        const ven::MeshLod& range = chain.levels[level];
+        const ven::MeshLod& previous = chain.levels[level - 1];
+        EXPECT_LT(range.indexCount, previous.indexCount);
+        EXPECT_GE(range.error, previous.error);
+        // the ranges of the meshes are contiguous inside the level
+        uint32_t next = range.firstIndex;
+        for (const std::vector<ven::MeshLod>& lods : chain.meshes) {
+            ASSERT_EQ(lods.size(), chain.levels.size());
+            EXPECT_EQ(lods[level].firstIndex, next);
+            EXPECT_GE(lods[level].error, lods[level - 1].error);
+            next += lods[level].indexCount;
+        }
+        EXPECT_EQ(next, range.firstIndex + range.indexCount);
+    }
+    EXPECT_EQ(chain.levels.back().firstIndex + chain.levels.back().indexCount, model.indices.size());
+}
+
+TEST(LodSelector, screenErrorAndHysteresis)
+{
+    const std::array<ven::MeshLod, 3> lods{{ { .indexCount = 3000 }, { .indexCount = 1500, .error = 0.01F }, { .indexCount = 600, .error = 0.05F } }};
+    const ven::BoundingSphere sphere{ .center = glm::vec3(0.F), .radius = 1.F };
+    const glm::mat4 model{1.F};
+    ven::LodSelector selector;
+    const float fov = glm::radians(60.F);
+    const float projectionScale = 1000.F / (2.F * std::tan(fov * 0.5F));
+    // distance at which a level error covers exactly one pixel
+    const auto pixelDistance = [&](const float error) { return (error * projectionScale) + sphere.radius; };
+    const auto selectAt = [&](const float distance, const uint8_t current) {
+        selector.begin(glm::vec3(0.F, 0.F, -distance), fov, 1000.F);
+        return selector.select(lods, sphere, model, current);
+    };
+
+    selector.begin(glm::vec3(0.F, 0.F, -pixelDistance(0.01F)), fov, 1000.F);
+    EXPECT_NEAR(selector.getScreenError(0.01F, sphere), 1.F, 1e-3F);
+
+    EXPECT_EQ(selectAt(2.F, 0), 0);
+    EXPECT_EQ(selectAt(pixelDistance(0.05F) * 2.F, 0), 2);
+    // inside the band around the level 1 threshold, the previous level is kept
+    EXPECT_EQ(selectAt(pixelDistance(0.01F) * 1.1F, 0), 0);
+    EXPECT_EQ(selectAt(pixelDistance(0.01F) * 0.9F, 1), 1);
+    EXPECT_EQ(selectAt(pixelDistance(0.01F) * 1.5F, 0), 1);
+    EXPECT_EQ(selectAt(pixelDistance(0.01F) * 0.7F, 1), 0);
+    // the model scale scales the errors
+    selector.begin(glm::vec3(0.F, 0.F, -pixelDistance(0.05F) * 2.F), fov, 1000.F);
+    EXPECT_EQ(selector.select(lods, sphere, glm::mat4(glm::vec4(10.F, 0.F, 0.F, 0.F), glm::vec4(0.F, 10.F, 0.F, 0.F), glm::vec4(0.F, 0.F, 10.F, 0.F), glm::vec4(0.F, 0.F, 0.F, 1.F)), 2), 1);
+
+    selector.setEnabled(false);
+    EXPECT_EQ(selectAt(1000.F, 2), 0);
+    EXPECT_EQ(selector.getStats().selected[0], 1U);
+    EXPECT_EQ(selector.getStats().indexCount, 3000U);
+}
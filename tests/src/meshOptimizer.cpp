@@ -0,0 +1,170 @@
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include "VEngine/Scene/MeshOptimizer.hpp"
+
+namespace {
+
+    struct TestMesh {
+        std::vector<glm::vec3> positions;
+        std::vector<uint32_t> indices;
+    };
+
+    // flat square of size x size quads in the xz plane, facing +y
+    TestMesh makeGrid(const uint32_t size)
+    {
+        TestMesh mesh;
+        for (uint32_t z = 0; z <= size; z++) {
+            for (uint32_t x = 0; x <= size; x++) {
+                mesh.positions.emplace_back(static_cast<float>(x), 0.F, static_cast<float>(z));
+            }
+        }
+        for (uint32_t z = 0; z < size; z++) {
+            for (uint32_t x = 0; x < size; x++) {
+                const uint32_t corner = (z * (size + 1)) + x;
+                mesh.indices.insert(mesh.indices.end(), { corner, corner + size + 1, corner + 1, corner + 1, corner + size + 1, corner + size + 2 });
+            }
+        }
+        return mesh;
+    }
+
+    // outward facing sphere
+    TestMesh makeSphere(const uint32_t rings, const uint32_t segments, const float radius)
+    {
+        TestMesh mesh;
+        for (uint32_t ring = 0; ring <= rings; ring++) {
+            const float theta = std::numbers::pi_v<float> * static_cast<float>(ring) / static_cast<float>(rings);
+            for (uint32_t segment = 0; segment <= segments; segment++) {
+                const float phi = 2.F * std::numbers::pi_v<float> * static_cast<float>(segment) / static_cast<float>(segments);
+                mesh.positions.emplace_back(radius * std::sin(theta) * std::cos(phi), radius * std::cos(theta), radius * std::sin(theta) * std::sin(phi));
+            }
+        }
+        for (uint32_t ring = 0; ring < rings; ring++) {
+            for (uint32_t segment = 0; segment < segments; segment++) {
+                const uint32_t a = (ring * (segments + 1)) + segment;
+                const uint32_t b = a + segments + 1;
+                mesh.indices.insert(mesh.indices.end(), { a, a + 1, b, a + 1, b + 1, b });
+            }
+        }
+        return mesh;
+    }
+
+    // fixed seed Fisher-Yates, the same order on every platform
+    void shuffleTriangles(std::vector<uint32_t>& indices, const uint32_t seed)
+    {
+        std::mt19937 random(seed);
+        for (std::size_t i = (indices.size() / 3) - 1; i > 0; i--) {
+            const std::size_t j = random() % (i + 1);
+            std::swap_ranges(indices.begin() + static_cast<std::ptrdiff_t>(i * 3), indices.begin() + static_cast<std::ptrdiff_t>((i * 3) + 3), indices.begin() + static_cast<std::ptrdiff_t>(j * 3));
+        }
+    }
+
+    // triangles rotated so the smallest index comes first (winding kept), sorted
+    std::vector<std::array<uint32_t, 3>> triangleSet(const std::vector<uint32_t>& indices)
+    {
+        std::vector<std::array<uint32_t, 3>> triangles;
+        for (std::size_t i = 0; i < indices.size(); i += 3) {
+            std::array<uint32_t, 3> triangle{indices[i], indices[i + 1], indices[i + 2]};
+            std::ranges::rotate(triangle, std::ranges::min_element(triangle));
+            triangles.push_back(triangle);
+        }
+        std::ranges::sort(triangles);
+        return triangles;
+    }
+
+} // namespace
+
+TEST(MeshOptimizer, analyzeVertexCache)
+{
+    // no shared vertex, every corner misses
+    const std::vector<uint32_t> soup{0, 1, 2, 3, 4, 5};
+    EXPECT_FLOAT_EQ(ven::MeshOptimizer::analyzeVertexCache(soup).acmr, 3.F);
+    EXPECT_FLOAT_EQ(ven::MeshOptimizer::analyzeVertexCache(soup).atvr, 1.F);
+    // a quad: the second triangle only adds one vertex
+    const std::vector<uint32_t> quad{0, 1, 2, 2, 1, 3};
+    EXPECT_FLOAT_EQ(ven::MeshOptimizer::analyzeVertexCache(quad).acmr, 2.F);
+    // with a cache of 3 the fan centre is evicted once before it comes back
+    const std::vector<uint32_t> fan{0, 1, 2, 0, 2, 3, 0, 3, 4};
+    EXPECT_FLOAT_EQ(ven::MeshOptimizer::analyzeVertexCache(fan, 3).atvr, 6.F / 5.F);
+    EXPECT_FLOAT_EQ(ven::MeshOptimizer::analyzeVertexCache(fan, 4).atvr, 1.F);
+}
+
+TEST(MeshOptimizer, vertexCacheKeepsTrianglesAndImproves)
+{
+    TestMesh grid = makeGrid(64);
+    shuffleTriangles(grid.indices, 42);
+    const std::vector<std::array<uint32_t, 3>> expected = triangleSet(grid.indices);
+    const ven::VertexCacheStats before = ven::MeshOptimizer::analyzeVertexCache(grid.indices);
+
+    std::vector<uint32_t> optimized = grid.indices;
+    ven::MeshOptimizer::optimizeVertexCache(optimized);
+    const ven::VertexCacheStats after = ven::MeshOptimizer::analyzeVertexCache(optimized);
+
+    EXPECT_EQ(triangleSet(optimized), expected);
+    EXPECT_GT(before.acmr, 2.F);
+    EXPECT_LT(after.acmr, 0.8F);
+    EXPECT_LT(after.atvr, 1.5F);
+
+    // the order only depends on the input
+    std::vector<uint32_t> again = grid.indices;
+    ven::MeshOptimizer::optimizeVertexCache(again);
+    EXPECT_EQ(again, optimized);
+}
+
+TEST(MeshOptimizer, overdrawKeepsCacheEfficiency)
+{
+    TestMesh sphere = makeSphere(32, 64, 1.F);
+    shuffleTriangles(sphere.indices, 7);
+    const std::vector<std::array<uint32_t, 3>> expected = triangleSet(sphere.indices);
+    ven::MeshOptimizer::optimizeVertexCache(sphere.indices);
+    const float cacheAcmr = ven::MeshOptimizer::analyzeVertexCache(sphere.indices).acmr;
+
+    ven::MeshOptimizer::optimizeOverdraw(sphere.indices, sphere.positions);
+    EXPECT_EQ(triangleSet(sphere.indices), expected);
+    // the splits stay under the threshold, the cluster joins add a little
+    EXPECT_LT(ven::MeshOptimizer::analyzeVertexCache(sphere.indices).acmr, cacheAcmr * ven::DEFAULT_OVERDRAW_THRESHOLD * 1.1F);
+}
+
+TEST(MeshOptimizer, overdrawDrawsOuterShellFirst)
+{
+    // a small sphere inside a large one, the inner one given first
+    TestMesh mesh = makeSphere(16, 32, 0.5F);
+    const TestMesh outer = makeSphere(16, 32, 2.F);
+    const auto offset = static_cast<uint32_t>(mesh.positions.size());
+    const std::size_t innerIndexCount = mesh.indices.size();
+    mesh.positions.insert(mesh.positions.end(), outer.positions.begin(), outer.positions.end());
+    for (const uint32_t index : outer.indices) {
+        mesh.indices.push_back(index + offset);
+    }
+    ven::MeshOptimizer::optimizeVertexCache(std::span(mesh.indices).first(innerIndexCount));
+    ven::MeshOptimizer::optimizeVertexCache(std::span(mesh.indices).subspan(innerIndexCount));
+
+    ven::MeshOptimizer::optimizeOverdraw(mesh.indices, mesh.positions);
+    std::size_t outerFirst = 0;
+    for (std::size_t i = 0; i < innerIndexCount; i++) {
+        outerFirst += mesh.indices[i] >= offset ? 1U : 0U;
+    }
+    EXPECT_GT(outerFirst, innerIndexCount * 3 / 4);
+}
+
+TEST(MeshOptimizer, vertexFetch)
+{
+    TestMesh grid = makeGrid(16);
+    shuffleTriangles(grid.indices, 3);
+    std::vector<uint32_t> indices = grid.indices;
+    const std::vector<uint32_t> remap = ven::MeshOptimizer::optimizeVertexFetch(indices, grid.positions.size() + 1);
+
+    ASSERT_EQ(remap.size(), grid.positions.size() + 1);
+    // unreferenced vertex last, the others numbered by first use
+    EXPECT_EQ(remap.back(), grid.positions.size());
+    uint32_t next = 0;
+    for (std::size_t i = 0; i < indices.size(); i++) {
+        EXPECT_EQ(indices[i], remap[grid.indices[i]]);
+        EXPECT_LE(indices[i], next);
+        next = std::max(next, indices[i] + 1);
+    }
+}
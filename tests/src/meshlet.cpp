@@ -0,0 +1,164 @@
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+#include <gtest/gtest.h>
+
+#include "VEngine/Scene/Camera.hpp"
+#include "VEngine/Scene/Meshlet.hpp"
+
+namespace {
+
+    struct TestMesh {
+        std::vector<glm::vec3> positions;
+        std::vector<uint32_t> indices;
+    };
+
+    // outward facing (counter clockwise seen from outside) sphere
+    TestMesh makeSphere(const uint32_t rings, const uint32_t segments, const float radius)
+    {
+        TestMesh mesh;
+        for (uint32_t ring = 0; ring <= rings; ring++) {
+            const float theta = std::numbers::pi_v<float> * static_cast<float>(ring) / static_cast<float>(rings);
+            for (uint32_t segment = 0; segment <= segments; segment++) {
+                const float phi = 2.F * std::numbers::pi_v<float> * static_cast<float>(segment) / static_cast<float>(segments);
+                mesh.positions.emplace_back(radius * std::sin(theta) * std::cos(phi), radius * std::cos(theta), radius * std::sin(theta) * std::sin(phi));
+            }
+        }
+        for (uint32_t ring = 0; ring < rings; ring++) {
+            for (uint32_t segment = 0; segment < segments; segment++) {
+                const uint32_t a = (ring * (segments + 1)) + segment;
+                const uint32_t b = a + segments + 1;
+                mesh.indices.insert(mesh.indices.end(), { a, a + 1, b, a + 1, b + 1, b });
+            }
+        }
+        return mesh;
+    }
+
+    std::array<uint32_t, 3> unpack(const ven::MeshletData& data, const ven::Meshlet& meshlet, const uint32_t triangle)
+    {
+        const uint32_t packed = data.triangles[meshlet.triangleOffset + triangle];
+        return {
+            data.vertices[meshlet.vertexOffset + (packed & 0xFFU)],
+            data.vertices[meshlet.vertexOffset + ((packed >> 8U) & 0xFFU)],
+            data.vertices[meshlet.vertexOffset + ((packed >> 16U) & 0xFFU)]
+        };
+    }
+
+    // rotate so the smallest index comes first, the winding is kept
+    std::array<uint32_t, 3> canonical(std::array<uint32_t, 3> triangle)
+    {
+        std::ranges::rotate(triangle, std::ranges::min_element(triangle));
+        return triangle;
+    }
+
+    glm::vec3 normalOf(const TestMesh& mesh, const std::array<uint32_t, 3>& triangle)
+    {
+        return cross(mesh.positions[triangle[1]] - mesh.positions[triangle[0]], mesh.positions[triangle[2]] - mesh.positions[triangle[0]]);
+    }
+
+} // namespace
+
+TEST(MeshletBuilder, coversEveryTriangleWithinLimits)
+{
+    const TestMesh sphere = makeSphere(48, 96, 1.F);
+    ven::MeshletData data;
+    const uint32_t count = ven::MeshletBuilder::build(sphere.positions, sphere.indices, data);
+
+    ASSERT_EQ(count, data.meshlets.size());
+    std::vector<std::array<uint32_t, 3>> expected;
+    std::vector<std::array<uint32_t, 3>> clustered;
+    for (std::size_t i = 0; i < sphere.indices.size(); i += 3) {
+        expected.push_back(canonical({ sphere.indices[i], sphere.indices[i + 1], sphere.indices[i + 2] }));
+    }
+    for (const ven::Meshlet& meshlet : data.meshlets) {
+        EXPECT_GT(meshlet.triangleCount, 0U);
+        EXPECT_LE(meshlet.vertexCount, ven::MESHLET_MAX_VERTICES);
+        EXPECT_LE(meshlet.triangleCount, ven::MESHLET_MAX_TRIANGLES);
+        for (uint32_t triangle = 0; triangle < meshlet.triangleCount; triangle++) {
+            clustered.push_back(canonical(unpack(data, meshlet, triangle)));
+        }
+    }
+    std::ranges::sort(expected);
+    std::ranges::sort(clustered);
+    EXPECT_EQ(clustered, expected);
+    // close to full meshlets on a connected mesh
+    EXPECT_LT(count, (sphere.indices.size() / 3 / (ven::MESHLET_MAX_TRIANGLES / 2)) + 1);
+}
+
+TEST(MeshletBuilder, deterministic)
+{
+    const TestMesh sphere = makeSphere(32, 64, 1.F);
+    ven::MeshletData first;
+    ven::MeshletData second;
+    second.vertices = { 7, 8, 9 }; // appending to existing data only offsets the ranges
+    second.triangles = { 0 };
+    ven::MeshletBuilder::build(sphere.positions, sphere.indices, first);
+    ven::MeshletBuilder::build(sphere.positions, sphere.indices, second);
+
+    ASSERT_EQ(first.meshlets.size(), second.meshlets.size());
+    EXPECT_TRUE(std::equal(first.vertices.begin(), first.vertices.end(), second.vertices.begin() + 3, second.vertices.end()));
+    EXPECT_TRUE(std::equal(first.triangles.begin(), first.triangles.end(), second.triangles.begin() + 1, second.triangles.end()));
+    for (std::size_t i = 0; i < first.meshlets.size(); i++) {
+        EXPECT_EQ(first.meshlets[i].vertexOffset + 3, second.meshlets[i].vertexOffset);
+        EXPECT_EQ(first.meshlets[i].triangleOffset + 1, second.meshlets[i].triangleOffset);
+        EXPECT_EQ(first.meshlets[i].sphere, second.meshlets[i].sphere);
+        EXPECT_EQ(first.meshlets[i].cone, second.meshlets[i].cone);
+    }
+}
+
+TEST(MeshletBuilder, boundsAndCones)
+{
+    const TestMesh sphere = makeSphere(32, 64, 1.F);
+    ven::MeshletData data;
+    ven::MeshletBuilder::build(sphere.positions, sphere.indices, data);
+
+    for (const ven::Meshlet& meshlet : data.meshlets) {
+        for (uint32_t i = 0; i < meshlet.vertexCount; i++) {
+            EXPECT_LE(glm::length(sphere.positions[data.vertices[meshlet.vertexOffset + i]] - glm::vec3(meshlet.sphere)), meshlet.sphere.w * 1.0001F);
+        }
+        if (meshlet.cone.w >= 1.F) { continue; }
+        const float minDot = std::sqrt(1.F - (meshlet.cone.w * meshlet.cone.w));
+        for (uint32_t triangle = 0; triangle < meshlet.triangleCount; triangle++) {
+            const glm::vec3 normal = normalOf(sphere, unpack(data, meshlet, triangle));
+            if (glm::length(normal) <= 0.F) { continue; }
+            EXPECT_GE(dot(normal / glm::length(normal), glm::vec3(meshlet.cone)), minDot - 1e-4F);
+        }
+    }
+}
+
+TEST(MeshletBuilder, backfaceAndFrustumCulling)
+{
+    const TestMesh sphere = makeSphere(32, 64, 1.F);
+    ven::MeshletData data;
+    ven::MeshletBuilder::build(sphere.positions, sphere.indices, data);
+
+    const glm::vec3 camera{0.F, 0.F, 10.F};
+    uint32_t backfacing = 0;
+    for (const ven::Meshlet& meshlet : data.meshlets) {
+        if (!ven::MeshletBuilder::isBackfacing(meshlet, camera)) { continue; }
+        backfacing++;
+        // conservative: every triangle of a rejected meshlet faces away
+        for (uint32_t triangle = 0; triangle < meshlet.triangleCount; triangle++) {
+            const std::array<uint32_t, 3> vertices = unpack(data, meshlet, triangle);
+            EXPECT_GE(dot(sphere.positions[vertices[0]] - camera, normalOf(sphere, vertices)), 0.F);
+        }
+    }
+    // about half of the sphere faces away, the cone test catches a good part of it
+    EXPECT_GT(backfacing, data.meshlets.size() / 5);
+
+    ven::Camera view(ven::DEFAULT_FOV, ven::DEFAULT_NEAR, ven::DEFAULT_FAR, ven::DEFAULT_MOVE_SPEED, ven::DEFAULT_LOOK_SPEED);
+    view.setViewDirection({0.F, 0.F, 5.F}, {0.F, 0.F, 1.F});
+    view.setPerspectiveProjection(1.F);
+    const ven::Frustum frustum(view.getProjection() * view.getView());
+    uint32_t outside = 0;
+    for (const ven::Meshlet& meshlet : data.meshlets) {
+        outside += ven::MeshletBuilder::isOutside(meshlet, frustum, glm::mat4(1.F)) ? 1U : 0U;
+        // moved 100 units in front of the camera, nothing can be out of the frustum
+        glm::mat4 model{1.F};
+        model[3] = glm::vec4(0.F, 0.F, 100.F, 1.F);
+        EXPECT_FALSE(ven::MeshletBuilder::isOutside(meshlet, frustum, model));
+    }
+    // the sphere is behind the camera
+    EXPECT_EQ(outside, data.meshlets.size());
+}
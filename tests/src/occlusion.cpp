@@ -0,0 +1,175 @@
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include "VEngine/Scene/Camera.hpp"
+#include "VEngine/Scene/OcclusionCuller.hpp"
+
+namespace {
+
+    ven::Camera makeCamera()
+    {
+        ven::Camera camera(ven::DEFAULT_FOV, ven::DEFAULT_NEAR, ven::DEFAULT_FAR, ven::DEFAULT_MOVE_SPEED, ven::DEFAULT_LOOK_SPEED);
+        camera.setViewDirection({0.F, 0.F, 0.F}, {0.F, 0.F, 1.F});
+        camera.setPerspectiveProjection(16.F / 9.F);
+        return camera;
+    }
+
+    // two triangles facing the camera at depth z
+    std::vector<glm::vec3> makeWall(const float halfSize, const float z)
+    {
+        return {
+            {-halfSize, -halfSize, z}, {halfSize, -halfSize, z}, {halfSize, halfSize, z},
+            {-halfSize, -halfSize, z}, {halfSize, halfSize, z}, {-halfSize, halfSize, z}
+        };
+    }
+
+    ven::AABB makeBox(const glm::vec3& center, const float halfSize)
+    {
+        return { .min = center - glm::vec3(halfSize), .max = center + glm::vec3(halfSize) };
+    }
+
+} // namespace
+
+TEST(OcclusionCuller, wall)
+{
+    const ven::Camera camera = makeCamera();
+    const std::vector<glm::vec3> wall = makeWall(2.F, 10.F);
+    ven::OcclusionCuller culler;
+
+    culler.begin(camera.getProjection() * camera.getView());
+    culler.addOccluder(wall, glm::mat4(1.F));
+    const uint32_t behind = culler.add(makeBox({0.F, 0.F, 20.F}, 0.5F));
+    const uint32_t front = culler.add(makeBox({0.F, 0.F, 5.F}, 0.5F));
+    const uint32_t beside = culler.add(makeBox({6.F, 0.F, 20.F}, 0.5F));
+    const uint32_t larger = culler.add(makeBox({0.F, 0.F, 20.F}, 6.F));
+    culler.cull();
+
+    EXPECT_FALSE(culler.isVisible(behind));
+    EXPECT_TRUE(culler.isVisible(front));
+    EXPECT_TRUE(culler.isVisible(beside));
+    EXPECT_TRUE(culler.isVisible(larger));
+    EXPECT_EQ(culler.getStats().occluderTriangles, 2U);
+    EXPECT_EQ(culler.getStats().occluded, 1U);
+}
+
+TEST(OcclusionCuller, nearPlaneClipping)
+{
+    const ven::Camera camera = makeCamera();
+    // floor running from behind the camera to far away
+    const std::vector<glm::vec3> floor{
+        {-50.F, 1.F, -10.F}, {50.F, 1.F, -10.F}, {50.F, 1.F, 80.F},
+        {-50.F, 1.F, -10.F}, {50.F, 1.F, 80.F}, {-50.F, 1.F, 80.F}
+    };
+    ven::OcclusionCuller culler;
+
+    culler.begin(camera.getProjection() * camera.getView());
+    culler.addOccluder(floor, glm::mat4(1.F));
+    const uint32_t under = culler.add(makeBox({0.F, 3.F, 15.F}, 0.5F));
+    const uint32_t above = culler.add(makeBox({0.F, -1.F, 15.F}, 0.5F));
+    culler.cull();
+
+    EXPECT_FALSE(culler.isVisible(under));
+    EXPECT_TRUE(culler.isVisible(above));
+}
+
+TEST(OcclusionCuller, candidatesAndDisabled)
+{
+    const ven::Camera camera = makeCamera();
+    const std::vector<glm::vec3> wall = makeWall(2.F, 10.F);
+    const std::vector<uint8_t> candidates{0, 1};
+    ven::OcclusionCuller culler;
+
+    culler.begin(camera.getProjection() * camera.getView());
+    culler.addOccluder(wall, glm::mat4(1.F));
+    culler.add(makeBox({0.F, 0.F, 5.F}, 0.5F));
+    culler.add(makeBox({0.F, 0.F, 20.F}, 0.5F));
+    culler.setEnabled(false);
+    culler.cull(&candidates);
+
+    EXPECT_FALSE(culler.isVisible(0));
+    EXPECT_TRUE(culler.isVisible(1));
+}
+
+TEST(OcclusionCuller, threadPoolMatchesSerial)
+{
+    static constexpr std::size_t OCCLUDER_COUNT = 50;
+    static constexpr std::size_t BOX_COUNT = 2000;
+    const ven::Camera camera = makeCamera();
+    ven::ThreadPool pool;
+    ven::OcclusionCuller serial;
+    ven::OcclusionCuller parallel(ven::DEFAULT_OCCLUSION_WIDTH, ven::DEFAULT_OCCLUSION_HEIGHT, &pool);
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> position(-30.F, 30.F);
+    std::uniform_real_distribution<float> depth(2.F, 90.F);
+    std::uniform_real_distribution<float> size(0.1F, 4.F);
+
+    serial.begin(camera.getProjection() * camera.getView());
+    parallel.begin(camera.getProjection() * camera.getView());
+    for (std::size_t i = 0; i < OCCLUDER_COUNT; i++) {
+        const std::vector<glm::vec3> wall = makeWall(size(rng), depth(rng));
+        const glm::mat4 model = glm::translate(glm::mat4(1.F), {position(rng), position(rng), 0.F});
+        serial.addOccluder(wall, model);
+        parallel.addOccluder(wall, model);
+    }
+    for (std::size_t i = 0; i < BOX_COUNT; i++) {
+        const ven::AABB box = makeBox({position(rng), position(rng), depth(rng)}, size(rng) * 0.25F);
+        serial.add(box);
+        parallel.add(box);
+    }
+    serial.cull();
+    parallel.cull();
+
+    for (uint32_t y = 0; y < serial.getHeight(); y++) {
+        for (uint32_t x = 0; x < serial.getWidth(); x++) {
+            ASSERT_EQ(serial.getDepth(x, y), parallel.getDepth(x, y)) << x << ", " << y;
+        }
+    }
+    for (uint32_t i = 0; i < BOX_COUNT; i++) {
+        EXPECT_EQ(serial.isVisible(i), parallel.isVisible(i)) << "box " << i;
+    }
+
+    EXPECT_EQ(parallel.getStats().occluded, serial.getStats().occluded);
+    EXPECT_GT(parallel.getStats().occluded, 0U);
+}
+
+TEST(OcclusionCuller, avx2MatchesScalar)
+{
+    if (ven::getSupportedSimdLevel() != ven::SimdLevel::AVX2) {
+        GTEST_SKIP() << "the CPU has no AVX2";
+    }
+    static constexpr std::size_t OCCLUDER_COUNT = 200;
+    const ven::Camera camera = makeCamera();
+    ven::OcclusionCuller scalar;
+    ven::OcclusionCuller avx2;
+    scalar.setLevel(ven::SimdLevel::SCALAR);
+    avx2.setLevel(ven::SimdLevel::AVX2);
+    ASSERT_EQ(avx2.getLevel(), ven::SimdLevel::AVX2);
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> position(-30.F, 30.F);
+    std::uniform_real_distribution<float> depth(2.F, 90.F);
+    std::uniform_real_distribution<float> size(0.1F, 4.F);
+
+    scalar.begin(camera.getProjection() * camera.getView());
+    avx2.begin(camera.getProjection() * camera.getView());
+    for (std::size_t i = 0; i < OCCLUDER_COUNT; i++) {
+        const std::vector<glm::vec3> wall = makeWall(size(rng), depth(rng));
+        const glm::mat4 model = glm::translate(glm::mat4(1.F), {position(rng), position(rng), 0.F});
+        scalar.addOccluder(wall, model);
+        avx2.addOccluder(wall, model);
+    }
+    scalar.cull();
+    avx2.cull();
+
+    // the kernel may fuse its multiply adds, only the pixels right on an edge can flip coverage
+    uint32_t mismatches = 0;
+    uint32_t covered = 0;
+    for (uint32_t y = 0; y < scalar.getHeight(); y++) {
+        for (uint32_t x = 0; x < scalar.getWidth(); x++) {
+            covered += scalar.getDepth(x, y) < 1.F ? 1U : 0U;
+            mismatches += std::abs(scalar.getDepth(x, y) - avx2.getDepth(x, y)) > 1e-5F ? 1U : 0U;
+        }
+    }
+    EXPECT_GT(covered, 0U);
+    EXPECT_LE(mismatches, scalar.getWidth() * scalar.getHeight() / 1000);
+}
@@ -0,0 +1,105 @@
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#include <gtest/gtest.h>
+
+#include "VEngine/Gfx/PipelineCacheFile.hpp"
+
+namespace {
+
+    ven::PipelineCacheIdentity makeIdentity()
+    {
+        ven::PipelineCacheIdentity identity{ .vendorID = 0x10DE, .deviceID = 0x2684, .driverVersion = 0x8A4C4000 };
+        for (uint8_t i = 0; i < identity.uuid.size(); i++) {
+            identity.uuid.at(i) = static_cast<uint8_t>(i * 7 + 1);
+        }
+        return identity;
+    }
+
+    // what vkGetPipelineCacheData returns: VkPipelineCacheHeaderVersionOne, then the driver data
+    std::vector<uint8_t> makeBlob(const ven::PipelineCacheIdentity& identity, const std::size_t driverDataSize)
+    {
+        const std::array<uint32_t, 4> fields{32, 1, identity.vendorID, identity.deviceID};
+        std::vector<uint8_t> blob(32 + driverDataSize);
+        std::memcpy(blob.data(), fields.data(), sizeof(fields));
+        std::memcpy(blob.data() + sizeof(fields), identity.uuid.data(), identity.uuid.size());
+        for (std::size_t i = 32; i < blob.size(); i++) {
+            blob[i] = static_cast<uint8_t>(i * 31);
+        }
+        return blob;
+    }
+
+} // namespace
+
+TEST(PipelineCacheFile, roundTrip)
+{
+    const ven::PipelineCacheIdentity identity = makeIdentity();
+    const std::vector<uint8_t> blob = makeBlob(identity, 1000);
+    const std::vector<uint8_t> file = ven::PipelineCacheFile::pack(identity, blob);
+
+    const auto data = ven::PipelineCacheFile::unpack(identity, file);
+    ASSERT_TRUE(data.has_value());
+    EXPECT_TRUE(std::ranges::equal(*data, blob));
+}
+
+TEST(PipelineCacheFile, otherDeviceOrDriver)
+{
+    const ven::PipelineCacheIdentity identity = makeIdentity();
+    const std::vector<uint8_t> file = ven::PipelineCacheFile::pack(identity, makeBlob(identity, 100));
+
+    ven::PipelineCacheIdentity other = identity;
+    other.driverVersion++;
+    EXPECT_FALSE(ven::PipelineCacheFile::unpack(other, file).has_value());
+    other = identity;
+    other.deviceID++;
+    EXPECT_FALSE(ven::PipelineCacheFile::unpack(other, file).has_value());
+    other = identity;
+    other.vendorID++;
+    EXPECT_FALSE(ven::PipelineCacheFile::unpack(other, file).has_value());
+    other = identity;
+    other.uuid.back()++;
+    EXPECT_FALSE(ven::PipelineCacheFile::unpack(other, file).has_value());
+}
+
+TEST(PipelineCacheFile, corrupted)
+{
+    const ven::PipelineCacheIdentity identity = makeIdentity();
+    const std::vector<uint8_t> file = ven::PipelineCacheFile::pack(identity, makeBlob(identity, 100));
+
+    std::vector<uint8_t> flipped = file;
+    flipped.back() ^= 1U;
+    EXPECT_FALSE(ven::PipelineCacheFile::unpack(identity, flipped).has_value());
+    EXPECT_FALSE(ven::PipelineCacheFile::unpack(identity, std::span(file).first(file.size() - 1)).has_value());
+    EXPECT_FALSE(ven::PipelineCacheFile::unpack(identity, std::span(file).first(10)).has_value());
+
+    // a well formed file around a blob the driver would not take
+    ven::PipelineCacheIdentity other = identity;
+    other.deviceID++;
+    EXPECT_FALSE(ven::PipelineCacheFile::unpack(identity, ven::PipelineCacheFile::pack(identity, makeBlob(other, 100))).has_value());
+    EXPECT_FALSE(ven::PipelineCacheFile::unpack(identity, ven::PipelineCacheFile::pack(identity, {})).has_value());
+}
+
+TEST(PipelineCacheFile, saveAndLoad)
+{
+    const std::string path = (std::filesystem::temp_directory_path() / "vengine_pipeline_cache_test.bin").string();
+    const ven::PipelineCacheIdentity identity = makeIdentity();
+    const std::vector<uint8_t> blob = makeBlob(identity, 4000);
+
+    std::filesystem::remove(path);
+    EXPECT_TRUE(ven::PipelineCacheFile::load(path, identity).empty());
+    ven::PipelineCacheFile::save(path, identity, blob);
+    EXPECT_FALSE(std::filesystem::exists(path + ".tmp"));
+    EXPECT_EQ(ven::PipelineCacheFile::load(path, identity), blob);
+
+    ven::PipelineCacheIdentity other = identity;
+    other.driverVersion++;
+    EXPECT_TRUE(ven::PipelineCacheFile::load(path, other).empty());
+
+    // overwritten in place by the next save
+    const std::vector<uint8_t> smaller = makeBlob(identity, 10);
+    ven::PipelineCacheFile::save(path, identity, smaller);
+    EXPECT_EQ(ven::PipelineCacheFile::load(path, identity), smaller);
+    std::filesystem::remove(path);
+}
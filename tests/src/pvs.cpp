@@ -0,0 +1,121 @@
+#include <filesystem>
+
+#include <gtest/gtest.h>
+
+#include "VEngine/Scene/Pvs.hpp"
+
+namespace {
+
+    struct Scene {
+        std::vector<glm::vec3> positions;
+        std::vector<uint32_t> indices;
+        std::vector<ven::PvsMeshRange> meshes;
+
+        // axis aligned box as 12 triangles, one mesh
+        void addBox(const glm::vec3& min, const glm::vec3& max)
+        {
+            const auto base = static_cast<uint32_t>(positions.size());
+            for (uint32_t i = 0; i < 8; i++) {
+                positions.emplace_back((i & 1U) != 0 ? max.x : min.x, (i & 2U) != 0 ? max.y : min.y, (i & 4U) != 0 ? max.z : min.z);
+            }
+            constexpr std::array<uint32_t, 36> BOX_INDICES{0, 1, 3, 0, 3, 2, 4, 6, 7, 4, 7, 5, 0, 4, 5, 0, 5, 1, 2, 3, 7, 2, 7, 6, 0, 2, 6, 0, 6, 4, 1, 5, 7, 1, 7, 3};
+            meshes.push_back({ .firstIndex = static_cast<uint32_t>(indices.size()), .indexCount = BOX_INDICES.size() });
+            for (const uint32_t index : BOX_INDICES) {
+                indices.push_back(base + index);
+            }
+        }
+    };
+
+    // two rooms split by a wall at x = 0, one small box in each room
+    Scene makeRooms()
+    {
+        Scene scene;
+        scene.addBox({-0.1F, -10.F, -10.F}, {0.1F, 10.F, 10.F});
+        scene.addBox({-6.F, -0.5F, -0.5F}, {-5.F, 0.5F, 0.5F});
+        scene.addBox({5.F, -0.5F, -0.5F}, {6.F, 0.5F, 0.5F});
+        // floor and ceiling bound the volume so the grid spans both rooms
+        scene.addBox({-10.F, -10.5F, -10.F}, {10.F, -10.F, 10.F});
+        scene.addBox({-10.F, 10.F, -10.F}, {10.F, 10.5F, 10.F});
+        return scene;
+    }
+
+    constexpr ven::PvsSettings TEST_SETTINGS{ .cellsPerAxis = 8, .samplesPerCell = 4, .raysPerTarget = 4, .randomRays = 16 };
+
+} // namespace
+
+TEST(Pvs, wallSplitsRooms)
+{
+    const Scene scene = makeRooms();
+    const uint64_t hash = ven::Pvs::hashContent(scene.positions, scene.indices, scene.meshes);
+    ven::ThreadPool pool(2);
+    const ven::Pvs pvs = ven::Pvs::bake(scene.positions, scene.indices, scene.meshes, hash, TEST_SETTINGS, &pool);
+    std::vector<uint8_t> visible;
+
+    ASSERT_TRUE(pvs.isValid());
+    EXPECT_EQ(pvs.getMeshCount(), scene.meshes.size());
+
+    const uint32_t left = pvs.findCell({-7.F, 0.F, 0.F});
+    ASSERT_NE(left, ven::Pvs::OUTSIDE);
+    pvs.decodeCell(left, visible);
+    EXPECT_EQ(visible[0], 1);
+    EXPECT_EQ(visible[1], 1);
+    EXPECT_EQ(visible[2], 0);
+
+    const uint32_t right = pvs.findCell({7.F, 0.F, 0.F});
+    ASSERT_NE(right, ven::Pvs::OUTSIDE);
+    pvs.decodeCell(right, visible);
+    EXPECT_EQ(visible[0], 1);
+    EXPECT_EQ(visible[1], 0);
+    EXPECT_EQ(visible[2], 1);
+
+    EXPECT_EQ(pvs.findCell({50.F, 0.F, 0.F}), ven::Pvs::OUTSIDE);
+}
+
+TEST(Pvs, deterministic)
+{
+    const Scene scene = makeRooms();
+    ven::ThreadPool pool(3);
+    const ven::Pvs serial = ven::Pvs::bake(scene.positions, scene.indices, scene.meshes, 1, TEST_SETTINGS);
+    const ven::Pvs parallel = ven::Pvs::bake(scene.positions, scene.indices, scene.meshes, 1, TEST_SETTINGS, &pool);
+    std::vector<uint8_t> a;
+    std::vector<uint8_t> b;
+
+    ASSERT_EQ(serial.getCellCount(), parallel.getCellCount());
+    EXPECT_EQ(serial.getCompressedSize(), parallel.getCompressedSize());
+    for (uint32_t cell = 0; cell < serial.getCellCount(); cell++) {
+        serial.decodeCell(cell, a);
+        parallel.decodeCell(cell, b);
+        EXPECT_EQ(a, b) << "cell " << cell;
+    }
+}
+
+TEST(Pvs, saveLoadAndInvalidation)
+{
+    const Scene scene = makeRooms();
+    const uint64_t hash = ven::Pvs::hashContent(scene.positions, scene.indices, scene.meshes);
+    const ven::Pvs pvs = ven::Pvs::bake(scene.positions, scene.indices, scene.meshes, hash, TEST_SETTINGS);
+    const std::string path = (std::filesystem::temp_directory_path() / "vengine_test.pvs").string();
+    ven::Pvs loaded;
+    std::vector<uint8_t> expected;
+    std::vector<uint8_t> actual;
+
+    pvs.save(path);
+    ASSERT_TRUE(loaded.load(path, hash));
+    ASSERT_EQ(loaded.getCellCount(), pvs.getCellCount());
+    for (uint32_t cell = 0; cell < pvs.getCellCount(); cell++) {
+        pvs.decodeCell(cell, expected);
+        loaded.decodeCell(cell, actual);
+        EXPECT_EQ(expected, actual) << "cell " << cell;
+    }
+    EXPECT_EQ(loaded.findCell({-7.F, 0.F, 0.F}), pvs.findCell({-7.F, 0.F, 0.F}));
+
+    // the content changed, the file is stale
+    Scene moved = makeRooms();
+    moved.positions[0].x -= 1.F;
+    ven::Pvs stale;
+    EXPECT_NE(ven::Pvs::hashContent(moved.positions, moved.indices, moved.meshes), hash);
+    EXPECT_FALSE(stale.load(path, ven::Pvs::hashContent(moved.positions, moved.indices, moved.meshes)));
+    EXPECT_FALSE(stale.isValid());
+    EXPECT_FALSE(stale.load(path + ".missing", hash));
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,174 @@
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#include <gtest/gtest.h>
+
+#include "VEngine/Scene/SceneFile.hpp"
+#include "VEngine/Scene/Entities/Light.hpp"
+
+namespace {
+
+    ven::SceneFile makeScene(const uint32_t objectCount, const uint32_t lightCount)
+    {
+        ven::SceneFile scene;
+        const uint32_t model = scene.addAsset(ven::AssetKind::MODEL, "assets/models/cube.obj", 0x0123456789abcdefULL);
+        const uint32_t texture = scene.addAsset(ven::AssetKind::TEXTURE, "assets/textures/with space.png", 42);
+        scene.objects.reserve(objectCount);
+        for (uint32_t i = 0; i < objectCount; i++) {
+            const auto value = static_cast<float>(i);
+            scene.objects.push_back({
+                .transform = { .translation = {value, -value, 0.1F * value}, .scale = {1.F, 2.F, 3.F}, .rotation = {0.001F * value, 0.F, -1.F / 3.F} },
+                .parent = i == 0 ? ven::SceneFile::NONE : (i - 1) / 4,
+                .model = i % 3 == 0 ? ven::SceneFile::NONE : model,
+                .diffuseMap = i % 2 == 0 ? texture : ven::SceneFile::NONE,
+                .occluder = i % 5 == 0,
+                .name = "object \"" + std::to_string(i) + "\""
+            });
+        }
+        for (uint32_t i = 0; i < lightCount; i++) {
+            scene.lights.push_back({
+                .transform = { .translation = {1.F, 2.F, 3.F}, .scale = {0.1F, 0.F, 0.F}, .rotation = {} },
+                .color = {1.F, 0.5F, 0.25F, 0.2F},
+                .shininess = 32.F,
+                .parent = objectCount > 0 ? i % objectCount : ven::SceneFile::NONE,
+                .flags = static_cast<uint8_t>(i % 4),
+                .name = "light " + std::to_string(i)
+            });
+        }
+        return scene;
+    }
+
+    void expectEqual(const ven::Transform3D& lhs, const ven::Transform3D& rhs)
+    {
+        EXPECT_EQ(lhs.translation, rhs.translation);
+        EXPECT_EQ(lhs.rotation, rhs.rotation);
+        EXPECT_EQ(lhs.scale, rhs.scale);
+    }
+
+    void expectEqual(const ven::SceneFile& lhs, const ven::SceneFile& rhs)
+    {
+        ASSERT_EQ(lhs.assets.size(), rhs.assets.size());
+        ASSERT_EQ(lhs.objects.size(), rhs.objects.size());
+        ASSERT_EQ(lhs.lights.size(), rhs.lights.size());
+        for (std::size_t i = 0; i < lhs.assets.size(); i++) {
+            EXPECT_EQ(lhs.assets[i].kind, rhs.assets[i].kind);
+            EXPECT_EQ(lhs.assets[i].contentHash, rhs.assets[i].contentHash);
+            EXPECT_EQ(lhs.assets[i].path, rhs.assets[i].path);
+        }
+        for (std::size_t i = 0; i < lhs.objects.size(); i++) {
+            expectEqual(lhs.objects[i].transform, rhs.objects[i].transform);
+            EXPECT_EQ(lhs.objects[i].parent, rhs.objects[i].parent);
+            EXPECT_EQ(lhs.objects[i].model, rhs.objects[i].model);
+            EXPECT_EQ(lhs.objects[i].diffuseMap, rhs.objects[i].diffuseMap);
+            EXPECT_EQ(lhs.objects[i].occluder, rhs.objects[i].occluder);
+            EXPECT_EQ(lhs.objects[i].name, rhs.objects[i].name);
+        }
+        for (std::size_t i = 0; i < lhs.lights.size(); i++) {
+            expectEqual(lhs.lights[i].transform, rhs.lights[i].transform);
+            EXPECT_EQ(lhs.lights[i].color, rhs.lights[i].color);
+            EXPECT_EQ(lhs.lights[i].shininess, rhs.lights[i].shininess);
+            EXPECT_EQ(lhs.lights[i].parent, rhs.lights[i].parent);
+            EXPECT_EQ(lhs.lights[i].flags, rhs.lights[i].flags);
+            EXPECT_EQ(lhs.lights[i].name, rhs.lights[i].name);
+        }
+    }
+
+    std::string tempPath(const std::string& name) { return (std::filesystem::temp_directory_path() / name).string(); }
+
+} // namespace
+
+TEST(SceneFile, binaryRoundTrip)
+{
+    const ven::SceneFile scene = makeScene(100, 6);
+    const std::string path = tempPath("vengine_test" + std::string(ven::SCENE_EXTENSION));
+    scene.save(path);
+    ven::SceneFile loaded;
+    loaded.load(path);
+    expectEqual(scene, loaded);
+    std::filesystem::remove(path);
+}
+
+TEST(SceneFile, textRoundTrip)
+{
+    const ven::SceneFile scene = makeScene(100, 6);
+    const std::string path = tempPath("vengine_test" + std::string(ven::SCENE_EXTENSION) + std::string(ven::SCENE_TEXT_EXTENSION));
+    scene.save(path);
+    ven::SceneFile loaded;
+    loaded.load(path);
+    expectEqual(scene, loaded);
+    std::filesystem::remove(path);
+}
+
+TEST(SceneFile, rejectsCorruptedFiles)
+{
+    const std::string path = tempPath("vengine_corrupted" + std::string(ven::SCENE_EXTENSION));
+    makeScene(10, 1).save(path);
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+    ven::SceneFile loaded;
+    EXPECT_THROW(loaded.load(path), std::runtime_error);
+    {
+        std::ofstream file(path, std::ios::trunc);
+        file << "vscene 2\nobject \"a\" translation 0 0 0 rotation 0 0 0 scale 1 1 1 parent 3 model - texture - occluder 0\n";
+    }
+    EXPECT_THROW(loaded.load(path), std::runtime_error);
+    EXPECT_THROW(loaded.load(tempPath("vengine_missing.vscene")), std::runtime_error);
+    std::filesystem::remove(path);
+}
+
+TEST(SceneFile, upgradesVersion1)
+{
+    const std::string path = tempPath("vengine_v1" + std::string(ven::SCENE_EXTENSION) + std::string(ven::SCENE_TEXT_EXTENSION));
+    {
+        std::ofstream file(path, std::ios::trunc);
+        file << "vscene 1\nlight \"a\" translation 1 2 3 rotation 0 0 0 scale 0.1 0 0 color 1 0 0 0.2 shininess 32 parent -\n";
+    }
+    ven::SceneFile loaded;
+    loaded.load(path);
+    ASSERT_EQ(loaded.lights.size(), 1U);
+    EXPECT_EQ(loaded.lights[0].flags, ven::LIGHT_ANIMATED);
+    EXPECT_EQ(loaded.lights[0].parent, ven::SceneFile::NONE);
+
+    // a version 1 binary file is the version 2 one with 68 bytes lights, rewrite one without the flags
+    const ven::SceneFile scene = makeScene(3, 2);
+    const std::string binaryPath = tempPath("vengine_v1" + std::string(ven::SCENE_EXTENSION));
+    scene.save(binaryPath);
+    std::vector<char> bytes(std::filesystem::file_size(binaryPath));
+    std::ifstream(binaryPath, std::ios::binary).read(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    constexpr std::size_t headerSize = 24;
+    constexpr std::size_t lightSize = 72;
+    const std::size_t lightsOffset = headerSize + (scene.assets.size() * 24) + (scene.objects.size() * 60);
+    constexpr uint32_t version = ven::SceneFile::FILE_VERSION_V1;
+    std::memcpy(bytes.data() + 4, &version, sizeof(version));
+    for (std::size_t i = scene.lights.size(); i > 0; i--) {
+        bytes.erase(bytes.begin() + static_cast<std::ptrdiff_t>(lightsOffset + (i * lightSize) - 4), bytes.begin() + static_cast<std::ptrdiff_t>(lightsOffset + (i * lightSize)));
+    }
+    std::ofstream(binaryPath, std::ios::binary | std::ios::trunc).write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    loaded.load(binaryPath);
+    ASSERT_EQ(loaded.lights.size(), scene.lights.size());
+    for (std::size_t i = 0; i < scene.lights.size(); i++) {
+        EXPECT_EQ(loaded.lights[i].flags, ven::LIGHT_ANIMATED);
+        EXPECT_EQ(loaded.lights[i].color, scene.lights[i].color);
+        EXPECT_EQ(loaded.lights[i].name, scene.lights[i].name);
+    }
+    std::filesystem::remove(path);
+    std::filesystem::remove(binaryPath);
+}
+
+TEST(SceneFile, hashFile)
+{
+    const std::string path = tempPath("vengine_hash.txt");
+    {
+        std::ofstream file(path, std::ios::trunc);
+        file << "content";
+    }
+    const uint64_t hash = ven::SceneFile::hashFile(path);
+    EXPECT_NE(hash, 0U);
+    {
+        std::ofstream file(path, std::ios::app);
+        file << '!';
+    }
+    EXPECT_NE(ven::SceneFile::hashFile(path), hash);
+    EXPECT_EQ(ven::SceneFile::hashFile(tempPath("vengine_missing.txt")), 0U);
+    std::filesystem::remove(path);
+}
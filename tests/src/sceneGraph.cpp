@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+
+#include "VEngine/Scene/SceneGraph.hpp"
+
+namespace {
+
+    glm::mat4 translation(const glm::vec3& offset) { return glm::translate(glm::mat4(1.F), offset); }
+
+    void expectPosition(const ven::SceneGraph& graph, const uint32_t node, const glm::vec3& position)
+    {
+        const glm::vec3 world(graph.getWorld(node)[3]);
+        EXPECT_NEAR(world.x, position.x, 1e-4F);
+        EXPECT_NEAR(world.y, position.y, 1e-4F);
+        EXPECT_NEAR(world.z, position.z, 1e-4F);
+    }
+
+    // tree with FANOUT children per node, node i is the child of (i - 1) / FANOUT
+    constexpr uint32_t FANOUT = 8;
+
+    void buildTree(ven::SceneGraph& graph, const uint32_t count)
+    {
+        graph.add(glm::mat4(1.F));
+        for (uint32_t i = 1; i < count; i++) {
+            graph.add(ven::Transform3D{ .translation = {1.F, 0.F, 0.F}, .scale = {1.F, 1.F, 1.F}, .rotation = {0.F, 0.01F, 0.F} }, (i - 1) / FANOUT);
+        }
+    }
+
+} // namespace
+
+TEST(SceneGraph, propagation)
+{
+    ven::SceneGraph graph;
+    const uint32_t root = graph.add(translation({1.F, 0.F, 0.F}));
+    const uint32_t child = graph.add(translation({0.F, 2.F, 0.F}), root);
+    const uint32_t grandChild = graph.add(translation({0.F, 0.F, 3.F}), child);
+
+    EXPECT_EQ(graph.update(), 3U);
+    EXPECT_EQ(graph.getLevelCount(), 3U);
+    expectPosition(graph, grandChild, {1.F, 2.F, 3.F});
+
+    EXPECT_EQ(graph.update(), 0U);
+    graph.setLocal(root, translation({5.F, 0.F, 0.F}));
+    EXPECT_EQ(graph.update(), 3U);
+    expectPosition(graph, grandChild, {5.F, 2.F, 3.F});
+
+    // only the touched subtree moves
+    const uint64_t rootVersion = graph.getVersion(root);
+    graph.setLocal(child, translation({0.F, 4.F, 0.F}));
+    EXPECT_EQ(graph.update(), 2U);
+    EXPECT_EQ(graph.getVersion(root), rootVersion);
+    expectPosition(graph, grandChild, {5.F, 4.F, 3.F});
+}
+
+TEST(SceneGraph, reparentAndRemove)
+{
+    ven::SceneGraph graph;
+    const uint32_t a = graph.add(translation({1.F, 0.F, 0.F}));
+    const uint32_t b = graph.add(translation({0.F, 1.F, 0.F}));
+    // added before its future parent in the dense order
+    const uint32_t c = graph.add(translation({0.F, 0.F, 1.F}));
+    graph.setParent(c, b);
+    graph.setParent(b, a);
+    static_cast<void>(graph.update());
+    expectPosition(graph, c, {1.F, 1.F, 1.F});
+
+    EXPECT_THROW(graph.setParent(a, c), std::invalid_argument);
+
+    graph.remove(b);
+    EXPECT_FALSE(graph.contains(b));
+    EXPECT_EQ(graph.getParent(c), a);
+    static_cast<void>(graph.update());
+    EXPECT_EQ(graph.size(), 2U);
+    EXPECT_EQ(graph.getLevelCount(), 2U);
+    expectPosition(graph, c, {1.F, 0.F, 1.F});
+
+    // removed ids are reused
+    EXPECT_EQ(graph.add(glm::mat4(1.F), c), b);
+    static_cast<void>(graph.update());
+    EXPECT_EQ(graph.getLevelCount(), 3U);
+}
+
+TEST(SceneGraph, removeKeepsSiblings)
+{
+    ven::SceneGraph graph;
+    const uint32_t root = graph.add(translation({1.F, 0.F, 0.F}));
+    const uint32_t middle = graph.add(translation({0.F, 1.F, 0.F}), root);
+    std::vector<uint32_t> children;
+    for (uint32_t i = 0; i < 4; i++) {
+        children.push_back(graph.add(translation({0.F, 0.F, static_cast<float>(i)}), middle));
+    }
+    const uint32_t sibling = graph.add(glm::mat4(1.F), root);
+    static_cast<void>(graph.update());
+
+    // removing a child in the middle of the list, then the parent, keeps the others attached
+    graph.remove(children[1]);
+    graph.remove(middle);
+    EXPECT_EQ(graph.getParent(sibling), root);
+    for (const uint32_t child : {children[0], children[2], children[3]}) {
+        EXPECT_EQ(graph.getParent(child), root);
+    }
+    static_cast<void>(graph.update());
+    expectPosition(graph, children[3], {1.F, 0.F, 3.F});
+    EXPECT_EQ(graph.getLevelCount(), 2U);
+
+    graph.remove(root);
+    EXPECT_EQ(graph.getParent(children[0]), ven::SceneGraph::NONE);
+    static_cast<void>(graph.update());
+    EXPECT_EQ(graph.size(), 4U);
+    expectPosition(graph, children[2], {0.F, 0.F, 2.F});
+}
+
+TEST(SceneGraph, parallelMatchesSerial)
+{
+    constexpr uint32_t count = 20000;
+    ven::ThreadPool pool;
+    ven::SceneGraph serial;
+    ven::SceneGraph parallel(&pool);
+    buildTree(serial, count);
+    buildTree(parallel, count);
+    EXPECT_EQ(serial.update(), count);
+    EXPECT_EQ(parallel.update(), count);
+    for (uint32_t node = 0; node < count; node += 997) {
+        for (int column = 0; column < 4; column++) {
+            EXPECT_EQ(serial.getWorld(node)[column], parallel.getWorld(node)[column]);
+        }
+    }
+}
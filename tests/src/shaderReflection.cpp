@@ -0,0 +1,190 @@
+#include <initializer_list>
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+
+#include "VEngine/Gfx/ShaderReflection.hpp"
+
+namespace {
+
+    // hand assembled modules, the ids are the ones of the comments
+    class SpirvWriter {
+
+        public:
+
+            SpirvWriter& op(const uint16_t opcode, const std::initializer_list<uint32_t> operands)
+            {
+                m_words.push_back(static_cast<uint32_t>(operands.size() + 1) << 16 | opcode);
+                m_words.insert(m_words.end(), operands);
+                return *this;
+            }
+
+            [[nodiscard]] const std::vector<uint32_t>& getWords() const { return m_words; }
+
+        private:
+
+            std::vector<uint32_t> m_words{0x07230203, 0x00010000, 0, 100, 0};
+
+    }; // class SpirvWriter
+
+    constexpr uint16_t OP_LINE = 8;
+    constexpr uint16_t OP_ENTRY_POINT = 15;
+    constexpr uint16_t OP_TYPE_INT = 21;
+    constexpr uint16_t OP_TYPE_FLOAT = 22;
+    constexpr uint16_t OP_TYPE_VECTOR = 23;
+    constexpr uint16_t OP_TYPE_MATRIX = 24;
+    constexpr uint16_t OP_TYPE_IMAGE = 25;
+    constexpr uint16_t OP_TYPE_SAMPLED_IMAGE = 27;
+    constexpr uint16_t OP_TYPE_ARRAY = 28;
+    constexpr uint16_t OP_TYPE_STRUCT = 30;
+    constexpr uint16_t OP_TYPE_POINTER = 32;
+    constexpr uint16_t OP_CONSTANT = 43;
+    constexpr uint16_t OP_FUNCTION = 54;
+    constexpr uint16_t OP_FUNCTION_END = 56;
+    constexpr uint16_t OP_VARIABLE = 59;
+    constexpr uint16_t OP_LOAD = 61;
+    constexpr uint16_t OP_ACCESS_CHAIN = 65;
+    constexpr uint16_t OP_DECORATE = 71;
+    constexpr uint16_t OP_MEMBER_DECORATE = 72;
+
+    constexpr uint32_t MODEL_VERTEX = 0;
+    constexpr uint32_t MODEL_FRAGMENT = 4;
+    constexpr uint32_t MAIN_NAME = 0x6E69616D; // "main", the terminator is the next word
+
+    // the types shared by the modules: float 3, vec4 4, mat4 5, sampled 2D image 7, uint 8, constant 4 of uint 9,
+    // UBO block {mat4} 10, storage block {vec4} 11, push block {mat4, vec4} 12, array of 4 sampled images 13
+    SpirvWriter& writeTypes(SpirvWriter& writer)
+    {
+        return writer
+            .op(OP_DECORATE, {10, 2}) // Block
+            .op(OP_MEMBER_DECORATE, {10, 0, 35, 0})
+            .op(OP_DECORATE, {11, 3}) // BufferBlock
+            .op(OP_MEMBER_DECORATE, {11, 0, 35, 0})
+            .op(OP_DECORATE, {12, 2})
+            .op(OP_MEMBER_DECORATE, {12, 0, 35, 0})
+            .op(OP_MEMBER_DECORATE, {12, 0, 7, 16}) // MatrixStride
+            .op(OP_MEMBER_DECORATE, {12, 1, 35, 64})
+            .op(OP_TYPE_FLOAT, {3, 32})
+            .op(OP_TYPE_VECTOR, {4, 3, 4})
+            .op(OP_TYPE_MATRIX, {5, 4, 4})
+            .op(OP_TYPE_IMAGE, {6, 3, 1, 0, 0, 0, 1, 0})
+            .op(OP_TYPE_SAMPLED_IMAGE, {7, 6})
+            .op(OP_TYPE_INT, {8, 32, 0})
+            .op(OP_CONSTANT, {8, 9, 4})
+            .op(OP_TYPE_STRUCT, {10, 5})
+            .op(OP_TYPE_STRUCT, {11, 4})
+            .op(OP_TYPE_STRUCT, {12, 5, 4})
+            .op(OP_TYPE_ARRAY, {13, 7, 9})
+            .op(OP_TYPE_POINTER, {14, 2, 10}) // Uniform
+            .op(OP_TYPE_POINTER, {15, 2, 11})
+            .op(OP_TYPE_POINTER, {16, 0, 7}) // UniformConstant
+            .op(OP_TYPE_POINTER, {17, 9, 12}) // PushConstant
+            .op(OP_TYPE_POINTER, {18, 0, 13});
+    }
+
+    // ubo 20 (set 0, binding 0), texture 21 (1, 1), unused texture 22 (1, 2), storage 23 (0, 2), textures 24 (1, 3), push 25
+    std::vector<uint32_t> makeFragmentModule()
+    {
+        SpirvWriter writer;
+        writer.op(OP_ENTRY_POINT, {MODEL_FRAGMENT, 2, MAIN_NAME, 0})
+            .op(OP_DECORATE, {20, 34, 0}).op(OP_DECORATE, {20, 33, 0})
+            .op(OP_DECORATE, {21, 34, 1}).op(OP_DECORATE, {21, 33, 1})
+            .op(OP_DECORATE, {22, 34, 1}).op(OP_DECORATE, {22, 33, 2})
+            .op(OP_DECORATE, {23, 34, 0}).op(OP_DECORATE, {23, 33, 2})
+            .op(OP_DECORATE, {24, 34, 1}).op(OP_DECORATE, {24, 33, 3});
+        writeTypes(writer)
+            .op(OP_VARIABLE, {14, 20, 2})
+            .op(OP_VARIABLE, {16, 21, 0})
+            .op(OP_VARIABLE, {16, 22, 0})
+            .op(OP_VARIABLE, {15, 23, 2})
+            .op(OP_VARIABLE, {18, 24, 0})
+            .op(OP_VARIABLE, {17, 25, 9})
+            .op(OP_FUNCTION, {1, 2, 0, 30})
+            .op(OP_LINE, {31, 22, 0}) // line 22, not the unused texture
+            .op(OP_ACCESS_CHAIN, {40, 41, 20, 9})
+            .op(OP_LOAD, {7, 42, 21})
+            .op(OP_ACCESS_CHAIN, {40, 43, 23, 9})
+            .op(OP_ACCESS_CHAIN, {40, 44, 24, 9})
+            .op(OP_ACCESS_CHAIN, {40, 45, 25, 9})
+            .op(OP_FUNCTION_END, {});
+        return writer.getWords();
+    }
+
+    // reads the ubo 20 (set 0, binding 0), declares the push 25 without reading it
+    std::vector<uint32_t> makeVertexModule()
+    {
+        SpirvWriter writer;
+        writer.op(OP_ENTRY_POINT, {MODEL_VERTEX, 2, MAIN_NAME, 0})
+            .op(OP_DECORATE, {20, 34, 0}).op(OP_DECORATE, {20, 33, 0});
+        writeTypes(writer)
+            .op(OP_VARIABLE, {14, 20, 2})
+            .op(OP_VARIABLE, {17, 25, 9})
+            .op(OP_FUNCTION, {1, 2, 0, 30})
+            .op(OP_ACCESS_CHAIN, {40, 41, 20, 9})
+            .op(OP_FUNCTION_END, {});
+        return writer.getWords();
+    }
+
+} // namespace
+
+TEST(ShaderReflection, fragmentModule)
+{
+    const ven::ShaderReflection reflection(makeFragmentModule());
+
+    EXPECT_EQ(reflection.getStageFlags(), static_cast<VkShaderStageFlags>(VK_SHADER_STAGE_FRAGMENT_BIT));
+    const std::vector<ven::ReflectedBinding> expected{
+        { .set = 0, .binding = 0, .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, .count = 1, .stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT },
+        { .set = 0, .binding = 2, .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, .count = 1, .stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT },
+        { .set = 1, .binding = 1, .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, .count = 1, .stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT },
+        { .set = 1, .binding = 3, .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, .count = 4, .stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT }
+    };
+    EXPECT_EQ(reflection.getBindings(), expected);
+    EXPECT_EQ(reflection.getPushConstantRange().stageFlags, static_cast<VkShaderStageFlags>(VK_SHADER_STAGE_FRAGMENT_BIT));
+    EXPECT_EQ(reflection.getPushConstantRange().size, 80U);
+
+    const std::vector<VkDescriptorSetLayoutBinding> set1 = reflection.getSetBindings(1);
+    ASSERT_EQ(set1.size(), 2U);
+    EXPECT_EQ(set1[0].binding, 1U);
+    EXPECT_EQ(set1[1].descriptorCount, 4U);
+    EXPECT_TRUE(reflection.getSetBindings(2).empty());
+}
+
+TEST(ShaderReflection, mergeStages)
+{
+    const ven::ShaderReflection vertex(makeVertexModule());
+    EXPECT_EQ(vertex.getBindings().size(), 1U);
+    EXPECT_EQ(vertex.getPushConstantRange().size, 0U);
+
+    ven::ShaderReflection pipeline;
+    pipeline.merge(vertex);
+    pipeline.merge(ven::ShaderReflection(makeFragmentModule()));
+    EXPECT_EQ(pipeline.getStageFlags(), static_cast<VkShaderStageFlags>(VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT));
+    ASSERT_EQ(pipeline.getBindings().size(), 4U);
+    EXPECT_EQ(pipeline.getBindings()[0].stageFlags, static_cast<VkShaderStageFlags>(VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT));
+    EXPECT_EQ(pipeline.getBindings()[1].stageFlags, static_cast<VkShaderStageFlags>(VK_SHADER_STAGE_FRAGMENT_BIT));
+    // only the fragment stage reads the push constants
+    EXPECT_EQ(pipeline.getPushConstantRange().stageFlags, static_cast<VkShaderStageFlags>(VK_SHADER_STAGE_FRAGMENT_BIT));
+    EXPECT_EQ(pipeline.getPushConstantRange().size, 80U);
+}
+
+TEST(ShaderReflection, conflictsAndInvalidModules)
+{
+    ven::ShaderReflection reflection(makeFragmentModule());
+    SpirvWriter writer;
+    // a sampled image at set 0 binding 0, where the fragment module reads a uniform buffer
+    writer.op(OP_ENTRY_POINT, {MODEL_VERTEX, 2, MAIN_NAME, 0})
+        .op(OP_DECORATE, {21, 34, 0}).op(OP_DECORATE, {21, 33, 0});
+    writeTypes(writer)
+        .op(OP_VARIABLE, {16, 21, 0})
+        .op(OP_FUNCTION, {1, 2, 0, 30})
+        .op(OP_LOAD, {7, 42, 21})
+        .op(OP_FUNCTION_END, {});
+    EXPECT_THROW(reflection.merge(ven::ShaderReflection(writer.getWords())), std::runtime_error);
+
+    std::vector<uint32_t> words = makeFragmentModule();
+    words[0] = 0;
+    EXPECT_THROW(ven::ShaderReflection{words}, std::runtime_error);
+    words = makeFragmentModule();
+    words.push_back(4U << 16 | OP_FUNCTION_END); // four words announced, none follow
+    EXPECT_THROW(ven::ShaderReflection{words}, std::runtime_error);
+}
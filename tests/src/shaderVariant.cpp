@@ -0,0 +1,48 @@
+#include <cstring>
+
+#include <gtest/gtest.h>
+
+#include "VEngine/Gfx/ShaderVariant.hpp"
+
+TEST(ShaderVariant, selectTakesOnlyTheGivenConstants)
+{
+    const ven::ShaderVariant base{ .alphaMode = ven::ALPHA_OPAQUE };
+    const ven::ShaderVariant frame{ .alphaMode = ven::ALPHA_BLEND, .shadows = VK_FALSE, .maxLights = 8 };
+
+    EXPECT_EQ(base.select(frame, 0), base);
+    const ven::ShaderVariant lit = base.select(frame, ven::SHADER_LIGHTING_CONSTANTS);
+    EXPECT_EQ(lit.alphaMode, ven::ALPHA_OPAQUE);
+    EXPECT_EQ(lit.shadows, VK_FALSE);
+    EXPECT_EQ(lit.maxLights, 8U);
+    EXPECT_EQ(base.select(frame, 1U << ven::SHADER_CONSTANT_ALPHA_MODE).alphaMode, ven::ALPHA_BLEND);
+}
+
+TEST(ShaderVariant, keysTellTheVariantsApart)
+{
+    const ven::ShaderVariant variant{};
+    EXPECT_EQ(variant.getKey(), ven::ShaderVariant{}.getKey());
+    EXPECT_NE(variant.getKey(), (ven::ShaderVariant{ .alphaMode = ven::ALPHA_OPAQUE }).getKey());
+    EXPECT_NE(variant.getKey(), (ven::ShaderVariant{ .shadows = VK_FALSE }).getKey());
+    EXPECT_NE(variant.getKey(), (ven::ShaderVariant{ .maxLights = 8 }).getKey());
+    // any non zero VkBool32 is true
+    EXPECT_EQ(variant.getKey(), (ven::ShaderVariant{ .shadows = 2 }).getKey());
+}
+
+TEST(ShaderVariant, specializationDataIsTheVariant)
+{
+    const ven::ShaderVariant variant{ .alphaMode = ven::ALPHA_CUTOUT, .shadows = VK_FALSE, .maxLights = 12 };
+    const VkSpecializationInfo info = variant.getSpecializationInfo();
+    ASSERT_EQ(info.mapEntryCount, ven::SHADER_CONSTANT_COUNT);
+    EXPECT_EQ(info.pData, &variant);
+    EXPECT_EQ(info.dataSize, sizeof(ven::ShaderVariant));
+
+    const std::array<uint32_t, ven::SHADER_CONSTANT_COUNT> expected{ven::ALPHA_CUTOUT, VK_FALSE, 12};
+    for (uint32_t i = 0; i < info.mapEntryCount; i++) {
+        const VkSpecializationMapEntry& entry = info.pMapEntries[i];
+        ASSERT_LT(entry.constantID, ven::SHADER_CONSTANT_COUNT);
+        ASSERT_LE(entry.offset + entry.size, info.dataSize);
+        uint32_t value = 0;
+        std::memcpy(&value, static_cast<const char*>(info.pData) + entry.offset, entry.size);
+        EXPECT_EQ(value, expected.at(entry.constantID));
+    }
+}
@@ -0,0 +1,123 @@
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "VEngine/Gfx/ShaderVariantCache.hpp"
+
+namespace {
+
+    // stands for the Shaders of a variant, the cache only owns and returns it
+    struct FakePipeline {
+        ven::ShaderVariant variant;
+    };
+
+    using FakeCache = ven::BasicShaderVariantCache<FakePipeline>;
+
+    // holds the compilations of the factory until the test opens it
+    class Gate {
+
+        public:
+
+            void open()
+            {
+                {
+                    const std::scoped_lock lock(m_mutex);
+                    m_open = true;
+                }
+                m_condition.notify_all();
+            }
+            void wait()
+            {
+                std::unique_lock lock(m_mutex);
+                m_condition.wait(lock, [this] { return m_open; });
+            }
+
+        private:
+
+            std::mutex m_mutex;
+            std::condition_variable m_condition;
+            bool m_open{false};
+
+    }; // class Gate
+
+    const ven::ShaderVariant BASE{ .alphaMode = ven::ALPHA_OPAQUE };
+    const ven::ShaderVariant FEW_LIGHTS{ .maxLights = 8 };
+
+} // namespace
+
+TEST(ShaderVariantCache, fallsBackToBaseUntilCompiled)
+{
+    ven::ThreadPool pool(2);
+    Gate gate;
+    FakeCache cache(pool, [&gate](const ven::ShaderVariant& variant) {
+        if (variant != BASE) {
+            gate.wait();
+        }
+        return std::make_unique<FakePipeline>(variant);
+    }, BASE, ven::SHADER_LIGHTING_CONSTANTS);
+
+    EXPECT_EQ(cache.get(FEW_LIGHTS).variant, BASE);
+    EXPECT_EQ(cache.getVariantCount(), 2U);
+    gate.open();
+    pool.waitIdle();
+    const FakePipeline& promoted = cache.get(FEW_LIGHTS);
+    EXPECT_EQ(promoted.variant, BASE.select(FEW_LIGHTS, ven::SHADER_LIGHTING_CONSTANTS));
+    EXPECT_EQ(&cache.get(FEW_LIGHTS), &promoted);
+    // the alpha mode is not one of the constants of the slot, it maps to the base pipeline
+    EXPECT_EQ(&cache.get({ .alphaMode = ven::ALPHA_BLEND }), &cache.get(BASE));
+    EXPECT_EQ(cache.getVariantCount(), 2U);
+}
+
+TEST(ShaderVariantCache, failedVariantKeepsBase)
+{
+    ven::ThreadPool pool(2);
+    std::atomic<uint32_t> calls{0};
+    FakeCache cache(pool, [&calls](const ven::ShaderVariant& variant) {
+        calls++;
+        if (variant.maxLights == FEW_LIGHTS.maxLights) {
+            throw std::runtime_error("bad variant");
+        }
+        return std::make_unique<FakePipeline>(variant);
+    }, BASE, ven::SHADER_LIGHTING_CONSTANTS);
+
+    static_cast<void>(cache.get(FEW_LIGHTS));
+    pool.waitIdle();
+    EXPECT_EQ(cache.get(FEW_LIGHTS).variant, BASE);
+    EXPECT_EQ(cache.get(FEW_LIGHTS).variant, BASE);
+    // the failed variant is not queued again
+    pool.waitIdle();
+    EXPECT_EQ(calls.load(), 2U);
+}
+
+TEST(ShaderVariantCache, failedBaseThrows)
+{
+    ven::ThreadPool pool(2);
+    FakeCache cache(pool, [](const ven::ShaderVariant&) -> std::unique_ptr<FakePipeline> {
+        throw std::runtime_error("bad base");
+    }, BASE);
+
+    EXPECT_THROW(static_cast<void>(cache.get(BASE)), std::runtime_error);
+    EXPECT_THROW(static_cast<void>(cache.get(FEW_LIGHTS)), std::runtime_error);
+}
+
+TEST(ShaderVariantCache, destructorWaitsForCompiles)
+{
+    ven::ThreadPool pool(2);
+    std::atomic<uint32_t> compiled{0};
+    {
+        FakeCache cache(pool, [&compiled](const ven::ShaderVariant& variant) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            compiled++;
+            return std::make_unique<FakePipeline>(variant);
+        }, BASE, ven::SHADER_LIGHTING_CONSTANTS);
+        static_cast<void>(cache.get(FEW_LIGHTS));
+        EXPECT_EQ(cache.getVariantCount(), 2U);
+    }
+    // the variant was still compiling when the cache went away, its task must not outlive it
+    EXPECT_EQ(compiled.load(), 2U);
+}
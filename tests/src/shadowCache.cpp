@@ -0,0 +1,245 @@
+#include <gtest/gtest.h>
+
+#include "VEngine/Scene/ShadowCache.hpp"
+
+namespace {
+
+    struct Scene {
+        std::vector<ven::Handle> handles;
+        std::vector<ven::AABB> bounds;
+        std::vector<uint64_t> versions;
+        uint64_t nextVersion{1};
+
+        void add(const glm::vec3& center)
+        {
+            handles.push_back({ .index = static_cast<uint32_t>(handles.size()), .generation = 0 });
+            bounds.push_back({ .min = center - 0.5F, .max = center + 0.5F });
+            versions.push_back(nextVersion++);
+        }
+        void move(const uint32_t object, const glm::vec3& offset)
+        {
+            bounds[object] = { .min = bounds[object].min + offset, .max = bounds[object].max + offset };
+            versions[object] = nextVersion++;
+        }
+        void update(ven::ShadowCache& cache, const std::vector<ven::ShadowLight>& lights) const { cache.update(handles, bounds, versions, lights); }
+    };
+
+    bool overlaps(const ven::ShadowTile& lhs, const ven::ShadowTile& rhs)
+    {
+        return lhs.x < rhs.x + rhs.size && rhs.x < lhs.x + lhs.size && lhs.y < rhs.y + rhs.size && rhs.y < lhs.y + lhs.size;
+    }
+
+    const ven::ShadowMap& mapOf(const ven::ShadowCache& cache, const uint32_t light)
+    {
+        return cache.getShadowMaps().at(static_cast<std::size_t>(cache.getLightShadows()[light]));
+    }
+
+} // namespace
+
+TEST(ShadowAtlas, tilesAreDisjointAndMergeBack)
+{
+    ven::ShadowAtlas atlas(1024, 64);
+    std::vector<ven::ShadowTile> tiles;
+    for (const uint32_t size : {256U, 64U, 512U, 128U, 64U, 256U}) {
+        const std::optional<ven::ShadowTile> tile = atlas.allocate(size);
+        ASSERT_TRUE(tile.has_value());
+        EXPECT_EQ(tile->size, size);
+        EXPECT_EQ(tile->x % size, 0U);
+        EXPECT_EQ(tile->y % size, 0U);
+        EXPECT_LE(tile->x + size, 1024U);
+        EXPECT_LE(tile->y + size, 1024U);
+        for (const ven::ShadowTile& other : tiles) {
+            EXPECT_FALSE(overlaps(*tile, other));
+        }
+        tiles.push_back(*tile);
+    }
+    EXPECT_EQ(atlas.getFreeArea(), (1024U * 1024U) - (2U * 256U * 256U) - (2U * 64U * 64U) - (512U * 512U) - (128U * 128U));
+    EXPECT_FALSE(atlas.allocate(1024).has_value());
+    EXPECT_FALSE(atlas.allocate(96).has_value());
+
+    for (const ven::ShadowTile& tile : tiles) {
+        atlas.free(tile);
+    }
+    EXPECT_EQ(atlas.getFreeArea(), 1024U * 1024U);
+    EXPECT_TRUE(atlas.allocate(1024).has_value());
+}
+
+TEST(ShadowAtlas, fullAtlas)
+{
+    ven::ShadowAtlas atlas(512, 128);
+    for (uint32_t i = 0; i < 16; i++) {
+        ASSERT_TRUE(atlas.allocate(128).has_value());
+    }
+    EXPECT_FALSE(atlas.allocate(128).has_value());
+    EXPECT_EQ(atlas.getFreeArea(), 0U);
+}
+
+TEST(ShadowCache, staticCastersAreBakedOnce)
+{
+    Scene scene;
+    scene.add({3.F, 0.F, 0.F});
+    scene.add({0.F, 0.F, -3.F});
+    scene.add({50.F, 0.F, 0.F}); // out of range
+    const std::vector<ven::ShadowLight> lights{{ .handle = { .index = 0, .generation = 0 }, .position = {0.F, 0.F, 0.F}, .range = 5.F }};
+    ven::ShadowCache cache;
+    cache.begin({0.F, 0.F, 10.F}, 1.F, 720.F);
+
+    // every object starts dynamic, the first update bakes the empty static layer
+    scene.update(cache, lights);
+    ASSERT_EQ(cache.getShadowMaps().size(), 1U);
+    EXPECT_TRUE(mapOf(cache, 0).bake);
+    EXPECT_TRUE(mapOf(cache, 0).composite);
+    EXPECT_TRUE(mapOf(cache, 0).dynamicCasters.at(0).size() == 1 && mapOf(cache, 0).dynamicCasters.at(0)[0] == 0); // +x face
+    EXPECT_TRUE(mapOf(cache, 0).dynamicCasters.at(5).size() == 1 && mapOf(cache, 0).dynamicCasters.at(5)[0] == 1); // -z face
+    EXPECT_TRUE(mapOf(cache, 0).dynamicCasters.at(2).empty());
+    for (uint32_t frame = 1; frame < ven::SHADOW_SETTLE_FRAMES; frame++) {
+        scene.update(cache, lights);
+        EXPECT_FALSE(mapOf(cache, 0).bake);
+        EXPECT_TRUE(mapOf(cache, 0).composite);
+    }
+
+    // the objects join the static layer together, then nothing changes
+    scene.update(cache, lights);
+    EXPECT_TRUE(cache.isStatic(scene.handles[0]));
+    EXPECT_TRUE(mapOf(cache, 0).bake);
+    EXPECT_EQ(mapOf(cache, 0).staticCasters.at(0), std::vector<uint32_t>{0});
+    EXPECT_EQ(mapOf(cache, 0).staticCasters.at(5), std::vector<uint32_t>{1});
+    EXPECT_TRUE(mapOf(cache, 0).dynamicCasters.at(0).empty());
+    for (uint32_t frame = 0; frame < 4; frame++) {
+        scene.update(cache, lights);
+        EXPECT_FALSE(mapOf(cache, 0).bake);
+        EXPECT_FALSE(mapOf(cache, 0).composite);
+    }
+    EXPECT_EQ(cache.getStats().dynamicObjects, 0U);
+}
+
+TEST(ShadowCache, dynamicCastersAreCompositedOverTheCache)
+{
+    Scene scene;
+    scene.add({3.F, 0.F, 0.F});
+    scene.add({0.F, 0.F, -3.F});
+    scene.add({50.F, 0.F, 0.F});
+    const std::vector<ven::ShadowLight> lights{{ .handle = { .index = 0, .generation = 0 }, .position = {0.F, 0.F, 0.F}, .range = 5.F }};
+    ven::ShadowCache cache;
+    cache.begin({0.F, 0.F, 10.F}, 1.F, 720.F);
+    for (uint32_t frame = 0; frame <= ven::SHADOW_SETTLE_FRAMES; frame++) {
+        scene.update(cache, lights);
+    }
+
+    // leaving the static layer removes its baked shadow once, then it is only composited
+    scene.move(0, {0.F, 0.1F, 0.F});
+    scene.update(cache, lights);
+    EXPECT_TRUE(mapOf(cache, 0).bake);
+    EXPECT_TRUE(mapOf(cache, 0).staticCasters.at(0).empty());
+    EXPECT_EQ(mapOf(cache, 0).staticCasters.at(5), std::vector<uint32_t>{1});
+    EXPECT_EQ(mapOf(cache, 0).dynamicCasters.at(0), std::vector<uint32_t>{0});
+    for (uint32_t frame = 0; frame < 3; frame++) {
+        scene.move(0, {0.F, 0.1F, 0.F});
+        scene.update(cache, lights);
+        EXPECT_FALSE(mapOf(cache, 0).bake);
+        EXPECT_TRUE(mapOf(cache, 0).composite);
+    }
+
+    // a dynamic object out of range costs nothing, the last frame of the one that left is wiped once
+    scene.move(0, {0.F, 100.F, 0.F});
+    scene.move(2, {1.F, 0.F, 0.F});
+    scene.update(cache, lights);
+    EXPECT_FALSE(mapOf(cache, 0).bake);
+    EXPECT_TRUE(mapOf(cache, 0).composite);
+    scene.move(2, {1.F, 0.F, 0.F});
+    scene.update(cache, lights);
+    EXPECT_FALSE(mapOf(cache, 0).composite);
+    EXPECT_EQ(cache.getStats().dynamicObjects, 2U);
+}
+
+TEST(ShadowCache, movedLightIsBakedAgain)
+{
+    Scene scene;
+    scene.add({3.F, 0.F, 0.F});
+    std::vector<ven::ShadowLight> lights{{ .handle = { .index = 0, .generation = 0 }, .position = {0.F, 0.F, 0.F}, .range = 5.F }};
+    ven::ShadowCache cache;
+    cache.begin({0.F, 0.F, 10.F}, 1.F, 720.F);
+    for (uint32_t frame = 0; frame <= ven::SHADOW_SETTLE_FRAMES + 1; frame++) {
+        scene.update(cache, lights);
+    }
+    EXPECT_FALSE(mapOf(cache, 0).bake);
+    lights[0].position.y = 0.5F;
+    scene.update(cache, lights);
+    EXPECT_TRUE(mapOf(cache, 0).bake);
+    EXPECT_TRUE(mapOf(cache, 0).composite);
+    scene.update(cache, lights);
+    EXPECT_FALSE(mapOf(cache, 0).bake);
+    lights[0].range = 6.F;
+    scene.update(cache, lights);
+    EXPECT_TRUE(mapOf(cache, 0).bake);
+}
+
+TEST(ShadowCache, importantLightsGetTheAtlas)
+{
+    Scene scene;
+    // 512 atlas of 128 faces: room for two cube maps
+    std::vector<ven::ShadowLight> lights{
+        { .handle = { .index = 0, .generation = 0 }, .position = {0.F, 0.F, 40.F}, .range = 2.F },
+        { .handle = { .index = 1, .generation = 0 }, .position = {0.F, 0.F, 10.F}, .range = 2.F },
+        { .handle = { .index = 2, .generation = 0 }, .position = {0.F, 0.F, 20.F}, .range = 2.F }
+    };
+    ven::ShadowCache cache(512, 128);
+    cache.begin({0.F, 0.F, 0.F}, 1.F, 720.F);
+    scene.update(cache, lights);
+    EXPECT_EQ(cache.getLightShadows()[0], -1);
+    EXPECT_NE(cache.getLightShadows()[1], -1);
+    EXPECT_NE(cache.getLightShadows()[2], -1);
+    for (const ven::ShadowMap& map : cache.getShadowMaps()) {
+        for (const ven::ShadowMap& other : cache.getShadowMaps()) {
+            for (uint32_t face = 0; face < ven::CUBE_FACE_COUNT; face++) {
+                for (uint32_t otherFace = 0; otherFace < ven::CUBE_FACE_COUNT; otherFace++) {
+                    if (&map == &other && face == otherFace) { continue; }
+                    EXPECT_FALSE(overlaps(map.tiles.at(face), other.tiles.at(otherFace)));
+                }
+            }
+        }
+    }
+
+    // walking to the far light makes it the most important, the least important one gives its tiles up
+    cache.begin({0.F, 0.F, 41.F}, 1.F, 720.F);
+    scene.update(cache, lights);
+    EXPECT_NE(cache.getLightShadows()[0], -1);
+    EXPECT_TRUE(mapOf(cache, 0).bake);
+    EXPECT_EQ(cache.getLightShadows()[1], -1);
+    EXPECT_NE(cache.getLightShadows()[2], -1);
+    EXPECT_FALSE(mapOf(cache, 2).bake);
+
+    // a light that stops casting shadows frees its tiles
+    lights.erase(lights.begin());
+    scene.update(cache, lights);
+    EXPECT_NE(cache.getLightShadows()[0], -1);
+    EXPECT_NE(cache.getLightShadows()[1], -1);
+}
+
+TEST(ShadowCache, faceSizeFollowsTheScreenSize)
+{
+    ven::ShadowCache cache;
+    cache.begin({0.F, 0.F, 0.F}, 1.F, 720.F);
+    const uint32_t near = cache.getFaceSize({ .handle = {}, .position = {0.F, 0.F, 8.F}, .range = 2.F });
+    const uint32_t far = cache.getFaceSize({ .handle = {}, .position = {0.F, 0.F, 80.F}, .range = 2.F });
+    EXPECT_GT(near, far);
+    EXPECT_EQ(cache.getFaceSize({ .handle = {}, .position = {0.F, 0.F, 1.F}, .range = 2.F }), ven::SHADOW_MAX_FACE_SIZE);
+    EXPECT_EQ(cache.getFaceSize({ .handle = {}, .position = {0.F, 0.F, 5000.F}, .range = 2.F }), ven::SHADOW_MIN_TILE_SIZE);
+}
+
+TEST(ShadowCache, faceProjectionsCoverTheirAxis)
+{
+    const glm::vec3 light{1.F, 2.F, 3.F};
+    const std::array<glm::vec3, ven::CUBE_FACE_COUNT> points{{{3.F, 2.5F, 2.F}, {-1.F, 1.F, 4.F}, {1.5F, 4.F, 3.F}, {1.F, 0.F, 2.5F}, {0.F, 2.F, 5.F}, {1.F, 3.F, 1.F}}};
+    for (uint32_t face = 0; face < ven::CUBE_FACE_COUNT; face++) {
+        const glm::vec4 clip = ven::ShadowCache::getFaceViewProjection(light, 10.F, face) * glm::vec4(points.at(face), 1.F);
+        const glm::vec3 ndc = glm::vec3(clip) / clip.w;
+        EXPECT_GT(clip.w, 0.F) << "face " << face;
+        EXPECT_LE(std::abs(ndc.x), 1.F) << "face " << face;
+        EXPECT_LE(std::abs(ndc.y), 1.F) << "face " << face;
+        EXPECT_GT(ndc.z, 0.F) << "face " << face;
+        EXPECT_LT(ndc.z, 1.F) << "face " << face;
+        // the depth is the distance along the axis of the face
+        EXPECT_NEAR(clip.w, std::abs((points.at(face) - light)[static_cast<int>(face / 2)]), 1e-4F) << "face " << face;
+    }
+}
@@ -0,0 +1,139 @@
+#include <algorithm>
+#include <random>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "VEngine/Scene/Entities/Object.hpp"
+
+namespace {
+
+    using TestSet = ven::SparseSet<int, std::string>;
+
+} // namespace
+
+TEST(SparseSet, insertAndLookup)
+{
+    TestSet set;
+    const ven::Handle a = set.insert(1, "a");
+    const ven::Handle b = set.insert(2, "b");
+
+    EXPECT_EQ(set.size(), 2U);
+    EXPECT_TRUE(set.contains(a));
+    EXPECT_TRUE(set.contains(b));
+    EXPECT_EQ(set.column<0>()[set.indexOf(b)], 2);
+    EXPECT_EQ(set.column<1>()[set.indexOf(a)], "a");
+    EXPECT_FALSE(set.contains(ven::Handle{}));
+}
+
+TEST(SparseSet, eraseKeepsColumnsDense)
+{
+    TestSet set;
+    const ven::Handle a = set.insert(1, "a");
+    const ven::Handle b = set.insert(2, "b");
+    const ven::Handle c = set.insert(3, "c");
+
+    EXPECT_TRUE(set.erase(a));
+    EXPECT_FALSE(set.erase(a));
+    ASSERT_EQ(set.size(), 2U);
+    EXPECT_EQ(set.column<0>().size(), 2U);
+    EXPECT_EQ(set.column<1>().size(), 2U);
+    // the last entity moved into the hole, its handle follows it
+    EXPECT_EQ(set.indexOf(c), 0U);
+    EXPECT_EQ(set.column<0>()[set.indexOf(c)], 3);
+    EXPECT_EQ(set.column<1>()[set.indexOf(b)], "b");
+    EXPECT_EQ(set.handles()[set.indexOf(c)], c);
+    EXPECT_THROW(static_cast<void>(set.indexOf(a)), std::out_of_range);
+}
+
+TEST(SparseSet, staleHandleAfterSlotReuse)
+{
+    TestSet set;
+    const ven::Handle a = set.insert(1, "a");
+    set.erase(a);
+    const ven::Handle d = set.insert(4, "d");
+
+    EXPECT_EQ(d.index, a.index);
+    EXPECT_NE(d.generation, a.generation);
+    EXPECT_FALSE(set.contains(a));
+    EXPECT_TRUE(set.contains(d));
+    EXPECT_FALSE(set.erase(a));
+    EXPECT_EQ(set.size(), 1U);
+}
+
+TEST(SparseSet, clear)
+{
+    TestSet set;
+    const ven::Handle a = set.insert(1, "a");
+    set.insert(2, "b");
+    set.clear();
+
+    EXPECT_TRUE(set.empty());
+    EXPECT_TRUE(set.column<0>().empty());
+    EXPECT_FALSE(set.contains(a));
+    EXPECT_TRUE(set.contains(set.insert(5, "e")));
+}
+
+TEST(ObjectStore, createDestroyRecyclesStorage)
+{
+    constexpr uint32_t CREATED = 20000;
+    constexpr uint32_t MAX_LIVE = 1000;
+    ven::SceneGraph graph;
+    ven::SpatialIndex index;
+    ven::ObjectStore objects(graph, index);
+    std::mt19937 rng(5);
+    uint32_t maxSlot = 0;
+    uint32_t maxNode = 0;
+    ven::Handle firstHandle{};
+    // what SceneManager::updateBuffer asks of the object uniform buffer every frame
+    uint32_t capacity = 0;
+    uint32_t reallocations = 0;
+
+    for (uint32_t i = 0; i < CREATED; i++) {
+        if (objects.size() == MAX_LIVE) {
+            const ven::Handle victim = objects.handles()[std::uniform_int_distribution<uint32_t>(0, MAX_LIVE - 1)(rng)];
+            ASSERT_TRUE(objects.erase(victim));
+            ASSERT_FALSE(objects.erase(victim));
+        }
+        const auto position = glm::vec3(static_cast<float>(i % 100));
+        // every tenth object hangs under a live one, erasing the parent must leave it attached to the graph
+        const uint32_t parent = i % 10 == 0 && !objects.empty() ? objects.nodes()[0] : ven::SceneGraph::NONE;
+        const ven::Handle handle = objects.create(nullptr, nullptr, "object", { .translation = position, .scale = glm::vec3(1.F), .rotation = glm::vec3(0.F) }, false, parent);
+        if (i == 0) { firstHandle = handle; }
+        maxSlot = std::max(maxSlot, handle.index);
+        maxNode = std::max(maxNode, objects.nodes()[objects.indexOf(handle)]);
+        if (i % 1000 == 0) {
+            static_cast<void>(graph.update());
+            static_cast<void>(objects.updateWorld());
+            const uint32_t grown = ven::Buffer::growCapacity(capacity, objects.size());
+            reallocations += grown != capacity ? 1 : 0;
+            capacity = grown;
+        }
+        const uint32_t grown = ven::Buffer::growCapacity(capacity, objects.size());
+        ASSERT_GE(grown, objects.size());
+        reallocations += grown != capacity ? 1 : 0;
+        capacity = grown;
+    }
+
+    // slots and nodes are recycled through the store: storage stays proportional to the live count, not to the number ever created
+    EXPECT_EQ(objects.size(), MAX_LIVE);
+    EXPECT_EQ(graph.size(), MAX_LIVE);
+    EXPECT_LT(maxSlot, MAX_LIVE + 1);
+    EXPECT_LT(maxNode, MAX_LIVE + 1);
+    EXPECT_FALSE(objects.contains(firstHandle));
+    for (const ven::Handle handle : objects.handles()) {
+        EXPECT_TRUE(objects.contains(handle));
+        EXPECT_TRUE(graph.contains(objects.nodes()[objects.indexOf(handle)]));
+    }
+    static_cast<void>(graph.update());
+    static_cast<void>(objects.updateWorld());
+    EXPECT_EQ(objects.updateWorld(), 0U);
+    // geometric growth: a handful of reallocations for all these creations
+    EXPECT_GE(capacity, MAX_LIVE);
+    EXPECT_LE(reallocations, 11U);
+
+    objects.clear();
+    EXPECT_TRUE(objects.empty());
+    EXPECT_EQ(graph.size(), 0U);
+    EXPECT_EQ(index.getProxyCount(), 0U);
+}
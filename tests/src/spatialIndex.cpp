@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include "VEngine/Scene/Camera.hpp"
+#include "VEngine/Scene/SpatialIndex.hpp"
+
+namespace {
+
+    struct Scene {
+        std::vector<ven::AABB> boxes;
+        ven::SpatialIndex index{0.F};
+        std::vector<uint32_t> proxies;
+    };
+
+    ven::AABB randomBox(std::mt19937& rng, const float worldSize)
+    {
+        std::uniform_real_distribution position(-worldSize, worldSize);
+        std::uniform_real_distribution size(0.1F, 2.F);
+        const glm::vec3 min{position(rng), position(rng), position(rng)};
+        return { .min = min, .max = min + glm::vec3(size(rng), size(rng), size(rng)) };
+    }
+
+    void fill(Scene& scene, const uint32_t count, const float worldSize, const uint32_t seed = 42)
+    {
+        std::mt19937 rng(seed);
+        for (uint32_t i = 0; i < count; i++) {
+            scene.boxes.push_back(randomBox(rng, worldSize));
+            scene.proxies.push_back(scene.index.insert(scene.boxes.back(), ven::Handle{ .index = i, .generation = 0 }));
+        }
+    }
+
+    std::vector<uint32_t> sorted(const std::vector<ven::Handle>& handles)
+    {
+        std::vector<uint32_t> indices;
+        std::ranges::transform(handles, std::back_inserter(indices), [](const ven::Handle& handle) { return handle.index; });
+        std::ranges::sort(indices);
+        return indices;
+    }
+
+    bool sphereOverlaps(const ven::BoundingSphere& sphere, const ven::AABB& box)
+    {
+        const glm::vec3 delta = glm::clamp(sphere.center, box.min, box.max) - sphere.center;
+        return dot(delta, delta) <= sphere.radius * sphere.radius;
+    }
+
+    ven::Frustum makeFrustum(const glm::vec3& position, const glm::vec3& direction)
+    {
+        ven::Camera camera(ven::DEFAULT_FOV, ven::DEFAULT_NEAR, ven::DEFAULT_FAR, ven::DEFAULT_MOVE_SPEED, ven::DEFAULT_LOOK_SPEED);
+        camera.setViewDirection(position, direction);
+        camera.setPerspectiveProjection(16.F / 9.F);
+        return ven::Frustum(camera.getProjection() * camera.getView());
+    }
+
+} // namespace
+
+TEST(SpatialIndex, queriesMatchBruteForce)
+{
+    Scene scene;
+    fill(scene, 2000, 50.F);
+    EXPECT_EQ(scene.index.getProxyCount(), 2000U);
+    // balanced: far from the 2000 levels of a degenerate list
+    EXPECT_LT(scene.index.getHeight(), 30U);
+
+    const ven::AABB box{ .min = {-10.F, -10.F, -10.F}, .max = {10.F, 5.F, 10.F} };
+    const ven::BoundingSphere sphere{ .center = {5.F, 0.F, -5.F}, .radius = 12.F };
+    const ven::Frustum frustum = makeFrustum({0.F, 0.F, -60.F}, {0.F, 0.F, 1.F});
+    std::vector<uint32_t> expectedBox;
+    std::vector<uint32_t> expectedSphere;
+    std::vector<uint32_t> expectedFrustum;
+    for (uint32_t i = 0; i < scene.boxes.size(); i++) {
+        const ven::AABB& bounds = scene.boxes[i];
+        if (bounds.min.x <= box.max.x && box.min.x <= bounds.max.x && bounds.min.y <= box.max.y && box.min.y <= bounds.max.y && bounds.min.z <= box.max.z && box.min.z <= bounds.max.z) { expectedBox.push_back(i); }
+        if (sphereOverlaps(sphere, bounds)) { expectedSphere.push_back(i); }
+        if (frustum.intersects(bounds)) { expectedFrustum.push_back(i); }
+    }
+
+    std::vector<ven::Handle> results;
+    scene.index.query(box, results);
+    EXPECT_EQ(sorted(results), expectedBox);
+    results.clear();
+    scene.index.query(sphere, results);
+    EXPECT_EQ(sorted(results), expectedSphere);
+    results.clear();
+    scene.index.query(frustum, results);
+    EXPECT_EQ(sorted(results), expectedFrustum);
+    EXPECT_FALSE(expectedFrustum.empty());
+}
+
+TEST(SpatialIndex, raycastFindsClosest)
+{
+    ven::SpatialIndex index;
+    index.insert({ .min = {-1.F, -1.F, 10.F}, .max = {1.F, 1.F, 12.F} }, { .index = 1 });
+    index.insert({ .min = {-1.F, -1.F, 5.F}, .max = {1.F, 1.F, 6.F} }, { .index = 2 });
+    index.insert({ .min = {5.F, 5.F, 0.F}, .max = {6.F, 6.F, 1.F} }, { .index = 3 });
+
+    const std::array rays{
+        ven::Ray{ .origin = {0.F, 0.F, 0.F}, .direction = {0.F, 0.F, 1.F} },
+        ven::Ray{ .origin = {0.F, 0.F, 20.F}, .direction = {0.F, 0.F, -1.F} },
+        ven::Ray{ .origin = {0.F, 0.F, 0.F}, .direction = {0.F, 1.F, 0.F} },
+        ven::Ray{ .origin = {0.F, 0.F, 0.F}, .direction = {0.F, 0.F, 1.F}, .maxDistance = 3.F }
+    };
+    std::array<ven::RayHit, rays.size()> hits{};
+    index.raycast(rays, hits);
+
+    EXPECT_EQ(hits[0].handle.index, 2U);
+    EXPECT_NEAR(hits[0].distance, 5.F - ven::DEFAULT_FAT_MARGIN, 1e-4F);
+    EXPECT_EQ(hits[1].handle.index, 1U);
+    EXPECT_TRUE(hits[2].handle.isNull());
+    EXPECT_TRUE(hits[3].handle.isNull());
+}
+
+TEST(SpatialIndex, updateAndRemove)
+{
+    Scene scene;
+    fill(scene, 500, 20.F);
+    std::mt19937 rng(7);
+
+    // small moves stay inside the fat bounds of a margin index
+    ven::SpatialIndex fat;
+    const uint32_t proxy = fat.insert(scene.boxes[0], { .index = 0 });
+    ven::AABB moved = scene.boxes[0];
+    moved.min.x += 0.05F;
+    moved.max.x += 0.05F;
+    EXPECT_FALSE(fat.update(proxy, moved));
+    moved.min.x += 1.F;
+    moved.max.x += 1.F;
+    EXPECT_TRUE(fat.update(proxy, moved));
+
+    for (uint32_t i = 0; i < scene.boxes.size(); i += 2) {
+        scene.boxes[i] = randomBox(rng, 20.F);
+        scene.index.update(scene.proxies[i], scene.boxes[i]);
+    }
+    for (uint32_t i = 1; i < scene.boxes.size(); i += 4) {
+        scene.index.remove(scene.proxies[i]);
+        scene.boxes[i] = {};
+    }
+    EXPECT_EQ(scene.index.getProxyCount(), 375U);
+
+    const ven::AABB everything{ .min = glm::vec3(-100.F), .max = glm::vec3(100.F) };
+    std::vector<ven::Handle> results;
+    scene.index.query(everything, results);
+    EXPECT_EQ(results.size(), 375U);
+    const ven::BoundingSphere sphere{ .center = {0.F, 0.F, 0.F}, .radius = 8.F };
+    std::vector<uint32_t> expected;
+    for (uint32_t i = 0; i < scene.boxes.size(); i++) {
+        if (scene.boxes[i].isValid() && sphereOverlaps(sphere, scene.boxes[i])) { expected.push_back(i); }
+    }
+    results.clear();
+    scene.index.query(sphere, results);
+    EXPECT_EQ(sorted(results), expected);
+}
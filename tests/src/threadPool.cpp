@@ -0,0 +1,37 @@
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "VEngine/Utils/ThreadPool.hpp"
+
+TEST(ThreadPool, parallelForCoversRange)
+{
+    ven::ThreadPool pool(3);
+    std::vector<std::atomic<uint32_t>> hits(10007);
+
+    pool.parallelFor(hits.size(), [&](const std::size_t begin, const std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            hits[i]++;
+        }
+    }, 64);
+    for (const auto& hit : hits) {
+        EXPECT_EQ(hit.load(), 1U);
+    }
+}
+
+TEST(ThreadPool, waitIdleRunsEveryTask)
+{
+    ven::ThreadPool pool(2);
+    std::atomic<uint32_t> done{0};
+
+    for (uint32_t i = 0; i < 64; i++) {
+        pool.submit([&done] {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            done++;
+        });
+    }
+    pool.waitIdle();
+    EXPECT_EQ(done.load(), 64U);
+}
@@ -0,0 +1,82 @@
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include "VEngine/Scene/TransformBatch.hpp"
+
+namespace {
+
+    std::vector<ven::Transform3D> randomTransforms(const std::size_t count)
+    {
+        std::mt19937 rng(11);
+        std::uniform_real_distribution position(-100.F, 100.F);
+        std::uniform_real_distribution angle(-10.F, 10.F);
+        std::uniform_real_distribution scale(0.1F, 4.F);
+        std::vector<ven::Transform3D> transforms(count);
+        for (ven::Transform3D& transform : transforms) {
+            transform.translation = {position(rng), position(rng), position(rng)};
+            transform.rotation = {angle(rng), angle(rng), angle(rng)};
+            transform.scale = {scale(rng), scale(rng), scale(rng)};
+        }
+        return transforms;
+    }
+
+    std::vector<ven::SimdLevel> supportedLevels()
+    {
+        std::vector<ven::SimdLevel> levels;
+        for (const ven::SimdLevel level : {ven::SimdLevel::SCALAR, ven::SimdLevel::SSE4, ven::SimdLevel::AVX2}) {
+            if (level <= ven::TransformBatch::getSupportedLevel()) { levels.push_back(level); }
+        }
+        return levels;
+    }
+
+    const char* levelName(const ven::SimdLevel level)
+    {
+        switch (level) {
+            case ven::SimdLevel::AVX2: return "AVX2";
+            case ven::SimdLevel::SSE4: return "SSE4";
+            case ven::SimdLevel::SCALAR:
+            default: return "scalar";
+        }
+    }
+
+} // namespace
+
+TEST(TransformBatch, matchesTransform3D)
+{
+    // not a multiple of the vector width, so the scalar tail runs too
+    const std::vector<ven::Transform3D> transforms = randomTransforms(1003);
+    ven::TransformBatch batch;
+    for (const ven::Transform3D& transform : transforms) {
+        batch.push(transform);
+    }
+    std::vector<glm::mat4> models(transforms.size());
+    std::vector<glm::mat4> normals(transforms.size());
+
+    for (const ven::SimdLevel level : supportedLevels()) {
+        batch.setLevel(level);
+        EXPECT_EQ(batch.getLevel(), level);
+        batch.compute(models, normals);
+        for (std::size_t i = 0; i < transforms.size(); i++) {
+            const glm::mat4 model = transforms[i].transformMatrix();
+            const glm::mat4 normal(transforms[i].normalMatrix());
+            for (int column = 0; column < 4; column++) {
+                for (int row = 0; row < 4; row++) {
+                    ASSERT_NEAR(models[i][column][row], model[column][row], 1e-4F * std::max(1.F, std::abs(model[column][row]))) << levelName(level) << " model " << i;
+                    ASSERT_NEAR(normals[i][column][row], normal[column][row], 1e-4F * std::max(1.F, std::abs(normal[column][row]))) << levelName(level) << " normal " << i;
+                }
+            }
+        }
+    }
+}
+
+TEST(TransformBatch, outputTooSmall)
+{
+    ven::TransformBatch batch;
+    batch.resize(4);
+    std::vector<glm::mat4> models(3);
+    std::vector<glm::mat4> normals(4);
+    EXPECT_THROW(batch.compute(models, normals), std::invalid_argument);
+}
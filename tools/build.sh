@@ -12,11 +12,14 @@ case $1 in
     tests)
         "${CMAKE_CMD[@]}" -DBUILD_TESTS=ON && cmake --build build
         ;;
+    benchmarks)
+        "${CMAKE_CMD[@]}" -DBUILD_BENCHMARKS=ON && cmake --build build
+        ;;
     doc)
         "${CMAKE_CMD[@]}" -DBUILD_DOC=ON && cmake --build build --target doxygen
         ;;
     *)
-        echo "[ERROR] Invalid command. Usage: $0 build | format | tests | doc"
+        echo "[ERROR] Invalid command. Usage: $0 build | format | tests | benchmarks | doc"
         exit 1
         ;;
 esac